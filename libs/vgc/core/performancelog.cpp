@@ -24,7 +24,9 @@ PerformanceLog::PerformanceLog(PerformanceLog* parent, const std::string& name)
     : Object()
     , params_(nullptr)
     , name_(name)
-    , time_(0.0) {
+    , time_(0.0)
+    , count_(0)
+    , isCount_(false) {
 
     if (parent) {
         appendObjectToParent_(parent);
@@ -64,6 +66,11 @@ double PerformanceLog::lastTime() const {
     return time_;
 }
 
+void PerformanceLog::logCount(Int count) {
+    count_ = count;
+    isCount_ = true;
+}
+
 PerformanceLogParams::PerformanceLogParams()
     : Object() {
 }
@@ -126,6 +133,18 @@ void PerformanceLogTask::stop() {
     }
 }
 
+void PerformanceLogTask::log(double time) {
+    for (const auto& log : logs_) {
+        log->log(time);
+    }
+}
+
+void PerformanceLogTask::logCount(Int count) {
+    for (const auto& log : logs_) {
+        log->logCount(count);
+    }
+}
+
 } // namespace vgc::core
 
 // Ideas for future work:
@@ -20,6 +20,7 @@
 #include <string>
 #include <vector>
 #include <vgc/core/api.h>
+#include <vgc/core/arithmetic.h>
 #include <vgc/core/object.h>
 #include <vgc/core/stopwatch.h>
 
@@ -231,6 +232,26 @@ public:
     ///
     double lastTime() const;
 
+    /// Manually writes a count into this log, for example the number of
+    /// objects processed by a task, rather than a time measurement.
+    ///
+    /// \sa isCount(), lastCount()
+    ///
+    void logCount(Int count);
+
+    /// Returns whether this log stores counts (see `logCount()`) rather than
+    /// time measurements.
+    ///
+    bool isCount() const {
+        return isCount_;
+    }
+
+    /// Returns the last logged count in this entry.
+    ///
+    Int lastCount() const {
+        return count_;
+    }
+
     /// Returns the parent of log entry, if any.
     ///
     PerformanceLog* parent() const {
@@ -265,6 +286,8 @@ private:
     PerformanceLogParamsPtr params_;
     std::string name_;
     double time_;
+    Int count_;
+    bool isCount_;
 
     Stopwatch stopwatch_;
 
@@ -337,6 +360,17 @@ public:
     ///
     void stop();
 
+    /// Equivalent to calling log->log(time) on all the managed logs.
+    ///
+    /// This is useful when the time was measured by other means than
+    /// start() and stop(), for example by another thread.
+    ///
+    void log(double time);
+
+    /// Equivalent to calling log->logCount(count) on all the managed logs.
+    ///
+    void logCount(Int count);
+
 private:
     std::string name_;
     std::vector<PerformanceLogPtr> logs_;
@@ -17,12 +17,64 @@
 #ifndef VGC_GEOMETRY_BEZIER_H
 #define VGC_GEOMETRY_BEZIER_H
 
+#include <vgc/core/arithmetic.h>
 #include <vgc/geometry/api.h>
 
 namespace vgc::geometry {
 
 // clang-format off
 
+/// Returns the position at coordinate \p u of the quadratic Bézier curve
+/// defined by the three control points \p p0, \p p1, and \p p2.
+///
+/// \sa quadraticBezierDer(), quadraticBezierPosAndDer()
+///
+template <typename Scalar, typename T>
+T quadraticBezier(
+    const T& p0, const T& p1, const T& p2,
+    Scalar u) {
+
+    Scalar v = 1 - u;
+
+    return       v * v * p0
+           + 2 * v * u * p1
+           +     u * u * p2;
+}
+
+/// Returns the (non-normalized) derivative at coordinate \p u of the
+/// quadratic Bézier curve defined by the three control points \p p0, \p p1,
+/// and \p p2.
+///
+/// \sa quadraticBezier(), quadraticBezierPosAndDer()
+///
+template <typename Scalar, typename T>
+T quadraticBezierDer(
+    const T& p0, const T& p1, const T& p2,
+    Scalar u) {
+
+    Scalar v = 1 - u;
+
+    return   2 * v * (p1 - p0)
+           + 2 * u * (p2 - p1);
+}
+
+/// Returns both the position \p pos and derivative \p der at coordinate \p u
+/// of the quadratic Bézier curve defined by the three control points \p p0,
+/// \p p1, and \p p2.
+///
+/// \sa quadraticBezier(), quadraticBezierDer()
+///
+template <typename Scalar, typename T>
+void quadraticBezierPosAndDer(
+    const T& p0, const T& p1, const T& p2,
+    Scalar u,
+    T& pos,
+    T& der) {
+
+    pos = quadraticBezier(p0, p1, p2, u);
+    der = quadraticBezierDer(p0, p1, p2, u);
+}
+
 /// Returns the position at coordinate \p u of the cubic Bézier curve defined
 /// by the four control points \p p0, \p p1, \p p2, and \p p3.
 ///
@@ -83,7 +135,7 @@ T cubicBezierDer(
 /// \sa cubicBezier(), cubicBezierDer()
 ///
 template <typename Scalar, typename T>
-T cubicBezierPosAndDer(
+void cubicBezierPosAndDer(
     const T& p0, const T& p1, const T& p2, const T& p3,
     Scalar u,
     T& pos,
@@ -107,6 +159,248 @@ T cubicBezierPosAndDer(
 
 // clang-format on
 
+/// \class vgc::geometry::UniformBezierSampler
+/// \brief Evaluates a Bézier curve at evenly spaced values of its parameter.
+///
+/// A `UniformBezierSampler<degree, T, Scalar>` iterates over the
+/// `numSteps + 1` values u = 0, 1/numSteps, ..., 1, and provides the position
+/// and derivative of the Bézier curve at each of these values. It is
+/// specialized for quadratic (`degree = 2`) and cubic (`degree = 3`) curves.
+///
+/// ```cpp
+/// UniformBezierSampler<3, Vec2d> sampler(p0, p1, p2, p3, numSteps);
+/// while (true) {
+///     doSomething(sampler.position(), sampler.derivative());
+///     if (sampler.isLast()) {
+///         break;
+///     }
+///     sampler.advance();
+/// }
+/// ```
+///
+/// This is much faster than calling `cubicBezier()` and `cubicBezierDer()`
+/// for each value of u, since advancing to the next sample uses forward
+/// differencing, that is, only a few additions. In order to bound the
+/// accumulation of floating point errors, the position, derivative, and
+/// differences are recomputed from scratch every `reanchorInterval` steps,
+/// as well as for the last sample, which is therefore exactly equal to the
+/// last control point.
+///
+template<int degree, typename T, typename Scalar = double>
+class UniformBezierSampler;
+
+/// \class vgc::geometry::UniformBezierSampler<2, T, Scalar>
+/// \brief Specialization of UniformBezierSampler for quadratic Bézier curves.
+///
+template<typename T, typename Scalar>
+class UniformBezierSampler<2, T, Scalar> {
+public:
+    /// How many steps are performed via forward differencing before the
+    /// position and derivative are recomputed from scratch.
+    ///
+    static constexpr Int reanchorInterval = 32;
+
+    /// Creates a sampler of the quadratic Bézier curve defined by the
+    /// control points \p p0, \p p1, and \p p2, whose current sample is
+    /// the one at u = 0.
+    ///
+    /// The given \p numSteps must be positive.
+    ///
+    UniformBezierSampler(const T& p0, const T& p1, const T& p2, Int numSteps)
+        : p0_(p0)
+        , p1_(p1)
+        , p2_(p2)
+        , a_(p0 - 2 * p1 + p2)
+        , b_(2 * (p1 - p0))
+        , numSteps_(numSteps)
+        , h_(static_cast<Scalar>(1) / static_cast<Scalar>(numSteps)) {
+
+        anchor_(0);
+    }
+
+    /// Returns the number of steps, that is, the number of samples minus one.
+    ///
+    Int numSteps() const {
+        return numSteps_;
+    }
+
+    /// Returns the index of the current sample, in [0, numSteps()].
+    ///
+    Int index() const {
+        return index_;
+    }
+
+    /// Returns whether the current sample is the last one, that is, the one
+    /// at u = 1.
+    ///
+    bool isLast() const {
+        return index_ >= numSteps_;
+    }
+
+    /// Returns the parameter u of the current sample.
+    ///
+    Scalar u() const {
+        return isLast() ? 1 : index_ * h_;
+    }
+
+    /// Returns the position of the current sample.
+    ///
+    const T& position() const {
+        return pos_;
+    }
+
+    /// Returns the (non-normalized) derivative of the current sample.
+    ///
+    const T& derivative() const {
+        return der_;
+    }
+
+    /// Moves to the next sample.
+    ///
+    void advance() {
+        ++index_;
+        if (index_ % reanchorInterval == 0 || index_ >= numSteps_) {
+            anchor_(index_);
+        }
+        else {
+            pos_ += d1_;
+            d1_ += d2_;
+            der_ += e1_;
+        }
+    }
+
+private:
+    T p0_, p1_, p2_;
+    T a_, b_; // P(u) = a u^2 + b u + p0
+    T pos_, d1_, d2_;
+    T der_, e1_;
+    Int numSteps_;
+    Int index_ = 0;
+    Scalar h_;
+
+    void anchor_(Int index) {
+        index_ = index;
+        Scalar u = this->u();
+        Scalar h = h_;
+        quadraticBezierPosAndDer(p0_, p1_, p2_, u, pos_, der_);
+        d1_ = h * ((2 * u + h) * a_ + b_);
+        d2_ = (2 * h * h) * a_;
+        e1_ = (2 * h) * a_;
+    }
+};
+
+/// \class vgc::geometry::UniformBezierSampler<3, T, Scalar>
+/// \brief Specialization of UniformBezierSampler for cubic Bézier curves.
+///
+template<typename T, typename Scalar>
+class UniformBezierSampler<3, T, Scalar> {
+public:
+    /// How many steps are performed via forward differencing before the
+    /// position and derivative are recomputed from scratch.
+    ///
+    static constexpr Int reanchorInterval = 32;
+
+    /// Creates a sampler of the cubic Bézier curve defined by the control
+    /// points \p p0, \p p1, \p p2, and \p p3, whose current sample is the one
+    /// at u = 0.
+    ///
+    /// The given \p numSteps must be positive.
+    ///
+    UniformBezierSampler(
+        const T& p0,
+        const T& p1,
+        const T& p2,
+        const T& p3,
+        Int numSteps)
+
+        : p0_(p0)
+        , p1_(p1)
+        , p2_(p2)
+        , p3_(p3)
+        , a_(p3 - p0 + 3 * (p1 - p2))
+        , b_(3 * (p0 - 2 * p1 + p2))
+        , c_(3 * (p1 - p0))
+        , numSteps_(numSteps)
+        , h_(static_cast<Scalar>(1) / static_cast<Scalar>(numSteps)) {
+
+        anchor_(0);
+    }
+
+    /// Returns the number of steps, that is, the number of samples minus one.
+    ///
+    Int numSteps() const {
+        return numSteps_;
+    }
+
+    /// Returns the index of the current sample, in [0, numSteps()].
+    ///
+    Int index() const {
+        return index_;
+    }
+
+    /// Returns whether the current sample is the last one, that is, the one
+    /// at u = 1.
+    ///
+    bool isLast() const {
+        return index_ >= numSteps_;
+    }
+
+    /// Returns the parameter u of the current sample.
+    ///
+    Scalar u() const {
+        return isLast() ? 1 : index_ * h_;
+    }
+
+    /// Returns the position of the current sample.
+    ///
+    const T& position() const {
+        return pos_;
+    }
+
+    /// Returns the (non-normalized) derivative of the current sample.
+    ///
+    const T& derivative() const {
+        return der_;
+    }
+
+    /// Moves to the next sample.
+    ///
+    void advance() {
+        ++index_;
+        if (index_ % reanchorInterval == 0 || index_ >= numSteps_) {
+            anchor_(index_);
+        }
+        else {
+            pos_ += d1_;
+            d1_ += d2_;
+            d2_ += d3_;
+            der_ += e1_;
+            e1_ += e2_;
+        }
+    }
+
+private:
+    T p0_, p1_, p2_, p3_;
+    T a_, b_, c_; // P(u) = a u^3 + b u^2 + c u + p0
+    T pos_, d1_, d2_, d3_;
+    T der_, e1_, e2_;
+    Int numSteps_;
+    Int index_ = 0;
+    Scalar h_;
+
+    void anchor_(Int index) {
+        index_ = index;
+        Scalar u = this->u();
+        Scalar h = h_;
+        cubicBezierPosAndDer(p0_, p1_, p2_, p3_, u, pos_, der_);
+        d1_ = h * ((3 * u * u + 3 * u * h + h * h) * a_ + (2 * u + h) * b_ + c_);
+        d2_ = (h * h) * ((6 * u + 6 * h) * a_ + 2 * b_);
+        d3_ = (6 * h * h * h) * a_;
+        e1_ = h * ((6 * u + 3 * h) * a_ + 2 * b_);
+        e2_ = (6 * h * h) * a_;
+    }
+};
+
 } // namespace vgc::geometry
 
 #endif // VGC_GEOMETRY_BEZIER_H
\ No newline at end of file
@@ -22,6 +22,7 @@
 #include <vector>
 #include <vgc/core/algorithm.h>
 #include <vgc/geometry/api.h>
+#include <vgc/geometry/bezier.h>
 
 namespace vgc::geometry {
 
@@ -176,6 +177,40 @@ public:
         return res;
     }
 
+    /// Appends to \p positions the positions of the spline at the
+    /// `numSegments() * n + 1` evenly spaced values of u in [0, 1], that is, n
+    /// samples per segment plus the last control point. If \p derivatives is
+    /// not null, the corresponding derivatives with respect to u are appended
+    /// to it.
+    ///
+    /// This is much faster than calling eval() for each value of u, since
+    /// samples are computed via forward differencing, see
+    /// UniformBezierSampler. The given \p n must be positive.
+    ///
+    void sampleUniform(
+        int n,
+        std::vector<T>& positions,
+        std::vector<T>* derivatives = nullptr) const {
+
+        assert(n > 0);
+        int numSegments = this->numSegments();
+        Scalar derScale = static_cast<Scalar>(numSegments);
+        for (int i = 0; i < numSegments; ++i) {
+            const T* p = data_.data() + 3 * i;
+            UniformBezierSampler<3, T, Scalar> sampler(p[0], p[1], p[2], p[3], n);
+            int numSamples = (i == numSegments - 1) ? n + 1 : n;
+            for (int j = 0; j < numSamples; ++j) {
+                if (j > 0) {
+                    sampler.advance();
+                }
+                positions.push_back(sampler.position());
+                if (derivatives) {
+                    derivatives->push_back(derScale * sampler.derivative());
+                }
+            }
+        }
+    }
+
 private:
     std::vector<T> data_;
 };
@@ -0,0 +1,346 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vgc/geometry/bvh2d.h>
+
+#include <vgc/core/exceptions.h>
+#include <vgc/core/format.h>
+
+namespace vgc::geometry {
+
+namespace {
+
+// Half the perimeter of the rectangle. This is the cost function used to
+// choose where to insert new leaves, as it better reflects the probability
+// of being hit by a random query than the area, and behaves well for
+// degenerate (flat) rectangles.
+//
+double cost(const Rect2d& r) {
+    return r.width() + r.height();
+}
+
+} // namespace
+
+Bvh2d::Bvh2d() {
+}
+
+void Bvh2d::clear() {
+    nodes_.clear();
+    root_ = -1;
+    freeList_ = -1;
+    numItems_ = 0;
+}
+
+Int Bvh2d::insert(const Rect2d& rect, Int value) {
+    Int leaf = allocateNode_();
+    Node& node = nodes_[leaf];
+    node.rect = rect;
+    node.height = 0;
+    node.value = value;
+    insertLeaf_(leaf);
+    ++numItems_;
+    return leaf;
+}
+
+void Bvh2d::remove(Int id) {
+    leaf_(id); // throws if invalid
+    removeLeaf_(id);
+    freeNode_(id);
+    --numItems_;
+}
+
+void Bvh2d::move(Int id, const Rect2d& rect) {
+    leaf_(id); // throws if invalid
+    removeLeaf_(id);
+    nodes_[id].rect = rect;
+    insertLeaf_(id);
+}
+
+const Bvh2d::Node& Bvh2d::leaf_(Int id) const {
+    if (!contains(id)) {
+        throw core::IndexError(core::format("No item with ID {} in this Bvh2d.", id));
+    }
+    return nodes_.getUnchecked(id);
+}
+
+Int Bvh2d::allocateNode_() {
+    Int i;
+    if (freeList_ == -1) {
+        i = nodes_.length();
+        nodes_.append(Node());
+    }
+    else {
+        i = freeList_;
+        freeList_ = nodes_[i].parent;
+    }
+    Node& node = nodes_[i];
+    node.rect = Rect2d::empty;
+    node.parent = -1;
+    node.child1 = -1;
+    node.child2 = -1;
+    node.height = 0;
+    node.value = 0;
+    return i;
+}
+
+void Bvh2d::freeNode_(Int i) {
+    Node& node = nodes_[i];
+    node.parent = freeList_;
+    node.height = -1;
+    freeList_ = i;
+}
+
+void Bvh2d::insertLeaf_(Int leaf) {
+    if (root_ == -1) {
+        root_ = leaf;
+        nodes_[root_].parent = -1;
+        return;
+    }
+
+    // Find the best sibling for the new leaf, using the same branch and bound
+    // heuristic as Box2D's b2DynamicTree: descend the tree, at each level
+    // choosing the child which minimizes the cost increase of the hierarchy.
+    //
+    const Rect2d leafRect = nodes_[leaf].rect;
+    Int i = root_;
+    while (!nodes_[i].isLeaf()) {
+        const Node& node = nodes_[i];
+        Int child1 = node.child1;
+        Int child2 = node.child2;
+
+        double nodeCost = cost(node.rect);
+        double combinedCost = cost(node.rect.unitedWith(leafRect));
+
+        // Cost of creating a new parent for this node and the new leaf
+        double costHere = 2.0 * combinedCost;
+
+        // Minimum cost of pushing the leaf further down the tree
+        double inheritanceCost = 2.0 * (combinedCost - nodeCost);
+
+        // Cost of descending into each child
+        auto descendCost = [&](Int child) {
+            const Node& c = nodes_[child];
+            double newCost = cost(leafRect.unitedWith(c.rect));
+            if (c.isLeaf()) {
+                return newCost + inheritanceCost;
+            }
+            else {
+                return newCost - cost(c.rect) + inheritanceCost;
+            }
+        };
+        double cost1 = descendCost(child1);
+        double cost2 = descendCost(child2);
+
+        if (costHere < cost1 && costHere < cost2) {
+            break;
+        }
+        i = (cost1 < cost2) ? child1 : child2;
+    }
+    Int sibling = i;
+
+    // Create a new parent
+    Int oldParent = nodes_[sibling].parent;
+    Int newParent = allocateNode_();
+    {
+        Node& p = nodes_[newParent];
+        p.parent = oldParent;
+        p.rect = leafRect.unitedWith(nodes_[sibling].rect);
+        p.height = nodes_[sibling].height + 1;
+        p.child1 = sibling;
+        p.child2 = leaf;
+    }
+    if (oldParent != -1) {
+        Node& op = nodes_[oldParent];
+        if (op.child1 == sibling) {
+            op.child1 = newParent;
+        }
+        else {
+            op.child2 = newParent;
+        }
+    }
+    else {
+        root_ = newParent;
+    }
+    nodes_[sibling].parent = newParent;
+    nodes_[leaf].parent = newParent;
+
+    // Walk back up the tree fixing heights and rects
+    refit_(newParent);
+}
+
+void Bvh2d::removeLeaf_(Int leaf) {
+    if (leaf == root_) {
+        root_ = -1;
+        return;
+    }
+
+    Int parent = nodes_[leaf].parent;
+    Int grandParent = nodes_[parent].parent;
+    Int sibling =
+        (nodes_[parent].child1 == leaf) ? nodes_[parent].child2 : nodes_[parent].child1;
+
+    if (grandParent != -1) {
+        // Destroy parent and connect sibling to grandParent
+        Node& gp = nodes_[grandParent];
+        if (gp.child1 == parent) {
+            gp.child1 = sibling;
+        }
+        else {
+            gp.child2 = sibling;
+        }
+        nodes_[sibling].parent = grandParent;
+        freeNode_(parent);
+        refit_(grandParent);
+    }
+    else {
+        root_ = sibling;
+        nodes_[sibling].parent = -1;
+        freeNode_(parent);
+    }
+    nodes_[leaf].parent = -1;
+}
+
+void Bvh2d::refit_(Int i) {
+    while (i != -1) {
+        i = balance_(i);
+        Node& node = nodes_[i];
+        const Node& c1 = nodes_[node.child1];
+        const Node& c2 = nodes_[node.child2];
+        node.height = 1 + (std::max)(c1.height, c2.height);
+        node.rect = c1.rect.unitedWith(c2.rect);
+        i = node.parent;
+    }
+}
+
+// Performs a left or right rotation if node A is imbalanced, and returns the
+// new root index of the subtree. Notations:
+//
+//   - A has children B and C
+//   - B has children D and E
+//   - C has children F and G
+//
+Int Bvh2d::balance_(Int iA) {
+    Node& A = nodes_[iA];
+    if (A.isLeaf() || A.height < 2) {
+        return iA;
+    }
+
+    Int iB = A.child1;
+    Int iC = A.child2;
+    Node& B = nodes_[iB];
+    Node& C = nodes_[iC];
+    Int balance = C.height - B.height;
+
+    // Rotate C up
+    if (balance > 1) {
+        Int iF = C.child1;
+        Int iG = C.child2;
+        Node& F = nodes_[iF];
+        Node& G = nodes_[iG];
+
+        // Swap A and C
+        C.child1 = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+
+        // A's old parent should point to C
+        if (C.parent != -1) {
+            Node& P = nodes_[C.parent];
+            if (P.child1 == iA) {
+                P.child1 = iC;
+            }
+            else {
+                P.child2 = iC;
+            }
+        }
+        else {
+            root_ = iC;
+        }
+
+        // Rotate
+        if (F.height > G.height) {
+            C.child2 = iF;
+            A.child2 = iG;
+            G.parent = iA;
+            A.rect = B.rect.unitedWith(G.rect);
+            C.rect = A.rect.unitedWith(F.rect);
+            A.height = 1 + (std::max)(B.height, G.height);
+            C.height = 1 + (std::max)(A.height, F.height);
+        }
+        else {
+            C.child2 = iG;
+            A.child2 = iF;
+            F.parent = iA;
+            A.rect = B.rect.unitedWith(F.rect);
+            C.rect = A.rect.unitedWith(G.rect);
+            A.height = 1 + (std::max)(B.height, F.height);
+            C.height = 1 + (std::max)(A.height, G.height);
+        }
+        return iC;
+    }
+
+    // Rotate B up
+    if (balance < -1) {
+        Int iD = B.child1;
+        Int iE = B.child2;
+        Node& D = nodes_[iD];
+        Node& E = nodes_[iE];
+
+        // Swap A and B
+        B.child1 = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+
+        // A's old parent should point to B
+        if (B.parent != -1) {
+            Node& P = nodes_[B.parent];
+            if (P.child1 == iA) {
+                P.child1 = iB;
+            }
+            else {
+                P.child2 = iB;
+            }
+        }
+        else {
+            root_ = iB;
+        }
+
+        // Rotate
+        if (D.height > E.height) {
+            B.child2 = iD;
+            A.child1 = iE;
+            E.parent = iA;
+            A.rect = C.rect.unitedWith(E.rect);
+            B.rect = A.rect.unitedWith(D.rect);
+            A.height = 1 + (std::max)(C.height, E.height);
+            B.height = 1 + (std::max)(A.height, D.height);
+        }
+        else {
+            B.child2 = iE;
+            A.child1 = iD;
+            D.parent = iA;
+            A.rect = C.rect.unitedWith(D.rect);
+            B.rect = A.rect.unitedWith(E.rect);
+            A.height = 1 + (std::max)(C.height, D.height);
+            B.height = 1 + (std::max)(A.height, E.height);
+        }
+        return iB;
+    }
+
+    return iA;
+}
+
+} // namespace vgc::geometry
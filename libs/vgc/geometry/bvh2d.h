@@ -0,0 +1,319 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VGC_GEOMETRY_BVH2D_H
+#define VGC_GEOMETRY_BVH2D_H
+
+#include <algorithm> // max
+#include <cmath> // sqrt
+#include <functional> // greater
+#include <queue>
+#include <utility> // pair
+#include <vector>
+
+#include <vgc/core/arithmetic.h>
+#include <vgc/core/array.h>
+#include <vgc/geometry/api.h>
+#include <vgc/geometry/rect2d.h>
+#include <vgc/geometry/vec2d.h>
+
+namespace vgc::geometry {
+
+/// \class vgc::geometry::Bvh2d
+/// \brief Dynamic bounding volume hierarchy of 2D rectangles.
+///
+/// A `Bvh2d` stores a set of items, each of them represented by its bounding
+/// rectangle (`Rect2d`) and an arbitrary integer `value` chosen by the client,
+/// for example the index of the curve that the rectangle bounds.
+///
+/// Items can be inserted, removed, or moved at any time in O(log n), and the
+/// hierarchy is kept balanced via tree rotations. This makes it possible to
+/// quickly answer spatial queries such as "which items are under this point"
+/// or "which items intersect this rectangle", without scanning all the items.
+///
+/// ```cpp
+/// Bvh2d bvh;
+/// Int id1 = bvh.insert(Rect2d(0, 0, 10, 10), 42);
+/// Int id2 = bvh.insert(Rect2d(20, 0, 30, 10), 43);
+/// core::IntArray ids;
+/// bvh.findIntersecting(Rect2d(5, 5, 25, 6), ids); // ids == [id1, id2] (any order)
+/// bvh.value(ids[0]); // == 42 or 43
+/// ```
+///
+/// The returned item IDs remain valid until the item is removed, and may be
+/// reused for new items after that.
+///
+class VGC_GEOMETRY_API Bvh2d {
+public:
+    /// Creates an empty `Bvh2d`.
+    ///
+    Bvh2d();
+
+    /// Returns the number of items in this `Bvh2d`.
+    ///
+    Int numItems() const {
+        return numItems_;
+    }
+
+    /// Returns whether this `Bvh2d` has no items.
+    ///
+    bool isEmpty() const {
+        return numItems_ == 0;
+    }
+
+    /// Removes all the items of this `Bvh2d`.
+    ///
+    void clear();
+
+    /// Inserts a new item with the given bounding `rect` and `value`, and
+    /// returns its ID.
+    ///
+    /// The given `rect` must not be empty.
+    ///
+    Int insert(const Rect2d& rect, Int value);
+
+    /// Removes the item with the given `id`.
+    ///
+    /// Throws `IndexError` if there is no item with the given `id`.
+    ///
+    void remove(Int id);
+
+    /// Changes the bounding rectangle of the item with the given `id`.
+    ///
+    /// Throws `IndexError` if there is no item with the given `id`.
+    ///
+    void move(Int id, const Rect2d& rect);
+
+    /// Returns whether there is an item with the given `id`.
+    ///
+    bool contains(Int id) const {
+        return id >= 0 && id < nodes_.length() && nodes_.getUnchecked(id).height == 0;
+    }
+
+    /// Returns the bounding rectangle of the item with the given `id`.
+    ///
+    /// Throws `IndexError` if there is no item with the given `id`.
+    ///
+    const Rect2d& rect(Int id) const {
+        return leaf_(id).rect;
+    }
+
+    /// Returns the value of the item with the given `id`.
+    ///
+    /// Throws `IndexError` if there is no item with the given `id`.
+    ///
+    Int value(Int id) const {
+        return leaf_(id).value;
+    }
+
+    /// Returns the bounding rectangle of all the items, or `Rect2d::empty` if
+    /// there is no item.
+    ///
+    Rect2d boundingRect() const {
+        return root_ == -1 ? Rect2d::empty : nodes_.getUnchecked(root_).rect;
+    }
+
+    /// Returns the height of the hierarchy, that is, zero if there is at most
+    /// one item, and O(log n) otherwise.
+    ///
+    Int height() const {
+        return root_ == -1 ? 0 : nodes_.getUnchecked(root_).height;
+    }
+
+    /// Appends to `ids` the IDs of all items whose bounding rectangle
+    /// intersects the given `rect`.
+    ///
+    void findIntersecting(const Rect2d& rect, core::IntArray& ids) const {
+        visitNodes_(
+            [&](const Rect2d& r) { return r.intersects(rect); },
+            [&](Int id) {
+                ids.append(id);
+                return true;
+            });
+    }
+
+    /// Appends to `ids` the IDs of all items whose bounding rectangle
+    /// contains the given `point`.
+    ///
+    void findContaining(const Vec2d& point, core::IntArray& ids) const {
+        visitNodes_(
+            [&](const Rect2d& r) { return r.contains(point); },
+            [&](Int id) {
+                ids.append(id);
+                return true;
+            });
+    }
+
+    /// Calls `f(id)` for all items whose bounding rectangle intersects the
+    /// given `rect`. If `f` returns `false`, then the search is stopped.
+    ///
+    template<typename Function>
+    void visitIntersecting(const Rect2d& rect, Function&& f) const {
+        visitNodes_([&](const Rect2d& r) { return r.intersects(rect); }, f);
+    }
+
+    /// Returns the ID of the item nearest to the given `point`, or `-1` if
+    /// there is no item closer than `maxDistance`.
+    ///
+    /// The given function `distance(id)` must return the distance between
+    /// `point` and the actual geometry of the item (e.g., a curve segment),
+    /// which must be greater or equal to the distance between `point` and the
+    /// bounding rectangle of the item. Items are visited in order of
+    /// increasing distance to their bounding rectangle, and `distance` is only
+    /// called on items which may be closer than the best candidate so far.
+    ///
+    /// If `outDistance` is not null, it is set to the distance to the
+    /// returned item.
+    ///
+    template<typename DistanceFunction>
+    Int findNearest(
+        const Vec2d& point,
+        DistanceFunction&& distance,
+        double maxDistance = core::infinity<double>,
+        double* outDistance = nullptr) const;
+
+    /// Returns the distance between the given `point` and the given `rect`,
+    /// which is zero if the point is inside the rectangle.
+    ///
+    static double distance(const Rect2d& rect, const Vec2d& point) {
+        double dx = (std::max)({rect.xMin() - point.x(), 0.0, point.x() - rect.xMax()});
+        double dy = (std::max)({rect.yMin() - point.y(), 0.0, point.y() - rect.yMax()});
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+private:
+    // Note: nodes are either leaves (height == 0), internal nodes (height >
+    // 0), or free nodes (height == -1). Free nodes are chained via `parent`.
+    //
+    struct Node {
+        Rect2d rect;
+        Int parent;
+        Int child1;
+        Int child2;
+        Int height;
+        Int value;
+
+        bool isLeaf() const {
+            return child1 == -1;
+        }
+    };
+
+    core::Array<Node> nodes_;
+    Int root_ = -1;
+    Int freeList_ = -1;
+    Int numItems_ = 0;
+
+    const Node& leaf_(Int id) const;
+    Int allocateNode_();
+    void freeNode_(Int i);
+    void insertLeaf_(Int leaf);
+    void removeLeaf_(Int leaf);
+    Int balance_(Int i);
+    void refit_(Int i);
+
+    // Depth-first traversal of all nodes whose rect passes `test`, calling
+    // `f` on leaves. Stops the traversal if `f` returns false.
+    //
+    template<typename Test, typename Function>
+    void visitNodes_(Test&& test, Function&& f) const {
+        if (root_ == -1) {
+            return;
+        }
+        Int stackBuffer[64];
+        core::IntArray stackOverflow;
+        Int stackSize = 0;
+        auto push = [&](Int i) {
+            if (stackSize < 64) {
+                stackBuffer[stackSize] = i;
+            }
+            else {
+                stackOverflow.append(i);
+            }
+            ++stackSize;
+        };
+        auto pop = [&]() {
+            --stackSize;
+            return stackSize < 64 ? stackBuffer[stackSize] : stackOverflow.pop();
+        };
+        push(root_);
+        while (stackSize > 0) {
+            const Node& node = nodes_.getUnchecked(pop());
+            if (!test(node.rect)) {
+                continue;
+            }
+            if (node.isLeaf()) {
+                Int id = &node - nodes_.data();
+                if (!f(id)) {
+                    return;
+                }
+            }
+            else {
+                push(node.child1);
+                push(node.child2);
+            }
+        }
+    }
+};
+
+template<typename DistanceFunction>
+Int Bvh2d::findNearest(
+    const Vec2d& point,
+    DistanceFunction&& distance,
+    double maxDistance,
+    double* outDistance) const {
+
+    Int bestId = -1;
+    double bestDistance = maxDistance;
+    if (root_ != -1) {
+        // Best-first search: nodes are visited in order of increasing
+        // distance to their bounding rectangle.
+        using Entry = std::pair<double, Int>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+        queue.push({Bvh2d::distance(nodes_.getUnchecked(root_).rect, point), root_});
+        while (!queue.empty()) {
+            auto [d, i] = queue.top();
+            queue.pop();
+            if (d > bestDistance) {
+                break;
+            }
+            const Node& node = nodes_.getUnchecked(i);
+            if (node.isLeaf()) {
+                double dist = distance(i);
+                if (dist <= bestDistance) {
+                    bestDistance = dist;
+                    bestId = i;
+                }
+            }
+            else {
+                for (Int child : {node.child1, node.child2}) {
+                    const Rect2d& r = nodes_.getUnchecked(child).rect;
+                    double dChild = Bvh2d::distance(r, point);
+                    if (dChild <= bestDistance) {
+                        queue.push({dChild, child});
+                    }
+                }
+            }
+        }
+    }
+    if (outDistance) {
+        *outDistance = bestDistance;
+    }
+    return bestId;
+}
+
+} // namespace vgc::geometry
+
+#endif // VGC_GEOMETRY_BVH2D_H
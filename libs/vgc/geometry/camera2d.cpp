@@ -66,4 +66,17 @@ Mat4d Camera2d::projectionMatrix() const {
     //    try with an object at (0, 0, 0.5) obsuring one at (0, 0, -0.5).
 }
 
+Rect2d Camera2d::visibleRect(double margin) const {
+    const double x0 = -margin;
+    const double y0 = -margin;
+    const double x1 = viewportWidth_ + margin;
+    const double y1 = viewportHeight_ + margin;
+    Mat4d viewInverse = viewMatrix().inverted();
+    Rect2d res = Rect2d::empty;
+    for (const Vec2d& p : {Vec2d(x0, y0), Vec2d(x1, y0), Vec2d(x0, y1), Vec2d(x1, y1)}) {
+        res.uniteWith(viewInverse.transformPointAffine(p));
+    }
+    return res;
+}
+
 } // namespace vgc::geometry
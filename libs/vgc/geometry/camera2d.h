@@ -19,6 +19,7 @@
 
 #include <vgc/geometry/api.h>
 #include <vgc/geometry/mat4d.h>
+#include <vgc/geometry/rect2d.h>
 #include <vgc/geometry/vec2d.h>
 
 namespace vgc::geometry {
@@ -267,6 +268,19 @@ public:
     ///
     Mat4d projectionMatrix() const;
 
+    /// Returns the smallest axis-aligned rectangle, in world coordinates,
+    /// which contains the area visible through the viewport. If the camera is
+    /// rotated, this rectangle is larger than the visible area.
+    ///
+    /// The optional `margin`, in viewport pixels, enlarges the viewport on
+    /// all sides before computing the visible rectangle. This is useful for
+    /// objects drawn with a fixed size on screen, such as control points.
+    ///
+    /// This is typically used to skip drawing objects whose bounding
+    /// rectangle does not intersect the visible rectangle.
+    ///
+    Rect2d visibleRect(double margin = 0) const;
+
 private:
     Vec2d center_;
     double zoom_;
@@ -16,9 +16,14 @@
 
 #include <vgc/geometry/curve.h>
 
+#include <algorithm> // lower_bound, max, min
+#include <cmath>
+
 #include <vgc/core/algorithm.h>
 #include <vgc/core/array.h>
 #include <vgc/core/colors.h>
+#include <vgc/core/exceptions.h>
+#include <vgc/core/format.h>
 #include <vgc/geometry/bezier.h>
 #include <vgc/geometry/catmullrom.h>
 
@@ -64,6 +69,200 @@ void computeSample(
     rightPosition = position - halfwidth * normal;
 }
 
+// Same as computeSample(), but using the current samples of the given
+// uniform samplers of positions and widths.
+//
+void computeSample(
+    const UniformBezierSampler<3, Vec2d>& positionSampler,
+    const UniformBezierSampler<3, double>& widthSampler,
+    Vec2d& leftPosition,
+    Vec2d& rightPosition,
+    Vec2d& normal) {
+
+    const Vec2d& position = positionSampler.position();
+    normal = positionSampler.derivative().normalized().orthogonalized();
+    double halfwidth = 0.5 * widthSampler.position();
+    leftPosition = position + halfwidth * normal;
+    rightPosition = position - halfwidth * normal;
+}
+
+void computeSegmentPositionBezier(
+    const core::DoubleArray& positionData,
+    Int idx,
+    Vec2d& q0,
+    Vec2d& q1,
+    Vec2d& q2,
+    Vec2d& q3) {
+
+    // Get indices of Catmull-Rom control points for current segment
+    Int numControlPoints = positionData.length() / 2;
+    Int zero = 0;
+    Int i0 = core::clamp(idx - 1, zero, numControlPoints - 1);
+    Int i1 = core::clamp(idx + 0, zero, numControlPoints - 1);
+    Int i2 = core::clamp(idx + 1, zero, numControlPoints - 1);
+    Int i3 = core::clamp(idx + 2, zero, numControlPoints - 1);
+
+    // Get positions of Catmull-Rom control points
+    Vec2d p0(positionData[2 * i0], positionData[2 * i0 + 1]);
+    Vec2d p1(positionData[2 * i1], positionData[2 * i1 + 1]);
+    Vec2d p2(positionData[2 * i2], positionData[2 * i2 + 1]);
+    Vec2d p3(positionData[2 * i3], positionData[2 * i3 + 1]);
+
+    // Convert positions from Catmull-Rom to Bézier
+    uniformCatmullRomToBezier(p0, p1, p2, p3, q0, q1, q2, q3);
+}
+
+void computeSegmentBezier(
+    const core::DoubleArray& positionData,
+    const core::DoubleArray& widthData,
+    Curve::AttributeVariability widthVariability,
+    Int idx,
+    Vec2d& q0,
+    Vec2d& q1,
+    Vec2d& q2,
+    Vec2d& q3,
+    double& w0,
+    double& w1,
+    double& w2,
+    double& w3) {
+
+    // Get Bézier control points of positions
+    computeSegmentPositionBezier(positionData, idx, q0, q1, q2, q3);
+
+    // Get indices of Catmull-Rom control points for current segment
+    Int numControlPoints = positionData.length() / 2;
+    Int zero = 0;
+    Int i0 = core::clamp(idx - 1, zero, numControlPoints - 1);
+    Int i1 = core::clamp(idx + 0, zero, numControlPoints - 1);
+    Int i2 = core::clamp(idx + 1, zero, numControlPoints - 1);
+    Int i3 = core::clamp(idx + 2, zero, numControlPoints - 1);
+
+    // Convert widths from Constant or Catmull-Rom to Bézier. Note: we
+    // could handle the 'Constant' case more efficiently, but we chose code
+    // simplicity over performance here, over the assumption that it's unlikely
+    // that width computation is a performance bottleneck.
+    if (widthVariability == Curve::AttributeVariability::PerControlPoint) {
+        double v0 = widthData[i0];
+        double v1 = widthData[i1];
+        double v2 = widthData[i2];
+        double v3 = widthData[i3];
+        uniformCatmullRomToBezier(v0, v1, v2, v3, w0, w1, w2, w3);
+    }
+    else // if (widthVariability == AttributeVariability::Constant)
+    {
+        w0 = widthData[0];
+        w1 = w0;
+        w2 = w0;
+        w3 = w0;
+    }
+}
+
+// Number of arc-length samples per segment. See Curve::arcLengths_.
+//
+constexpr Int numArcLengthSamples = 8;
+
+// Returns the length of the cubic Bézier curve (q0, q1, q2, q3) between the
+// parameters u1 and u2, using a 5-point Gauss-Legendre quadrature.
+//
+double bezierLength(
+    const Vec2d& q0,
+    const Vec2d& q1,
+    const Vec2d& q2,
+    const Vec2d& q3,
+    double u1,
+    double u2) {
+
+    static constexpr double x[5] = {
+        -0.9061798459386640,
+        -0.5384693101056831,
+        0.0,
+        0.5384693101056831,
+        0.9061798459386640};
+    static constexpr double w[5] = {
+        0.2369268850561891,
+        0.4786286704993665,
+        0.5688888888888889,
+        0.4786286704993665,
+        0.2369268850561891};
+
+    double halfRange = 0.5 * (u2 - u1);
+    double mid = 0.5 * (u1 + u2);
+    double res = 0;
+    for (Int k = 0; k < 5; ++k) {
+        res += w[k] * cubicBezierDer(q0, q1, q2, q3, mid + halfRange * x[k]).length();
+    }
+    return halfRange * res;
+}
+
+// Returns the second derivative of the cubic Bézier curve (q0, q1, q2, q3) at
+// the parameter u.
+//
+Vec2d bezierSecondDer(
+    const Vec2d& q0,
+    const Vec2d& q1,
+    const Vec2d& q2,
+    const Vec2d& q3,
+    double u) {
+
+    return 6 * (1 - u) * (q2 - 2 * q1 + q0) + 6 * u * (q3 - 2 * q2 + q1);
+}
+
+// Returns the parameter u in [0, 1] of the point of the cubic Bézier curve
+// (q0, q1, q2, q3) closest to p, and sets distance to the distance between
+// this point and p.
+//
+// We first find the closest sample among uniform samples, then refine it
+// via Newton iterations on f(u) = (B(u) - p) . B'(u), which is zero at
+// local extrema of the distance.
+//
+double bezierClosestParameter(
+    const Vec2d& q0,
+    const Vec2d& q1,
+    const Vec2d& q2,
+    const Vec2d& q3,
+    const Vec2d& p,
+    double& distance) {
+
+    constexpr Int numSamples = 2 * numArcLengthSamples;
+    constexpr Int numNewtonIterations = 5;
+
+    double bestU = 0;
+    double bestSquaredDistance = core::infinity<double>;
+    UniformBezierSampler<3, Vec2d> sampler(q0, q1, q2, q3, numSamples);
+    while (true) {
+        double d2 = (sampler.position() - p).squaredLength();
+        if (d2 < bestSquaredDistance) {
+            bestSquaredDistance = d2;
+            bestU = sampler.u();
+        }
+        if (sampler.isLast()) {
+            break;
+        }
+        sampler.advance();
+    }
+
+    double u = bestU;
+    for (Int k = 0; k < numNewtonIterations; ++k) {
+        Vec2d pos = cubicBezier(q0, q1, q2, q3, u);
+        Vec2d der = cubicBezierDer(q0, q1, q2, q3, u);
+        Vec2d der2 = bezierSecondDer(q0, q1, q2, q3, u);
+        double f = (pos - p).dot(der);
+        double df = der.dot(der) + (pos - p).dot(der2);
+        if (df <= 0) {
+            break;
+        }
+        u = core::clamp(u - f / df, 0.0, 1.0);
+        double d2 = (cubicBezier(q0, q1, q2, q3, u) - p).squaredLength();
+        if (d2 < bestSquaredDistance) {
+            bestSquaredDistance = d2;
+            bestU = u;
+        }
+    }
+
+    distance = std::sqrt(bestSquaredDistance);
+    return bestU;
+}
+
 } // namespace
 
 Curve::Curve(Type type)
@@ -88,6 +287,10 @@ double Curve::width() const {
 
 void Curve::addControlPoint(double x, double y) {
 
+    // Invalidate cached data. Only the last segment is affected, since its
+    // tangent at the end point depends on the next control point.
+    invalidateSegments_(numSegments() - 1, numSegments());
+
     // Set position
     positionData_.append(x);
     positionData_.append(y);
@@ -108,6 +311,10 @@ void Curve::addControlPoint(const Vec2d& position) {
 
 void Curve::addControlPoint(double x, double y, double width) {
 
+    // Invalidate cached data. Only the last segment is affected, since its
+    // tangent at the end point depends on the next control point.
+    invalidateSegments_(numSegments() - 1, numSegments());
+
     // Set position
     positionData_.append(x);
     positionData_.append(y);
@@ -122,6 +329,235 @@ void Curve::addControlPoint(const Vec2d& position, double width) {
     addControlPoint(position.x(), position.y(), width);
 }
 
+void Curve::setControlPoint(Int i, const Vec2d& position) {
+    controlPoint_(i); // throws IndexError if out of range
+
+    // Segment j depends on the control points j-1, j, j+1, and j+2
+    invalidateSegments_(i - 2, i + 2);
+
+    positionData_[2 * i] = position.x();
+    positionData_[2 * i + 1] = position.y();
+}
+
+void Curve::setControlPoint(Int i, const Vec2d& position, double width) {
+    setControlPoint(i, position);
+    if (widthVariability() == AttributeVariability::PerControlPoint) {
+        widthData_[i] = width;
+    }
+}
+
+Int Curve::numSegments() const {
+    Int numControlPoints = positionData_.length() / 2;
+    return (std::max)(numControlPoints - 1, Int(0));
+}
+
+Rect2d Curve::segmentBoundingRect(Int segmentIndex) const {
+    if (segmentIndex < 0 || segmentIndex >= numSegments()) {
+        throw core::IndexError(core::format(
+            "Segment index {} out of range [0, {}).", segmentIndex, numSegments()));
+    }
+
+    const SegmentData& b = segmentBezier_(segmentIndex);
+
+    // By the convex hull property of Bézier curves, the centerline is
+    // contained in the bounding rect of its control points, and the half-width
+    // is bounded by the maximum of the (absolute) width control points.
+    double halfwidth = 0.5
+                       * (std::max)({std::abs(b.w0),
+                                     std::abs(b.w1),
+                                     std::abs(b.w2),
+                                     std::abs(b.w3)});
+    Rect2d res = Rect2d::empty;
+    res.uniteWith(b.q0).uniteWith(b.q1).uniteWith(b.q2).uniteWith(b.q3);
+    Vec2d offset(halfwidth, halfwidth);
+    return Rect2d(res.pMin() - offset, res.pMax() + offset);
+}
+
+Rect2d Curve::boundingRect() const {
+    Rect2d res = Rect2d::empty;
+    Int n = numSegments();
+    for (Int i = 0; i < n; ++i) {
+        res.uniteWith(segmentBoundingRect(i));
+    }
+    return res;
+}
+
+double Curve::length() const {
+    updateArcLengths_();
+    return arcLengths_.isEmpty() ? 0 : arcLengths_.last();
+}
+
+Vec2d Curve::positionAtLength(double s) const {
+    updateArcLengths_();
+    if (arcLengths_.isEmpty()) {
+        return controlPoint_(0); // throws IndexError if no control points
+    }
+
+    // Find the arc-length sample interval [s1, s2] that contains s, which
+    // corresponds to the parameter interval [u1, u2] of a given segment.
+    s = core::clamp(s, 0.0, arcLengths_.last());
+    auto it = std::lower_bound(arcLengths_.begin(), arcLengths_.end(), s);
+    Int k = (std::min)(Int(it - arcLengths_.begin()), arcLengths_.length() - 1);
+    Int segmentIndex = k / numArcLengthSamples;
+    Int j = k % numArcLengthSamples;
+    double s1 = (k == 0) ? 0 : arcLengths_[k - 1];
+    double s2 = arcLengths_[k];
+    double u1 = static_cast<double>(j) / numArcLengthSamples;
+    double u2 = static_cast<double>(j + 1) / numArcLengthSamples;
+
+    const SegmentData& b = segmentBezier_(segmentIndex);
+    const Vec2d& q0 = b.q0;
+    const Vec2d& q1 = b.q1;
+    const Vec2d& q2 = b.q2;
+    const Vec2d& q3 = b.q3;
+
+    // Initial guess assuming constant speed in the interval, then refine via
+    // Newton iterations on f(u) = length(u1, u) - (s - s1), whose derivative
+    // is the speed |B'(u)|.
+    double u = u1;
+    if (s2 > s1) {
+        u = u1 + (u2 - u1) * (s - s1) / (s2 - s1);
+        constexpr Int numNewtonIterations = 3;
+        for (Int i = 0; i < numNewtonIterations; ++i) {
+            double f = bezierLength(q0, q1, q2, q3, u1, u) - (s - s1);
+            double speed = cubicBezierDer(q0, q1, q2, q3, u).length();
+            if (speed <= 0) {
+                break;
+            }
+            u = core::clamp(u - f / speed, u1, u2);
+        }
+    }
+    return cubicBezier(q0, q1, q2, q3, u);
+}
+
+Vec2d Curve::closestPoint(const Vec2d& point, double* arcLength) const {
+    updateArcLengths_();
+    if (arcLengths_.isEmpty()) {
+        if (arcLength) {
+            *arcLength = 0;
+        }
+        return controlPoint_(0); // throws IndexError if no control points
+    }
+
+    // Find closest segment. Segments whose bounding rectangle is further
+    // than the best candidate so far are not even considered.
+    Int bestSegment = -1;
+    double bestU = 0;
+    double bestDistance = core::infinity<double>;
+    auto distance = [&](Int id) {
+        Int segmentIndex = segmentsBvh_.value(id);
+        const SegmentData& b = segmentBezier_(segmentIndex);
+        double d = 0;
+        double u = bezierClosestParameter(b.q0, b.q1, b.q2, b.q3, point, d);
+        if (d < bestDistance) {
+            bestSegment = segmentIndex;
+            bestU = u;
+            bestDistance = d;
+        }
+        return d;
+    };
+    segmentsBvh_.findNearest(point, distance);
+
+    const SegmentData& b = segmentBezier_(bestSegment);
+    if (arcLength) {
+        Int j = (std::min)(
+            static_cast<Int>(bestU * numArcLengthSamples), numArcLengthSamples - 1);
+        Int k = bestSegment * numArcLengthSamples + j;
+        double s1 = (k == 0) ? 0 : arcLengths_[k - 1];
+        double u1 = static_cast<double>(j) / numArcLengthSamples;
+        *arcLength = s1 + bezierLength(b.q0, b.q1, b.q2, b.q3, u1, bestU);
+    }
+    return cubicBezier(b.q0, b.q1, b.q2, b.q3, bestU);
+}
+
+Vec2d Curve::controlPoint_(Int i) const {
+    if (i < 0 || 2 * i + 1 >= positionData_.length()) {
+        throw core::IndexError(core::format(
+            "Control point index {} out of range [0, {}).",
+            i,
+            positionData_.length() / 2));
+    }
+    return Vec2d(positionData_[2 * i], positionData_[2 * i + 1]);
+}
+
+const Curve::SegmentData& Curve::segmentBezier_(Int i) const {
+    Int n = numSegments();
+    if (segments_.length() != n) {
+        segments_.resize(n);
+    }
+    SegmentData& data = segments_[i];
+    if (!data.isBezierValid) {
+        // clang-format off
+        computeSegmentBezier(
+            positionData_, widthData_, widthVariability_, i,
+            data.q0, data.q1, data.q2, data.q3,
+            data.w0, data.w1, data.w2, data.w3);
+        // clang-format on
+        data.isBezierValid = true;
+    }
+    return data;
+}
+
+void Curve::invalidateSegments_(Int begin, Int end) {
+    begin = (std::max)(begin, Int(0));
+    end = (std::min)(end, segments_.length());
+    for (Int i = begin; i < end; ++i) {
+        SegmentData& data = segments_[i];
+        data.isBezierValid = false;
+        data.isArcLengthValid = false;
+    }
+    numValidArcLengthSegments_ = (std::min)(numValidArcLengthSegments_, begin);
+}
+
+void Curve::updateArcLengths_() const {
+    Int n = numSegments();
+    if (numValidArcLengthSegments_ == n) {
+        return;
+    }
+    Int oldLength = arcLengths_.length();
+    arcLengths_.resize(n * numArcLengthSamples);
+
+    // Difference between the new and old arc length at the end of the
+    // previous segment, which must be added to all the arc lengths of the
+    // following segments that are still valid.
+    double offset = 0;
+
+    for (Int i = numValidArcLengthSegments_; i < n; ++i) {
+        const SegmentData& b = segmentBezier_(i);
+        Int k = i * numArcLengthSamples;
+        if (b.isArcLengthValid) {
+            for (Int j = 0; j < numArcLengthSamples; ++j) {
+                arcLengths_[k + j] += offset;
+            }
+            continue;
+        }
+
+        // Arc lengths
+        Int last = k + numArcLengthSamples - 1;
+        double oldEnd = (last < oldLength) ? arcLengths_[last] : 0;
+        double s = (k == 0) ? 0 : arcLengths_[k - 1];
+        for (Int j = 0; j < numArcLengthSamples; ++j) {
+            double u1 = static_cast<double>(j) / numArcLengthSamples;
+            double u2 = static_cast<double>(j + 1) / numArcLengthSamples;
+            s += bezierLength(b.q0, b.q1, b.q2, b.q3, u1, u2);
+            arcLengths_[k + j] = s;
+        }
+        offset = s - oldEnd;
+
+        // Bounding rectangle of the centerline (convex hull property)
+        Rect2d rect = Rect2d::empty;
+        rect.uniteWith(b.q0).uniteWith(b.q1).uniteWith(b.q2).uniteWith(b.q3);
+        if (i < segmentBvhIds_.length()) {
+            segmentsBvh_.move(segmentBvhIds_[i], rect);
+        }
+        else {
+            segmentBvhIds_.append(segmentsBvh_.insert(rect, i));
+        }
+        segments_[i].isArcLengthValid = true;
+    }
+    numValidArcLengthSegments_ = n;
+}
+
 Vec2dArray Curve::triangulate(double maxAngle, Int minQuads, Int maxQuads) const {
 
     // Result of this computation.
@@ -160,42 +596,16 @@ Vec2dArray Curve::triangulate(double maxAngle, Int minQuads, Int maxQuads) const
 
     // Iterate over all segments
     for (Int idx = 0; idx < numSegments; ++idx) {
-        // Get indices of Catmull-Rom control points for current segment
-        Int zero = 0;
-        Int i0 = core::clamp(idx - 1, zero, numControlPoints - 1);
-        Int i1 = core::clamp(idx + 0, zero, numControlPoints - 1);
-        Int i2 = core::clamp(idx + 1, zero, numControlPoints - 1);
-        Int i3 = core::clamp(idx + 2, zero, numControlPoints - 1);
-
-        // Get positions of Catmull-Rom control points
-        Vec2d p0(positionData_[2 * i0], positionData_[2 * i0 + 1]);
-        Vec2d p1(positionData_[2 * i1], positionData_[2 * i1 + 1]);
-        Vec2d p2(positionData_[2 * i2], positionData_[2 * i2 + 1]);
-        Vec2d p3(positionData_[2 * i3], positionData_[2 * i3 + 1]);
-
-        // Convert positions from Catmull-Rom to Bézier
-        Vec2d q0, q1, q2, q3;
-        uniformCatmullRomToBezier(p0, p1, p2, p3, q0, q1, q2, q3);
-
-        // Convert widths from Constant or Catmull-Rom to Bézier. Note: we
-        // could handle the 'Constant' case more efficiently, but we chose code
-        // simplicity over performance here, over the assumption that it's unlikely
-        // that width computation is a performance bottleneck.
-        double w0, w1, w2, w3;
-        if (widthVariability() == AttributeVariability::PerControlPoint) {
-            double v0 = widthData()[i0];
-            double v1 = widthData()[i1];
-            double v2 = widthData()[i2];
-            double v3 = widthData()[i3];
-            uniformCatmullRomToBezier(v0, v1, v2, v3, w0, w1, w2, w3);
-        }
-        else // if (widthVariability() == AttributeVariability::Constant)
-        {
-            w0 = widthData()[0];
-            w1 = w0;
-            w2 = w0;
-            w3 = w0;
-        }
+        // Get Bézier control points of positions and widths
+        const SegmentData& b = segmentBezier_(idx);
+        const Vec2d& q0 = b.q0;
+        const Vec2d& q1 = b.q1;
+        const Vec2d& q2 = b.q2;
+        const Vec2d& q3 = b.q3;
+        double w0 = b.w0;
+        double w1 = b.w1;
+        double w2 = b.w2;
+        double w3 = b.w3;
 
         // Compute first sample of segment
         if (idx == 0) {
@@ -228,25 +638,24 @@ Vec2dArray Curve::triangulate(double maxAngle, Int minQuads, Int maxQuads) const
         uParams.clear();
         uParams.append(0);
 
-        // Compute uniform samples for this segment
+        // Compute uniform samples for this segment, via forward differencing
         Int numQuads = 0;
-        double du = 1.0 / static_cast<double>(minQuads);
+        UniformBezierSampler<3, Vec2d> positionSampler(q0, q1, q2, q3, minQuads);
+        UniformBezierSampler<3, double> widthSampler(w0, w1, w2, w3, minQuads);
         for (Int j = 1; j <= minQuads; ++j) {
-            double u = j * du;
+            positionSampler.advance();
+            widthSampler.advance();
             appendUninitializedElement(leftPositions);
             appendUninitializedElement(rightPositions);
             appendUninitializedElement(normals);
-            // clang-format off
             computeSample(
-                q0, q1, q2, q3,
-                w0, w1, w2, w3,
-                u,
+                positionSampler,
+                widthSampler,
                 leftPositions.last(),
                 rightPositions.last(),
                 normals.last());
-            // clang-format on
 
-            uParams.append(u);
+            uParams.append(positionSampler.u());
             ++numQuads;
         }
 
@@ -21,6 +21,8 @@
 #include <vgc/core/color.h>
 #include <vgc/core/object.h>
 #include <vgc/geometry/api.h>
+#include <vgc/geometry/bvh2d.h>
+#include <vgc/geometry/rect2d.h>
 #include <vgc/geometry/vec2d.h>
 
 namespace vgc::geometry {
@@ -164,6 +166,86 @@ public:
     ///
     void addControlPoint(const Vec2d& position, double width);
 
+    /// Returns the number of control points of this curve.
+    ///
+    Int numControlPoints() const {
+        return positionData_.length() / 2;
+    }
+
+    /// Sets the position of the control point of index \p i.
+    ///
+    /// Only the cached data of the segments which depend on this control
+    /// point, that is, at most four segments, are invalidated.
+    ///
+    /// Throws `IndexError` if \p i is not in the range [0,
+    /// numControlPoints()).
+    ///
+    void setControlPoint(Int i, const Vec2d& position);
+
+    /// Sets the position and width of the control point of index \p i.
+    ///
+    /// If widthVariability() == Constant, then the provided \p width is ignored.
+    ///
+    /// Throws `IndexError` if \p i is not in the range [0,
+    /// numControlPoints()).
+    ///
+    void setControlPoint(Int i, const Vec2d& position, double width);
+
+    /// Returns the number of segments of this curve, that is, the number of
+    /// control points minus one, or zero if there is no control point.
+    ///
+    Int numSegments() const;
+
+    /// Returns a conservative bounding rectangle of the segment of index \p
+    /// segmentIndex, taking into account the width of the curve. The returned
+    /// rectangle is guaranteed to contain the triangulation of the segment,
+    /// but may be slightly larger.
+    ///
+    /// Throws `IndexError` if \p segmentIndex is not in the range [0,
+    /// numSegments()).
+    ///
+    Rect2d segmentBoundingRect(Int segmentIndex) const;
+
+    /// Returns a conservative bounding rectangle of this curve, taking into
+    /// account its width. This is the union of all segmentBoundingRect(), or
+    /// `Rect2d::empty` if the curve has no segment.
+    ///
+    Rect2d boundingRect() const;
+
+    /// Returns the length of the centerline of this curve.
+    ///
+    /// The first call to this function, or to any other function based on
+    /// arc length, computes and caches an arc-length table which is then
+    /// reused by subsequent calls. Adding control points only recomputes the
+    /// last segments of the table.
+    ///
+    double length() const;
+
+    /// Returns the position of the centerline at the given arc length `s`,
+    /// that is, the point at distance `s` from the start of the curve when
+    /// travelling along the centerline. The value `s` is clamped to [0,
+    /// length()].
+    ///
+    /// This is computed in O(log n) via binary search in the arc-length table,
+    /// followed by a few Newton iterations.
+    ///
+    /// Throws `IndexError` if the curve has no control points.
+    ///
+    Vec2d positionAtLength(double s) const;
+
+    /// Returns the point of the centerline closest to the given `point`. If
+    /// `arcLength` is not null, then it is set to the arc length of the
+    /// returned position.
+    ///
+    /// Segments are visited in order of increasing distance to their bounding
+    /// rectangle, and segments whose bounding rectangle is further than the
+    /// closest point found so far are skipped. Therefore, the cost of this
+    /// function is typically O(log n).
+    ///
+    /// Throws `IndexError` if the curve has no control points.
+    ///
+    Vec2d closestPoint(const Vec2d& point, double* arcLength = nullptr) const;
+
     /// Computes and returns a triangulation of this curve as a triangle strip
     /// [ p0, p1, ..., p_{2n}, p_{2n+1} ]. The even indices are on the "left"
     /// of the centerline, while the odd indices are on the "right", assuming a
@@ -250,6 +332,44 @@ private:
 
     // Color of the curve
     core::Color color_;
+
+    // Cached data of each segment, lazily computed and shared by
+    // triangulation, hit-testing, and length queries. Each segment is
+    // invalidated individually when one of the control points it depends on
+    // is modified, see invalidateSegments_().
+    //
+    struct SegmentData {
+        // Bézier control points of the centerline and of the width, converted
+        // from the Catmull-Rom control points.
+        Vec2d q0, q1, q2, q3;
+        double w0, w1, w2, w3;
+        bool isBezierValid = false;
+
+        // Whether the arc lengths of this segment in arcLengths_, up to a
+        // constant offset, and its rectangle in segmentsBvh_ are up-to-date.
+        bool isArcLengthValid = false;
+    };
+    mutable core::Array<SegmentData> segments_;
+
+    // Arc-length table, lazily computed. arcLengths_[i * k + j] is the
+    // length of the centerline from its start to the parameter (j + 1) / k
+    // of segment i, where k is the number of samples per segment. Only the
+    // first numValidArcLengthSegments_ segments are up-to-date. The arc
+    // lengths of the other segments are either recomputed, or only offset if
+    // isArcLengthValid is true.
+    //
+    // We also store the bounding rectangles of the segment centerlines in a
+    // Bvh2d, used to accelerate closestPoint().
+    //
+    mutable core::DoubleArray arcLengths_;
+    mutable Int numValidArcLengthSegments_ = 0;
+    mutable Bvh2d segmentsBvh_;
+    mutable core::IntArray segmentBvhIds_;
+
+    Vec2d controlPoint_(Int i) const;
+    const SegmentData& segmentBezier_(Int i) const;
+    void invalidateSegments_(Int begin, Int end);
+    void updateArcLengths_() const;
 };
 
 } // namespace vgc::geometry
@@ -16,10 +16,27 @@
 
 #include <vgc/geometry/curves2d.h>
 
+#include <algorithm>
+#include <array>
+
+#include <vgc/geometry/bezier.h>
+#include <vgc/geometry/points.h>
+
 #include <tesselator.h> // libtess2
 
 namespace vgc::geometry {
 
+void Curves2d::transformAffine(const Mat3d& m) {
+    // Note: all command parameters are 2D points
+    Vec2d* points = reinterpret_cast<Vec2d*>(data_.data());
+    transformPointsAffine(m, points, points, data_.length() / 2);
+}
+
+Rect2d Curves2d::controlPointsBoundingRect() const {
+    const Vec2d* points = reinterpret_cast<const Vec2d*>(data_.data());
+    return boundingRect(points, data_.length() / 2);
+}
+
 void Curves2d::close() {
     commandData_.append({CurveCommandType::Close, data_.length()});
 }
@@ -111,11 +128,34 @@ struct QuadraticSegment {
         return p2 - p1;
     }
 
+    UniformBezierSampler<2, Vec2d> uniformSampler(Int numSteps) const {
+        return UniformBezierSampler<2, Vec2d>(p0, p1, p2, numSteps);
+    }
+
     Vec2d operator()(double u) const {
         return (1 - u) * (1 - u) * p0 //
                + 2 * u * (1 - u) * p1 //
                + u * u * p2;
     }
+
+    // Returns an upper bound of the squared distance between B(u) and the
+    // point at u of the chord, that is, (1 - u) * p0 + u * p2. We have:
+    //   B(u) - chord(u) = u(1-u)(2p1 - p0 - p2)
+    // and u(1-u) <= 1/4.
+    //
+    double maxDeviationSquared() const {
+        return (2 * p1 - p0 - p2).squaredLength() / 16;
+    }
+
+    // Splits at u = 0.5 using De Casteljau's algorithm.
+    //
+    void split(QuadraticSegment& left, QuadraticSegment& right) const {
+        Vec2d q0 = 0.5 * (p0 + p1);
+        Vec2d q1 = 0.5 * (p1 + p2);
+        Vec2d r = 0.5 * (q0 + q1);
+        left = {p0, q0, r};
+        right = {r, q1, p2};
+    }
 };
 
 struct CubicSegment {
@@ -132,14 +172,89 @@ struct CubicSegment {
     Vec2d endTangent() const {
         return p3 - p2;
     }
+    UniformBezierSampler<3, Vec2d> uniformSampler(Int numSteps) const {
+        return UniformBezierSampler<3, Vec2d>(p0, p1, p2, p3, numSteps);
+    }
     Vec2d operator()(double u) const {
         return (1 - u) * (1 - u) * (1 - u) * p0 //
                + 3 * u * (1 - u) * (1 - u) * p1 //
                + 3 * u * u * (1 - u) * p2       //
                + u * u * u * p3;
     }
+    // Returns an upper bound of the squared distance between B(u) and the
+    // point at u of the chord, that is, (1 - u) * p0 + u * p3. We have:
+    //   B(u) - chord(u) = u(1-u)((1-u)(3p1 - 2p0 - p3) + u(3p2 - p0 - 2p3))
+    // and u(1-u) <= 1/4.
+    //
+    double maxDeviationSquared() const {
+        double a = (3 * p1 - 2 * p0 - p3).squaredLength();
+        double b = (3 * p2 - p0 - 2 * p3).squaredLength();
+        return (std::max)(a, b) / 16;
+    }
+    // Splits at u = 0.5 using De Casteljau's algorithm.
+    //
+    void split(CubicSegment& left, CubicSegment& right) const {
+        Vec2d q0 = 0.5 * (p0 + p1);
+        Vec2d q1 = 0.5 * (p1 + p2);
+        Vec2d q2 = 0.5 * (p2 + p3);
+        Vec2d r0 = 0.5 * (q0 + q1);
+        Vec2d r1 = 0.5 * (q1 + q2);
+        Vec2d s = 0.5 * (r0 + r1);
+        left = {p0, q0, r0, s};
+        right = {s, r1, q2, p3};
+    }
 };
 
+// Maximum number of times a segment can be split in halves when using
+// error-bounded sampling. This bounds the size of the stack, which is
+// allocated on the call stack rather than on the heap.
+//
+constexpr Int maxErrorBoundedDepth = 24;
+
+// Recursively splits the segment until each half is within maxError() of
+// its chord, using an explicit stack. The halves are processed left first,
+// so that their end positions are appended in order.
+//
+template<class SegmentType>
+void sampleSegmentErrorBounded(
+    Curves2d& res,
+    const Curves2dSampleParams& params,
+    const SegmentType& segment) {
+
+    double maxErrorSquared = params.maxError() * params.maxError();
+    Int maxSamplesPerSegment = params.maxSamplesPerSegment();
+    Int maxDepth = 0;
+    while (maxDepth < maxErrorBoundedDepth
+           && (Int(2) << maxDepth) <= maxSamplesPerSegment) {
+        ++maxDepth;
+    }
+
+    // Each iteration pops one item and pushes at most two items one level
+    // deeper, so the stack never has more than maxDepth + 1 items.
+    struct StackItem {
+        SegmentType segment;
+        Int depth;
+    };
+    std::array<StackItem, maxErrorBoundedDepth + 1> stack;
+    Int stackSize = 0;
+    stack[stackSize++] = {segment, 0};
+    while (stackSize > 0) {
+        StackItem item = stack[--stackSize];
+        if (item.depth == maxDepth
+            || item.segment.maxDeviationSquared() <= maxErrorSquared) {
+            res.lineTo(item.segment.endPosition());
+        }
+        else {
+            Int depth = item.depth + 1;
+            StackItem& right = stack[stackSize++];
+            StackItem& left = stack[stackSize++];
+            item.segment.split(left.segment, right.segment);
+            left.depth = depth;
+            right.depth = depth;
+        }
+    }
+}
+
 template<class SegmentType>
 void sampleSegment(
     Curves2d& res,
@@ -151,6 +266,22 @@ void sampleSegment(
     double maxAngle = params.maxAngle();
     Int maxSamplesPerSegment = params.maxSamplesPerSegment();
 
+    // Uniform sampling
+    if (params.isUniform()) {
+        auto sampler = segment.uniformSampler((std::max)(Int(1), maxSamplesPerSegment));
+        while (!sampler.isLast()) {
+            sampler.advance();
+            res.lineTo(sampler.position());
+        }
+        return;
+    }
+
+    // Error-bounded sampling
+    if (params.isErrorBounded()) {
+        sampleSegmentErrorBounded(res, params, segment);
+        return;
+    }
+
     core::Array<Sample>& samples = buffer.samples;
     core::IntArray& failed = buffer.failed;
     core::IntArray& added = buffer.added;
@@ -312,6 +443,112 @@ void editQuadData(core::DoubleArray& data, Int i, const Vec2d& a, const Vec2d& b
     data[i + 9] = b[1];
 }
 
+// Stroke output as a triangle soup, where each quad between two consecutive
+// samples is emitted as two triangles with duplicated vertices.
+//
+class TriangleSoupStrokeMesh {
+public:
+    TriangleSoupStrokeMesh(core::DoubleArray& data)
+        : data_(data) {
+    }
+
+    void beginSubpath() {
+        firstVertexIndex_ = data_.length();
+        hasPrevious_ = false;
+    }
+
+    void addSample(const Vec2d& l, const Vec2d& r) {
+        if (hasPrevious_) {
+            insertQuad(data_, l0_, r0_, l, r);
+        }
+        l0_ = l;
+        r0_ = r;
+        hasPrevious_ = true;
+    }
+
+    void closeSubpath(const Vec2d& l, const Vec2d& r) {
+        insertQuad(data_, l0_, r0_, l, r);
+        editQuadData(data_, firstVertexIndex_, l, r);
+        hasPrevious_ = false;
+    }
+
+private:
+    core::DoubleArray& data_;
+    Int firstVertexIndex_ = 0;
+    Vec2d l0_, r0_;
+    bool hasPrevious_ = false;
+};
+
+// Stroke output as an indexed triangle mesh, where each sample contributes
+// exactly two vertices (left and right), and each quad between two
+// consecutive samples is emitted as six indices.
+//
+// Indices are offset by the number of vertices already in the given vertex
+// array, so that calling stroke() several times with the same output arrays
+// stitches all curves into a single triangle list.
+//
+template<typename TFloat, typename TIndex>
+class IndexedStrokeMesh {
+public:
+    IndexedStrokeMesh(core::Array<TFloat>& vertices, core::Array<TIndex>& indices)
+        : vertices_(vertices)
+        , indices_(indices) {
+    }
+
+    void beginSubpath() {
+        firstVertexIndex_ = vertices_.length() / 2;
+        hasPrevious_ = false;
+    }
+
+    void addSample(const Vec2d& l, const Vec2d& r) {
+        Int i = vertices_.length() / 2;
+        appendVertex_(l);
+        appendVertex_(r);
+        if (hasPrevious_) {
+            appendQuad_(i - 2, i);
+        }
+        hasPrevious_ = true;
+    }
+
+    // Instead of adding a new pair of vertices, we re-use the first pair of
+    // the subpath, which is moved to the mitered position.
+    //
+    void closeSubpath(const Vec2d& l, const Vec2d& r) {
+        Int i = vertices_.length() / 2;
+        setVertex_(firstVertexIndex_, l);
+        setVertex_(firstVertexIndex_ + 1, r);
+        appendQuad_(i - 2, firstVertexIndex_);
+        hasPrevious_ = false;
+    }
+
+private:
+    core::Array<TFloat>& vertices_;
+    core::Array<TIndex>& indices_;
+    Int firstVertexIndex_ = 0;
+    bool hasPrevious_ = false;
+
+    void appendVertex_(const Vec2d& p) {
+        vertices_.append(static_cast<TFloat>(p[0]));
+        vertices_.append(static_cast<TFloat>(p[1]));
+    }
+
+    void setVertex_(Int i, const Vec2d& p) {
+        vertices_[2 * i] = static_cast<TFloat>(p[0]);
+        vertices_[2 * i + 1] = static_cast<TFloat>(p[1]);
+    }
+
+    // Appends the two triangles ABC and CBD, where (a, b) is the pair of
+    // vertices starting at index i0, and (c, d) the pair starting at i1.
+    //
+    void appendQuad_(Int i0, Int i1) {
+        TIndex a = core::int_cast<TIndex>(i0);
+        TIndex b = core::int_cast<TIndex>(i0 + 1);
+        TIndex c = core::int_cast<TIndex>(i1);
+        TIndex d = core::int_cast<TIndex>(i1 + 1);
+        indices_.extend({a, b, c, c, b, d});
+    }
+};
+
 // Each of the "process" methods computes n1, l1, and r1 based
 // on c0, c1, c2, and n0:
 //
@@ -329,7 +566,6 @@ void editQuadData(core::DoubleArray& data, Int i, const Vec2d& a, const Vec2d& b
 // For the last sample, we don't have c2.
 //
 void processFirstSample(
-    core::DoubleArray& /*data*/,
     double width,
     const Vec2d& c1,
     const Vec2d& c2,
@@ -343,14 +579,11 @@ void processFirstSample(
 }
 
 void processMiddleSample(
-    core::DoubleArray& data,
     double width,
     const Vec2d& /*c0*/,
     const Vec2d& c1,
     const Vec2d& c2,
-    const Vec2d& l0,
     Vec2d& l1,
-    const Vec2d& r0,
     Vec2d& r1,
     const Vec2d& n0,
     Vec2d& n1) {
@@ -372,49 +605,34 @@ void processMiddleSample(
     Vec2d miterDir = (n0 + n1).normalized();
     l1 = c1 + 0.5 * miterLength * miterDir;
     r1 = c1 - 0.5 * miterLength * miterDir;
-
-    // Insert
-    insertQuad(data, l0, r0, l1, r1);
 }
 
 void processLastOpenSample(
-    core::DoubleArray& data,
     double width,
     const Vec2d& c0,
     const Vec2d& c1,
-    const Vec2d& l0,
     Vec2d& l1,
-    const Vec2d& r0,
     Vec2d& r1,
     const Vec2d& /*n0*/,
     Vec2d& n1) {
+
     n1 = (c1 - c0).normalize().orthogonalized();
     l1 = c1 + 0.5 * width * n1;
     r1 = c1 - 0.5 * width * n1;
-    insertQuad(data, l0, r0, l1, r1);
 }
 
-} // namespace
-
-void Curves2d::stroke(
-    core::DoubleArray& data,
-    double width,
-    const Curves2dSampleParams& params) const {
-
-    // Compute adaptive sampling
-    Curves2d samples = sample(params);
-
-    // Stroke samples
+template<typename StrokeMesh>
+void stroke_(StrokeMesh& mesh, const Curves2d& samples, double width) {
     Int numSamples = 0;
-    Int firstVertexIndex = data.length();
     Vec2d firstPoint, secondPoint;
-    Vec2d c0, c1, c2, l0, l1, r0, r1, n0, n1;
+    Vec2d c0, c1, c2, l1, r1, n0, n1;
     for (Curves2dCommandRef c : samples.commands()) {
         if (c.type() == CurveCommandType::MoveTo) {
             if (numSamples > 1) {
-                processLastOpenSample(data, width, c0, c1, l0, l1, r0, r1, n0, n1);
+                processLastOpenSample(width, c0, c1, l1, r1, n0, n1);
+                mesh.addSample(l1, r1);
             }
-            firstVertexIndex = data.length();
+            mesh.beginSubpath();
             firstPoint = c.p();
             c1 = firstPoint;
             numSamples = 1;
@@ -423,125 +641,330 @@ void Curves2d::stroke(
             c2 = c.p();
             if (numSamples == 1) {
                 secondPoint = c2;
-                processFirstSample(data, width, c1, c2, l1, r1, n1);
+                processFirstSample(width, c1, c2, l1, r1, n1);
             }
             else {
-                processMiddleSample(data, width, c0, c1, c2, l0, l1, r0, r1, n0, n1);
+                processMiddleSample(width, c0, c1, c2, l1, r1, n0, n1);
             }
+            mesh.addSample(l1, r1);
             c0 = c1;
             c1 = c2;
-            l0 = l1;
-            r0 = r1;
             n0 = n1;
             numSamples += 1;
         }
         else if (c.type() == CurveCommandType::Close) {
             if (numSamples > 2) {
                 c2 = secondPoint;
-                processMiddleSample(data, width, c0, c1, c2, l0, l1, r0, r1, n0, n1);
-                editQuadData(data, firstVertexIndex, l1, r1);
+                processMiddleSample(width, c0, c1, c2, l1, r1, n0, n1);
+                mesh.closeSubpath(l1, r1);
                 numSamples = 0;
             }
         }
     }
     if (numSamples > 1) {
-        processLastOpenSample(data, width, c0, c1, l0, l1, r0, r1, n0, n1);
+        processLastOpenSample(width, c0, c1, l1, r1, n0, n1);
+        mesh.addSample(l1, r1);
     }
 }
 
+template<typename TFloat, typename TIndex>
+void strokeIndexed_(
+    core::Array<TFloat>& vertices,
+    core::Array<TIndex>& indices,
+    const Curves2d& samples,
+    double width) {
+
+    // If an index overflows TIndex, we restore the output arrays to their
+    // previous size before propagating the error, so that the caller never
+    // sees a partially stroked curve.
+    //
+    Int oldNumVertices = vertices.length();
+    Int oldNumIndices = indices.length();
+    IndexedStrokeMesh<TFloat, TIndex> mesh(vertices, indices);
+    try {
+        stroke_(mesh, samples, width);
+    }
+    catch (const core::IntegerOverflowError&) {
+        vertices.resize(oldNumVertices);
+        indices.resize(oldNumIndices);
+        throw;
+    }
+}
+
+} // namespace
+
+void Curves2d::stroke(
+    core::DoubleArray& data,
+    double width,
+    const Curves2dSampleParams& params) const {
+
+    TriangleSoupStrokeMesh mesh(data);
+    stroke_(mesh, sample(params), width);
+}
+
+void Curves2d::stroke(
+    core::DoubleArray& vertices,
+    core::Array<UInt32>& indices,
+    double width,
+    const Curves2dSampleParams& params) const {
+
+    strokeIndexed_(vertices, indices, sample(params), width);
+}
+
+void Curves2d::stroke(
+    core::FloatArray& vertices,
+    core::Array<UInt32>& indices,
+    double width,
+    const Curves2dSampleParams& params) const {
+
+    strokeIndexed_(vertices, indices, sample(params), width);
+}
+
+void Curves2d::stroke(
+    core::FloatArray& vertices,
+    core::Array<UInt16>& indices,
+    double width,
+    const Curves2dSampleParams& params) const {
+
+    strokeIndexed_(vertices, indices, sample(params), width);
+}
+
 namespace {
 
-template<typename TFloat>
-void fill_(core::Array<TFloat>& data, const Curves2d& samples) {
-    // Triangulate using libtess2
-    TESSalloc* alloc = nullptr; // Default allocator
-    int vertexSize = 2;         // Number of coordinates per vertex (must be 2 or 3)
-    int windingRule = TESS_WINDING_NONZERO; // Winding rule
-    int elementType = TESS_POLYGONS;
-    // ^ Use sequence of polygons as output. Note: we could use
-    // TESS_CONNECTED_POLYGONS to detect which edges have no neighbor
-    // polygons, which can be useful for anti-aliasing.
-    int maxPolySize = 3;              // Triangles only
-    const TESSreal* normal = nullptr; // Automatically compute polygon normal
-    TESStesselator* tess = tessNewTess(alloc);
-    core::Array<TESSreal> coords;
+// Result of a triangulation: a list of vertices, and a list of triangles
+// stored as triplets of indices into the vertices.
+//
+struct Triangulation {
+    const Vec2dArray& vertices;
+    const core::IntArray& indices;
+};
+
+// Calls f(contour) for each closed subcurve of the given samples.
+//
+template<typename Function>
+void forEachClosedContour_(const Curves2d& samples, Function&& f) {
+    thread_local Vec2dArray contour;
+    contour.clear();
     for (Curves2dCommandRef c : samples.commands()) {
         if (c.type() == CurveCommandType::MoveTo) {
-            coords.clear();
-            Vec2d p = c.p();
-            coords.append(static_cast<TESSreal>(p[0]));
-            coords.append(static_cast<TESSreal>(p[1]));
-            // Note: currently, TESSreal == float.
-            // Ideally, we'd like to be able to tesslate using either floats
-            // or doubles. Once question would still be, in the case of
-            // Curves2d::fill(FloatArray& out, ...), should we first cast
-            // the contours to float then tesselate in float, or keep the
-            // contours in double then tesselate in double then cast to float?
+            contour.clear();
+            contour.append(c.p());
         }
         else if (c.type() == CurveCommandType::LineTo) {
-            Vec2d p = c.p();
-            coords.append(static_cast<TESSreal>(p[0]));
-            coords.append(static_cast<TESSreal>(p[1]));
+            contour.append(c.p());
         }
         else if (c.type() == CurveCommandType::Close) {
-            if (coords.size() > 4) { // ignore contour if 2 points or less
-                tessAddContour(
-                    tess,
-                    vertexSize,
-                    coords.data(),
-                    sizeof(TESSreal) * vertexSize,
-                    core::int_cast<int>(coords.length() / 2));
+            if (contour.length() > 2) { // ignore contour if 2 points or less
+                f(contour);
             }
         }
     }
-    int success =
-        tessTesselate(tess, windingRule, elementType, maxPolySize, vertexSize, normal);
+}
+
+// Number of coordinates per vertex (must be 2 or 3)
+constexpr int tessVertexSize = 2;
+
+// Maximum number of vertices per output polygon (triangles only)
+constexpr int tessMaxPolySize = 3;
+
+// Returns the number of vertices of the given libtess2 output polygon.
+//
+int polySize_(const TESSindex* p) {
+    int polySize = tessMaxPolySize;
+    while (polySize > 0 && p[polySize - 1] == TESS_UNDEF) {
+        --polySize;
+    }
+    return polySize;
+}
+
+// Triangulates the closed subcurves of the given samples using libtess2. The
+// result is stored in thread_local arrays, and is valid until the next call
+// in the same thread.
+//
+Triangulation triangulateLibtess2_(const Curves2d& samples, WindingRule windingRule) {
+    thread_local Vec2dArray vertices;
+    thread_local core::IntArray indices;
+    thread_local core::Array<TESSreal> coords;
+    vertices.clear();
+    indices.clear();
+
+    TESSalloc* alloc = nullptr; // Default allocator
+    TESStesselator* tess = tessNewTess(alloc);
+    if (!tess) {
+        return {vertices, indices};
+    }
+    forEachClosedContour_(samples, [&](const Vec2dArray& contour) {
+        // Note: currently, TESSreal == float, so the contours are
+        // triangulated in single precision.
+        coords.clear();
+        for (const Vec2d& p : contour) {
+            coords.append(static_cast<TESSreal>(p[0]));
+            coords.append(static_cast<TESSreal>(p[1]));
+        }
+        tessAddContour(
+            tess,
+            tessVertexSize,
+            coords.data(),
+            sizeof(TESSreal) * tessVertexSize,
+            core::int_cast<int>(contour.length()));
+    });
+
+    int tessWindingRule = (windingRule == WindingRule::EvenOdd) //
+                              ? TESS_WINDING_ODD
+                              : TESS_WINDING_NONZERO;
+    int elementType = TESS_POLYGONS;
+    const TESSreal* normal = nullptr; // Automatically compute polygon normal
+    int success = tessTesselate(
+        tess, tessWindingRule, elementType, tessMaxPolySize, tessVertexSize, normal);
     if (success) {
-        const TESSreal* vertices = tessGetVertices(tess);
+        const TESSreal* tessVertices = tessGetVertices(tess);
+        const int numVertices = tessGetVertexCount(tess);
         const TESSindex* polygons = tessGetElements(tess);
         const int numPolygons = tessGetElementCount(tess);
-        Int numOutputVertices = 0;
-        for (int i = 0; i < numPolygons; ++i) {
-            const TESSindex* p = &polygons[i * maxPolySize];
-            int polySize = maxPolySize;
-            while (p[polySize - 1] == TESS_UNDEF) {
-                --polySize;
-            }
-            numOutputVertices += 6 * (polySize - 2);
+        vertices.reserve(numVertices);
+        for (int i = 0; i < numVertices; ++i) {
+            const TESSreal* v = &tessVertices[i * tessVertexSize];
+            vertices.append(Vec2d(v[0], v[1]));
         }
-        data.reserve(data.length() + numOutputVertices);
         for (int i = 0; i < numPolygons; ++i) {
-            const TESSindex* p = &polygons[i * maxPolySize];
-            int polySize = maxPolySize;
-            while (p[polySize - 1] == TESS_UNDEF) {
-                --polySize;
-            }
+            const TESSindex* p = &polygons[i * tessMaxPolySize];
+            int polySize = polySize_(p);
             for (int j = 0; j < polySize - 2; ++j) { // triangle fan
-                const TESSreal* v1 = &vertices[p[j] * vertexSize];
-                const TESSreal* v2 = &vertices[p[j + 1] * vertexSize];
-                const TESSreal* v3 = &vertices[p[j + 2] * vertexSize];
-                data.append(static_cast<TFloat>(v1[0]));
-                data.append(static_cast<TFloat>(v1[1]));
-                data.append(static_cast<TFloat>(v2[0]));
-                data.append(static_cast<TFloat>(v2[1]));
-                data.append(static_cast<TFloat>(v3[0]));
-                data.append(static_cast<TFloat>(v3[1]));
+                indices.extend({p[0], p[j + 1], p[j + 2]});
             }
         }
     }
-    else {
-        // TODO: error reporting?
+    // TODO: error reporting if !success?
+    tessDeleteTess(tess);
+    return {vertices, indices};
+}
+
+// Triangulates the closed subcurves of the given samples using
+// PolygonTriangulator. The triangulator is shared by all calls in the same
+// thread, which avoids reallocating its scratch memory for each fill.
+//
+Triangulation
+triangulatePolygonTriangulator_(const Curves2d& samples, WindingRule windingRule) {
+    thread_local PolygonTriangulator triangulator;
+    triangulator.clear();
+    forEachClosedContour_(samples, [&](const Vec2dArray& contour) {
+        triangulator.addContour(contour);
+    });
+    triangulator.triangulate(windingRule);
+    return {triangulator.vertices(), triangulator.indices()};
+}
+
+Triangulation
+triangulate_(const Curves2d& samples, WindingRule windingRule, FillMethod method) {
+    switch (method) {
+    case FillMethod::PolygonTriangulator:
+        return triangulatePolygonTriangulator_(samples, windingRule);
+    case FillMethod::Libtess2:
+        break;
+    }
+    return triangulateLibtess2_(samples, windingRule);
+}
+
+template<typename TFloat>
+void fill_(
+    core::Array<TFloat>& data,
+    const Curves2d& samples,
+    WindingRule windingRule,
+    FillMethod method) {
+
+    Triangulation triangulation = triangulate_(samples, windingRule, method);
+    const Vec2dArray& vertices = triangulation.vertices;
+    const core::IntArray& indices = triangulation.indices;
+    data.reserve(data.length() + 2 * indices.length());
+    for (Int i : indices) {
+        const Vec2d& v = vertices[i];
+        data.append(static_cast<TFloat>(v[0]));
+        data.append(static_cast<TFloat>(v[1]));
+    }
+}
+
+// Same as fill_(), but outputs each vertex only once, and the triangles as
+// indices into these vertices. Indices are offset by the number of vertices
+// already in the given vertex array.
+//
+template<typename TFloat, typename TIndex>
+void fillIndexed_(
+    core::Array<TFloat>& vertices,
+    core::Array<TIndex>& indices,
+    const Curves2d& samples,
+    WindingRule windingRule,
+    FillMethod method) {
+
+    Triangulation triangulation = triangulate_(samples, windingRule, method);
+    const Vec2dArray& outVertices = triangulation.vertices;
+    const core::IntArray& outIndices = triangulation.indices;
+    Int numVertices = outVertices.length();
+
+    // Check that all indices will fit in TIndex before mutating the output
+    Int baseIndex = vertices.length() / 2;
+    if (numVertices > 0) {
+        core::int_cast<TIndex>(baseIndex + numVertices - 1);
+    }
+
+    vertices.reserve(vertices.length() + 2 * numVertices);
+    for (const Vec2d& v : outVertices) {
+        vertices.append(static_cast<TFloat>(v[0]));
+        vertices.append(static_cast<TFloat>(v[1]));
+    }
+    indices.reserve(indices.length() + outIndices.length());
+    for (Int i : outIndices) {
+        indices.append(static_cast<TIndex>(baseIndex + i));
     }
 }
 
 } // namespace
 
-void Curves2d::fill(core::DoubleArray& data, const Curves2dSampleParams& params) const {
-    fill_(data, sample(params));
+void Curves2d::fill(
+    core::DoubleArray& data,
+    const Curves2dSampleParams& params,
+    WindingRule windingRule,
+    FillMethod method) const {
+
+    fill_(data, sample(params), windingRule, method);
 }
 
-void Curves2d::fill(core::FloatArray& data, const Curves2dSampleParams& params) const {
-    fill_(data, sample(params));
+void Curves2d::fill(
+    core::FloatArray& data,
+    const Curves2dSampleParams& params,
+    WindingRule windingRule,
+    FillMethod method) const {
+
+    fill_(data, sample(params), windingRule, method);
+}
+
+void Curves2d::fill(
+    core::DoubleArray& vertices,
+    core::Array<UInt32>& indices,
+    const Curves2dSampleParams& params,
+    WindingRule windingRule,
+    FillMethod method) const {
+
+    fillIndexed_(vertices, indices, sample(params), windingRule, method);
+}
+
+void Curves2d::fill(
+    core::FloatArray& vertices,
+    core::Array<UInt32>& indices,
+    const Curves2dSampleParams& params,
+    WindingRule windingRule,
+    FillMethod method) const {
+
+    fillIndexed_(vertices, indices, sample(params), windingRule, method);
+}
+
+void Curves2d::fill(
+    core::FloatArray& vertices,
+    core::Array<UInt16>& indices,
+    const Curves2dSampleParams& params,
+    WindingRule windingRule,
+    FillMethod method) const {
+
+    fillIndexed_(vertices, indices, sample(params), windingRule, method);
 }
 
 } // namespace vgc::geometry
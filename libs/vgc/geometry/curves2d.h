@@ -20,6 +20,9 @@
 #include <vgc/core/array.h>
 #include <vgc/geometry/api.h>
 #include <vgc/geometry/curvecommand.h>
+#include <vgc/geometry/mat3d.h>
+#include <vgc/geometry/polygontriangulator.h>
+#include <vgc/geometry/rect2d.h>
 #include <vgc/geometry/vec2d.h>
 
 namespace vgc::geometry {
@@ -273,10 +276,16 @@ private:
 //
 class VGC_GEOMETRY_API Curves2dSampleParams {
 protected:
-    Curves2dSampleParams(double minDistance, double maxAngle, Int maxSamplesPerSegment)
+    Curves2dSampleParams(
+        double minDistance,
+        double maxAngle,
+        Int maxSamplesPerSegment,
+        bool isUniform = false)
+
         : minDistance_(minDistance)
         , maxAngle_(maxAngle)
-        , maxSamplesPerSegment_(maxSamplesPerSegment) {
+        , maxSamplesPerSegment_(maxSamplesPerSegment)
+        , isUniform_(isUniform) {
     }
 
 public:
@@ -300,6 +309,69 @@ public:
         return Curves2dSampleParams(minDistance, maxAngle, maxSamplesPerSegment);
     }
 
+    /// Creates a Curves2dSampleParams to be used for uniform sampling: each
+    /// curved segment is sampled at `numSamplesPerSegment` evenly spaced
+    /// values of its parameter, regardless of its shape. This sets
+    /// `maxSamplesPerSegment()` to `numSamplesPerSegment`.
+    ///
+    /// This is faster than adaptive sampling since the samples are computed
+    /// via forward differencing (see `UniformBezierSampler`), but typically
+    /// requires more samples for the same visual quality.
+    ///
+    static Curves2dSampleParams uniform(Int numSamplesPerSegment = 8) {
+        return Curves2dSampleParams(0.0, 0.0, numSamplesPerSegment, true);
+    }
+
+    /// Creates a Curves2dSampleParams to be used for error-bounded sampling:
+    /// each curved segment is recursively split in halves until the distance
+    /// between each half and its chord is guaranteed to be at most `maxError`.
+    /// The angle and minimum distance criteria are not used.
+    ///
+    /// Unlike adaptive sampling, the number of samples depends on the size of
+    /// the curve: long and nearly straight segments get a few more samples
+    /// than with `adaptive()`, while small and tightly curved segments get a
+    /// lot fewer, which is typically what we want for glyph outlines and
+    /// strokes.
+    ///
+    /// Since segments are split in halves, the actual number of samples per
+    /// segment is at most the largest power of two less than or equal to
+    /// `maxSamplesPerSegment`. If this limit is reached, the error bound is
+    /// not guaranteed.
+    ///
+    static Curves2dSampleParams
+    errorBounded(double maxError = 0.1, Int maxSamplesPerSegment = 64) {
+        Curves2dSampleParams res(0.0, 0.0, maxSamplesPerSegment);
+        res.maxError_ = maxError;
+        return res;
+    }
+
+    /// Returns whether uniform sampling is used, see `uniform()`.
+    ///
+    bool isUniform() const {
+        return isUniform_;
+    }
+
+    /// Returns whether error-bounded sampling is used, see `errorBounded()`.
+    ///
+    bool isErrorBounded() const {
+        return maxError_ > 0;
+    }
+
+    /// Returns the maximum distance allowed between a sampled segment and the
+    /// curve it approximates, when using error-bounded sampling. This is
+    /// `0.0` for other sampling modes.
+    ///
+    double maxError() const {
+        return maxError_;
+    }
+
+    /// Sets the maximum error. Setting it to a positive value enables
+    /// error-bounded sampling.
+    ///
+    void setMaxError(double maxError) {
+        maxError_ = maxError;
+    }
+
     /// Returns the minimum distance between two samples required for a new
     /// sample to be added.
     ///
@@ -342,6 +414,25 @@ private:
     double minDistance_;
     double maxAngle_;
     Int maxSamplesPerSegment_;
+    bool isUniform_;
+    double maxError_ = 0.0;
+};
+
+/// \enum vgc::geometry::FillMethod
+/// \brief Specifies which triangulator is used by Curves2d::fill().
+///
+enum class FillMethod {
+
+    /// Triangulates using libtess2. This is the default.
+    ///
+    Libtess2,
+
+    /// Triangulates using PolygonTriangulator, which doesn't allocate once
+    /// its scratch memory is warm. Its output is checked against libtess2 on
+    /// a corpus of glyph outlines, and it is used to fill glyphs (see
+    /// `graphics::SizedGlyph`).
+    ///
+    PolygonTriangulator
 };
 
 /// \class vgc::geometry::Curves2d
@@ -387,6 +478,19 @@ public:
         return data_;
     }
 
+    /// Transforms all the control points of this Curves2d by the given matrix
+    /// interpreted as an affine transformation. Since lines and Bézier curves
+    /// are invariant under affine transformations, this is equivalent to
+    /// transforming the curves themselves.
+    ///
+    void transformAffine(const Mat3d& m);
+
+    /// Returns the bounding rectangle of all the control points of this
+    /// Curves2d. This rectangle contains all the curves, but may be larger
+    /// than their tightest bounding rectangle.
+    ///
+    Rect2d controlPointsBoundingRect() const;
+
     /// Adds a Close command.
     ///
     void close();
@@ -475,10 +579,49 @@ public:
         double width,
         const Curves2dSampleParams& params) const;
 
+    /// Strokes this curve as an indexed triangle mesh, that is, appends
+    /// vertex data to the given \p vertices array, in the form [x1, y1, x2,
+    /// y2, ...], and appends triangles to the given \p indices array, as
+    /// triplets of indices into the vertex array.
+    ///
+    /// Unlike the triangle soup output of the other overload, each sample of
+    /// the curve contributes exactly two vertices (one on each side of the
+    /// centerline), which are shared by all adjacent triangles.
+    ///
+    /// The appended indices are offset by the number of vertices already
+    /// present in \p vertices. This means that you can call this function
+    /// with the same output arrays for several curves in order to build a
+    /// single triangle list that can be drawn with one draw call.
+    ///
+    /// An `IntegerOverflowError` is raised if an index does not fit in the
+    /// index type, which may happen when using 16-bit indices.
+    ///
+    void stroke(
+        core::DoubleArray& vertices,
+        core::Array<UInt32>& indices,
+        double width,
+        const Curves2dSampleParams& params) const;
+
+    /// \overload
+    ///
+    void stroke(
+        core::FloatArray& vertices,
+        core::Array<UInt32>& indices,
+        double width,
+        const Curves2dSampleParams& params) const;
+
+    /// \overload
+    ///
+    void stroke(
+        core::FloatArray& vertices,
+        core::Array<UInt16>& indices,
+        double width,
+        const Curves2dSampleParams& params) const;
+
     /// Fills this Curves2d, that is, triangulate the interior of the curves
-    /// interpreted as contours of a polygon, using the non-zero winding rule.
-    /// Subcurves which are not closed are ignored. The triangle data is
-    /// appended to the given DoubleArray in this form:
+    /// interpreted as contours of a polygon. Subcurves which are not closed
+    /// are ignored. The triangle data is appended to the given DoubleArray in
+    /// this form:
     ///
     /// ```
     /// [x1, y1,     // First vertex of first triangle
@@ -492,13 +635,59 @@ public:
     ///  ...]
     /// ```
     ///
-    // TODO: add winding rule, anti-aliasing options, auto-closing open subcurves, etc.
+    /// The given \p windingRule determines which regions are considered
+    /// inside when the subcurves overlap or self-intersect, and the given \p
+    /// method determines which triangulator is used.
+    ///
+    // TODO: add anti-aliasing options, auto-closing open subcurves, etc.
     //
-    void fill(core::DoubleArray& data, const Curves2dSampleParams& params) const;
+    void fill(
+        core::DoubleArray& data,
+        const Curves2dSampleParams& params,
+        WindingRule windingRule = WindingRule::NonZero,
+        FillMethod method = FillMethod::Libtess2) const;
+
+    /// \overload
+    ///
+    void fill(
+        core::FloatArray& data,
+        const Curves2dSampleParams& params,
+        WindingRule windingRule = WindingRule::NonZero,
+        FillMethod method = FillMethod::Libtess2) const;
+
+    /// Fills this Curves2d as an indexed triangle mesh, that is, appends
+    /// vertex data to the given \p vertices array, in the form [x1, y1, x2,
+    /// y2, ...], and appends triangles to the given \p indices array, as
+    /// triplets of indices into the vertex array.
+    ///
+    /// As with stroke(), the appended indices are offset by the number of
+    /// vertices already present in \p vertices, which makes it possible to
+    /// accumulate the fills of several Curves2d into a single mesh.
+    ///
+    void fill(
+        core::DoubleArray& vertices,
+        core::Array<UInt32>& indices,
+        const Curves2dSampleParams& params,
+        WindingRule windingRule = WindingRule::NonZero,
+        FillMethod method = FillMethod::Libtess2) const;
+
+    /// \overload
+    ///
+    void fill(
+        core::FloatArray& vertices,
+        core::Array<UInt32>& indices,
+        const Curves2dSampleParams& params,
+        WindingRule windingRule = WindingRule::NonZero,
+        FillMethod method = FillMethod::Libtess2) const;
 
     /// \overload
     ///
-    void fill(core::FloatArray& data, const Curves2dSampleParams& params) const;
+    void fill(
+        core::FloatArray& vertices,
+        core::Array<UInt16>& indices,
+        const Curves2dSampleParams& params,
+        WindingRule windingRule = WindingRule::NonZero,
+        FillMethod method = FillMethod::Libtess2) const;
 
 private:
     friend Curves2dCommandRef;
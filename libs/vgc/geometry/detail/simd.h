@@ -0,0 +1,492 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef VGC_GEOMETRY_DETAIL_SIMD_H
+#define VGC_GEOMETRY_DETAIL_SIMD_H
+
+/// \file vgc/geometry/detail/simd.h
+/// \brief Small SIMD helpers used to implement the 3x3 and 4x4 matrix
+///        operations of `Mat3f` and `Mat4f`.
+///
+/// The matrix classes are generated from the templates in `tools/`, which
+/// call the generic kernels defined in this file. The kernels are written
+/// in terms of `Packet4<T>`, a pack of four scalars which is implemented
+/// with SSE or NEON registers when `T` is `float` and the target supports
+/// it, and with plain scalars otherwise. Defining `VGC_GEOMETRY_NO_SIMD`
+/// forces the scalar implementation.
+///
+/// All kernels operate on column-major matrices, and perform the same
+/// operations in the same order regardless of the implementation, so that
+/// results only depend on the instruction set when the compiler chooses to
+/// contract multiplications and additions.
+///
+
+#include <cmath>
+
+#include <vgc/core/compiler.h>
+
+#if !defined(VGC_GEOMETRY_NO_SIMD)
+#    if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#        define VGC_GEOMETRY_SIMD_SSE
+#        include <xmmintrin.h>
+#    elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+#        define VGC_GEOMETRY_SIMD_NEON
+#        include <arm_neon.h>
+#    endif
+#endif
+
+namespace vgc::geometry::detail {
+
+/// \class vgc::geometry::detail::Packet4
+/// \brief A pack of four scalars of type `T`.
+///
+/// This generic implementation stores the four scalars in an array. It is
+/// specialized for `float` when SSE or NEON is available.
+///
+template<typename T>
+class Packet4 {
+public:
+    /// Creates an uninitialized `Packet4`.
+    ///
+    Packet4() {
+    }
+
+    static Packet4 load(const T* p) {
+        return Packet4(p[0], p[1], p[2], p[3]);
+    }
+
+    /// Loads the three columns of the 3x3 matrix stored at `p`. The fourth
+    /// component of each column is unspecified.
+    ///
+    static void loadMat3(const T* p, Packet4& c0, Packet4& c1, Packet4& c2) {
+        c0 = Packet4(p[0], p[1], p[2], 0);
+        c1 = Packet4(p[3], p[4], p[5], 0);
+        c2 = Packet4(p[6], p[7], p[8], 0);
+    }
+
+    static Packet4 broadcast(T x) {
+        return Packet4(x, x, x, x);
+    }
+
+    static Packet4 set(T x, T y, T z, T w) {
+        return Packet4(x, y, z, w);
+    }
+
+    void store(T* p) const {
+        p[0] = v_[0];
+        p[1] = v_[1];
+        p[2] = v_[2];
+        p[3] = v_[3];
+    }
+
+    /// Stores the first three components of the given columns as a 3x3
+    /// matrix at `p`.
+    ///
+    static void
+    storeMat3(T* p, const Packet4& c0, const Packet4& c1, const Packet4& c2) {
+        for (int i = 0; i < 3; ++i) {
+            p[i] = c0.v_[i];
+            p[i + 3] = c1.v_[i];
+            p[i + 6] = c2.v_[i];
+        }
+    }
+
+    /// Returns the `i`-th component of this packet.
+    ///
+    template<int i>
+    T get() const {
+        return v_[i];
+    }
+
+    friend Packet4 operator+(const Packet4& a, const Packet4& b) {
+        return Packet4(
+            a.v_[0] + b.v_[0], a.v_[1] + b.v_[1], a.v_[2] + b.v_[2], a.v_[3] + b.v_[3]);
+    }
+
+    friend Packet4 operator-(const Packet4& a, const Packet4& b) {
+        return Packet4(
+            a.v_[0] - b.v_[0], a.v_[1] - b.v_[1], a.v_[2] - b.v_[2], a.v_[3] - b.v_[3]);
+    }
+
+    friend Packet4 operator*(const Packet4& a, const Packet4& b) {
+        return Packet4(
+            a.v_[0] * b.v_[0], a.v_[1] * b.v_[1], a.v_[2] * b.v_[2], a.v_[3] * b.v_[3]);
+    }
+
+    /// Returns the packet `(v[i0], v[i1], v[i2], v[i3])`.
+    ///
+    template<int i0, int i1, int i2, int i3>
+    Packet4 swizzle() const {
+        return Packet4(v_[i0], v_[i1], v_[i2], v_[i3]);
+    }
+
+    /// Returns `(v[0] + v[2]) + (v[1] + v[3])`.
+    ///
+    T sum() const {
+        return (v_[0] + v_[2]) + (v_[1] + v_[3]);
+    }
+
+    /// Transposes the 4x4 matrix whose rows are the given packets.
+    ///
+    static void transpose(Packet4& r0, Packet4& r1, Packet4& r2, Packet4& r3) {
+        Packet4 c0(r0.v_[0], r1.v_[0], r2.v_[0], r3.v_[0]);
+        Packet4 c1(r0.v_[1], r1.v_[1], r2.v_[1], r3.v_[1]);
+        Packet4 c2(r0.v_[2], r1.v_[2], r2.v_[2], r3.v_[2]);
+        Packet4 c3(r0.v_[3], r1.v_[3], r2.v_[3], r3.v_[3]);
+        r0 = c0;
+        r1 = c1;
+        r2 = c2;
+        r3 = c3;
+    }
+
+private:
+    T v_[4];
+
+    Packet4(T x, T y, T z, T w)
+        : v_{x, y, z, w} {
+    }
+};
+
+#if defined(VGC_GEOMETRY_SIMD_SSE)
+
+template<>
+class Packet4<float> {
+public:
+    Packet4() {
+    }
+
+    static Packet4 load(const float* p) {
+        return Packet4(_mm_loadu_ps(p));
+    }
+
+    // Uses loads and stores which match each other, to allow store-to-load
+    // forwarding when a matrix is loaded right after being stored.
+    static void loadMat3(const float* p, Packet4& c0, Packet4& c1, Packet4& c2) {
+        __m128 v0 = _mm_loadu_ps(p);     // (p0, p1, p2, p3)
+        __m128 v1 = _mm_loadu_ps(p + 4); // (p4, p5, p6, p7)
+        __m128 v2 = _mm_load_ss(p + 8);  // (p8, 0, 0, 0)
+        __m128 t = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(0, 0, 3, 3));
+        c0.v_ = v0;
+        c1.v_ = _mm_shuffle_ps(t, v1, _MM_SHUFFLE(1, 1, 2, 0));
+        c2.v_ = _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(0, 0, 3, 2));
+    }
+
+    static Packet4 broadcast(float x) {
+        return Packet4(_mm_set1_ps(x));
+    }
+
+    static Packet4 set(float x, float y, float z, float w) {
+        return Packet4(_mm_setr_ps(x, y, z, w));
+    }
+
+    void store(float* p) const {
+        _mm_storeu_ps(p, v_);
+    }
+
+    static void
+    storeMat3(float* p, const Packet4& c0, const Packet4& c1, const Packet4& c2) {
+        __m128 t = _mm_shuffle_ps(c0.v_, c1.v_, _MM_SHUFFLE(0, 0, 2, 2));
+        _mm_storeu_ps(p, _mm_shuffle_ps(c0.v_, t, _MM_SHUFFLE(2, 0, 1, 0)));
+        _mm_storeu_ps(p + 4, _mm_shuffle_ps(c1.v_, c2.v_, _MM_SHUFFLE(1, 0, 2, 1)));
+        _mm_store_ss(p + 8, _mm_movehl_ps(c2.v_, c2.v_));
+    }
+
+    template<int i>
+    float get() const {
+        return _mm_cvtss_f32(_mm_shuffle_ps(v_, v_, _MM_SHUFFLE(i, i, i, i)));
+    }
+
+    friend Packet4 operator+(const Packet4& a, const Packet4& b) {
+        return Packet4(_mm_add_ps(a.v_, b.v_));
+    }
+
+    friend Packet4 operator-(const Packet4& a, const Packet4& b) {
+        return Packet4(_mm_sub_ps(a.v_, b.v_));
+    }
+
+    friend Packet4 operator*(const Packet4& a, const Packet4& b) {
+        return Packet4(_mm_mul_ps(a.v_, b.v_));
+    }
+
+    template<int i0, int i1, int i2, int i3>
+    Packet4 swizzle() const {
+        return Packet4(_mm_shuffle_ps(v_, v_, _MM_SHUFFLE(i3, i2, i1, i0)));
+    }
+
+    float sum() const {
+        __m128 s = _mm_add_ps(v_, _mm_movehl_ps(v_, v_)); // (v0 + v2, v1 + v3, ...)
+        return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1)));
+    }
+
+    static void transpose(Packet4& r0, Packet4& r1, Packet4& r2, Packet4& r3) {
+        _MM_TRANSPOSE4_PS(r0.v_, r1.v_, r2.v_, r3.v_);
+    }
+
+private:
+    __m128 v_;
+
+    explicit Packet4(__m128 v)
+        : v_(v) {
+    }
+};
+
+#elif defined(VGC_GEOMETRY_SIMD_NEON)
+
+template<>
+class Packet4<float> {
+public:
+    Packet4() {
+    }
+
+    static Packet4 load(const float* p) {
+        return Packet4(vld1q_f32(p));
+    }
+
+    static void loadMat3(const float* p, Packet4& c0, Packet4& c1, Packet4& c2) {
+        float32x4_t v0 = vld1q_f32(p);
+        float32x4_t v1 = vld1q_f32(p + 4);
+        c0.v_ = v0;
+        c1.v_ = vextq_f32(v0, v1, 3);
+        c2.v_ = vsetq_lane_f32(p[8], vextq_f32(v1, v1, 2), 2);
+    }
+
+    static Packet4 broadcast(float x) {
+        return Packet4(vdupq_n_f32(x));
+    }
+
+    static Packet4 set(float x, float y, float z, float w) {
+        const float p[4] = {x, y, z, w};
+        return Packet4(vld1q_f32(p));
+    }
+
+    void store(float* p) const {
+        vst1q_f32(p, v_);
+    }
+
+    static void
+    storeMat3(float* p, const Packet4& c0, const Packet4& c1, const Packet4& c2) {
+        float32x4_t c1yzwx = vextq_f32(c1.v_, c1.v_, 1);
+        vst1q_f32(p, vsetq_lane_f32(vgetq_lane_f32(c1.v_, 0), c0.v_, 3));
+        vst1q_f32(p + 4, vcombine_f32(vget_low_f32(c1yzwx), vget_low_f32(c2.v_)));
+        p[8] = vgetq_lane_f32(c2.v_, 2);
+    }
+
+    template<int i>
+    float get() const {
+        return vgetq_lane_f32(v_, i);
+    }
+
+    friend Packet4 operator+(const Packet4& a, const Packet4& b) {
+        return Packet4(vaddq_f32(a.v_, b.v_));
+    }
+
+    friend Packet4 operator-(const Packet4& a, const Packet4& b) {
+        return Packet4(vsubq_f32(a.v_, b.v_));
+    }
+
+    friend Packet4 operator*(const Packet4& a, const Packet4& b) {
+        return Packet4(vmulq_f32(a.v_, b.v_));
+    }
+
+    template<int i0, int i1, int i2, int i3>
+    Packet4 swizzle() const {
+        float32x4_t r = vdupq_n_f32(vgetq_lane_f32(v_, i0));
+        r = vsetq_lane_f32(vgetq_lane_f32(v_, i1), r, 1);
+        r = vsetq_lane_f32(vgetq_lane_f32(v_, i2), r, 2);
+        r = vsetq_lane_f32(vgetq_lane_f32(v_, i3), r, 3);
+        return Packet4(r);
+    }
+
+    float sum() const {
+        float32x2_t s = vadd_f32(vget_low_f32(v_), vget_high_f32(v_));
+        return vget_lane_f32(vpadd_f32(s, s), 0);
+    }
+
+    static void transpose(Packet4& r0, Packet4& r1, Packet4& r2, Packet4& r3) {
+        float32x4x2_t t01 = vtrnq_f32(r0.v_, r1.v_);
+        float32x4x2_t t23 = vtrnq_f32(r2.v_, r3.v_);
+        r0.v_ = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+        r1.v_ = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+        r2.v_ = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+        r3.v_ = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+    }
+
+private:
+    float32x4_t v_;
+
+    explicit Packet4(float32x4_t v)
+        : v_(v) {
+    }
+};
+
+#endif
+
+/// Returns `m * (x, y, z)` where `m` is a 3x3 matrix. The fourth component
+/// of the result is unspecified.
+///
+template<typename T>
+VGC_FORCE_INLINE Packet4<T> mat3Transform(const T* m, T x, T y, T z) {
+    using P = Packet4<T>;
+    P c0, c1, c2;
+    P::loadMat3(m, c0, c1, c2);
+    return c0 * P::broadcast(x) + c1 * P::broadcast(y) + c2 * P::broadcast(z);
+}
+
+/// Computes `res = a * b` where `a`, `b`, and `res` are 3x3 matrices. The
+/// matrix `res` must not overlap `a` or `b`.
+///
+template<typename T>
+VGC_FORCE_INLINE void mat3Multiply(const T* a, const T* b, T* res) {
+    using P = Packet4<T>;
+    P c0, c1, c2;
+    P::loadMat3(a, c0, c1, c2);
+    P r0 = c0 * P::broadcast(b[0]) + c1 * P::broadcast(b[1]) + c2 * P::broadcast(b[2]);
+    P r1 = c0 * P::broadcast(b[3]) + c1 * P::broadcast(b[4]) + c2 * P::broadcast(b[5]);
+    P r2 = c0 * P::broadcast(b[6]) + c1 * P::broadcast(b[7]) + c2 * P::broadcast(b[8]);
+    P::storeMat3(res, r0, r1, r2);
+}
+
+/// Right-multiplies in-place the 3x3 matrix `m` by the translation matrix
+/// given by `x` and `y`.
+///
+template<typename T>
+VGC_FORCE_INLINE void mat3Translate(T* m, T x, T y) {
+    using P = Packet4<T>;
+    P c0, c1, c2;
+    P::loadMat3(m, c0, c1, c2);
+    c2 = c0 * P::broadcast(x) + c1 * P::broadcast(y) + c2;
+    P::storeMat3(m, c0, c1, c2);
+}
+
+/// Returns `m * (x, y, z, w)` where `m` is a 4x4 matrix.
+///
+template<typename T>
+VGC_FORCE_INLINE Packet4<T> mat4Transform(const T* m, T x, T y, T z, T w) {
+    using P = Packet4<T>;
+    P c0 = P::load(m);
+    P c1 = P::load(m + 4);
+    P c2 = P::load(m + 8);
+    P c3 = P::load(m + 12);
+    return c0 * P::broadcast(x) + c1 * P::broadcast(y) + c2 * P::broadcast(z)
+           + c3 * P::broadcast(w);
+}
+
+/// Computes `res = a * b` where `a`, `b`, and `res` are 4x4 matrices. The
+/// matrix `res` must not overlap `a` or `b`.
+///
+template<typename T>
+VGC_FORCE_INLINE void mat4Multiply(const T* a, const T* b, T* res) {
+    using P = Packet4<T>;
+    P c0 = P::load(a);
+    P c1 = P::load(a + 4);
+    P c2 = P::load(a + 8);
+    P c3 = P::load(a + 12);
+    for (int j = 0; j < 16; j += 4) {
+        P r = c0 * P::broadcast(b[j]) + c1 * P::broadcast(b[j + 1])
+              + c2 * P::broadcast(b[j + 2]) + c3 * P::broadcast(b[j + 3]);
+        r.store(res + j);
+    }
+}
+
+/// Right-multiplies in-place the 4x4 matrix `m` by the translation matrix
+/// given by `x`, `y`, and `z`.
+///
+template<typename T>
+VGC_FORCE_INLINE void mat4Translate(T* m, T x, T y, T z) {
+    mat4Transform(m, x, y, z, static_cast<T>(1)).store(m + 12);
+}
+
+/// Computes the inverse of the 4x4 matrix `m` and stores it in `res`,
+/// unless the absolute value of the determinant of `m` is less or equal
+/// than `epsilon`, in which case `res` is left unchanged and this function
+/// returns false.
+///
+/// The inverse is computed as the adjugate matrix divided by the
+/// determinant, where the cofactors are obtained from the 2x2 minors of
+/// pairs of columns, which requires about a third of the multiplications
+/// of a direct cofactor expansion.
+///
+template<typename T>
+bool mat4Inverse(const T* m, T* res, T epsilon) {
+    using P = Packet4<T>;
+
+    // Columns of m, that is, rows of its transpose B
+    P r0 = P::load(m);
+    P r1 = P::load(m + 4);
+    P r2 = P::load(m + 8);
+    P r3 = P::load(m + 12);
+
+    // Swizzles of the rows of B used in the 2x2 minors and in the cofactor
+    // expansions, where x, y, z, w denote the four columns of B.
+    P r0yxxx = r0.template swizzle<1, 0, 0, 0>();
+    P r0zzyy = r0.template swizzle<2, 2, 1, 1>();
+    P r0wwwz = r0.template swizzle<3, 3, 3, 2>();
+    P r1yxxx = r1.template swizzle<1, 0, 0, 0>();
+    P r1zzyy = r1.template swizzle<2, 2, 1, 1>();
+    P r1wwwz = r1.template swizzle<3, 3, 3, 2>();
+    P r2yxxx = r2.template swizzle<1, 0, 0, 0>();
+    P r2zzyy = r2.template swizzle<2, 2, 1, 1>();
+    P r2wwwz = r2.template swizzle<3, 3, 3, 2>();
+    P r3yxxx = r3.template swizzle<1, 0, 0, 0>();
+    P r3zzyy = r3.template swizzle<2, 2, 1, 1>();
+    P r3wwwz = r3.template swizzle<3, 3, 3, 2>();
+
+    // 2x2 minors of rows (0, 1), where mij is the minor of columns i and j:
+    //   ma = (m23, m23, m13, m12)
+    //   mb = (m13, m03, m03, m02)
+    //   mc = (m12, m02, m01, m01)
+    P ma = r0zzyy * r1wwwz - r0wwwz * r1zzyy;
+    P mb = r0yxxx * r1wwwz - r0wwwz * r1yxxx;
+    P mc = r0yxxx * r1zzyy - r0zzyy * r1yxxx;
+
+    // Same for rows (2, 3)
+    P na = r2zzyy * r3wwwz - r2wwwz * r3zzyy;
+    P nb = r2yxxx * r3wwwz - r2wwwz * r3yxxx;
+    P nc = r2yxxx * r3zzyy - r2zzyy * r3yxxx;
+
+    // Rows of the cofactor matrix of B, up to alternating signs. Each 3x3
+    // minor is expanded along a row of B that is not part of the 2x2
+    // minors.
+    P c0 = r1yxxx * na - r1zzyy * nb + r1wwwz * nc;
+    P c1 = r0yxxx * na - r0zzyy * nb + r0wwwz * nc;
+    P c2 = r3yxxx * ma - r3zzyy * mb + r3wwwz * mc;
+    P c3 = r2yxxx * ma - r2zzyy * mb + r2wwwz * mc;
+    P plusMinus = P::set(1, -1, 1, -1);
+    P minusPlus = P::set(-1, 1, -1, 1);
+    c0 = c0 * plusMinus;
+    c1 = c1 * minusPlus;
+    c2 = c2 * plusMinus;
+    c3 = c3 * minusPlus;
+
+    // Since B is the transpose of m, the inverse of m is the cofactor matrix
+    // of B divided by its determinant.
+    T det = (r0 * c0).sum();
+    if (std::abs(det) <= epsilon) {
+        return false;
+    }
+    P invDet = P::broadcast(static_cast<T>(1) / det);
+    P::transpose(c0, c1, c2, c3);
+    (c0 * invDet).store(res);
+    (c1 * invDet).store(res + 4);
+    (c2 * invDet).store(res + 8);
+    (c3 * invDet).store(res + 12);
+    return true;
+}
+
+} // namespace vgc::geometry::detail
+
+#endif // VGC_GEOMETRY_DETAIL_SIMD_H
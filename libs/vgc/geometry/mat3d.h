@@ -26,6 +26,7 @@
 
 #include <vgc/core/array.h>
 #include <vgc/geometry/api.h>
+#include <vgc/geometry/detail/simd.h>
 #include <vgc/geometry/mat.h>
 #include <vgc/geometry/stride.h>
 #include <vgc/geometry/vec2d.h>
@@ -234,16 +235,8 @@ public:
     /// Returns the multiplication of the Mat3d \p m1 and the Mat3d \p m2.
     ///
     friend Mat3d operator*(const Mat3d& m1, const Mat3d& m2) {
-        Mat3d res;
-        res(0,0) = m1(0,0)*m2(0,0) + m1(0,1)*m2(1,0) + m1(0,2)*m2(2,0);
-        res(0,1) = m1(0,0)*m2(0,1) + m1(0,1)*m2(1,1) + m1(0,2)*m2(2,1);
-        res(0,2) = m1(0,0)*m2(0,2) + m1(0,1)*m2(1,2) + m1(0,2)*m2(2,2);
-        res(1,0) = m1(1,0)*m2(0,0) + m1(1,1)*m2(1,0) + m1(1,2)*m2(2,0);
-        res(1,1) = m1(1,0)*m2(0,1) + m1(1,1)*m2(1,1) + m1(1,2)*m2(2,1);
-        res(1,2) = m1(1,0)*m2(0,2) + m1(1,1)*m2(1,2) + m1(1,2)*m2(2,2);
-        res(2,0) = m1(2,0)*m2(0,0) + m1(2,1)*m2(1,0) + m1(2,2)*m2(2,0);
-        res(2,1) = m1(2,0)*m2(0,1) + m1(2,1)*m2(1,1) + m1(2,2)*m2(2,1);
-        res(2,2) = m1(2,0)*m2(0,2) + m1(2,1)*m2(1,2) + m1(2,2)*m2(2,2);
+        Mat3d res(core::NoInit{});
+        detail::mat3Multiply(m1.data(), m2.data(), res.data());
         return res;
     }
 
@@ -326,10 +319,8 @@ public:
     /// Returns the multiplication of this Mat3d by the given Vec3d \p v.
     ///
     Vec3d operator*(const Vec3d& v) const {
-        return Vec3d(
-            data_[0][0]*v[0] + data_[1][0]*v[1] + data_[2][0]*v[2],
-            data_[0][1]*v[0] + data_[1][1]*v[1] + data_[2][1]*v[2],
-            data_[0][2]*v[0] + data_[1][2]*v[1] + data_[2][2]*v[2]);
+        auto r = detail::mat3Transform(data(), v[0], v[1], v[2]);
+        return Vec3d(r.get<0>(), r.get<1>(), r.get<2>());
     }
 
     /// Returns the result of transforming the given `Vec2d` by this `Mat3d`
@@ -340,11 +331,9 @@ public:
     /// coordinate.
     ///
     Vec2d transformPoint(const Vec2d& v) const {
-        double x = data_[0][0]*v[0] + data_[1][0]*v[1] + data_[2][0];
-        double y = data_[0][1]*v[0] + data_[1][1]*v[1] + data_[2][1];
-        double w = data_[0][2]*v[0] + data_[1][2]*v[1] + data_[2][2];
-        double iw = 1.0 / w;
-        return Vec2d(iw * x, iw * y);
+        auto r = detail::mat3Transform(data(), v[0], v[1], 1.0);
+        double iw = 1.0 / r.get<2>();
+        return Vec2d(iw * r.get<0>(), iw * r.get<1>());
     }
 
     /// Returns the result of transforming the given `Vec2d` by this `Mat3d`
@@ -393,9 +382,7 @@ public:
     /// Returns a reference to this Mat3d.
     ///
     Mat3d& translate(double vx, double vy = 0) {
-        data_[2][0] += vx*data_[0][0] + vy*data_[1][0];
-        data_[2][1] += vx*data_[0][1] + vy*data_[1][1];
-        data_[2][2] += vx*data_[0][2] + vy*data_[1][2];
+        detail::mat3Translate(data(), vx, vy);
         return *this;
     }
 
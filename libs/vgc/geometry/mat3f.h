@@ -26,6 +26,7 @@
 
 #include <vgc/core/array.h>
 #include <vgc/geometry/api.h>
+#include <vgc/geometry/detail/simd.h>
 #include <vgc/geometry/mat.h>
 #include <vgc/geometry/stride.h>
 #include <vgc/geometry/vec2f.h>
@@ -234,16 +235,8 @@ public:
     /// Returns the multiplication of the Mat3f \p m1 and the Mat3f \p m2.
     ///
     friend Mat3f operator*(const Mat3f& m1, const Mat3f& m2) {
-        Mat3f res;
-        res(0,0) = m1(0,0)*m2(0,0) + m1(0,1)*m2(1,0) + m1(0,2)*m2(2,0);
-        res(0,1) = m1(0,0)*m2(0,1) + m1(0,1)*m2(1,1) + m1(0,2)*m2(2,1);
-        res(0,2) = m1(0,0)*m2(0,2) + m1(0,1)*m2(1,2) + m1(0,2)*m2(2,2);
-        res(1,0) = m1(1,0)*m2(0,0) + m1(1,1)*m2(1,0) + m1(1,2)*m2(2,0);
-        res(1,1) = m1(1,0)*m2(0,1) + m1(1,1)*m2(1,1) + m1(1,2)*m2(2,1);
-        res(1,2) = m1(1,0)*m2(0,2) + m1(1,1)*m2(1,2) + m1(1,2)*m2(2,2);
-        res(2,0) = m1(2,0)*m2(0,0) + m1(2,1)*m2(1,0) + m1(2,2)*m2(2,0);
-        res(2,1) = m1(2,0)*m2(0,1) + m1(2,1)*m2(1,1) + m1(2,2)*m2(2,1);
-        res(2,2) = m1(2,0)*m2(0,2) + m1(2,1)*m2(1,2) + m1(2,2)*m2(2,2);
+        Mat3f res(core::NoInit{});
+        detail::mat3Multiply(m1.data(), m2.data(), res.data());
         return res;
     }
 
@@ -326,10 +319,8 @@ public:
     /// Returns the multiplication of this Mat3f by the given Vec3f \p v.
     ///
     Vec3f operator*(const Vec3f& v) const {
-        return Vec3f(
-            data_[0][0]*v[0] + data_[1][0]*v[1] + data_[2][0]*v[2],
-            data_[0][1]*v[0] + data_[1][1]*v[1] + data_[2][1]*v[2],
-            data_[0][2]*v[0] + data_[1][2]*v[1] + data_[2][2]*v[2]);
+        auto r = detail::mat3Transform(data(), v[0], v[1], v[2]);
+        return Vec3f(r.get<0>(), r.get<1>(), r.get<2>());
     }
 
     /// Returns the result of transforming the given `Vec2f` by this `Mat3f`
@@ -340,11 +331,9 @@ public:
     /// coordinate.
     ///
     Vec2f transformPoint(const Vec2f& v) const {
-        float x = data_[0][0]*v[0] + data_[1][0]*v[1] + data_[2][0];
-        float y = data_[0][1]*v[0] + data_[1][1]*v[1] + data_[2][1];
-        float w = data_[0][2]*v[0] + data_[1][2]*v[1] + data_[2][2];
-        float iw = 1.0f / w;
-        return Vec2f(iw * x, iw * y);
+        auto r = detail::mat3Transform(data(), v[0], v[1], 1.0f);
+        float iw = 1.0f / r.get<2>();
+        return Vec2f(iw * r.get<0>(), iw * r.get<1>());
     }
 
     /// Returns the result of transforming the given `Vec2f` by this `Mat3f`
@@ -393,9 +382,7 @@ public:
     /// Returns a reference to this Mat3f.
     ///
     Mat3f& translate(float vx, float vy = 0) {
-        data_[2][0] += vx*data_[0][0] + vy*data_[1][0];
-        data_[2][1] += vx*data_[0][1] + vy*data_[1][1];
-        data_[2][2] += vx*data_[0][2] + vy*data_[1][2];
+        detail::mat3Translate(data(), vx, vy);
         return *this;
     }
 
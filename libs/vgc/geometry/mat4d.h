@@ -26,6 +26,7 @@
 
 #include <vgc/core/array.h>
 #include <vgc/geometry/api.h>
+#include <vgc/geometry/detail/simd.h>
 #include <vgc/geometry/mat.h>
 #include <vgc/geometry/stride.h>
 #include <vgc/geometry/vec2d.h>
@@ -263,23 +264,8 @@ public:
     /// Returns the multiplication of the Mat4d \p m1 and the Mat4d \p m2.
     ///
     friend Mat4d operator*(const Mat4d& m1, const Mat4d& m2) {
-        Mat4d res;
-        res(0,0) = m1(0,0)*m2(0,0) + m1(0,1)*m2(1,0) + m1(0,2)*m2(2,0) + m1(0,3)*m2(3,0);
-        res(0,1) = m1(0,0)*m2(0,1) + m1(0,1)*m2(1,1) + m1(0,2)*m2(2,1) + m1(0,3)*m2(3,1);
-        res(0,2) = m1(0,0)*m2(0,2) + m1(0,1)*m2(1,2) + m1(0,2)*m2(2,2) + m1(0,3)*m2(3,2);
-        res(0,3) = m1(0,0)*m2(0,3) + m1(0,1)*m2(1,3) + m1(0,2)*m2(2,3) + m1(0,3)*m2(3,3);
-        res(1,0) = m1(1,0)*m2(0,0) + m1(1,1)*m2(1,0) + m1(1,2)*m2(2,0) + m1(1,3)*m2(3,0);
-        res(1,1) = m1(1,0)*m2(0,1) + m1(1,1)*m2(1,1) + m1(1,2)*m2(2,1) + m1(1,3)*m2(3,1);
-        res(1,2) = m1(1,0)*m2(0,2) + m1(1,1)*m2(1,2) + m1(1,2)*m2(2,2) + m1(1,3)*m2(3,2);
-        res(1,3) = m1(1,0)*m2(0,3) + m1(1,1)*m2(1,3) + m1(1,2)*m2(2,3) + m1(1,3)*m2(3,3);
-        res(2,0) = m1(2,0)*m2(0,0) + m1(2,1)*m2(1,0) + m1(2,2)*m2(2,0) + m1(2,3)*m2(3,0);
-        res(2,1) = m1(2,0)*m2(0,1) + m1(2,1)*m2(1,1) + m1(2,2)*m2(2,1) + m1(2,3)*m2(3,1);
-        res(2,2) = m1(2,0)*m2(0,2) + m1(2,1)*m2(1,2) + m1(2,2)*m2(2,2) + m1(2,3)*m2(3,2);
-        res(2,3) = m1(2,0)*m2(0,3) + m1(2,1)*m2(1,3) + m1(2,2)*m2(2,3) + m1(2,3)*m2(3,3);
-        res(3,0) = m1(3,0)*m2(0,0) + m1(3,1)*m2(1,0) + m1(3,2)*m2(2,0) + m1(3,3)*m2(3,0);
-        res(3,1) = m1(3,0)*m2(0,1) + m1(3,1)*m2(1,1) + m1(3,2)*m2(2,1) + m1(3,3)*m2(3,1);
-        res(3,2) = m1(3,0)*m2(0,2) + m1(3,1)*m2(1,2) + m1(3,2)*m2(2,2) + m1(3,3)*m2(3,2);
-        res(3,3) = m1(3,0)*m2(0,3) + m1(3,1)*m2(1,3) + m1(3,2)*m2(2,3) + m1(3,3)*m2(3,3);
+        Mat4d res(core::NoInit{});
+        detail::mat4Multiply(m1.data(), m2.data(), res.data());
         return res;
     }
 
@@ -390,11 +376,9 @@ public:
     /// Returns the multiplication of this Mat4d by the given Vec4d \p v.
     ///
     Vec4d operator*(const Vec4d& v) const {
-        return Vec4d(
-            data_[0][0]*v[0] + data_[1][0]*v[1] + data_[2][0]*v[2] + data_[3][0]*v[3],
-            data_[0][1]*v[0] + data_[1][1]*v[1] + data_[2][1]*v[2] + data_[3][1]*v[3],
-            data_[0][2]*v[0] + data_[1][2]*v[1] + data_[2][2]*v[2] + data_[3][2]*v[3],
-            data_[0][3]*v[0] + data_[1][3]*v[1] + data_[2][3]*v[2] + data_[3][3]*v[3]);
+        Vec4d res(core::NoInit{});
+        detail::mat4Transform(data(), v[0], v[1], v[2], v[3]).store(res.data());
+        return res;
     }
 
     /// Returns the result of transforming the given `Vec3d` by this `Mat4d`
@@ -405,12 +389,9 @@ public:
     /// coordinate.
     ///
     Vec3d transformPoint(const Vec3d& v) const {
-        double x = data_[0][0]*v[0] + data_[1][0]*v[1] + data_[2][0]*v[2] + data_[3][0];
-        double y = data_[0][1]*v[0] + data_[1][1]*v[1] + data_[2][1]*v[2] + data_[3][1];
-        double z = data_[0][2]*v[0] + data_[1][2]*v[1] + data_[2][2]*v[2] + data_[3][2];
-        double w = data_[0][3]*v[0] + data_[1][3]*v[1] + data_[2][3]*v[2] + data_[3][3];
-        double iw = 1.0 / w;
-        return Vec3d(iw * x, iw * y, iw * z);
+        auto r = detail::mat4Transform(data(), v[0], v[1], v[2], 1.0);
+        double iw = 1.0 / r.get<3>();
+        return Vec3d(iw * r.get<0>(), iw * r.get<1>(), iw * r.get<2>());
     }
 
     /// Computes the transformation of the given `Vec2d` (interpreted as a
@@ -420,11 +401,9 @@ public:
     /// See `transformPoint(const Vec3d& v)` for details.
     ///
     Vec2d transformPoint(const Vec2d& v) const {
-        double x = data_[0][0]*v[0] + data_[1][0]*v[1] + data_[3][0];
-        double y = data_[0][1]*v[0] + data_[1][1]*v[1] + data_[3][1];
-        double w = data_[0][3]*v[0] + data_[1][3]*v[1] + data_[3][3];
-        double iw = 1.0 / w;
-        return Vec2d(iw * x, iw * y);
+        auto r = detail::mat4Transform(data(), v[0], v[1], 0.0, 1.0);
+        double iw = 1.0 / r.get<3>();
+        return Vec2d(iw * r.get<0>(), iw * r.get<1>());
     }
 
     /// Returns the result of transforming the given `Vec3d` by this `Mat4d`
@@ -439,10 +418,8 @@ public:
     /// whenever you prefer to behave as if the last row was `[0, 0, 0, 1]`.
     ///
     Vec3d transformPointAffine(const Vec3d& v) const {
-        double x = data_[0][0]*v[0] + data_[1][0]*v[1] + data_[2][0]*v[2] + data_[3][0];
-        double y = data_[0][1]*v[0] + data_[1][1]*v[1] + data_[2][1]*v[2] + data_[3][1];
-        double z = data_[0][2]*v[0] + data_[1][2]*v[1] + data_[2][2]*v[2] + data_[3][2];
-        return Vec3d(x, y, z);
+        auto r = detail::mat4Transform(data(), v[0], v[1], v[2], 1.0);
+        return Vec3d(r.get<0>(), r.get<1>(), r.get<2>());
     }
 
     /// Computes the transformation of the given `Vec2d` (interpreted as a
@@ -488,10 +465,7 @@ public:
     /// Returns a reference to this Mat4d.
     ///
     Mat4d& translate(double vx, double vy = 0, double vz = 0) {
-        data_[3][0] += vx*data_[0][0] + vy*data_[1][0] + vz*data_[2][0];
-        data_[3][1] += vx*data_[0][1] + vy*data_[1][1] + vz*data_[2][1];
-        data_[3][2] += vx*data_[0][2] + vy*data_[1][2] + vz*data_[2][2];
-        data_[3][3] += vx*data_[0][3] + vy*data_[1][3] + vz*data_[2][3];
+        detail::mat4Translate(data(), vx, vy, vz);
         return *this;
     }
 
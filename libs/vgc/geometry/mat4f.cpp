@@ -27,64 +27,18 @@ namespace vgc::geometry {
 
 Mat4f Mat4f::inverted(bool* isInvertible, float epsilon_) const {
 
-    Mat4f res;
-
-    const auto& d = data_;
-    auto& inv = res.data_;
-
-    inv[0][0] =   d[1][1]*d[2][2]*d[3][3] - d[1][1]*d[2][3]*d[3][2] - d[2][1]*d[1][2]*d[3][3]
-                + d[2][1]*d[1][3]*d[3][2] + d[3][1]*d[1][2]*d[2][3] - d[3][1]*d[1][3]*d[2][2];
-    inv[1][0] = - d[1][0]*d[2][2]*d[3][3] + d[1][0]*d[2][3]*d[3][2] + d[2][0]*d[1][2]*d[3][3]
-                - d[2][0]*d[1][3]*d[3][2] - d[3][0]*d[1][2]*d[2][3] + d[3][0]*d[1][3]*d[2][2];
-    inv[2][0] =   d[1][0]*d[2][1]*d[3][3] - d[1][0]*d[2][3]*d[3][1] - d[2][0]*d[1][1]*d[3][3]
-                + d[2][0]*d[1][3]*d[3][1] + d[3][0]*d[1][1]*d[2][3] - d[3][0]*d[1][3]*d[2][1];
-    inv[3][0] = - d[1][0]*d[2][1]*d[3][2] + d[1][0]*d[2][2]*d[3][1] + d[2][0]*d[1][1]*d[3][2]
-                - d[2][0]*d[1][2]*d[3][1] - d[3][0]*d[1][1]*d[2][2] + d[3][0]*d[1][2]*d[2][1];
-
-    float det = d[0][0]*inv[0][0] + d[0][1]*inv[1][0] + d[0][2]*inv[2][0] + d[0][3]*inv[3][0];
-
-    if (std::abs(det) <= epsilon_) {
-        if (isInvertible) {
-            *isInvertible = false;
-        }
+    Mat4f res(core::NoInit{});
+    bool invertible = detail::mat4Inverse(data(), res.data(), epsilon_);
+    if (isInvertible) {
+        *isInvertible = invertible;
+    }
+    if (!invertible) {
         constexpr float inf = core::infinity<float>;
         res.setElements(inf, inf, inf, inf,
                         inf, inf, inf, inf,
                         inf, inf, inf, inf,
                         inf, inf, inf, inf);
     }
-    else {
-        if (isInvertible) {
-            *isInvertible = true;
-        }
-
-        inv[0][1] = - d[0][1]*d[2][2]*d[3][3] + d[0][1]*d[2][3]*d[3][2] + d[2][1]*d[0][2]*d[3][3]
-                    - d[2][1]*d[0][3]*d[3][2] - d[3][1]*d[0][2]*d[2][3] + d[3][1]*d[0][3]*d[2][2];
-        inv[1][1] =   d[0][0]*d[2][2]*d[3][3] - d[0][0]*d[2][3]*d[3][2] - d[2][0]*d[0][2]*d[3][3]
-                    + d[2][0]*d[0][3]*d[3][2] + d[3][0]*d[0][2]*d[2][3] - d[3][0]*d[0][3]*d[2][2];
-        inv[2][1] = - d[0][0]*d[2][1]*d[3][3] + d[0][0]*d[2][3]*d[3][1] + d[2][0]*d[0][1]*d[3][3]
-                    - d[2][0]*d[0][3]*d[3][1] - d[3][0]*d[0][1]*d[2][3] + d[3][0]*d[0][3]*d[2][1];
-        inv[3][1] =   d[0][0]*d[2][1]*d[3][2] - d[0][0]*d[2][2]*d[3][1] - d[2][0]*d[0][1]*d[3][2]
-                    + d[2][0]*d[0][2]*d[3][1] + d[3][0]*d[0][1]*d[2][2] - d[3][0]*d[0][2]*d[2][1];
-        inv[0][2] =   d[0][1]*d[1][2]*d[3][3] - d[0][1]*d[1][3]*d[3][2] - d[1][1]*d[0][2]*d[3][3]
-                    + d[1][1]*d[0][3]*d[3][2] + d[3][1]*d[0][2]*d[1][3] - d[3][1]*d[0][3]*d[1][2];
-        inv[1][2] = - d[0][0]*d[1][2]*d[3][3] + d[0][0]*d[1][3]*d[3][2] + d[1][0]*d[0][2]*d[3][3]
-                    - d[1][0]*d[0][3]*d[3][2] - d[3][0]*d[0][2]*d[1][3] + d[3][0]*d[0][3]*d[1][2];
-        inv[2][2] =   d[0][0]*d[1][1]*d[3][3] - d[0][0]*d[1][3]*d[3][1] - d[1][0]*d[0][1]*d[3][3]
-                    + d[1][0]*d[0][3]*d[3][1] + d[3][0]*d[0][1]*d[1][3] - d[3][0]*d[0][3]*d[1][1];
-        inv[3][2] = - d[0][0]*d[1][1]*d[3][2] + d[0][0]*d[1][2]*d[3][1] + d[1][0]*d[0][1]*d[3][2]
-                    - d[1][0]*d[0][2]*d[3][1] - d[3][0]*d[0][1]*d[1][2] + d[3][0]*d[0][2]*d[1][1];
-        inv[0][3] = - d[0][1]*d[1][2]*d[2][3] + d[0][1]*d[1][3]*d[2][2] + d[1][1]*d[0][2]*d[2][3]
-                    - d[1][1]*d[0][3]*d[2][2] - d[2][1]*d[0][2]*d[1][3] + d[2][1]*d[0][3]*d[1][2];
-        inv[1][3] =   d[0][0]*d[1][2]*d[2][3] - d[0][0]*d[1][3]*d[2][2] - d[1][0]*d[0][2]*d[2][3]
-                    + d[1][0]*d[0][3]*d[2][2] + d[2][0]*d[0][2]*d[1][3] - d[2][0]*d[0][3]*d[1][2];
-        inv[2][3] = - d[0][0]*d[1][1]*d[2][3] + d[0][0]*d[1][3]*d[2][1] + d[1][0]*d[0][1]*d[2][3]
-                    - d[1][0]*d[0][3]*d[2][1] - d[2][0]*d[0][1]*d[1][3] + d[2][0]*d[0][3]*d[1][1];
-        inv[3][3] =   d[0][0]*d[1][1]*d[2][2] - d[0][0]*d[1][2]*d[2][1] - d[1][0]*d[0][1]*d[2][2]
-                    + d[1][0]*d[0][2]*d[2][1] + d[2][0]*d[0][1]*d[1][2] - d[2][0]*d[0][2]*d[1][1];
-
-        res *= static_cast<float>(1) / det;
-    }
     return res;
 }
 
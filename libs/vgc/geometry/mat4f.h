@@ -26,6 +26,7 @@
 
 #include <vgc/core/array.h>
 #include <vgc/geometry/api.h>
+#include <vgc/geometry/detail/simd.h>
 #include <vgc/geometry/mat.h>
 #include <vgc/geometry/stride.h>
 #include <vgc/geometry/vec2f.h>
@@ -263,23 +264,8 @@ public:
     /// Returns the multiplication of the Mat4f \p m1 and the Mat4f \p m2.
     ///
     friend Mat4f operator*(const Mat4f& m1, const Mat4f& m2) {
-        Mat4f res;
-        res(0,0) = m1(0,0)*m2(0,0) + m1(0,1)*m2(1,0) + m1(0,2)*m2(2,0) + m1(0,3)*m2(3,0);
-        res(0,1) = m1(0,0)*m2(0,1) + m1(0,1)*m2(1,1) + m1(0,2)*m2(2,1) + m1(0,3)*m2(3,1);
-        res(0,2) = m1(0,0)*m2(0,2) + m1(0,1)*m2(1,2) + m1(0,2)*m2(2,2) + m1(0,3)*m2(3,2);
-        res(0,3) = m1(0,0)*m2(0,3) + m1(0,1)*m2(1,3) + m1(0,2)*m2(2,3) + m1(0,3)*m2(3,3);
-        res(1,0) = m1(1,0)*m2(0,0) + m1(1,1)*m2(1,0) + m1(1,2)*m2(2,0) + m1(1,3)*m2(3,0);
-        res(1,1) = m1(1,0)*m2(0,1) + m1(1,1)*m2(1,1) + m1(1,2)*m2(2,1) + m1(1,3)*m2(3,1);
-        res(1,2) = m1(1,0)*m2(0,2) + m1(1,1)*m2(1,2) + m1(1,2)*m2(2,2) + m1(1,3)*m2(3,2);
-        res(1,3) = m1(1,0)*m2(0,3) + m1(1,1)*m2(1,3) + m1(1,2)*m2(2,3) + m1(1,3)*m2(3,3);
-        res(2,0) = m1(2,0)*m2(0,0) + m1(2,1)*m2(1,0) + m1(2,2)*m2(2,0) + m1(2,3)*m2(3,0);
-        res(2,1) = m1(2,0)*m2(0,1) + m1(2,1)*m2(1,1) + m1(2,2)*m2(2,1) + m1(2,3)*m2(3,1);
-        res(2,2) = m1(2,0)*m2(0,2) + m1(2,1)*m2(1,2) + m1(2,2)*m2(2,2) + m1(2,3)*m2(3,2);
-        res(2,3) = m1(2,0)*m2(0,3) + m1(2,1)*m2(1,3) + m1(2,2)*m2(2,3) + m1(2,3)*m2(3,3);
-        res(3,0) = m1(3,0)*m2(0,0) + m1(3,1)*m2(1,0) + m1(3,2)*m2(2,0) + m1(3,3)*m2(3,0);
-        res(3,1) = m1(3,0)*m2(0,1) + m1(3,1)*m2(1,1) + m1(3,2)*m2(2,1) + m1(3,3)*m2(3,1);
-        res(3,2) = m1(3,0)*m2(0,2) + m1(3,1)*m2(1,2) + m1(3,2)*m2(2,2) + m1(3,3)*m2(3,2);
-        res(3,3) = m1(3,0)*m2(0,3) + m1(3,1)*m2(1,3) + m1(3,2)*m2(2,3) + m1(3,3)*m2(3,3);
+        Mat4f res(core::NoInit{});
+        detail::mat4Multiply(m1.data(), m2.data(), res.data());
         return res;
     }
 
@@ -390,11 +376,9 @@ public:
     /// Returns the multiplication of this Mat4f by the given Vec4f \p v.
     ///
     Vec4f operator*(const Vec4f& v) const {
-        return Vec4f(
-            data_[0][0]*v[0] + data_[1][0]*v[1] + data_[2][0]*v[2] + data_[3][0]*v[3],
-            data_[0][1]*v[0] + data_[1][1]*v[1] + data_[2][1]*v[2] + data_[3][1]*v[3],
-            data_[0][2]*v[0] + data_[1][2]*v[1] + data_[2][2]*v[2] + data_[3][2]*v[3],
-            data_[0][3]*v[0] + data_[1][3]*v[1] + data_[2][3]*v[2] + data_[3][3]*v[3]);
+        Vec4f res(core::NoInit{});
+        detail::mat4Transform(data(), v[0], v[1], v[2], v[3]).store(res.data());
+        return res;
     }
 
     /// Returns the result of transforming the given `Vec3f` by this `Mat4f`
@@ -405,12 +389,9 @@ public:
     /// coordinate.
     ///
     Vec3f transformPoint(const Vec3f& v) const {
-        float x = data_[0][0]*v[0] + data_[1][0]*v[1] + data_[2][0]*v[2] + data_[3][0];
-        float y = data_[0][1]*v[0] + data_[1][1]*v[1] + data_[2][1]*v[2] + data_[3][1];
-        float z = data_[0][2]*v[0] + data_[1][2]*v[1] + data_[2][2]*v[2] + data_[3][2];
-        float w = data_[0][3]*v[0] + data_[1][3]*v[1] + data_[2][3]*v[2] + data_[3][3];
-        float iw = 1.0f / w;
-        return Vec3f(iw * x, iw * y, iw * z);
+        auto r = detail::mat4Transform(data(), v[0], v[1], v[2], 1.0f);
+        float iw = 1.0f / r.get<3>();
+        return Vec3f(iw * r.get<0>(), iw * r.get<1>(), iw * r.get<2>());
     }
 
     /// Computes the transformation of the given `Vec2f` (interpreted as a
@@ -420,11 +401,9 @@ public:
     /// See `transformPoint(const Vec3f& v)` for details.
     ///
     Vec2f transformPoint(const Vec2f& v) const {
-        float x = data_[0][0]*v[0] + data_[1][0]*v[1] + data_[3][0];
-        float y = data_[0][1]*v[0] + data_[1][1]*v[1] + data_[3][1];
-        float w = data_[0][3]*v[0] + data_[1][3]*v[1] + data_[3][3];
-        float iw = 1.0f / w;
-        return Vec2f(iw * x, iw * y);
+        auto r = detail::mat4Transform(data(), v[0], v[1], 0.0f, 1.0f);
+        float iw = 1.0f / r.get<3>();
+        return Vec2f(iw * r.get<0>(), iw * r.get<1>());
     }
 
     /// Returns the result of transforming the given `Vec3f` by this `Mat4f`
@@ -439,10 +418,8 @@ public:
     /// whenever you prefer to behave as if the last row was `[0, 0, 0, 1]`.
     ///
     Vec3f transformPointAffine(const Vec3f& v) const {
-        float x = data_[0][0]*v[0] + data_[1][0]*v[1] + data_[2][0]*v[2] + data_[3][0];
-        float y = data_[0][1]*v[0] + data_[1][1]*v[1] + data_[2][1]*v[2] + data_[3][1];
-        float z = data_[0][2]*v[0] + data_[1][2]*v[1] + data_[2][2]*v[2] + data_[3][2];
-        return Vec3f(x, y, z);
+        auto r = detail::mat4Transform(data(), v[0], v[1], v[2], 1.0f);
+        return Vec3f(r.get<0>(), r.get<1>(), r.get<2>());
     }
 
     /// Computes the transformation of the given `Vec2f` (interpreted as a
@@ -488,10 +465,7 @@ public:
     /// Returns a reference to this Mat4f.
     ///
     Mat4f& translate(float vx, float vy = 0, float vz = 0) {
-        data_[3][0] += vx*data_[0][0] + vy*data_[1][0] + vz*data_[2][0];
-        data_[3][1] += vx*data_[0][1] + vy*data_[1][1] + vz*data_[2][1];
-        data_[3][2] += vx*data_[0][2] + vy*data_[1][2] + vz*data_[2][2];
-        data_[3][3] += vx*data_[0][3] + vy*data_[1][3] + vz*data_[2][3];
+        detail::mat4Translate(data(), vx, vy, vz);
         return *this;
     }
 
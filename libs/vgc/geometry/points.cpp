@@ -0,0 +1,459 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vgc/geometry/points.h>
+
+#include <algorithm> // min, max
+
+// SSE2 is part of the x86-64 baseline, so it can be used without any runtime
+// check of the CPU features. On other architectures, we rely on the compiler
+// to auto-vectorize the scalar loops below.
+//
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define VGC_GEOMETRY_POINTS_SSE2
+#    include <emmintrin.h>
+#endif
+
+namespace vgc::geometry {
+
+namespace {
+
+// The coefficients of a 2D projective transformation:
+//
+// x' = (a*x + b*y + c) / (g*x + h*y + i)
+// y' = (d*x + e*y + f) / (g*x + h*y + i)
+//
+template<typename T>
+struct Coefficients {
+    T a, b, c;
+    T d, e, f;
+    T g, h, i;
+
+    bool isAffine() const {
+        return g == 0 && h == 0 && i == 1;
+    }
+};
+
+Coefficients<double> coefficients(const Mat3d& m) {
+    return {
+        m(0, 0), m(0, 1), m(0, 2), //
+        m(1, 0), m(1, 1), m(1, 2), //
+        m(2, 0), m(2, 1), m(2, 2)};
+}
+
+Coefficients<float> coefficients(const Mat3f& m) {
+    return {
+        m(0, 0), m(0, 1), m(0, 2), //
+        m(1, 0), m(1, 1), m(1, 2), //
+        m(2, 0), m(2, 1), m(2, 2)};
+}
+
+// Points are interpreted as (x, y, 0, 1), so the third row and column of the
+// matrix are ignored.
+//
+Coefficients<float> coefficients(const Mat4f& m) {
+    return {
+        m(0, 0), m(0, 1), m(0, 3), //
+        m(1, 0), m(1, 1), m(1, 3), //
+        m(3, 0), m(3, 1), m(3, 3)};
+}
+
+template<typename T, typename TVec2>
+void transformAffineScalar(
+    const Coefficients<T>& k,
+    const TVec2* in,
+    TVec2* out,
+    Int count) {
+
+    for (Int j = 0; j < count; ++j) {
+        T x = in[j][0];
+        T y = in[j][1];
+        out[j][0] = k.a * x + k.b * y + k.c;
+        out[j][1] = k.d * x + k.e * y + k.f;
+    }
+}
+
+template<typename T, typename TVec2>
+void transformProjectiveScalar(
+    const Coefficients<T>& k,
+    const TVec2* in,
+    TVec2* out,
+    Int count) {
+
+    for (Int j = 0; j < count; ++j) {
+        T x = in[j][0];
+        T y = in[j][1];
+        T iw = T(1) / (k.g * x + k.h * y + k.i);
+        out[j][0] = iw * (k.a * x + k.b * y + k.c);
+        out[j][1] = iw * (k.d * x + k.e * y + k.f);
+    }
+}
+
+#ifdef VGC_GEOMETRY_POINTS_SSE2
+
+// One Vec2d per SSE2 register: [x, y]
+//
+template<bool isAffine>
+void transformSse2(
+    const Coefficients<double>& k,
+    const Vec2d* in,
+    Vec2d* out,
+    Int count) {
+
+    const double* src = reinterpret_cast<const double*>(in);
+    double* dst = reinterpret_cast<double*>(out);
+    __m128d cx = _mm_setr_pd(k.a, k.d);
+    __m128d cy = _mm_setr_pd(k.b, k.e);
+    __m128d c1 = _mm_setr_pd(k.c, k.f);
+    __m128d wx = _mm_set1_pd(k.g);
+    __m128d wy = _mm_set1_pd(k.h);
+    __m128d w1 = _mm_set1_pd(k.i);
+    __m128d one = _mm_set1_pd(1.0);
+    for (Int j = 0; j < count; ++j) {
+        __m128d p = _mm_loadu_pd(src + 2 * j);
+        __m128d x = _mm_unpacklo_pd(p, p);
+        __m128d y = _mm_unpackhi_pd(p, p);
+        __m128d q = _mm_add_pd(_mm_add_pd(_mm_mul_pd(cx, x), _mm_mul_pd(cy, y)), c1);
+        if constexpr (!isAffine) {
+            __m128d w = _mm_add_pd(_mm_add_pd(_mm_mul_pd(wx, x), _mm_mul_pd(wy, y)), w1);
+            q = _mm_mul_pd(_mm_div_pd(one, w), q);
+        }
+        _mm_storeu_pd(dst + 2 * j, q);
+    }
+}
+
+// Two Vec2f per SSE register: [x0, y0, x1, y1]
+//
+template<bool isAffine>
+void transformSse2(
+    const Coefficients<float>& k,
+    const Vec2f* in,
+    Vec2f* out,
+    Int count) {
+
+    const float* src = reinterpret_cast<const float*>(in);
+    float* dst = reinterpret_cast<float*>(out);
+    __m128 cx = _mm_setr_ps(k.a, k.d, k.a, k.d);
+    __m128 cy = _mm_setr_ps(k.b, k.e, k.b, k.e);
+    __m128 c1 = _mm_setr_ps(k.c, k.f, k.c, k.f);
+    __m128 wx = _mm_set1_ps(k.g);
+    __m128 wy = _mm_set1_ps(k.h);
+    __m128 w1 = _mm_set1_ps(k.i);
+    __m128 one = _mm_set1_ps(1.0f);
+    Int j = 0;
+    for (; j + 2 <= count; j += 2) {
+        __m128 p = _mm_loadu_ps(src + 2 * j);
+        __m128 x = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 y = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 q = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, x), _mm_mul_ps(cy, y)), c1);
+        if constexpr (!isAffine) {
+            __m128 w = _mm_add_ps(_mm_add_ps(_mm_mul_ps(wx, x), _mm_mul_ps(wy, y)), w1);
+            q = _mm_mul_ps(_mm_div_ps(one, w), q);
+        }
+        _mm_storeu_ps(dst + 2 * j, q);
+    }
+    if (j < count) {
+        if constexpr (isAffine) {
+            transformAffineScalar(k, in + j, out + j, count - j);
+        }
+        else {
+            transformProjectiveScalar(k, in + j, out + j, count - j);
+        }
+    }
+}
+
+#endif // VGC_GEOMETRY_POINTS_SSE2
+
+// Transforms in place the points whose x-coordinates are given by `xs` and
+// y-coordinates are given by `ys`.
+//
+template<bool isAffine>
+void transformSoA(const Coefficients<double>& k, double* xs, double* ys, Int count) {
+    Int j = 0;
+#ifdef VGC_GEOMETRY_POINTS_SSE2
+    __m128d a = _mm_set1_pd(k.a);
+    __m128d b = _mm_set1_pd(k.b);
+    __m128d c = _mm_set1_pd(k.c);
+    __m128d d = _mm_set1_pd(k.d);
+    __m128d e = _mm_set1_pd(k.e);
+    __m128d f = _mm_set1_pd(k.f);
+    __m128d g = _mm_set1_pd(k.g);
+    __m128d h = _mm_set1_pd(k.h);
+    __m128d i = _mm_set1_pd(k.i);
+    __m128d one = _mm_set1_pd(1.0);
+    for (; j + 2 <= count; j += 2) {
+        __m128d x = _mm_loadu_pd(xs + j);
+        __m128d y = _mm_loadu_pd(ys + j);
+        __m128d x2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(a, x), _mm_mul_pd(b, y)), c);
+        __m128d y2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(d, x), _mm_mul_pd(e, y)), f);
+        if constexpr (!isAffine) {
+            __m128d w = _mm_add_pd(_mm_add_pd(_mm_mul_pd(g, x), _mm_mul_pd(h, y)), i);
+            __m128d iw = _mm_div_pd(one, w);
+            x2 = _mm_mul_pd(iw, x2);
+            y2 = _mm_mul_pd(iw, y2);
+        }
+        _mm_storeu_pd(xs + j, x2);
+        _mm_storeu_pd(ys + j, y2);
+    }
+#endif
+    for (; j < count; ++j) {
+        double x = xs[j];
+        double y = ys[j];
+        double x2 = k.a * x + k.b * y + k.c;
+        double y2 = k.d * x + k.e * y + k.f;
+        if constexpr (!isAffine) {
+            double iw = 1.0 / (k.g * x + k.h * y + k.i);
+            x2 = iw * x2;
+            y2 = iw * y2;
+        }
+        xs[j] = x2;
+        ys[j] = y2;
+    }
+}
+
+// Returns the minimum and maximum of the given non-empty array of values.
+//
+void minMax(const double* values, Int count, double& min, double& max) {
+    Int j = 0;
+    min = values[0];
+    max = values[0];
+#ifdef VGC_GEOMETRY_POINTS_SSE2
+    if (count >= 2) {
+        __m128d vMin = _mm_loadu_pd(values);
+        __m128d vMax = vMin;
+        for (j = 2; j + 2 <= count; j += 2) {
+            __m128d v = _mm_loadu_pd(values + j);
+            vMin = _mm_min_pd(vMin, v);
+            vMax = _mm_max_pd(vMax, v);
+        }
+        vMin = _mm_min_sd(vMin, _mm_unpackhi_pd(vMin, vMin));
+        vMax = _mm_max_sd(vMax, _mm_unpackhi_pd(vMax, vMax));
+        min = _mm_cvtsd_f64(vMin);
+        max = _mm_cvtsd_f64(vMax);
+    }
+#endif
+    for (; j < count; ++j) {
+        min = (std::min)(min, values[j]);
+        max = (std::max)(max, values[j]);
+    }
+}
+
+template<typename T, typename TVec2>
+void transformAffine(const Coefficients<T>& k, const TVec2* in, TVec2* out, Int count) {
+#ifdef VGC_GEOMETRY_POINTS_SSE2
+    transformSse2<true>(k, in, out, count);
+#else
+    transformAffineScalar(k, in, out, count);
+#endif
+}
+
+template<typename T, typename TVec2>
+void transform(const Coefficients<T>& k, const TVec2* in, TVec2* out, Int count) {
+    if (k.isAffine()) {
+        transformAffine(k, in, out, count);
+    }
+    else {
+#ifdef VGC_GEOMETRY_POINTS_SSE2
+        transformSse2<false>(k, in, out, count);
+#else
+        transformProjectiveScalar(k, in, out, count);
+#endif
+    }
+}
+
+template<typename T, typename TVec2>
+Int containsPoints_(
+    T xMin,
+    T yMin,
+    T xMax,
+    T yMax,
+    const TVec2* points,
+    Int count,
+    bool* isContained) {
+
+    Int res = 0;
+    for (Int j = 0; j < count; ++j) {
+        T x = points[j][0];
+        T y = points[j][1];
+        bool b = (x <= xMax) & (y <= yMax) & (xMin <= x) & (yMin <= y);
+        isContained[j] = b;
+        res += b;
+    }
+    return res;
+}
+
+} // namespace
+
+void transformPoints(const Mat3d& m, const Vec2d* in, Vec2d* out, Int count) {
+    transform(coefficients(m), in, out, count);
+}
+
+void transformPoints(const Mat3f& m, const Vec2f* in, Vec2f* out, Int count) {
+    transform(coefficients(m), in, out, count);
+}
+
+void transformPoints(const Mat4f& m, const Vec2f* in, Vec2f* out, Int count) {
+    transform(coefficients(m), in, out, count);
+}
+
+void transformPointsAffine(const Mat3d& m, const Vec2d* in, Vec2d* out, Int count) {
+    transformAffine(coefficients(m), in, out, count);
+}
+
+void transformPointsAffine(const Mat3f& m, const Vec2f* in, Vec2f* out, Int count) {
+    transformAffine(coefficients(m), in, out, count);
+}
+
+void transformPointsAffine(const Mat4f& m, const Vec2f* in, Vec2f* out, Int count) {
+    transformAffine(coefficients(m), in, out, count);
+}
+
+void transformPoints(const Mat3d& m, Vec2dSoA& points) {
+    Coefficients<double> k = coefficients(m);
+    if (k.isAffine()) {
+        transformSoA<true>(k, points.xData(), points.yData(), points.length());
+    }
+    else {
+        transformSoA<false>(k, points.xData(), points.yData(), points.length());
+    }
+}
+
+void transformPointsAffine(const Mat3d& m, Vec2dSoA& points) {
+    Coefficients<double> k = coefficients(m);
+    transformSoA<true>(k, points.xData(), points.yData(), points.length());
+}
+
+Rect2d boundingRect(const Vec2d* points, Int count) {
+    if (count <= 0) {
+        return Rect2d::empty;
+    }
+#ifdef VGC_GEOMETRY_POINTS_SSE2
+    const double* src = reinterpret_cast<const double*>(points);
+    __m128d pMin = _mm_loadu_pd(src);
+    __m128d pMax = pMin;
+    for (Int j = 1; j < count; ++j) {
+        __m128d p = _mm_loadu_pd(src + 2 * j);
+        pMin = _mm_min_pd(pMin, p);
+        pMax = _mm_max_pd(pMax, p);
+    }
+    Vec2d res[2];
+    _mm_storeu_pd(reinterpret_cast<double*>(&res[0]), pMin);
+    _mm_storeu_pd(reinterpret_cast<double*>(&res[1]), pMax);
+    return Rect2d(res[0], res[1]);
+#else
+    Vec2d pMin = points[0];
+    Vec2d pMax = points[0];
+    for (Int j = 1; j < count; ++j) {
+        const Vec2d& p = points[j];
+        pMin[0] = (std::min)(pMin[0], p[0]);
+        pMin[1] = (std::min)(pMin[1], p[1]);
+        pMax[0] = (std::max)(pMax[0], p[0]);
+        pMax[1] = (std::max)(pMax[1], p[1]);
+    }
+    return Rect2d(pMin, pMax);
+#endif
+}
+
+Rect2f boundingRect(const Vec2f* points, Int count) {
+    if (count <= 0) {
+        return Rect2f::empty;
+    }
+#ifdef VGC_GEOMETRY_POINTS_SSE2
+    const float* src = reinterpret_cast<const float*>(points);
+    __m128 pMin = _mm_setr_ps(src[0], src[1], src[0], src[1]);
+    __m128 pMax = pMin;
+    Int j = 1;
+    for (; j + 2 <= count; j += 2) {
+        __m128 p = _mm_loadu_ps(src + 2 * j);
+        pMin = _mm_min_ps(pMin, p);
+        pMax = _mm_max_ps(pMax, p);
+    }
+    if (j < count) {
+        __m128 p = _mm_setr_ps(src[2 * j], src[2 * j + 1], src[0], src[1]);
+        pMin = _mm_min_ps(pMin, p);
+        pMax = _mm_max_ps(pMax, p);
+    }
+    pMin = _mm_min_ps(pMin, _mm_movehl_ps(pMin, pMin));
+    pMax = _mm_max_ps(pMax, _mm_movehl_ps(pMax, pMax));
+    float res[8];
+    _mm_storeu_ps(res, pMin);
+    _mm_storeu_ps(res + 4, pMax);
+    return Rect2f(Vec2f(res[0], res[1]), Vec2f(res[4], res[5]));
+#else
+    Vec2f pMin = points[0];
+    Vec2f pMax = points[0];
+    for (Int j = 1; j < count; ++j) {
+        const Vec2f& p = points[j];
+        pMin[0] = (std::min)(pMin[0], p[0]);
+        pMin[1] = (std::min)(pMin[1], p[1]);
+        pMax[0] = (std::max)(pMax[0], p[0]);
+        pMax[1] = (std::max)(pMax[1], p[1]);
+    }
+    return Rect2f(pMin, pMax);
+#endif
+}
+
+Rect2d boundingRect(const Vec2dSoA& points) {
+    Int count = points.length();
+    if (count == 0) {
+        return Rect2d::empty;
+    }
+    double xMin, xMax, yMin, yMax;
+    minMax(points.xData(), count, xMin, xMax);
+    minMax(points.yData(), count, yMin, yMax);
+    return Rect2d(xMin, yMin, xMax, yMax);
+}
+
+Int containsPoints(
+    const Rect2d& rect,
+    const Vec2d* points,
+    Int count,
+    bool* isContained) {
+
+    return containsPoints_(
+        rect.xMin(), rect.yMin(), rect.xMax(), rect.yMax(), points, count, isContained);
+}
+
+Int containsPoints(
+    const Rect2f& rect,
+    const Vec2f* points,
+    Int count,
+    bool* isContained) {
+
+    return containsPoints_(
+        rect.xMin(), rect.yMin(), rect.xMax(), rect.yMax(), points, count, isContained);
+}
+
+Int containsPoints(const Rect2d& rect, const Vec2dSoA& points, bool* isContained) {
+    double xMin = rect.xMin();
+    double yMin = rect.yMin();
+    double xMax = rect.xMax();
+    double yMax = rect.yMax();
+    const double* xs = points.xData();
+    const double* ys = points.yData();
+    Int count = points.length();
+    Int res = 0;
+    for (Int j = 0; j < count; ++j) {
+        double x = xs[j];
+        double y = ys[j];
+        bool b = (x <= xMax) & (y <= yMax) & (xMin <= x) & (yMin <= y);
+        isContained[j] = b;
+        res += b;
+    }
+    return res;
+}
+
+} // namespace vgc::geometry
@@ -0,0 +1,196 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VGC_GEOMETRY_POINTS_H
+#define VGC_GEOMETRY_POINTS_H
+
+/// \file vgc/geometry/points.h
+/// \brief Batch operations on arrays of 2D points.
+///
+/// The functions in this file are equivalent to loops calling the
+/// corresponding per-point operations, such as `Mat3d::transformPoint()` or
+/// `Rect2d::uniteWith()`, but are significantly faster on large arrays of
+/// points. Where available, they are implemented using SIMD instructions.
+///
+/// Note that the results may differ from the per-point operations by a few
+/// ulps, since the order of floating point operations may differ.
+///
+
+#include <vgc/core/array.h>
+#include <vgc/geometry/api.h>
+#include <vgc/geometry/mat3d.h>
+#include <vgc/geometry/mat3f.h>
+#include <vgc/geometry/mat4f.h>
+#include <vgc/geometry/rect2d.h>
+#include <vgc/geometry/rect2f.h>
+#include <vgc/geometry/vec2d.h>
+#include <vgc/geometry/vec2dsoa.h>
+#include <vgc/geometry/vec2f.h>
+
+namespace vgc::geometry {
+
+/// Transforms the `count` points starting at `in` by the given matrix, and
+/// writes the results to the `count` points starting at `out`.
+///
+/// This is equivalent to `out[i] = m.transformPoint(in[i])` for all `i`. If
+/// the last row of the matrix is `[0, 0, 1]`, this automatically uses the
+/// faster `transformPointsAffine()`.
+///
+/// The input and output can be the same array, but must not otherwise
+/// overlap.
+///
+VGC_GEOMETRY_API
+void transformPoints(const Mat3d& m, const Vec2d* in, Vec2d* out, Int count);
+
+/// \overload
+///
+VGC_GEOMETRY_API
+void transformPoints(const Mat3f& m, const Vec2f* in, Vec2f* out, Int count);
+
+/// \overload
+///
+/// The points are interpreted as 3D points with `z = 0`, and the resulting
+/// `z` coordinates are ignored. The matrix is considered affine if its last
+/// row is `[0, 0, 0, 1]`.
+///
+VGC_GEOMETRY_API
+void transformPoints(const Mat4f& m, const Vec2f* in, Vec2f* out, Int count);
+
+/// Transforms in place all the points of the given array by the given matrix.
+///
+inline void transformPoints(const Mat3d& m, Vec2dArray& points) {
+    transformPoints(m, points.data(), points.data(), points.length());
+}
+
+/// \overload
+///
+inline void transformPoints(const Mat3f& m, Vec2fArray& points) {
+    transformPoints(m, points.data(), points.data(), points.length());
+}
+
+/// \overload
+///
+inline void transformPoints(const Mat4f& m, Vec2fArray& points) {
+    transformPoints(m, points.data(), points.data(), points.length());
+}
+
+/// \overload
+///
+/// The `Vec2dSoA` layout makes it possible to process several points per SIMD
+/// instruction without shuffling coordinates, which is typically faster than
+/// the `Vec2dArray` overload.
+///
+VGC_GEOMETRY_API
+void transformPoints(const Mat3d& m, Vec2dSoA& points);
+
+/// Transforms the `count` points starting at `in` by the given matrix
+/// interpreted as an affine transformation, and writes the results to the
+/// `count` points starting at `out`.
+///
+/// This is equivalent to `out[i] = m.transformPointAffine(in[i])` for all
+/// `i`.
+///
+/// The input and output can be the same array, but must not otherwise
+/// overlap.
+///
+VGC_GEOMETRY_API
+void transformPointsAffine(const Mat3d& m, const Vec2d* in, Vec2d* out, Int count);
+
+/// \overload
+///
+VGC_GEOMETRY_API
+void transformPointsAffine(const Mat3f& m, const Vec2f* in, Vec2f* out, Int count);
+
+/// \overload
+///
+VGC_GEOMETRY_API
+void transformPointsAffine(const Mat4f& m, const Vec2f* in, Vec2f* out, Int count);
+
+/// Transforms in place all the points of the given array by the given matrix
+/// interpreted as an affine transformation.
+///
+inline void transformPointsAffine(const Mat3d& m, Vec2dArray& points) {
+    transformPointsAffine(m, points.data(), points.data(), points.length());
+}
+
+/// \overload
+///
+inline void transformPointsAffine(const Mat3f& m, Vec2fArray& points) {
+    transformPointsAffine(m, points.data(), points.data(), points.length());
+}
+
+/// \overload
+///
+inline void transformPointsAffine(const Mat4f& m, Vec2fArray& points) {
+    transformPointsAffine(m, points.data(), points.data(), points.length());
+}
+
+/// \overload
+///
+VGC_GEOMETRY_API
+void transformPointsAffine(const Mat3d& m, Vec2dSoA& points);
+
+/// Returns the smallest rectangle containing the `count` points starting at
+/// `points`, or `Rect2d::empty` if `count` is zero.
+///
+VGC_GEOMETRY_API
+Rect2d boundingRect(const Vec2d* points, Int count);
+
+/// \overload
+///
+VGC_GEOMETRY_API
+Rect2f boundingRect(const Vec2f* points, Int count);
+
+/// Returns the smallest rectangle containing all the points of the given
+/// array, or `Rect2d::empty` if the array is empty.
+///
+inline Rect2d boundingRect(const Vec2dArray& points) {
+    return boundingRect(points.data(), points.length());
+}
+
+/// \overload
+///
+inline Rect2f boundingRect(const Vec2fArray& points) {
+    return boundingRect(points.data(), points.length());
+}
+
+/// \overload
+///
+VGC_GEOMETRY_API
+Rect2d boundingRect(const Vec2dSoA& points);
+
+/// Sets `isContained[i]` to whether `rect.contains(points[i])` for all the
+/// `count` points starting at `points`, and returns the number of contained
+/// points.
+///
+VGC_GEOMETRY_API
+Int containsPoints(const Rect2d& rect, const Vec2d* points, Int count, bool* isContained);
+
+/// \overload
+///
+VGC_GEOMETRY_API
+Int containsPoints(const Rect2f& rect, const Vec2f* points, Int count, bool* isContained);
+
+/// Sets `isContained[i]` to whether `rect.contains(points[i])` for all the
+/// points of the given `Vec2dSoA`, and returns the number of contained
+/// points.
+///
+VGC_GEOMETRY_API
+Int containsPoints(const Rect2d& rect, const Vec2dSoA& points, bool* isContained);
+
+} // namespace vgc::geometry
+
+#endif // VGC_GEOMETRY_POINTS_H
@@ -0,0 +1,354 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vgc/geometry/polygontriangulator.h>
+
+#include <algorithm> // sort, unique, max, min
+#include <numeric>   // iota
+#include <utility>   // swap
+
+namespace vgc::geometry {
+
+namespace {
+
+// Returns a positive value if (p, q, r) is counterclockwise, a negative
+// value if it is clockwise, and zero if the three points are aligned.
+//
+double orientation(const Vec2d& p, const Vec2d& q, const Vec2d& r) {
+    return (q - p).det(r - p);
+}
+
+bool hasOppositeSigns(double a, double b) {
+    return (a > 0 && b < 0) || (a < 0 && b > 0);
+}
+
+bool isInside(Int winding, WindingRule windingRule) {
+    if (windingRule == WindingRule::NonZero) {
+        return winding != 0;
+    }
+    else { // if (windingRule == WindingRule::EvenOdd)
+        return (winding % 2) != 0;
+    }
+}
+
+} // namespace
+
+PolygonTriangulator::PolygonTriangulator() {
+}
+
+void PolygonTriangulator::clear() {
+    points_.clear();
+    contourEnds_.clear();
+    vertices_.clear();
+    indices_.clear();
+}
+
+void PolygonTriangulator::addContour(const Vec2d* points, Int numPoints) {
+    if (numPoints < 3) {
+        return;
+    }
+    for (Int i = 0; i < numPoints; ++i) {
+        points_.append(points[i]);
+    }
+    contourEnds_.append(points_.length());
+}
+
+void PolygonTriangulator::triangulate(WindingRule windingRule) {
+    vertices_.clear();
+    indices_.clear();
+    computeEdges_();
+    splitAtIntersections_();
+    sweep_(windingRule);
+}
+
+void PolygonTriangulator::computeEdges_() {
+    // Note: horizontal edges are ignored since they don't change the winding
+    // number of any horizontal interval.
+    edges_.clear();
+    Int contourStart = 0;
+    for (Int contourEnd : contourEnds_) {
+        for (Int i = contourStart; i < contourEnd; ++i) {
+            const Vec2d& p = points_[i];
+            const Vec2d& q = points_[(i + 1 < contourEnd) ? i + 1 : contourStart];
+            if (p.y() < q.y()) {
+                edges_.append({p, q, 1});
+            }
+            else if (p.y() > q.y()) {
+                edges_.append({q, p, -1});
+            }
+        }
+        contourStart = contourEnd;
+    }
+}
+
+void PolygonTriangulator::splitAtIntersections_() {
+    Int numEdges = edges_.length();
+    sortEdges_();
+
+    // Sweep a horizontal line upward, maintaining the list of edges crossing
+    // the line, and test each new edge against these edges.
+    splitPoints_.clear();
+    activeEdges_.clear();
+    for (Int i : sortedEdges_) {
+        double y = edges_[i].a.y();
+        activeEdges_.removeIf([this, y](Int j) { return edges_[j].b.y() <= y; });
+        for (Int j : activeEdges_) {
+            addSplitPoints_(i, j);
+        }
+        activeEdges_.append(i);
+    }
+    if (splitPoints_.isEmpty()) {
+        return;
+    }
+
+    // Split edges
+    std::sort(
+        splitPoints_.begin(),
+        splitPoints_.end(),
+        [](const SplitPoint& p1, const SplitPoint& p2) {
+            return p1.edge < p2.edge
+                   || (p1.edge == p2.edge && p1.position.y() < p2.position.y());
+        });
+    splitEdges_.clear();
+    auto splitPoint = splitPoints_.begin();
+    for (Int i = 0; i < numEdges; ++i) {
+        const Edge& edge = edges_[i];
+        Vec2d a = edge.a;
+        for (; splitPoint != splitPoints_.end() && splitPoint->edge == i; ++splitPoint) {
+            const Vec2d& p = splitPoint->position;
+            if (p.y() > a.y() && p.y() < edge.b.y()) {
+                splitEdges_.append({a, p, edge.winding});
+                a = p;
+            }
+        }
+        splitEdges_.append({a, edge.b, edge.winding});
+    }
+    std::swap(edges_, splitEdges_);
+    sortEdges_();
+}
+
+// Sorts edges by increasing minimum y.
+//
+void PolygonTriangulator::sortEdges_() {
+    sortedEdges_.resize(edges_.length());
+    std::iota(sortedEdges_.begin(), sortedEdges_.end(), Int(0));
+    std::sort(sortedEdges_.begin(), sortedEdges_.end(), [this](Int i, Int j) {
+        return edges_[i].a.y() < edges_[j].a.y();
+    });
+}
+
+// Adds the split points of the edges i and j, if they intersect. Note that
+// if an endpoint of an edge lies in the interior of the other edge, we split
+// the other edge at this endpoint. This ensures that after splitting, edges
+// never intersect except at their endpoints.
+//
+void PolygonTriangulator::addSplitPoints_(Int i, Int j) {
+    const Edge& e = edges_[i];
+    const Edge& f = edges_[j];
+    if ((std::max)(e.a.x(), e.b.x()) < (std::min)(f.a.x(), f.b.x())
+        || (std::max)(f.a.x(), f.b.x()) < (std::min)(e.a.x(), e.b.x())) {
+        return;
+    }
+    double d1 = orientation(f.a, f.b, e.a);
+    double d2 = orientation(f.a, f.b, e.b);
+    double d3 = orientation(e.a, e.b, f.a);
+    double d4 = orientation(e.a, e.b, f.b);
+    if (hasOppositeSigns(d1, d2) && hasOppositeSigns(d3, d4)) {
+        double t = d1 / (d1 - d2);
+        Vec2d p = e.a + t * (e.b - e.a);
+        splitPoints_.append({i, p});
+        splitPoints_.append({j, p});
+        return;
+    }
+    auto isInterior = [](const Edge& edge, const Vec2d& p) {
+        return p.y() > edge.a.y() && p.y() < edge.b.y();
+    };
+    if (d1 == 0 && isInterior(f, e.a)) {
+        splitPoints_.append({j, e.a});
+    }
+    if (d2 == 0 && isInterior(f, e.b)) {
+        splitPoints_.append({j, e.b});
+    }
+    if (d3 == 0 && isInterior(e, f.a)) {
+        splitPoints_.append({i, f.a});
+    }
+    if (d4 == 0 && isInterior(e, f.b)) {
+        splitPoints_.append({i, f.b});
+    }
+}
+
+void PolygonTriangulator::sweep_(WindingRule windingRule) {
+    // Compute the y-coordinates of all vertices, called levels. Between two
+    // consecutive levels, the edges crossing the horizontal strip (or
+    // "slab") never intersect, so their left-to-right order is well-defined.
+    Int numEdges = edges_.length();
+    levels_.clear();
+    for (const Edge& edge : edges_) {
+        levels_.append(edge.a.y());
+        levels_.append(edge.b.y());
+    }
+    std::sort(levels_.begin(), levels_.end());
+    levels_.erase(std::unique(levels_.begin(), levels_.end()), levels_.end());
+
+    activeEdges_.clear();
+    trapezoids_.clear();
+    trapezoidByLeftEdge_.clear();
+    trapezoidByLeftEdge_.resize(numEdges, -1);
+    Int nextEdge = 0;
+    Int numLevels = levels_.length();
+    for (Int level = 0; level + 1 < numLevels; ++level) {
+        double y = levels_[level];
+        double ym = 0.5 * (y + levels_[level + 1]);
+
+        // Update the list of edges crossing the slab, and sort it from left
+        // to right. This order rarely changes from one slab to the next, so
+        // an insertion sort is close to linear here.
+        activeEdges_.removeIf([this, y](Int i) { return edges_[i].b.y() <= y; });
+        while (nextEdge < numEdges && edges_[sortedEdges_[nextEdge]].a.y() <= y) {
+            activeEdges_.append(sortedEdges_[nextEdge]);
+            ++nextEdge;
+        }
+        Int numActiveEdges = activeEdges_.length();
+        activeEdgeXs_.resize(numActiveEdges);
+        for (Int k = 0; k < numActiveEdges; ++k) {
+            Int i = activeEdges_[k];
+            double x = xAt_(i, ym);
+            Int j = k;
+            for (; j > 0 && activeEdgeXs_[j - 1] > x; --j) {
+                activeEdges_[j] = activeEdges_[j - 1];
+                activeEdgeXs_[j] = activeEdgeXs_[j - 1];
+            }
+            activeEdges_[j] = i;
+            activeEdgeXs_[j] = x;
+        }
+
+        // Compute the inside intervals of the slab, and either continue the
+        // trapezoid of the previous slab bounded by the same edges, or
+        // start a new trapezoid.
+        nextTrapezoids_.clear();
+        Int winding = 0;
+        Int left = -1;
+        for (Int i : activeEdges_) {
+            bool wasInside = isInside(winding, windingRule);
+            winding += edges_[i].winding;
+            bool isInsideNow = isInside(winding, windingRule);
+            if (!wasInside && isInsideNow) {
+                left = i;
+            }
+            else if (wasInside && !isInsideNow) {
+                Int k = trapezoidByLeftEdge_[left];
+                if (k != -1 && trapezoids_[k].right == i) {
+                    nextTrapezoids_.append(trapezoids_[k]);
+                    trapezoids_[k].startLevel = -1; // mark as continued
+                }
+                else {
+                    nextTrapezoids_.append({left, i, level, -1, -1});
+                }
+            }
+        }
+
+        // Emit the trapezoids of the previous slab which are not continued,
+        // then add the bottom vertices of the new trapezoids. Both are
+        // processed from left to right, so vertices at the same position can
+        // be shared by only comparing them with their neighbors.
+        Int firstVertex = vertices_.length();
+        for (const Trapezoid& t : trapezoids_) {
+            trapezoidByLeftEdge_[t.left] = -1;
+            if (t.startLevel != -1) {
+                emitTrapezoid_(t, level, firstVertex);
+            }
+        }
+        Int firstNewVertex = vertices_.length();
+        Int k = firstVertex;
+        auto addBottomVertex = [&](Int edge) {
+            Vec2d v(xAt_(edge, y), y);
+            while (k < firstNewVertex && vertices_[k].x() < v.x()) {
+                ++k;
+            }
+            if (k < firstNewVertex && vertices_[k] == v) {
+                return k;
+            }
+            return addVertex_(v, firstNewVertex);
+        };
+        for (Trapezoid& t : nextTrapezoids_) {
+            if (t.startLevel == level) {
+                t.bottomLeft = addBottomVertex(t.left);
+                t.bottomRight = addBottomVertex(t.right);
+            }
+        }
+        std::swap(trapezoids_, nextTrapezoids_);
+        for (Int i = 0; i < trapezoids_.length(); ++i) {
+            trapezoidByLeftEdge_[trapezoids_[i].left] = i;
+        }
+    }
+
+    // Emit the remaining trapezoids
+    Int firstVertex = vertices_.length();
+    for (const Trapezoid& t : trapezoids_) {
+        emitTrapezoid_(t, numLevels - 1, firstVertex);
+    }
+}
+
+void PolygonTriangulator::emitTrapezoid_(
+    const Trapezoid& t,
+    Int endLevel,
+    Int firstVertex) {
+
+    double y = levels_[endLevel];
+    Int a = t.bottomLeft;
+    Int b = t.bottomRight;
+    Int d = addVertex_(Vec2d(xAt_(t.left, y), y), firstVertex);
+    Int c = addVertex_(Vec2d(xAt_(t.right, y), y), firstVertex);
+    bool hasBottom = a != b;
+    bool hasTop = c != d;
+    if (hasBottom && hasTop) {
+        indices_.extend({a, b, c, a, c, d});
+    }
+    else if (hasBottom) {
+        indices_.extend({a, b, c});
+    }
+    else if (hasTop) {
+        indices_.extend({a, c, d});
+    }
+}
+
+// Appends the given vertex and returns its index, unless it is equal to the
+// last vertex and the last vertex has an index greater or equal than
+// firstVertex, in which case the index of the last vertex is returned.
+//
+Int PolygonTriangulator::addVertex_(const Vec2d& v, Int firstVertex) {
+    Int n = vertices_.length();
+    if (n > firstVertex && vertices_.last() == v) {
+        return n - 1;
+    }
+    vertices_.append(v);
+    return n;
+}
+
+double PolygonTriangulator::xAt_(Int edge, double y) const {
+    const Edge& e = edges_[edge];
+    if (y <= e.a.y()) {
+        return e.a.x();
+    }
+    else if (y >= e.b.y()) {
+        return e.b.x();
+    }
+    else {
+        return e.a.x() + (y - e.a.y()) * (e.b.x() - e.a.x()) / (e.b.y() - e.a.y());
+    }
+}
+
+} // namespace vgc::geometry
@@ -0,0 +1,169 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VGC_GEOMETRY_POLYGONTRIANGULATOR_H
+#define VGC_GEOMETRY_POLYGONTRIANGULATOR_H
+
+#include <vgc/core/array.h>
+#include <vgc/geometry/api.h>
+#include <vgc/geometry/vec2d.h>
+
+namespace vgc::geometry {
+
+/// \enum vgc::geometry::WindingRule
+/// \brief Specifies which regions of a polygon with several or
+///        self-intersecting contours are considered inside.
+///
+/// The winding number of a point is the number of times the contours wind
+/// around this point, counting counterclockwise turns as positive and
+/// clockwise turns as negative.
+///
+enum class WindingRule {
+
+    /// A point is inside if its winding number is non-zero.
+    ///
+    NonZero,
+
+    /// A point is inside if its winding number is odd.
+    ///
+    EvenOdd
+};
+
+/// \class vgc::geometry::PolygonTriangulator
+/// \brief Computes triangulations of polygons with arbitrary contours.
+///
+/// This class computes a triangulation of the interior of a polygon made of
+/// one or several closed contours, which may intersect each other or
+/// self-intersect, according to a given `WindingRule`.
+///
+/// ```cpp
+/// PolygonTriangulator triangulator;
+/// triangulator.addContour(outerContour);
+/// triangulator.addContour(hole);
+/// triangulator.triangulate(WindingRule::NonZero);
+/// const Vec2dArray& vertices = triangulator.vertices();
+/// const core::IntArray& indices = triangulator.indices(); // triplets
+/// ```
+///
+/// The algorithm first splits the edges at their intersections, then sweeps
+/// a horizontal line through the polygon, decomposing its interior into
+/// trapezoids bounded by two edges, each of which is output as two triangles
+/// (or one triangle if degenerate). Consecutive trapezoids bounded by the
+/// same pair of edges are merged, so that no vertex lies in the middle of an
+/// edge of another triangle, except along horizontal lines through vertices.
+///
+/// All computations are performed in double precision. The memory used
+/// during the computation is kept between calls, so it is recommended to
+/// reuse the same `PolygonTriangulator` to triangulate many polygons, for
+/// example the glyphs of a font, rather than creating a new one each time.
+///
+class VGC_GEOMETRY_API PolygonTriangulator {
+public:
+    /// Creates a `PolygonTriangulator` with no contours.
+    ///
+    PolygonTriangulator();
+
+    /// Removes all contours and triangles, but keeps the allocated memory for
+    /// future use.
+    ///
+    void clear();
+
+    /// Adds a closed contour, given as a sequence of `numPoints` points. The
+    /// last point is implicitly connected to the first point.
+    ///
+    void addContour(const Vec2d* points, Int numPoints);
+
+    /// \overload
+    ///
+    void addContour(const Vec2dArray& points) {
+        addContour(points.data(), points.length());
+    }
+
+    /// Computes the triangulation of the contours added so far, according to
+    /// the given `windingRule`. The result can be accessed via `vertices()`
+    /// and `indices()`.
+    ///
+    void triangulate(WindingRule windingRule);
+
+    /// Returns the vertices of the triangulation, without duplicates.
+    ///
+    const Vec2dArray& vertices() const {
+        return vertices_;
+    }
+
+    /// Returns the triangles of the triangulation, as triplets of indices
+    /// into `vertices()`.
+    ///
+    const core::IntArray& indices() const {
+        return indices_;
+    }
+
+private:
+    // Non-horizontal edge, with a.y() < b.y(). The winding is +1 if the edge
+    // goes upward in its contour, and -1 otherwise.
+    struct Edge {
+        Vec2d a;
+        Vec2d b;
+        Int winding;
+    };
+
+    // Edge split point, and trapezoid currently being swept, with the
+    // indices of its bottom vertices
+    struct SplitPoint {
+        Int edge;
+        Vec2d position;
+    };
+    struct Trapezoid {
+        Int left;
+        Int right;
+        Int startLevel;
+        Int bottomLeft;
+        Int bottomRight;
+    };
+
+    // Input
+    Vec2dArray points_;
+    core::IntArray contourEnds_;
+
+    // Output
+    Vec2dArray vertices_;
+    core::IntArray indices_;
+
+    // Scratch memory, kept between calls
+    core::Array<Edge> edges_;
+    core::Array<Edge> splitEdges_;
+    core::Array<SplitPoint> splitPoints_;
+    core::IntArray sortedEdges_;
+    core::IntArray activeEdges_;
+    core::DoubleArray activeEdgeXs_;
+    core::DoubleArray levels_;
+    core::Array<Trapezoid> trapezoids_;
+    core::Array<Trapezoid> nextTrapezoids_;
+    core::IntArray trapezoidByLeftEdge_;
+
+    void computeEdges_();
+    void splitAtIntersections_();
+    void addSplitPoints_(Int i, Int j);
+    void sortEdges_();
+    void sweep_(WindingRule windingRule);
+    void emitTrapezoid_(const Trapezoid& t, Int endLevel, Int firstVertex);
+    Int addVertex_(const Vec2d& v, Int firstVertex);
+    double xAt_(Int edge, double y) const;
+};
+
+} // namespace vgc::geometry
+
+#endif // VGC_GEOMETRY_POLYGONTRIANGULATOR_H
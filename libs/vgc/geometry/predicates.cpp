@@ -0,0 +1,393 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vgc/geometry/predicates.h>
+
+#include <algorithm> // copy
+#include <cmath>     // abs, fma
+#include <limits>    // epsilon
+#include <memory>    // unique_ptr
+
+namespace vgc::geometry {
+
+namespace {
+
+// Computes x and y such that x + y = a + b exactly, where x is the floating
+// point approximation of a + b. See:
+//
+// Jonathan Richard Shewchuk. Adaptive Precision Floating-Point Arithmetic
+// and Fast Robust Geometric Predicates. Discrete & Computational Geometry,
+// 18(3):305-363, 1997.
+//
+void twoSum(double a, double b, double& x, double& y) {
+    x = a + b;
+    double bVirtual = x - a;
+    double aVirtual = x - bVirtual;
+    double bRoundoff = b - bVirtual;
+    double aRoundoff = a - aVirtual;
+    y = aRoundoff + bRoundoff;
+}
+
+// Adds the value b to the expansion e of length n, that is, a sequence of
+// non-overlapping floating point values sorted by increasing magnitude whose
+// exact sum is the represented value. The length of e must be at least n + 1.
+// Returns the new length of e.
+//
+Int growExpansion(double* e, Int n, double b) {
+    double q = b;
+    for (Int i = 0; i < n; ++i) {
+        double h;
+        twoSum(q, e[i], q, h);
+        e[i] = h;
+    }
+    e[n] = q;
+    return n + 1;
+}
+
+// Adds the product a * b to the expansion e of length n, and returns the new
+// length of e. The length of e must be at least n + 2.
+//
+Int growExpansionWithProduct(double* e, Int n, double a, double b) {
+    double p = a * b;
+    double error = std::fma(a, b, -p); // exact since p is the rounded a * b
+    n = growExpansion(e, n, error);
+    return growExpansion(e, n, p);
+}
+
+int orientationSignExact(const Vec2d& a, const Vec2d& b, const Vec2d& c) {
+
+    // det(b - a, c - a) = (bx - ax)(cy - ay) - (by - ay)(cx - ax)
+    //                   = bx cy - bx ay - ax cy - by cx + by ax + ay cx
+    //
+    double e[12];
+    Int n = 0;
+    n = growExpansionWithProduct(e, n, b.x(), c.y());
+    n = growExpansionWithProduct(e, n, -b.x(), a.y());
+    n = growExpansionWithProduct(e, n, -a.x(), c.y());
+    n = growExpansionWithProduct(e, n, -b.y(), c.x());
+    n = growExpansionWithProduct(e, n, b.y(), a.x());
+    n = growExpansionWithProduct(e, n, a.y(), c.x());
+
+    // The sign of an expansion is the sign of its largest non-zero component
+    for (Int i = n - 1; i >= 0; --i) {
+        if (e[i] > 0) {
+            return 1;
+        }
+        else if (e[i] < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// An exact representation of a real number as an expansion, which is
+// dynamically resized and does not store zero components.
+//
+// Small expansions, which are the most common since zero components are
+// eliminated, are stored inline to avoid dynamic allocations.
+//
+class Expansion {
+public:
+    // Creates an Expansion representing zero.
+    //
+    Expansion() {
+    }
+
+    Expansion(const Expansion& other) {
+        reserve_(other.size_);
+        std::copy(other.data_, other.data_ + other.size_, data_);
+        size_ = other.size_;
+    }
+
+    Expansion& operator=(const Expansion& other) = delete;
+
+    // Creates an Expansion representing exactly a - b.
+    //
+    static Expansion difference(double a, double b) {
+        double x;
+        double y;
+        twoSum(a, -b, x, y);
+        Expansion res;
+        res.grow_(y);
+        res.grow_(x);
+        return res;
+    }
+
+    Expansion operator+(const Expansion& other) const {
+        Expansion res(*this);
+        res.reserve_(size_ + other.size_);
+        for (Int i = 0; i < other.size_; ++i) {
+            res.grow_(other.data_[i]);
+        }
+        return res;
+    }
+
+    Expansion operator-(const Expansion& other) const {
+        Expansion res(*this);
+        res.reserve_(size_ + other.size_);
+        for (Int i = 0; i < other.size_; ++i) {
+            res.grow_(-other.data_[i]);
+        }
+        return res;
+    }
+
+    Expansion operator*(const Expansion& other) const {
+        Expansion res;
+        res.reserve_(2 * size_ * other.size_);
+        for (Int i = 0; i < size_; ++i) {
+            for (Int j = 0; j < other.size_; ++j) {
+                double a = data_[i];
+                double b = other.data_[j];
+                double p = a * b;
+                res.grow_(std::fma(a, b, -p));
+                res.grow_(p);
+            }
+        }
+        return res;
+    }
+
+    // Returns the sign of the represented value, which is the sign of its
+    // largest component.
+    //
+    int sign() const {
+        if (size_ == 0) {
+            return 0;
+        }
+        return data_[size_ - 1] > 0 ? 1 : -1;
+    }
+
+private:
+    static constexpr Int inlineCapacity_ = 16;
+    double inlineData_[inlineCapacity_];
+    std::unique_ptr<double[]> heapData_;
+    double* data_ = inlineData_;
+    Int size_ = 0;
+    Int capacity_ = inlineCapacity_;
+
+    void reserve_(Int capacity) {
+        if (capacity > capacity_) {
+            std::unique_ptr<double[]> newData(new double[capacity]);
+            std::copy(data_, data_ + size_, newData.get());
+            heapData_ = std::move(newData);
+            data_ = heapData_.get();
+            capacity_ = capacity;
+        }
+    }
+
+    // Same as growExpansion(), but eliminates zero components.
+    //
+    void grow_(double b) {
+        reserve_(size_ + 1);
+        double q = b;
+        Int k = 0;
+        for (Int i = 0; i < size_; ++i) {
+            double h;
+            twoSum(q, data_[i], q, h);
+            if (h != 0) {
+                data_[k++] = h;
+            }
+        }
+        if (q != 0) {
+            data_[k++] = q;
+        }
+        size_ = k;
+    }
+};
+
+// A floating point approximation of a real number, together with the
+// magnitude of the expression used to compute it, that is, the same
+// expression where all the subtractions are replaced by additions and all
+// the operands by their absolute values.
+//
+// The rounding error of an expression with at most 16 levels of operations
+// is bounded by `errorBoundFactor * magnitude`. See for example: Higham,
+// Accuracy and Stability of Numerical Algorithms, Section 3.1.
+//
+struct BoundedDouble {
+    double value = 0;
+    double magnitude = 0;
+
+    static constexpr double errorBoundFactor =
+        32 * std::numeric_limits<double>::epsilon();
+
+    static BoundedDouble difference(double a, double b) {
+        double d = a - b;
+        return {d, std::abs(d)};
+    }
+
+    BoundedDouble operator+(const BoundedDouble& other) const {
+        return {value + other.value, magnitude + other.magnitude};
+    }
+
+    BoundedDouble operator-(const BoundedDouble& other) const {
+        return {value - other.value, magnitude + other.magnitude};
+    }
+
+    BoundedDouble operator*(const BoundedDouble& other) const {
+        return {value * other.value, magnitude * other.magnitude};
+    }
+};
+
+// Returns the exact sign of the given expression, which must be a generic
+// callable taking a zero-initialized number type as argument, and computing
+// its result from differences of input coordinates using this number type.
+//
+// The expression is first evaluated with floating point arithmetic, and
+// only evaluated again with exact arithmetic if the sign of the result
+// cannot be determined from its error bound.
+//
+template<typename Expression>
+int filteredSign(Expression expression) {
+    BoundedDouble x = expression(BoundedDouble());
+    double errorBound = BoundedDouble::errorBoundFactor * x.magnitude;
+    if (x.value > errorBound) {
+        return 1;
+    }
+    else if (x.value < -errorBound) {
+        return -1;
+    }
+    else {
+        return expression(Expansion()).sign();
+    }
+}
+
+// Computes det(b - a, d - c).
+//
+template<typename T>
+T directionDeterminant(const Vec2d& a, const Vec2d& b, const Vec2d& c, const Vec2d& d) {
+    return T::difference(b.x(), a.x()) * T::difference(d.y(), c.y())
+           - T::difference(b.y(), a.y()) * T::difference(d.x(), c.x());
+}
+
+// The intersection point of the lines (a, b) and (c, d) is a + (n / d) (b -
+// a), where d = det(b - a, d - c) and n = det(c - a, d - c).
+//
+template<typename T>
+T intersectionNumerator(const Vec2d& a, const Vec2d& c, const Vec2d& d) {
+    return directionDeterminant<T>(a, c, c, d);
+}
+
+} // namespace
+
+int orientationSign(const Vec2d& a, const Vec2d& b, const Vec2d& c) {
+    double left = (b.x() - a.x()) * (c.y() - a.y());
+    double right = (b.y() - a.y()) * (c.x() - a.x());
+    double det = left - right;
+
+    // Bound on the rounding error of det, see Shewchuk's ccwerrboundA
+    constexpr double epsilon = 0.5 * std::numeric_limits<double>::epsilon();
+    constexpr double errorBoundFactor = (3.0 + 16.0 * epsilon) * epsilon;
+    double errorBound = errorBoundFactor * (std::abs(left) + std::abs(right));
+    if (det > errorBound) {
+        return 1;
+    }
+    else if (det < -errorBound) {
+        return -1;
+    }
+    else {
+        return orientationSignExact(a, b, c);
+    }
+}
+
+int directionOrientationSign(
+    const Vec2d& a,
+    const Vec2d& b,
+    const Vec2d& c,
+    const Vec2d& d) {
+
+    return filteredSign([&](auto zero) {
+        using T = decltype(zero);
+        return directionDeterminant<T>(a, b, c, d);
+    });
+}
+
+int intersectionOrientationSign(
+    const Vec2d& p,
+    const Vec2d& q,
+    const Vec2d& a,
+    const Vec2d& b,
+    const Vec2d& c,
+    const Vec2d& d) {
+
+    // det(q - p, x - p) = (det(q - p, a - p) d + n det(q - p, b - a)) / d
+    int s = filteredSign([&](auto zero) {
+        using T = decltype(zero);
+        T den = directionDeterminant<T>(a, b, c, d);
+        T num = intersectionNumerator<T>(a, c, d);
+        return directionDeterminant<T>(p, q, p, a) * den
+               + num * directionDeterminant<T>(p, q, a, b);
+    });
+    return s * directionOrientationSign(a, b, c, d);
+}
+
+int compareIntersection(
+    const Vec2d& a,
+    const Vec2d& b,
+    const Vec2d& c,
+    const Vec2d& d,
+    const Vec2d& p) {
+
+    // x - p = ((a - p) d + n (b - a)) / d
+    int sx = filteredSign([&](auto zero) {
+        using T = decltype(zero);
+        T den = directionDeterminant<T>(a, b, c, d);
+        T num = intersectionNumerator<T>(a, c, d);
+        return T::difference(a.x(), p.x()) * den + num * T::difference(b.x(), a.x());
+    });
+    if (sx == 0) {
+        sx = filteredSign([&](auto zero) {
+            using T = decltype(zero);
+            T den = directionDeterminant<T>(a, b, c, d);
+            T num = intersectionNumerator<T>(a, c, d);
+            return T::difference(a.y(), p.y()) * den
+                   + num * T::difference(b.y(), a.y());
+        });
+    }
+    return sx * directionOrientationSign(a, b, c, d);
+}
+
+int compareIntersections(
+    const Vec2d& a,
+    const Vec2d& b,
+    const Vec2d& c,
+    const Vec2d& d,
+    const Vec2d& e,
+    const Vec2d& f,
+    const Vec2d& g,
+    const Vec2d& h) {
+
+    // x1 - x2 = ((a - e) d1 d2 + n1 d2 (b - a) - n2 d1 (f - e)) / (d1 d2)
+    auto compare = [&](auto coord) {
+        return filteredSign([&](auto zero) {
+            using T = decltype(zero);
+            T d1 = directionDeterminant<T>(a, b, c, d);
+            T n1 = intersectionNumerator<T>(a, c, d);
+            T d2 = directionDeterminant<T>(e, f, g, h);
+            T n2 = intersectionNumerator<T>(e, g, h);
+            return T::difference(coord(a), coord(e)) * d1 * d2
+                   + n1 * d2 * T::difference(coord(b), coord(a))
+                   - n2 * d1 * T::difference(coord(f), coord(e));
+        });
+    };
+    int s = compare([](const Vec2d& v) { return v.x(); });
+    if (s == 0) {
+        s = compare([](const Vec2d& v) { return v.y(); });
+    }
+    s *= directionOrientationSign(a, b, c, d);
+    return s * directionOrientationSign(e, f, g, h);
+}
+
+} // namespace vgc::geometry
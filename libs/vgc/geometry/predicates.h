@@ -0,0 +1,121 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VGC_GEOMETRY_PREDICATES_H
+#define VGC_GEOMETRY_PREDICATES_H
+
+/// \file vgc/geometry/predicates.h
+/// \brief Robust geometric predicates.
+///
+/// Geometric algorithms typically make combinatorial decisions based on the
+/// sign of some expression, for example, whether a point is on the left or on
+/// the right of a line. When computed naively using floating point
+/// arithmetic, the sign may be wrong for nearly degenerate inputs, which may
+/// cause these algorithms to produce inconsistent results, or even to loop
+/// forever.
+///
+/// The predicates in this file always return the exact sign. They first
+/// evaluate the expression with floating point arithmetic together with a
+/// bound on its rounding error, and only fall back to slower exact arithmetic
+/// when the sign cannot be determined from this approximation. Therefore,
+/// they are almost as fast as the naive computation in the vast majority of
+/// cases.
+///
+
+#include <vgc/geometry/api.h>
+#include <vgc/geometry/vec2d.h>
+
+namespace vgc::geometry {
+
+/// Returns `1` if the points `a`, `b`, and `c` are in counterclockwise order,
+/// that is, if `c` is on the left of the directed line from `a` to `b`,
+/// returns `-1` if they are in clockwise order, and returns `0` if they are
+/// exactly aligned.
+///
+/// The returned value is exactly the sign of the determinant of `(b - a, c -
+/// a)`, without any rounding error.
+///
+VGC_GEOMETRY_API
+int orientationSign(const Vec2d& a, const Vec2d& b, const Vec2d& c);
+
+/// Returns `1` if the direction from `c` to `d` is counterclockwise from the
+/// direction from `a` to `b`, returns `-1` if it is clockwise, and returns
+/// `0` if they are exactly parallel.
+///
+/// The returned value is exactly the sign of the determinant of `(b - a, d -
+/// c)`, without any rounding error.
+///
+VGC_GEOMETRY_API
+int directionOrientationSign(
+    const Vec2d& a,
+    const Vec2d& b,
+    const Vec2d& c,
+    const Vec2d& d);
+
+/// Returns the orientation sign of `p`, `q`, and the intersection point of
+/// the lines `(a, b)` and `(c, d)`, as defined in `orientationSign()`.
+///
+/// The intersection point is not computed explicitly, so the returned value
+/// is exact even though this point is typically not representable with
+/// floating point numbers. The lines must not be parallel.
+///
+VGC_GEOMETRY_API
+int intersectionOrientationSign(
+    const Vec2d& p,
+    const Vec2d& q,
+    const Vec2d& a,
+    const Vec2d& b,
+    const Vec2d& c,
+    const Vec2d& d);
+
+/// Compares the intersection point of the lines `(a, b)` and `(c, d)` with
+/// the point `p` in lexicographic order, that is, by x-coordinate then by
+/// y-coordinate. Returns `-1` if the intersection is before `p`, `1` if it is
+/// after `p`, and `0` if they are exactly equal.
+///
+/// The intersection point is not computed explicitly, so the returned value
+/// is exact even though this point is typically not representable with
+/// floating point numbers. The lines must not be parallel.
+///
+VGC_GEOMETRY_API
+int compareIntersection(
+    const Vec2d& a,
+    const Vec2d& b,
+    const Vec2d& c,
+    const Vec2d& d,
+    const Vec2d& p);
+
+/// Compares the intersection point of the lines `(a, b)` and `(c, d)` with
+/// the intersection point of the lines `(e, f)` and `(g, h)` in
+/// lexicographic order. Returns `-1` if the first is before the second, `1`
+/// if it is after, and `0` if they are exactly equal.
+///
+/// The lines of each pair must not be parallel.
+///
+VGC_GEOMETRY_API
+int compareIntersections(
+    const Vec2d& a,
+    const Vec2d& b,
+    const Vec2d& c,
+    const Vec2d& d,
+    const Vec2d& e,
+    const Vec2d& f,
+    const Vec2d& g,
+    const Vec2d& h);
+
+} // namespace vgc::geometry
+
+#endif // VGC_GEOMETRY_PREDICATES_H
@@ -0,0 +1,609 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vgc/geometry/segmentintersector.h>
+
+#include <algorithm>     // sort, swap
+#include <iterator>      // next, prev
+#include <queue>         // priority_queue
+#include <set>           // set
+#include <unordered_set> // unordered_set
+#include <vector>        // vector
+
+#include <vgc/core/algorithm.h>
+#include <vgc/geometry/predicates.h>
+
+namespace vgc::geometry {
+
+namespace {
+
+// Returns whether p is before q in the order of the sweep, that is, by
+// increasing x, then by increasing y.
+//
+bool isBefore(const Vec2d& p, const Vec2d& q) {
+    return p.x() < q.x() || (p.x() == q.x() && p.y() < q.y());
+}
+
+// Returns the parameter t in [0, 1] of the point of the segment (a, b)
+// closest to p.
+//
+double parameter(const Vec2d& a, const Vec2d& b, const Vec2d& p) {
+    Vec2d d = b - a;
+    double l2 = d.squaredLength();
+    return l2 > 0 ? core::clamp((p - a).dot(d) / l2, 0.0, 1.0) : 0.0;
+}
+
+UInt64 pairKey(Int i, Int j) {
+    if (i > j) {
+        std::swap(i, j);
+    }
+    return (static_cast<UInt64>(i) << 32) | static_cast<UInt64>(j);
+}
+
+enum class IntersectionType {
+    None,
+    Crossing, // at a single point interior to both segments
+    Touching  // at an endpoint, or along a collinear overlap
+};
+
+// Computes whether the segments (a, b) and (c, d) intersect, and if so,
+// where. The endpoints of each segment must be in sweep order.
+//
+IntersectionType intersect(
+    const Vec2d& a,
+    const Vec2d& b,
+    const Vec2d& c,
+    const Vec2d& d,
+    Vec2d& position) {
+
+    int o1 = orientationSign(a, b, c);
+    int o2 = orientationSign(a, b, d);
+    int o3 = orientationSign(c, d, a);
+    int o4 = orientationSign(c, d, b);
+    if (o1 * o2 > 0 || o3 * o4 > 0) {
+        return IntersectionType::None;
+    }
+    if (o1 == 0 && o2 == 0) {
+        // Collinear segments: use the start of the overlap, if any
+        const Vec2d& start = isBefore(a, c) ? c : a;
+        const Vec2d& end = isBefore(b, d) ? b : d;
+        if (isBefore(end, start)) {
+            return IntersectionType::None;
+        }
+        position = start;
+        return IntersectionType::Touching;
+    }
+    else if (o1 != 0 && o2 != 0 && o3 != 0 && o4 != 0) {
+        // The denominator may round to zero for nearly parallel segments
+        double d1 = (d - c).det(a - c);
+        double d2 = (d - c).det(b - c);
+        double t = (d1 != d2) ? core::clamp(d1 / (d1 - d2), 0.0, 1.0) : 0.5;
+        position = a + t * (b - a);
+        return IntersectionType::Crossing;
+    }
+    else {
+        position = (o1 == 0) ? c : (o2 == 0) ? d : (o3 == 0) ? a : b;
+        return IntersectionType::Touching;
+    }
+}
+
+struct EndpointEvent {
+    Vec2d point;
+    bool isStart;
+    Int segment;
+};
+
+// A crossing event, located at the intersection point of two segments which
+// cross at a point interior to both.
+//
+struct CrossingEvent {
+    Int segment1;
+    Int segment2;
+};
+
+} // namespace
+
+// The sweep line moves in lexicographic order, that is, as a vertical line
+// moving from left to right, slightly tilted so that it meets points with the
+// same x-coordinate from bottom to top. The status is the set of segments
+// crossing the sweep line, ordered from bottom to top. Two segments are
+// tested for intersection when they become adjacent in the status, and
+// crossing events are scheduled to reorder segments at their intersection.
+//
+// For robustness, the intersection points are never computed explicitly for
+// the purpose of the sweep. Instead, crossing events are represented by their
+// pair of segments, and are ordered using exact predicates. This guarantees
+// that all events are processed in the exact order, and that the status is
+// always exactly sorted.
+//
+class SegmentIntersector::Sweep {
+public:
+    explicit Sweep(SegmentIntersector& intersector)
+        : intersections_(intersector.intersections_)
+        , segments_(intersector.segments_.data())
+        , numSegments_(intersector.segments_.length())
+        , status_(StatusLess{this})
+        , crossings_(CrossingIsAfter{this}) {
+    }
+
+    void run() {
+        handles_.resize(numSegments_);
+        isActive_.resize(numSegments_, false);
+        isInBatch_.resize(numSegments_, false);
+
+        // Sort endpoint events. At the same point, segments are removed
+        // before other segments are inserted.
+        core::Array<EndpointEvent> events;
+        events.reserve(2 * numSegments_);
+        for (Int i = 0; i < numSegments_; ++i) {
+            events.append({segments_[i].p, true, i});
+            events.append({segments_[i].q, false, i});
+        }
+        std::sort(
+            events.begin(),
+            events.end(),
+            [](const EndpointEvent& e1, const EndpointEvent& e2) {
+                if (e1.point != e2.point) {
+                    return isBefore(e1.point, e2.point);
+                }
+                else if (e1.isStart != e2.isStart) {
+                    return e2.isStart;
+                }
+                else {
+                    return e1.segment < e2.segment;
+                }
+            });
+
+        // Process all the events located at the same point as a batch: first
+        // the segments ending at this point are removed, then the segments
+        // crossing at this point are reordered, then the segments starting at
+        // this point are inserted.
+        const EndpointEvent* event = events.begin();
+        const EndpointEvent* eventsEnd = events.end();
+        while (event != eventsEnd || !crossings_.empty()) {
+            bool isCrossing =
+                (event == eventsEnd)
+                || (!crossings_.empty()
+                    && compareCrossing_(crossings_.top(), event->point) < 0);
+            if (isCrossing) {
+                sweepCrossing_ = crossings_.top();
+            }
+            else {
+                sweepCrossing_ = {-1, -1};
+                sweepPoint_ = event->point;
+            }
+            endedSegments_.clear();
+            for (; !isCrossing && event != eventsEnd && event->point == sweepPoint_
+                   && !event->isStart;
+                 ++event) {
+
+                remove_(event->segment);
+            }
+            while (!crossings_.empty() && isAtSweepPoint_(crossings_.top())) {
+                batch_.clear();
+                while (!crossings_.empty() && isAtSweepPoint_(crossings_.top())) {
+                    batch_.append(crossings_.top().segment1);
+                    batch_.append(crossings_.top().segment2);
+                    crossings_.pop();
+                }
+                processCrossings_();
+            }
+            for (; !isCrossing && event != eventsEnd && event->point == sweepPoint_;
+                 ++event) {
+
+                insert_(event->segment);
+            }
+        }
+    }
+
+private:
+    struct StatusEntry {
+        // Mutable since crossing events reorder entries in place, which
+        // preserves the validity of the set since the order also changes.
+        mutable Int segment;
+    };
+
+    struct StatusLess {
+        const Sweep* sweep;
+        bool operator()(const StatusEntry& a, const StatusEntry& b) const {
+            return sweep->isBelow_(a.segment, b.segment);
+        }
+    };
+
+    // Ordering of crossing events such that the top of the priority queue is
+    // the first event of the sweep.
+    //
+    struct CrossingIsAfter {
+        const Sweep* sweep;
+        bool operator()(const CrossingEvent& e1, const CrossingEvent& e2) const {
+            return sweep->compareCrossings_(e1, e2) > 0;
+        }
+    };
+
+    using Status = std::set<StatusEntry, StatusLess>;
+    using StatusIterator = Status::iterator;
+    using CrossingQueue =
+        std::priority_queue<CrossingEvent, std::vector<CrossingEvent>, CrossingIsAfter>;
+
+    core::Array<SegmentIntersection>& intersections_;
+    const Segment* segments_;
+    Int numSegments_;
+    Status status_;
+    CrossingQueue crossings_;
+    core::Array<StatusIterator> handles_;
+    core::Array<bool> isActive_;
+    core::Array<bool> isInBatch_;
+    std::unordered_set<UInt64> intersectingPairs_;
+    Vec2d sweepPoint_;                 // if the sweep point is an endpoint
+    CrossingEvent sweepCrossing_ = {}; // if the sweep point is a crossing
+    Int insertedSegment_ = -1;
+    core::IntArray endedSegments_;
+    core::IntArray batch_;
+    core::Array<StatusIterator> run_;
+    core::IntArray runSegments_;
+
+    // Compares the position of the crossing event e with the point p.
+    //
+    int compareCrossing_(const CrossingEvent& e, const Vec2d& p) const {
+        const Segment& s = segments_[e.segment1];
+        const Segment& t = segments_[e.segment2];
+        return compareIntersection(s.p, s.q, t.p, t.q, p);
+    }
+
+    // Compares the positions of the crossing events e1 and e2.
+    //
+    int compareCrossings_(const CrossingEvent& e1, const CrossingEvent& e2) const {
+        const Segment& s1 = segments_[e1.segment1];
+        const Segment& t1 = segments_[e1.segment2];
+        const Segment& s2 = segments_[e2.segment1];
+        const Segment& t2 = segments_[e2.segment2];
+        return compareIntersections(s1.p, s1.q, t1.p, t1.q, s2.p, s2.q, t2.p, t2.q);
+    }
+
+    // Compares the position of the crossing event e with the sweep point.
+    //
+    int compareWithSweepPoint_(const CrossingEvent& e) const {
+        if (sweepCrossing_.segment1 != -1) {
+            return compareCrossings_(e, sweepCrossing_);
+        }
+        else {
+            return compareCrossing_(e, sweepPoint_);
+        }
+    }
+
+    bool isAtSweepPoint_(const CrossingEvent& e) const {
+        return compareWithSweepPoint_(e) == 0;
+    }
+
+    // Returns whether the segment i, which must be in the status, contains
+    // the sweep point.
+    //
+    bool containsSweepPoint_(Int i) const {
+        const Segment& s = segments_[i];
+        if (sweepCrossing_.segment1 != -1) {
+            const Segment& s1 = segments_[sweepCrossing_.segment1];
+            const Segment& s2 = segments_[sweepCrossing_.segment2];
+            return i == sweepCrossing_.segment1 || i == sweepCrossing_.segment2
+                   || intersectionOrientationSign(s.p, s.q, s1.p, s1.q, s2.p, s2.q) == 0;
+        }
+        else {
+            return orientationSign(s.p, s.q, sweepPoint_) == 0;
+        }
+    }
+
+    // Comparisons only ever involve the segment being inserted, since the
+    // relative order of the other segments is already known.
+    //
+    bool isBelow_(Int i, Int j) const {
+        if (i == insertedSegment_) {
+            return isInsertedBelow_(i, j);
+        }
+        else {
+            return !isInsertedBelow_(j, i);
+        }
+    }
+
+    // Returns whether the segment i, inserted at its start point, is below
+    // the segment j, which crosses the sweep line. Collinear segments are
+    // ordered by index.
+    //
+    bool isInsertedBelow_(Int i, Int j) const {
+        const Segment& s = segments_[i];
+        const Segment& t = segments_[j];
+        int o = orientationSign(t.p, t.q, s.p);
+        if (o == 0) {
+            // s starts on t: compare directions
+            o = orientationSign(t.p, t.q, s.q);
+        }
+        return (o == 0) ? i < j : o < 0;
+    }
+
+    // Returns whether the segment i is below the segment j after the sweep
+    // point, assuming that they both contain the sweep point. Collinear
+    // segments are ordered by index, consistently with isInsertedBelow_().
+    //
+    bool isBelowAfterSweepPoint_(Int i, Int j) const {
+        const Segment& s = segments_[i];
+        const Segment& t = segments_[j];
+        int o = directionOrientationSign(s.p, s.q, t.p, t.q);
+        return (o == 0) ? i < j : o > 0;
+    }
+
+    void insert_(Int i) {
+        insertedSegment_ = i;
+        StatusIterator it = status_.insert(StatusEntry{i}).first;
+        insertedSegment_ = -1;
+        handles_[i] = it;
+        isActive_[i] = true;
+        if (it != status_.begin()) {
+            checkAdjacentPair_(std::prev(it)->segment, i);
+        }
+        if (std::next(it) != status_.end()) {
+            checkAdjacentPair_(i, std::next(it)->segment);
+        }
+        checkSegmentsThroughSweepPoint_(it);
+        for (Int j : endedSegments_) {
+            checkPair_(i, j);
+        }
+    }
+
+    void remove_(Int i) {
+        StatusIterator it = handles_[i];
+        checkSegmentsThroughSweepPoint_(it);
+        StatusIterator above = std::next(it);
+        bool hasBelow = (it != status_.begin());
+        StatusIterator below = hasBelow ? std::prev(it) : status_.end();
+        status_.erase(it);
+        isActive_[i] = false;
+        endedSegments_.append(i);
+        if (hasBelow && above != status_.end()) {
+            checkAdjacentPair_(below->segment, above->segment);
+        }
+    }
+
+    // Tests the segment at the given iterator, which has an endpoint at the
+    // sweep point, against the other segments containing the sweep point.
+    // Since these are contiguous in the status, but not necessarily adjacent
+    // to the given segment, this is necessary to report all intersections
+    // when more than two segments meet at the same point.
+    //
+    void checkSegmentsThroughSweepPoint_(StatusIterator it) {
+        Int i = it->segment;
+        for (StatusIterator below = it; below != status_.begin();) {
+            --below;
+            if (!containsSweepPoint_(below->segment)) {
+                break;
+            }
+            checkPair_(below->segment, i);
+        }
+        for (StatusIterator above = std::next(it); above != status_.end(); ++above) {
+            if (!containsSweepPoint_(above->segment)) {
+                break;
+            }
+            checkPair_(i, above->segment);
+        }
+    }
+
+    // Reorders each run of consecutive segments in the status which contain
+    // the sweep point and include at least one of the crossing segments in
+    // `batch_`. The run may also include segments which are not part of any
+    // crossing event, such as segments collinear to a crossing segment.
+    //
+    void processCrossings_() {
+        for (Int i : batch_) {
+            if (isActive_[i]) {
+                isInBatch_[i] = true;
+            }
+        }
+        auto isInRun = [this](StatusIterator it) {
+            return isInBatch_[it->segment] || containsSweepPoint_(it->segment);
+        };
+        for (Int i : batch_) {
+            if (!isInBatch_[i]) {
+                continue; // already processed or inactive
+            }
+            StatusIterator it = handles_[i];
+            while (it != status_.begin() && isInRun(std::prev(it))) {
+                --it;
+            }
+            run_.clear();
+            runSegments_.clear();
+            for (; it != status_.end() && isInRun(it); ++it) {
+                isInBatch_[it->segment] = false;
+                run_.append(it);
+                runSegments_.append(it->segment);
+            }
+            Int n = run_.length();
+            if (n < 2) {
+                continue;
+            }
+            std::sort(
+                runSegments_.begin(), runSegments_.end(), [this](Int j, Int k) {
+                    return isBelowAfterSweepPoint_(j, k);
+                });
+            for (Int k = 0; k < n; ++k) {
+                Int j = runSegments_[k];
+                run_[k]->segment = j;
+                handles_[j] = run_[k];
+            }
+            for (Int k = 0; k < n; ++k) {
+                for (Int l = k + 1; l < n; ++l) {
+                    checkPair_(runSegments_[k], runSegments_[l]);
+                }
+            }
+            if (run_.first() != status_.begin()) {
+                Int below = std::prev(run_.first())->segment;
+                checkAdjacentPair_(below, runSegments_.first());
+            }
+            StatusIterator above = std::next(run_.last());
+            if (above != status_.end()) {
+                checkAdjacentPair_(runSegments_.last(), above->segment);
+            }
+        }
+        for (Int i : batch_) {
+            isInBatch_[i] = false;
+        }
+    }
+
+    // Reports the intersection between the segments i and j, if any and not
+    // already reported.
+    //
+    void checkPair_(Int i, Int j) {
+        const Segment& a = segments_[i];
+        const Segment& b = segments_[j];
+        if (i == j || a.next == j || b.next == i) {
+            return; // consecutive segments
+        }
+        UInt64 key = pairKey(i, j);
+        if (intersectingPairs_.count(key) > 0) {
+            return;
+        }
+        Vec2d position;
+        if (intersect(a.p, a.q, b.p, b.q, position) != IntersectionType::None) {
+            intersectingPairs_.insert(key);
+            addIntersection_(i, j, position);
+        }
+    }
+
+    // Same as checkPair_(), but for segments which are adjacent in the
+    // status, `below` being just below `above`. If they cross at or after
+    // the sweep point, a crossing event is scheduled to reorder them.
+    //
+    void checkAdjacentPair_(Int below, Int above) {
+        checkPair_(below, above);
+        const Segment& a = segments_[below];
+        const Segment& b = segments_[above];
+        Vec2d position;
+        if (intersect(a.p, a.q, b.p, b.q, position) == IntersectionType::Crossing) {
+            CrossingEvent e = {below, above};
+            if (compareWithSweepPoint_(e) >= 0) {
+                crossings_.push(e);
+            }
+        }
+    }
+
+    void addIntersection_(Int i, Int j, const Vec2d& position) {
+        const Segment* a = &segments_[i];
+        const Segment* b = &segments_[j];
+        if (b->polyline < a->polyline
+            || (b->polyline == a->polyline && b->index < a->index)) {
+            std::swap(a, b);
+        }
+        auto parameterOn = [&position](const Segment* s) {
+            double t = parameter(s->p, s->q, position);
+            return s->isReversed ? 1 - t : t;
+        };
+        intersections_.append(SegmentIntersection(
+            position,
+            a->polyline,
+            a->index,
+            parameterOn(a),
+            b->polyline,
+            b->index,
+            parameterOn(b)));
+    }
+};
+
+SegmentIntersector::SegmentIntersector() {
+}
+
+void SegmentIntersector::clear() {
+    numPolylines_ = 0;
+    segments_.clear();
+    intersections_.clear();
+}
+
+Int SegmentIntersector::addPolyline(const Vec2d* points, Int count, bool isClosed) {
+    Int polylineIndex = numPolylines_;
+    ++numPolylines_;
+    Int numSegments = (count < 2) ? 0 : (isClosed ? count : count - 1);
+    Int firstSegment = segments_.length();
+    for (Int i = 0; i < numSegments; ++i) {
+        const Vec2d& a = points[i];
+        const Vec2d& b = points[(i + 1 < count) ? i + 1 : 0];
+        if (a == b) {
+            continue;
+        }
+        bool isReversed = isBefore(b, a);
+        Int segmentIndex = segments_.length();
+        if (segmentIndex > firstSegment) {
+            segments_.last().next = segmentIndex;
+        }
+        segments_.append(
+            {isReversed ? b : a, isReversed ? a : b, polylineIndex, i, -1, isReversed});
+    }
+    Int numNonDegenerateSegments = segments_.length() - firstSegment;
+    if (isClosed && numNonDegenerateSegments > 1) {
+        segments_.last().next = firstSegment;
+    }
+    return polylineIndex;
+}
+
+void SegmentIntersector::addPolylines(const Curves2d& curves) {
+    polylineBuffer_.clear();
+    for (Curves2dCommandRef c : curves.commands()) {
+        switch (c.type()) {
+        case CurveCommandType::Close:
+            addPolyline(polylineBuffer_, true);
+            polylineBuffer_.clear();
+            break;
+        case CurveCommandType::MoveTo:
+            if (!polylineBuffer_.isEmpty()) {
+                addPolyline(polylineBuffer_);
+            }
+            polylineBuffer_.clear();
+            polylineBuffer_.append(c.p());
+            break;
+        case CurveCommandType::LineTo:
+            polylineBuffer_.append(c.p());
+            break;
+        case CurveCommandType::QuadraticBezierTo:
+            polylineBuffer_.append(c.p2());
+            break;
+        case CurveCommandType::CubicBezierTo:
+            polylineBuffer_.append(c.p3());
+            break;
+        }
+    }
+    if (!polylineBuffer_.isEmpty()) {
+        addPolyline(polylineBuffer_);
+    }
+}
+
+void SegmentIntersector::computeIntersections() {
+    intersections_.clear();
+    Sweep sweep(*this);
+    sweep.run();
+    std::sort(
+        intersections_.begin(),
+        intersections_.end(),
+        [](const SegmentIntersection& i1, const SegmentIntersection& i2) {
+            if (i1.polyline1() != i2.polyline1()) {
+                return i1.polyline1() < i2.polyline1();
+            }
+            else if (i1.segment1() != i2.segment1()) {
+                return i1.segment1() < i2.segment1();
+            }
+            else if (i1.polyline2() != i2.polyline2()) {
+                return i1.polyline2() < i2.polyline2();
+            }
+            else {
+                return i1.segment2() < i2.segment2();
+            }
+        });
+}
+
+} // namespace vgc::geometry
@@ -0,0 +1,218 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VGC_GEOMETRY_SEGMENTINTERSECTOR_H
+#define VGC_GEOMETRY_SEGMENTINTERSECTOR_H
+
+#include <vgc/core/array.h>
+#include <vgc/geometry/api.h>
+#include <vgc/geometry/curves2d.h>
+#include <vgc/geometry/vec2d.h>
+
+namespace vgc::geometry {
+
+/// \class vgc::geometry::SegmentIntersection
+/// \brief An intersection between two segments of polylines.
+///
+/// The segment of index `i` of a polyline is the line segment between its
+/// points of index `i` and `i + 1`. The parameter of the intersection along
+/// this segment is the value `t` in [0, 1] such that the position of the
+/// intersection is `(1 - t) * points[i] + t * points[i + 1]`.
+///
+/// The first segment is always the smallest of the two, compared by
+/// polyline index then segment index.
+///
+/// \sa SegmentIntersector
+///
+class VGC_GEOMETRY_API SegmentIntersection {
+public:
+    /// Creates a SegmentIntersection.
+    ///
+    SegmentIntersection(
+        const Vec2d& position,
+        Int polyline1,
+        Int segment1,
+        double parameter1,
+        Int polyline2,
+        Int segment2,
+        double parameter2)
+
+        : position_(position)
+        , polyline1_(polyline1)
+        , segment1_(segment1)
+        , parameter1_(parameter1)
+        , polyline2_(polyline2)
+        , segment2_(segment2)
+        , parameter2_(parameter2) {
+    }
+
+    /// Returns the position of the intersection.
+    ///
+    const Vec2d& position() const {
+        return position_;
+    }
+
+    /// Returns the index of the polyline of the first segment.
+    ///
+    Int polyline1() const {
+        return polyline1_;
+    }
+
+    /// Returns the index of the first segment within its polyline.
+    ///
+    Int segment1() const {
+        return segment1_;
+    }
+
+    /// Returns the parameter of the intersection along the first segment.
+    ///
+    double parameter1() const {
+        return parameter1_;
+    }
+
+    /// Returns the index of the polyline of the second segment.
+    ///
+    Int polyline2() const {
+        return polyline2_;
+    }
+
+    /// Returns the index of the second segment within its polyline.
+    ///
+    Int segment2() const {
+        return segment2_;
+    }
+
+    /// Returns the parameter of the intersection along the second segment.
+    ///
+    double parameter2() const {
+        return parameter2_;
+    }
+
+private:
+    Vec2d position_;
+    Int polyline1_;
+    Int segment1_;
+    double parameter1_;
+    Int polyline2_;
+    Int segment2_;
+    double parameter2_;
+};
+
+/// \class vgc::geometry::SegmentIntersector
+/// \brief Computes all the intersections among the segments of polylines.
+///
+/// This class finds all the self-intersections and pairwise intersections of
+/// a set of polylines, such as sampled strokes, using a Bentley-Ottmann
+/// sweep-line algorithm. Its cost is O((n + k) log n), where n is the number
+/// of segments and k the number of intersections, instead of the O(n²) cost
+/// of testing all pairs of segments.
+///
+/// ```cpp
+/// SegmentIntersector intersector;
+/// intersector.addPolylines(curves.sample(Curves2dSampleParams::adaptive()));
+/// intersector.computeIntersections();
+/// for (const SegmentIntersection& i : intersector.intersections()) {
+///     // ...
+/// }
+/// ```
+///
+/// Combinatorial decisions, such as whether two segments intersect, are
+/// computed exactly using `orientationSign()`, and all the events located
+/// at the same point are processed as a batch. This makes the algorithm
+/// robust to degenerate configurations, for example, several segments
+/// crossing at the same point, segment endpoints lying on other segments, or
+/// vertical segments. Only the positions and parameters of the reported
+/// intersections are subject to rounding errors.
+///
+/// Each pair of intersecting segments is reported once. Two segments which
+/// overlap along a collinear part are reported at the start of the overlap.
+/// Consecutive segments of a polyline, which share an endpoint by
+/// construction, are not reported, and neither are zero-length segments.
+///
+class VGC_GEOMETRY_API SegmentIntersector {
+public:
+    /// Creates a SegmentIntersector.
+    ///
+    SegmentIntersector();
+
+    /// Removes all the polylines and intersections.
+    ///
+    void clear();
+
+    /// Adds a polyline made of the `count` points starting at `points`, and
+    /// returns its index. If `isClosed` is true, the polyline has an
+    /// additional segment from its last point to its first point.
+    ///
+    Int addPolyline(const Vec2d* points, Int count, bool isClosed = false);
+
+    /// \overload
+    ///
+    Int addPolyline(const Vec2dArray& points, bool isClosed = false) {
+        return addPolyline(points.data(), points.length(), isClosed);
+    }
+
+    /// Adds one polyline per subpath of the given `curves`, that is, per
+    /// MoveTo command. Curved commands are treated as straight lines between
+    /// their endpoints, so this is typically called on the output of
+    /// `Curves2d::sample()`.
+    ///
+    void addPolylines(const Curves2d& curves);
+
+    /// Returns the number of polylines.
+    ///
+    Int numPolylines() const {
+        return numPolylines_;
+    }
+
+    /// Computes the intersections among all the segments of all the
+    /// polylines. The result, sorted by first segment then second segment,
+    /// is available via `intersections()`.
+    ///
+    void computeIntersections();
+
+    /// Returns the intersections computed by the last call to
+    /// `computeIntersections()`.
+    ///
+    const core::Array<SegmentIntersection>& intersections() const {
+        return intersections_;
+    }
+
+private:
+    // Non-zero-length segments, with their endpoints sorted in lexicographic
+    // (x, y) order. The `next` segment is the index in segments_ of the next
+    // segment in the same polyline, or -1 if none.
+    //
+    struct Segment {
+        Vec2d p;
+        Vec2d q;
+        Int polyline;
+        Int index;
+        Int next;
+        bool isReversed;
+    };
+
+    Int numPolylines_ = 0;
+    core::Array<Segment> segments_;
+    core::Array<SegmentIntersection> intersections_;
+    Vec2dArray polylineBuffer_;
+
+    // State of the sweep, only used during computeIntersections()
+    class Sweep;
+};
+
+} // namespace vgc::geometry
+
+#endif // VGC_GEOMETRY_SEGMENTINTERSECTOR_H
@@ -179,6 +179,12 @@ public:
         return *reinterpret_cast<U*>(begin_ + n * stride_);
     }
 
+    /// Returns the number of elements in the span.
+    ///
+    Int length() const {
+        return count_;
+    }
+
 private:
     T* begin_;
     Int count_;
@@ -0,0 +1,107 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vgc/geometry/strokesimplifier.h>
+
+#include <cmath>
+
+namespace vgc::geometry {
+
+namespace {
+
+// Maximum number of input samples that can be skipped between two kept
+// samples. This bounds the cost of addSample().
+//
+constexpr Int maxWindowSize = 64;
+
+// Returns the parameter in [0, 1] of the point of the segment [a, b] closest
+// to the point p.
+//
+double closestParameter(const Vec2d& a, const Vec2d& b, const Vec2d& p) {
+    Vec2d ab = b - a;
+    double l2 = ab.squaredLength();
+    if (l2 > 0) {
+        double t = (p - a).dot(ab) / l2;
+        return t < 0 ? 0 : (t > 1 ? 1 : t);
+    }
+    else {
+        return 0;
+    }
+}
+
+} // namespace
+
+StrokeSimplifier::StrokeSimplifier(double tolerance)
+    : tolerance_(tolerance) {
+}
+
+void StrokeSimplifier::clear() {
+    positions_.clear();
+    widths_.clear();
+    window_.clear();
+    numInputSamples_ = 0;
+}
+
+void StrokeSimplifier::addSample(const Vec2d& position, double width) {
+    ++numInputSamples_;
+    Sample sample = {position, width};
+    if (positions_.isEmpty()) {
+        keep_(sample);
+        return;
+    }
+    if (window_.length() > 0
+        && (window_.length() >= maxWindowSize || !isWithinTolerance_(sample))) {
+
+        // The segment from the last kept sample to the new sample does not
+        // approximate well the samples in between, so we keep the previous
+        // sample, which was approximating them well.
+        Sample previous = window_.last();
+        window_.clear();
+        keep_(previous);
+    }
+    window_.append(sample);
+}
+
+void StrokeSimplifier::finish() {
+    if (window_.length() > 0) {
+        keep_(window_.last());
+        window_.clear();
+    }
+}
+
+void StrokeSimplifier::keep_(const Sample& sample) {
+    positions_.append(sample.position);
+    widths_.append(sample.width);
+}
+
+bool StrokeSimplifier::isWithinTolerance_(const Sample& last) const {
+    const Vec2d& a = positions_.last();
+    const Vec2d& b = last.position;
+    double wa = widths_.last();
+    double wb = last.width;
+    for (const Sample& s : window_) {
+        double t = closestParameter(a, b, s.position);
+        Vec2d p = a + t * (b - a);
+        double w = wa + t * (wb - wa);
+        double error = (s.position - p).length() + 0.5 * std::abs(s.width - w);
+        if (error > tolerance_) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace vgc::geometry
@@ -0,0 +1,151 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VGC_GEOMETRY_STROKESIMPLIFIER_H
+#define VGC_GEOMETRY_STROKESIMPLIFIER_H
+
+#include <vgc/core/array.h>
+#include <vgc/geometry/api.h>
+#include <vgc/geometry/vec2d.h>
+
+namespace vgc::geometry {
+
+/// \class vgc::geometry::StrokeSimplifier
+/// \brief Removes redundant samples from a stroke while it is being sketched.
+///
+/// Input devices typically generate many more samples than necessary to
+/// represent a stroke: for example, a tablet may generate hundreds of samples
+/// per second, most of them barely moving from the previous one. A
+/// `StrokeSimplifier` processes such samples one at a time (see
+/// `addSample()`), and only keeps the samples that are necessary to represent
+/// the stroke within the given `tolerance()`.
+///
+/// More precisely, a sample is discarded if the polyline through the kept
+/// samples passes within `tolerance()` of it, where the distance also takes
+/// into account half the difference between the width of the sample and the
+/// interpolated width. This is an online variant of the Ramer-Douglas-Peucker
+/// algorithm: whenever the segment between the last kept sample and the
+/// latest sample fails to approximate the samples in between, the previous
+/// sample is kept.
+///
+/// The latest sample is always available via `lastPosition()` and
+/// `lastWidth()`, but is not added to `positions()` and `widths()` until it
+/// is known to be necessary, or until `finish()` is called.
+///
+/// ```cpp
+/// StrokeSimplifier simplifier(0.5);
+/// for (const auto& [position, width] : samples) {
+///     simplifier.addSample(position, width);
+///     // Display simplifier.positions() + simplifier.lastPosition()
+/// }
+/// simplifier.finish();
+/// // Store simplifier.positions() and simplifier.widths()
+/// ```
+///
+class VGC_GEOMETRY_API StrokeSimplifier {
+public:
+    /// Creates a `StrokeSimplifier` with the given `tolerance`.
+    ///
+    explicit StrokeSimplifier(double tolerance = 0.5);
+
+    /// Returns the tolerance of this `StrokeSimplifier`.
+    ///
+    double tolerance() const {
+        return tolerance_;
+    }
+
+    /// Sets the tolerance of this `StrokeSimplifier`. This only affects
+    /// samples added after this call.
+    ///
+    void setTolerance(double tolerance) {
+        tolerance_ = tolerance;
+    }
+
+    /// Removes all samples, so that a new stroke can be started.
+    ///
+    void clear();
+
+    /// Adds a new input sample.
+    ///
+    void addSample(const Vec2d& position, double width);
+
+    /// Keeps the last input sample, if any. Call this when the stroke is
+    /// complete.
+    ///
+    void finish();
+
+    /// Returns the positions of the samples kept so far.
+    ///
+    const Vec2dArray& positions() const {
+        return positions_;
+    }
+
+    /// Returns the widths of the samples kept so far.
+    ///
+    const core::DoubleArray& widths() const {
+        return widths_;
+    }
+
+    /// Returns whether there is an input sample which has not yet been
+    /// added to `positions()` and `widths()`.
+    ///
+    bool hasPendingSample() const {
+        return window_.length() > 0;
+    }
+
+    /// Returns the position of the last input sample. This must only be
+    /// called if `hasPendingSample()` is true.
+    ///
+    const Vec2d& lastPosition() const {
+        return window_.last().position;
+    }
+
+    /// Returns the width of the last input sample. This must only be
+    /// called if `hasPendingSample()` is true.
+    ///
+    double lastWidth() const {
+        return window_.last().width;
+    }
+
+    /// Returns the number of input samples added since the last call to
+    /// `clear()`.
+    ///
+    Int numInputSamples() const {
+        return numInputSamples_;
+    }
+
+private:
+    struct Sample {
+        Vec2d position;
+        double width;
+    };
+
+    double tolerance_;
+    Vec2dArray positions_;
+    core::DoubleArray widths_;
+    Int numInputSamples_ = 0;
+
+    // Input samples since the last kept sample. This is bounded by
+    // maxWindowSize so that addSample() is O(1).
+    core::Array<Sample> window_;
+
+    void keep_(const Sample& sample);
+    bool isWithinTolerance_(const Sample& last) const;
+};
+
+} // namespace vgc::geometry
+
+#endif // VGC_GEOMETRY_STROKESIMPLIFIER_H
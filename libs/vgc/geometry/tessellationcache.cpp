@@ -0,0 +1,223 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <vgc/geometry/tessellationcache.h>
+
+#include <algorithm> // max
+#include <cstring>   // memcpy
+
+namespace vgc::geometry {
+
+namespace {
+
+// The first element of each key, which identifies which function computed
+// the tessellation.
+//
+enum class TessellationKind {
+    CurveTriangulate,
+    Curves2dStroke,
+    Curves2dFill
+};
+
+// Approximate memory overhead of each entry, in addition to sizeof(Entry):
+// list node pointers, hash map node and bucket.
+//
+constexpr Int entryOverhead = 6 * sizeof(void*);
+
+UInt64 mix(UInt64 x) {
+    // Finalizer of splitmix64
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+UInt64 hash(const core::DoubleArray& key) {
+    UInt64 res = static_cast<UInt64>(key.length());
+    for (double x : key) {
+        UInt64 bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        res = mix(res ^ bits) + 0x9e3779b97f4a7c15ULL;
+    }
+    return res;
+}
+
+core::DoubleArray
+curves2dKey(TessellationKind kind, const Curves2d& curves, Int numParams) {
+    const core::DoubleArray& data = curves.data();
+    core::DoubleArray key;
+    key.reserve(1 + numParams + data.length() + data.length() / 2);
+    key.append(static_cast<double>(kind));
+    for (Curves2dCommandRef c : curves.commands()) {
+        key.append(static_cast<double>(c.type()));
+    }
+    key.append(-1); // Separator between the command types and the data
+    key.extend(data.begin(), data.end());
+    return key;
+}
+
+void appendParams(core::DoubleArray& key, const Curves2dSampleParams& params) {
+    key.append(params.isUniform() ? 1 : 0);
+    key.append(params.minDistance());
+    key.append(params.maxAngle());
+    key.append(static_cast<double>(params.maxSamplesPerSegment()));
+    key.append(params.maxError());
+}
+
+Int arrayMemoryUsage(const core::DoubleArray& a) {
+    return a.length() * static_cast<Int>(sizeof(double));
+}
+
+Int arrayMemoryUsage(const Vec2dArray& a) {
+    return a.length() * static_cast<Int>(sizeof(Vec2d));
+}
+
+} // namespace
+
+TessellationCache::TessellationCache(Int maxMemoryUsage)
+    : maxMemoryUsage_(maxMemoryUsage) {
+}
+
+Vec2dArray TessellationCache::triangulate(
+    const Curve& curve,
+    double maxAngle,
+    Int minQuads,
+    Int maxQuads) {
+
+    const core::DoubleArray& positions = curve.positionData();
+    const core::DoubleArray& widths = curve.widthData();
+    core::DoubleArray key;
+    key.reserve(8 + positions.length() + widths.length());
+    key.append(static_cast<double>(TessellationKind::CurveTriangulate));
+    key.append(maxAngle);
+    key.append(static_cast<double>(minQuads));
+    key.append(static_cast<double>(maxQuads));
+    key.append(static_cast<double>(curve.type()));
+    key.append(static_cast<double>(curve.widthVariability()));
+    key.append(static_cast<double>(positions.length()));
+    key.extend(positions.begin(), positions.end());
+    key.extend(widths.begin(), widths.end());
+
+    const Entry& entry = findOrInsert_(std::move(key), [&](Entry& e) {
+        e.triangles = curve.triangulate(maxAngle, minQuads, maxQuads);
+    });
+    return entry.triangles;
+}
+
+void TessellationCache::stroke(
+    const Curves2d& curves,
+    core::DoubleArray& data,
+    double width,
+    const Curves2dSampleParams& params) {
+
+    core::DoubleArray key = curves2dKey(TessellationKind::Curves2dStroke, curves, 6);
+    appendParams(key, params);
+    key.append(width);
+
+    const Entry& entry = findOrInsert_(std::move(key), [&](Entry& e) {
+        curves.stroke(e.data, width, params);
+    });
+    data.extend(entry.data.begin(), entry.data.end());
+}
+
+void TessellationCache::fill(
+    const Curves2d& curves,
+    core::DoubleArray& data,
+    const Curves2dSampleParams& params,
+    WindingRule windingRule,
+    FillMethod method) {
+
+    core::DoubleArray key = curves2dKey(TessellationKind::Curves2dFill, curves, 7);
+    appendParams(key, params);
+    key.append(static_cast<double>(windingRule));
+    key.append(static_cast<double>(method));
+
+    const Entry& entry = findOrInsert_(std::move(key), [&](Entry& e) {
+        curves.fill(e.data, params, windingRule, method);
+    });
+    data.extend(entry.data.begin(), entry.data.end());
+}
+
+void TessellationCache::setMaxMemoryUsage(Int maxMemoryUsage) {
+    maxMemoryUsage_ = maxMemoryUsage;
+    evict_(maxMemoryUsage);
+}
+
+void TessellationCache::resetCounters() {
+    numHits_ = 0;
+    numMisses_ = 0;
+    numEvictions_ = 0;
+}
+
+void TessellationCache::clear() {
+    entries_.clear();
+    entryMap_.clear();
+    memoryUsage_ = 0;
+}
+
+template<typename ComputeFunction>
+const TessellationCache::Entry&
+TessellationCache::findOrInsert_(core::DoubleArray&& key, ComputeFunction compute) {
+
+    // Find a matching entry. In case of hash collision, the existing entry is
+    // replaced by the new one.
+    UInt64 h = hash(key);
+    auto it = entryMap_.find(h);
+    if (it != entryMap_.end()) {
+        EntryList::iterator entry = it->second;
+        if (entry->key == key) {
+            ++numHits_;
+            entries_.splice(entries_.begin(), entries_, entry);
+            return *entry;
+        }
+        erase_(entry);
+    }
+    ++numMisses_;
+
+    // Compute the new entry and make it the most recently used.
+    entries_.emplace_front();
+    Entry& entry = entries_.front();
+    entry.hash = h;
+    entry.key = std::move(key);
+    compute(entry);
+    entry.memoryUsage = static_cast<Int>(sizeof(Entry)) + entryOverhead
+                        + arrayMemoryUsage(entry.key)
+                        + arrayMemoryUsage(entry.triangles)
+                        + arrayMemoryUsage(entry.data);
+    entryMap_[h] = entries_.begin();
+    memoryUsage_ += entry.memoryUsage;
+
+    // Evict the least recently used entries, except the new entry, which
+    // must stay valid until the caller copies its output. If it doesn't fit
+    // on its own, it is evicted on the next insertion.
+    evict_(std::max<Int>(maxMemoryUsage_, entry.memoryUsage));
+    return entry;
+}
+
+void TessellationCache::erase_(EntryList::iterator it) {
+    memoryUsage_ -= it->memoryUsage;
+    entryMap_.erase(it->hash);
+    entries_.erase(it);
+}
+
+void TessellationCache::evict_(Int maxMemoryUsage) {
+    while (memoryUsage_ > maxMemoryUsage && !entries_.empty()) {
+        erase_(std::prev(entries_.end()));
+        ++numEvictions_;
+    }
+}
+
+} // namespace vgc::geometry
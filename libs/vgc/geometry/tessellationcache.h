@@ -0,0 +1,177 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef VGC_GEOMETRY_TESSELLATIONCACHE_H
+#define VGC_GEOMETRY_TESSELLATIONCACHE_H
+
+#include <list>
+#include <unordered_map>
+
+#include <vgc/core/array.h>
+#include <vgc/geometry/api.h>
+#include <vgc/geometry/curve.h>
+#include <vgc/geometry/curves2d.h>
+#include <vgc/geometry/vec2d.h>
+
+namespace vgc::geometry {
+
+/// \class vgc::geometry::TessellationCache
+/// \brief Caches the tessellations of curves, keyed by their content.
+///
+/// A `TessellationCache` remembers the results of `Curve::triangulate()`,
+/// `Curves2d::stroke()`, and `Curves2d::fill()`, so that tessellating again
+/// a curve whose control points, widths, and sampling parameters are
+/// identical to a recently tessellated curve only costs a lookup and a copy.
+/// This typically happens when undoing and redoing changes, or when toggling
+/// back and forth between rendering modes.
+///
+/// Entries are identified by a hash of their inputs, but the inputs are also
+/// stored and compared on lookup, so that a hash collision can never return
+/// the tessellation of a different curve.
+///
+/// The memory used by the cache (including the stored inputs) is bounded by
+/// `maxMemoryUsage()`. When inserting a new entry would exceed this bound,
+/// the least recently used entries are evicted.
+///
+/// ```cpp
+/// TessellationCache cache;
+/// Vec2dArray triangles = cache.triangulate(curve);  // miss: computed
+/// Vec2dArray triangles2 = cache.triangulate(curve); // hit: copied
+/// ```
+///
+/// This class is not thread-safe.
+///
+class VGC_GEOMETRY_API TessellationCache {
+public:
+    /// Creates a `TessellationCache` whose memory usage is bounded by the
+    /// given number of bytes.
+    ///
+    explicit TessellationCache(Int maxMemoryUsage = 64 * 1024 * 1024);
+
+    /// Returns the same as `curve.triangulate(maxAngle, minQuads, maxQuads)`,
+    /// reusing a previous result if possible.
+    ///
+    Vec2dArray triangulate(
+        const Curve& curve,
+        double maxAngle = 0.05,
+        Int minQuads = 1,
+        Int maxQuads = 64);
+
+    /// Performs the same as `curves.stroke(data, width, params)`, reusing a
+    /// previous result if possible.
+    ///
+    void stroke(
+        const Curves2d& curves,
+        core::DoubleArray& data,
+        double width,
+        const Curves2dSampleParams& params);
+
+    /// Performs the same as `curves.fill(data, params, windingRule, method)`,
+    /// reusing a previous result if possible.
+    ///
+    void fill(
+        const Curves2d& curves,
+        core::DoubleArray& data,
+        const Curves2dSampleParams& params,
+        WindingRule windingRule = WindingRule::NonZero,
+        FillMethod method = FillMethod::Libtess2);
+
+    /// Returns the number of tessellations currently stored in the cache.
+    ///
+    Int numEntries() const {
+        return static_cast<Int>(entries_.size());
+    }
+
+    /// Returns an estimation of the number of bytes currently used by the
+    /// cache.
+    ///
+    Int memoryUsage() const {
+        return memoryUsage_;
+    }
+
+    /// Returns the maximum number of bytes that the cache may use.
+    ///
+    Int maxMemoryUsage() const {
+        return maxMemoryUsage_;
+    }
+
+    /// Sets the maximum number of bytes that the cache may use, evicting
+    /// the least recently used entries if necessary.
+    ///
+    void setMaxMemoryUsage(Int maxMemoryUsage);
+
+    /// Returns how many tessellations were found in the cache since it was
+    /// created, or since the last call to `resetCounters()`.
+    ///
+    Int numHits() const {
+        return numHits_;
+    }
+
+    /// Returns how many tessellations were not found in the cache, and
+    /// therefore had to be computed, since it was created or since the last
+    /// call to `resetCounters()`.
+    ///
+    Int numMisses() const {
+        return numMisses_;
+    }
+
+    /// Returns how many entries were evicted to keep the memory usage within
+    /// `maxMemoryUsage()`, since the cache was created or since the last call
+    /// to `resetCounters()`.
+    ///
+    Int numEvictions() const {
+        return numEvictions_;
+    }
+
+    /// Sets `numHits()`, `numMisses()`, and `numEvictions()` to zero.
+    ///
+    void resetCounters();
+
+    /// Removes all entries from the cache. This does not reset the counters.
+    ///
+    void clear();
+
+private:
+    struct Entry {
+        UInt64 hash;
+        core::DoubleArray key;  // Kind of tessellation, parameters, and inputs
+        Vec2dArray triangles;   // Output of triangulate()
+        core::DoubleArray data; // Output of stroke() and fill()
+        Int memoryUsage;
+    };
+
+    // Most recently used first
+    using EntryList = std::list<Entry>;
+    EntryList entries_;
+    std::unordered_map<UInt64, EntryList::iterator> entryMap_;
+
+    Int memoryUsage_ = 0;
+    Int maxMemoryUsage_;
+    Int numHits_ = 0;
+    Int numMisses_ = 0;
+    Int numEvictions_ = 0;
+
+    template<typename ComputeFunction>
+    const Entry& findOrInsert_(core::DoubleArray&& key, ComputeFunction compute);
+
+    void erase_(EntryList::iterator it);
+    void evict_(Int maxMemoryUsage);
+};
+
+} // namespace vgc::geometry
+
+#endif // VGC_GEOMETRY_TESSELLATIONCACHE_H
@@ -0,0 +1,170 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <vgc/core/stopwatch.h>
+#include <vgc/geometry/bezier.h>
+#include <vgc/geometry/bezierspline.h>
+#include <vgc/geometry/vec2d.h>
+#include <vgc/geometry/vec2f.h>
+
+using vgc::Int;
+using vgc::geometry::BezierSpline;
+using vgc::geometry::UniformBezierSampler;
+using vgc::geometry::Vec2d;
+using vgc::geometry::Vec2f;
+
+namespace {
+
+template<typename TVec2>
+void expectNear(const TVec2& p, const TVec2& q, double tol) {
+    EXPECT_NEAR(p[0], q[0], tol);
+    EXPECT_NEAR(p[1], q[1], tol);
+}
+
+Vec2d toVec2d(const Vec2f& p) {
+    return Vec2d(p[0], p[1]);
+}
+
+} // namespace
+
+TEST(TestBezier, UniformSamplerCubic) {
+    Vec2d p0(0, 0);
+    Vec2d p1(100, 300);
+    Vec2d p2(400, -200);
+    Vec2d p3(500, 100);
+    // Test sizes around multiples of reanchorInterval
+    for (Int n : {1, 2, 3, 7, 31, 32, 33, 64, 100, 1000}) {
+        UniformBezierSampler<3, Vec2d> sampler(p0, p1, p2, p3, n);
+        for (Int j = 0; j <= n; ++j) {
+            double u = static_cast<double>(j) / n;
+            EXPECT_EQ(sampler.index(), j);
+            EXPECT_NEAR(sampler.u(), u, 1e-12);
+            expectNear(sampler.position(), cubicBezier(p0, p1, p2, p3, u), 1e-9);
+            expectNear(sampler.derivative(), cubicBezierDer(p0, p1, p2, p3, u), 1e-9);
+            EXPECT_EQ(sampler.isLast(), j == n);
+            if (!sampler.isLast()) {
+                sampler.advance();
+            }
+        }
+        EXPECT_EQ(sampler.position(), p3);
+    }
+}
+
+TEST(TestBezier, UniformSamplerQuadratic) {
+    Vec2d p0(0, 0);
+    Vec2d p1(100, 300);
+    Vec2d p2(400, -200);
+    for (Int n : {1, 2, 5, 32, 33, 1000}) {
+        UniformBezierSampler<2, Vec2d> sampler(p0, p1, p2, n);
+        for (Int j = 0; j <= n; ++j) {
+            double u = static_cast<double>(j) / n;
+            expectNear(sampler.position(), quadraticBezier(p0, p1, p2, u), 1e-9);
+            expectNear(sampler.derivative(), quadraticBezierDer(p0, p1, p2, u), 1e-9);
+            if (!sampler.isLast()) {
+                sampler.advance();
+            }
+        }
+        EXPECT_EQ(sampler.position(), p2);
+    }
+}
+
+TEST(TestBezier, UniformSamplerFloat) {
+    // Re-anchoring keeps single-precision drift small even for many steps
+    Vec2f p0(0, 0);
+    Vec2f p1(100, 300);
+    Vec2f p2(400, -200);
+    Vec2f p3(500, 100);
+    Int n = 10000;
+    UniformBezierSampler<3, Vec2f, float> sampler(p0, p1, p2, p3, n);
+    for (Int j = 0; j <= n; ++j) {
+        double u = static_cast<double>(j) / n;
+        Vec2d q = cubicBezier(toVec2d(p0), toVec2d(p1), toVec2d(p2), toVec2d(p3), u);
+        expectNear(toVec2d(sampler.position()), q, 1e-3);
+        if (!sampler.isLast()) {
+            sampler.advance();
+        }
+    }
+}
+
+TEST(TestBezier, BezierSplineSampleUniform) {
+    BezierSpline<Vec2d> spline;
+    spline.data() = {Vec2d(0, 0), Vec2d(1, 2), Vec2d(3, 2), Vec2d(4, 0), //
+                     Vec2d(5, -2), Vec2d(7, -1), Vec2d(8, 0)};
+    std::vector<Vec2d> positions;
+    std::vector<Vec2d> derivatives;
+    Int n = 5;
+    spline.sampleUniform(static_cast<int>(n), positions, &derivatives);
+    ASSERT_EQ(static_cast<Int>(positions.size()), 2 * n + 1);
+    ASSERT_EQ(static_cast<Int>(derivatives.size()), 2 * n + 1);
+    for (Int k = 0; k <= 2 * n; ++k) {
+        Int i = (std::min)(k / n, Int(1));
+        double u = static_cast<double>(k - i * n) / n;
+        const Vec2d* p = spline.data().data() + 3 * i;
+        expectNear(positions[k], cubicBezier(p[0], p[1], p[2], p[3], u), 1e-12);
+        expectNear(
+            derivatives[k], 2 * cubicBezierDer(p[0], p[1], p[2], p[3], u), 1e-12);
+    }
+}
+
+#ifndef VGC_DEBUG_BUILD
+
+TEST(TestBezier, PerfUniformSampler) {
+    Vec2d p0(0, 0);
+    Vec2d p1(100, 300);
+    Vec2d p2(400, -200);
+    Vec2d p3(500, 100);
+    Int n = 10000000;
+
+    vgc::core::Stopwatch s;
+    Vec2d sumDirect;
+    for (Int j = 0; j <= n; ++j) {
+        double u = static_cast<double>(j) / n;
+        sumDirect += cubicBezier(p0, p1, p2, p3, u);
+        sumDirect += cubicBezierDer(p0, p1, p2, p3, u);
+    }
+    double directTime = s.elapsed();
+
+    s.restart();
+    Vec2d sumSampler;
+    UniformBezierSampler<3, Vec2d> sampler(p0, p1, p2, p3, n);
+    while (true) {
+        sumSampler += sampler.position();
+        sumSampler += sampler.derivative();
+        if (sampler.isLast()) {
+            break;
+        }
+        sampler.advance();
+    }
+    double samplerTime = s.elapsed();
+    expectNear(sumSampler, sumDirect, 1e-6 * sumDirect.length());
+
+    vgc::core::print(
+        "Sample cubic Bezier {} times: direct = {:.7f} sec, sampler = {:.7f} sec.\n",
+        n,
+        directTime,
+        samplerTime);
+}
+
+#endif // VGC_DEBUG_BUILD
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,220 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <gtest/gtest.h>
+#include <vgc/core/array.h>
+#include <vgc/core/exceptions.h>
+#include <vgc/core/stopwatch.h>
+#include <vgc/geometry/bvh2d.h>
+#include <vgc/geometry/curve.h>
+
+using vgc::Int;
+using vgc::core::IntArray;
+using vgc::geometry::Bvh2d;
+using vgc::geometry::Curve;
+using vgc::geometry::Rect2d;
+using vgc::geometry::Vec2d;
+
+namespace {
+
+// Generates `n` random rectangles in [0, size]^2, with sides of at most
+// `maxSide`.
+//
+vgc::core::Array<Rect2d> randomRects(Int n, double size, double maxSide) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> pos(0, size);
+    std::uniform_real_distribution<double> side(0, maxSide);
+    vgc::core::Array<Rect2d> res;
+    for (Int i = 0; i < n; ++i) {
+        Vec2d p(pos(gen), pos(gen));
+        Vec2d s(side(gen), side(gen));
+        res.append(Rect2d(p, p + s));
+    }
+    return res;
+}
+
+// Returns the sorted values of the given item IDs.
+//
+IntArray sortedValues(const Bvh2d& bvh, const IntArray& ids) {
+    IntArray res;
+    for (Int id : ids) {
+        res.append(bvh.value(id));
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+// Returns the sorted indices of the rects that intersect the given rect.
+//
+IntArray bruteForceIntersecting(const vgc::core::Array<Rect2d>& rects, const Rect2d& r) {
+    IntArray res;
+    for (Int i = 0; i < rects.length(); ++i) {
+        if (rects[i].intersects(r)) {
+            res.append(i);
+        }
+    }
+    return res;
+}
+
+} // namespace
+
+TEST(TestBvh2d, InsertRemove) {
+    Bvh2d bvh;
+    EXPECT_TRUE(bvh.isEmpty());
+    EXPECT_EQ(bvh.boundingRect(), Rect2d::empty);
+    Int id1 = bvh.insert(Rect2d(0, 0, 10, 10), 42);
+    Int id2 = bvh.insert(Rect2d(20, 0, 30, 10), 43);
+    EXPECT_EQ(bvh.numItems(), 2);
+    EXPECT_EQ(bvh.value(id1), 42);
+    EXPECT_EQ(bvh.value(id2), 43);
+    EXPECT_EQ(bvh.boundingRect(), Rect2d(0, 0, 30, 10));
+
+    IntArray ids;
+    bvh.findIntersecting(Rect2d(5, 5, 25, 6), ids);
+    EXPECT_EQ(sortedValues(bvh, ids), IntArray({42, 43}));
+
+    ids.clear();
+    bvh.findContaining(Vec2d(25, 5), ids);
+    EXPECT_EQ(sortedValues(bvh, ids), IntArray({43}));
+
+    bvh.remove(id1);
+    EXPECT_EQ(bvh.numItems(), 1);
+    EXPECT_FALSE(bvh.contains(id1));
+    EXPECT_THROW(bvh.remove(id1), vgc::core::IndexError);
+    EXPECT_THROW(bvh.value(-1), vgc::core::IndexError);
+    EXPECT_EQ(bvh.boundingRect(), Rect2d(20, 0, 30, 10));
+
+    bvh.move(id2, Rect2d(0, 0, 1, 1));
+    EXPECT_EQ(bvh.boundingRect(), Rect2d(0, 0, 1, 1));
+
+    bvh.clear();
+    EXPECT_TRUE(bvh.isEmpty());
+}
+
+TEST(TestBvh2d, CompareWithBruteForce) {
+    Int n = 2000;
+    vgc::core::Array<Rect2d> rects = randomRects(n, 1000, 50);
+    Bvh2d bvh;
+    IntArray ids;
+    for (Int i = 0; i < n; ++i) {
+        ids.append(bvh.insert(rects[i], i));
+    }
+
+    // Move half of the items and remove a quarter of them
+    vgc::core::Array<Rect2d> moved = randomRects(n, 1000, 50);
+    for (Int i = 0; i < n; i += 2) {
+        rects[i] = moved[i];
+        bvh.move(ids[i], rects[i]);
+    }
+    for (Int i = 1; i < n; i += 4) {
+        rects[i] = Rect2d::empty; // never intersects
+        bvh.remove(ids[i]);
+    }
+    EXPECT_EQ(bvh.numItems(), n - n / 4);
+
+    // The tree is balanced
+    EXPECT_LT(bvh.height(), 4 * std::log2(static_cast<double>(n)));
+
+    for (const Rect2d& query : randomRects(100, 1000, 200)) {
+        IntArray found;
+        bvh.findIntersecting(query, found);
+        EXPECT_EQ(sortedValues(bvh, found), bruteForceIntersecting(rects, query));
+    }
+
+    for (const Rect2d& query : randomRects(100, 1000, 0)) {
+        Vec2d p = query.pMin();
+        double maxDistance = 30;
+        double d = 0;
+        Int nearest = bvh.findNearest(
+            p, [&](Int id) { return Bvh2d::distance(bvh.rect(id), p); }, maxDistance, &d);
+        double expected = maxDistance;
+        for (const Rect2d& r : rects) {
+            if (!r.isEmpty()) {
+                expected = (std::min)(expected, Bvh2d::distance(r, p));
+            }
+        }
+        EXPECT_EQ(d, expected);
+        if (nearest != -1) {
+            EXPECT_EQ(Bvh2d::distance(rects[bvh.value(nearest)], p), expected);
+        }
+    }
+}
+
+TEST(TestBvh2d, CurveSegmentBoundingRect) {
+    Curve c;
+    c.addControlPoint(0, 0, 2);
+    c.addControlPoint(10, 5, 4);
+    c.addControlPoint(20, 0, 2);
+    EXPECT_EQ(c.numSegments(), 2);
+    EXPECT_THROW(c.segmentBoundingRect(2), vgc::core::IndexError);
+
+    // Every vertex of the triangulation must be in the bounding rect of the curve
+    Rect2d bbox = c.boundingRect();
+    for (const Vec2d& v : c.triangulate()) {
+        EXPECT_TRUE(bbox.contains(v));
+    }
+    EXPECT_EQ(bbox, c.segmentBoundingRect(0).unitedWith(c.segmentBoundingRect(1)));
+}
+
+#ifndef VGC_DEBUG_BUILD
+
+TEST(TestBvh2d, FindIntersectingPerf) {
+    Int n = 100000;
+    Int numQueries = 1000;
+    vgc::core::Array<Rect2d> rects = randomRects(n, 10000, 20);
+    vgc::core::Array<Rect2d> queries = randomRects(numQueries, 10000, 100);
+
+    vgc::core::Stopwatch s;
+    Bvh2d bvh;
+    for (Int i = 0; i < n; ++i) {
+        bvh.insert(rects[i], i);
+    }
+    double elapsedBuild = s.elapsed();
+
+    s.restart();
+    Int numFoundBruteForce = 0;
+    for (const Rect2d& query : queries) {
+        numFoundBruteForce += bruteForceIntersecting(rects, query).length();
+    }
+    double elapsedBruteForce = s.elapsed();
+
+    s.restart();
+    Int numFoundBvh = 0;
+    IntArray found;
+    for (const Rect2d& query : queries) {
+        found.clear();
+        bvh.findIntersecting(query, found);
+        numFoundBvh += found.length();
+    }
+    double elapsedBvh = s.elapsed();
+
+    EXPECT_EQ(numFoundBvh, numFoundBruteForce);
+    vgc::core::print("Build BVH of {} items = {:.7f} sec.\n", n, elapsedBuild);
+    vgc::core::print("Brute force queries   = {:.7f} sec.\n", elapsedBruteForce);
+    vgc::core::print("BVH queries           = {:.7f} sec.\n", elapsedBvh);
+    EXPECT_LT(elapsedBvh, 0.1 * elapsedBruteForce);
+}
+
+#endif // VGC_DEBUG_BUILD
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
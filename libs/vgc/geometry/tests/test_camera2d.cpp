@@ -0,0 +1,141 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+#include <vgc/core/array.h>
+#include <vgc/core/arithmetic.h>
+#include <vgc/geometry/camera2d.h>
+#include <vgc/geometry/curves2d.h>
+
+using vgc::Int;
+using vgc::geometry::Camera2d;
+using vgc::geometry::Curves2d;
+using vgc::geometry::Rect2d;
+
+namespace {
+
+void expectRectNear(const Rect2d& r, const Rect2d& expected) {
+    EXPECT_NEAR(r.xMin(), expected.xMin(), 1e-9);
+    EXPECT_NEAR(r.yMin(), expected.yMin(), 1e-9);
+    EXPECT_NEAR(r.xMax(), expected.xMax(), 1e-9);
+    EXPECT_NEAR(r.yMax(), expected.yMax(), 1e-9);
+}
+
+Curves2d square(double x, double y, double side) {
+    Curves2d c;
+    c.moveTo(x, y);
+    c.lineTo(x + side, y);
+    c.lineTo(x + side, y + side);
+    c.lineTo(x, y + side);
+    c.close();
+    return c;
+}
+
+// Returns the bounding rectangle of the MoveTo and LineTo control points of
+// the given curves, which is all that the squares above use.
+//
+Rect2d controlPointsBoundingRect(const Curves2d& curves) {
+    Rect2d res = Rect2d::empty;
+    for (vgc::geometry::Curves2dCommandRef c : curves.commands()) {
+        vgc::geometry::CurveCommandType type = c.type();
+        if (type == vgc::geometry::CurveCommandType::MoveTo
+            || type == vgc::geometry::CurveCommandType::LineTo) {
+
+            res.uniteWith(c.p());
+        }
+    }
+    return res;
+}
+
+// Returns the indices of the given curves that are not culled, using the
+// same test as OpenGLViewer::paintGL().
+//
+vgc::core::IntArray visibleCurves(
+    const Camera2d& camera,
+    const vgc::core::Array<Curves2d>& curves,
+    double margin = 0) {
+
+    vgc::core::IntArray res;
+    Rect2d visibleRect = camera.visibleRect(margin);
+    for (Int i = 0; i < curves.length(); ++i) {
+        if (controlPointsBoundingRect(curves[i]).intersects(visibleRect)) {
+            res.append(i);
+        }
+    }
+    return res;
+}
+
+} // namespace
+
+TEST(TestCamera2d, VisibleRectDefault) {
+    Camera2d camera;
+    camera.setViewportSize(200, 100);
+    expectRectNear(camera.visibleRect(), Rect2d(-100, -50, 100, 50));
+}
+
+TEST(TestCamera2d, VisibleRectZoomed) {
+    Camera2d camera;
+    camera.setViewportSize(200, 100);
+    camera.setZoom(2);
+    expectRectNear(camera.visibleRect(), Rect2d(-50, -25, 50, 25));
+
+    // The margin is in viewport pixels, so it is divided by the zoom.
+    expectRectNear(camera.visibleRect(10), Rect2d(-55, -30, 55, 30));
+}
+
+TEST(TestCamera2d, VisibleRectRotated) {
+    Camera2d camera;
+    camera.setViewportSize(200, 100);
+    camera.setRotation(vgc::core::pi / 2);
+    expectRectNear(camera.visibleRect(), Rect2d(-50, -100, 50, 100));
+
+    // With a 45° rotation, the visible rectangle is the bounding box of the
+    // rotated viewport, which is larger than the viewport itself.
+    camera.setRotation(vgc::core::pi / 4);
+    camera.setZoom(0.5);
+    double d = 150 * std::sqrt(2.0);
+    expectRectNear(camera.visibleRect(), Rect2d(-d, -d, d, d));
+}
+
+TEST(TestCamera2d, CullOffscreenCurves) {
+    vgc::core::Array<Curves2d> curves;
+    curves.append(square(-5, -5, 10));     // 0: at the center
+    curves.append(square(60, 0, 20));      // 1: right of the viewport
+    curves.append(square(0, 40, 10));      // 2: below the viewport
+    curves.append(square(-500, -500, 10)); // 3: far away
+    curves.append(square(45, 20, 20));     // 4: overlaps the bottom-right corner
+
+    Camera2d camera;
+    camera.setViewportSize(200, 100);
+    camera.setZoom(2);
+    EXPECT_EQ(visibleCurves(camera, curves), vgc::core::IntArray({0, 4}));
+
+    // A margin keeps curves which are just outside the viewport. Here, the
+    // curve 1 is 10 world units = 20 pixels to the right of the viewport.
+    EXPECT_EQ(visibleCurves(camera, curves, 19), vgc::core::IntArray({0, 4}));
+    EXPECT_EQ(visibleCurves(camera, curves, 21), vgc::core::IntArray({0, 1, 4}));
+
+    // After a rotation of 90°, the visible area is taller than wide.
+    camera.setRotation(vgc::core::pi / 2);
+    EXPECT_EQ(visibleCurves(camera, curves), vgc::core::IntArray({0, 2}));
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,180 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+
+#include <gtest/gtest.h>
+#include <vgc/core/exceptions.h>
+#include <vgc/core/stopwatch.h>
+#include <vgc/geometry/curve.h>
+
+using vgc::Int;
+using vgc::geometry::Curve;
+using vgc::geometry::Vec2d;
+
+namespace {
+
+// Control points regularly spaced on a circle of the given radius.
+//
+Curve arc(Int numControlPoints, double radius, double angle) {
+    Curve c;
+    for (Int i = 0; i < numControlPoints; ++i) {
+        double t = angle * i / static_cast<double>(numControlPoints - 1);
+        c.addControlPoint(radius * std::cos(t), radius * std::sin(t), 1.0);
+    }
+    return c;
+}
+
+// Wavy curve with many control points.
+//
+Curve wave(Int numControlPoints) {
+    Curve c;
+    for (Int i = 0; i < numControlPoints; ++i) {
+        double x = static_cast<double>(i);
+        c.addControlPoint(x, 5 * std::sin(0.3 * x), 1.0);
+    }
+    return c;
+}
+
+} // namespace
+
+TEST(TestCurve, LengthOfLine) {
+    Curve c;
+    c.addControlPoint(0, 0, 1);
+    c.addControlPoint(10, 0, 1);
+    c.addControlPoint(20, 0, 1);
+    EXPECT_NEAR(c.length(), 20, 1e-12);
+    EXPECT_NEAR((c.positionAtLength(5) - Vec2d(5, 0)).length(), 0, 1e-9);
+    EXPECT_NEAR((c.positionAtLength(13) - Vec2d(13, 0)).length(), 0, 1e-9);
+    EXPECT_EQ(c.positionAtLength(-1), Vec2d(0, 0));
+    EXPECT_EQ(c.positionAtLength(100), Vec2d(20, 0));
+}
+
+TEST(TestCurve, LengthOfArc) {
+    double pi = 3.141592653589793;
+    Curve c = arc(30, 100, pi);
+    EXPECT_NEAR(c.length(), 100 * pi, 0.1);
+
+    // Positions at regular arc lengths should be regularly spaced on the
+    // circle, at least away from the end segments.
+    double l = c.length();
+    for (Int i = 1; i < 9; ++i) {
+        Vec2d p1 = c.positionAtLength(0.1 * i * l);
+        Vec2d p2 = c.positionAtLength(0.1 * (i + 1) * l);
+        EXPECT_NEAR((p2 - p1).length(), 200 * std::sin(pi / 20), 0.1);
+    }
+}
+
+TEST(TestCurve, LengthIsUpdatedWhenAddingControlPoints) {
+    Curve c1 = wave(100);
+    Curve c2;
+    for (Int i = 0; i < 100; ++i) {
+        c2.addControlPoint(c1.positionData()[2 * i], c1.positionData()[2 * i + 1], 1.0);
+        EXPECT_GE(c2.length(), 0);
+    }
+    EXPECT_NEAR(c1.length(), c2.length(), 1e-9);
+}
+
+TEST(TestCurve, SetControlPoint) {
+    Curve c1 = wave(100);
+    EXPECT_GT(c1.length(), 0); // compute and cache arc lengths
+    c1.triangulate();          // compute and cache Bézier control points
+    for (Int i : {0, 1, 50, 98, 99}) {
+        c1.setControlPoint(i, Vec2d(i, 10), 2.0);
+        Curve c2;
+        const vgc::core::DoubleArray& d = c1.positionData();
+        for (Int j = 0; j < 100; ++j) {
+            c2.addControlPoint(Vec2d(d[2 * j], d[2 * j + 1]), c1.widthData()[j]);
+        }
+        EXPECT_NEAR(c1.length(), c2.length(), 1e-9);
+        EXPECT_EQ(c1.triangulate(), c2.triangulate());
+        EXPECT_EQ(c1.boundingRect(), c2.boundingRect());
+        Vec2d target(i + 0.3, 12);
+        EXPECT_EQ(c1.closestPoint(target), c2.closestPoint(target));
+        Vec2d p1 = c1.positionAtLength(30);
+        Vec2d p2 = c2.positionAtLength(30);
+        EXPECT_NEAR((p1 - p2).length(), 0, 1e-9);
+    }
+    EXPECT_EQ(c1.numControlPoints(), 100);
+    EXPECT_THROW(c1.setControlPoint(100, Vec2d(0, 0)), vgc::core::IndexError);
+    EXPECT_THROW(c1.setControlPoint(-1, Vec2d(0, 0)), vgc::core::IndexError);
+}
+
+TEST(TestCurve, Empty) {
+    Curve c;
+    EXPECT_EQ(c.length(), 0);
+    EXPECT_THROW(c.positionAtLength(0), vgc::core::IndexError);
+    EXPECT_THROW(c.closestPoint(Vec2d(0, 0)), vgc::core::IndexError);
+    c.addControlPoint(1, 2, 1);
+    EXPECT_EQ(c.length(), 0);
+    EXPECT_EQ(c.positionAtLength(0), Vec2d(1, 2));
+    EXPECT_EQ(c.closestPoint(Vec2d(0, 0)), Vec2d(1, 2));
+}
+
+TEST(TestCurve, ClosestPoint) {
+    Curve c = wave(50);
+
+    // Dense sampling of the curve by arc length, for brute force comparison
+    double l = c.length();
+    Int numSamples = 20000;
+    vgc::geometry::Vec2dArray samples;
+    for (Int i = 0; i <= numSamples; ++i) {
+        samples.append(c.positionAtLength(l * i / numSamples));
+    }
+
+    for (Int i = 0; i < 50; ++i) {
+        Vec2d p(i - 2.5, 8 * std::cos(0.7 * i));
+        double s = 0;
+        Vec2d q = c.closestPoint(p, &s);
+        double d = (q - p).length();
+        double expected = vgc::core::infinity<double>;
+        for (const Vec2d& sample : samples) {
+            expected = (std::min)(expected, (sample - p).length());
+        }
+        EXPECT_LE(d, expected + 1e-9);
+        EXPECT_GE(d, expected - l / numSamples);
+        EXPECT_NEAR((c.positionAtLength(s) - q).length(), 0, 1e-6);
+    }
+}
+
+#ifndef VGC_DEBUG_BUILD
+
+TEST(TestCurve, ClosestPointPerf) {
+    Curve c = wave(100000);
+    c.length(); // build the arc-length table
+
+    Int numQueries = 10000;
+    vgc::core::Stopwatch s;
+    double sum = 0;
+    for (Int i = 0; i < numQueries; ++i) {
+        Vec2d p(10.0 * i, 10 * std::cos(0.7 * i));
+        sum += (c.closestPoint(p) - p).length();
+    }
+    double elapsed = s.elapsed();
+    EXPECT_GT(sum, 0);
+    vgc::core::print("{} closest point queries = {:.7f} sec.\n", numQueries, elapsed);
+
+    // Each query should be way faster than visiting the 100k segments
+    EXPECT_LT(elapsed / numQueries, 1e-4);
+}
+
+#endif // VGC_DEBUG_BUILD
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
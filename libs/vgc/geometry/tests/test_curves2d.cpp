@@ -0,0 +1,217 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+#include <vgc/core/array.h>
+#include <vgc/geometry/bezier.h>
+#include <vgc/geometry/curves2d.h>
+
+using vgc::Int;
+using vgc::UInt16;
+using vgc::UInt32;
+using vgc::core::DoubleArray;
+using vgc::core::FloatArray;
+using vgc::geometry::Curves2d;
+using vgc::geometry::Curves2dSampleParams;
+using vgc::geometry::Vec2d;
+using vgc::geometry::Vec2dArray;
+
+namespace {
+
+Curves2d openCurve() {
+    Curves2d c;
+    c.moveTo(0, 0);
+    c.cubicBezierTo(10, 20, 30, 20, 40, 0);
+    c.lineTo(60, 10);
+    return c;
+}
+
+Curves2d closedCurve() {
+    Curves2d c;
+    c.moveTo(0, 0);
+    c.lineTo(10, 0);
+    c.quadraticBezierTo(15, 5, 10, 10);
+    c.lineTo(0, 10);
+    c.lineTo(0, 0);
+    c.close();
+    return c;
+}
+
+// Expands an indexed triangle mesh into a triangle soup.
+//
+template<typename TFloat, typename TIndex>
+DoubleArray expand(
+    const vgc::core::Array<TFloat>& vertices,
+    const vgc::core::Array<TIndex>& indices) {
+
+    DoubleArray res;
+    for (TIndex i : indices) {
+        res.append(vertices[2 * static_cast<Int>(i)]);
+        res.append(vertices[2 * static_cast<Int>(i) + 1]);
+    }
+    return res;
+}
+
+Vec2dArray samplePositions(const Curves2d& c, const Curves2dSampleParams& params) {
+    Vec2dArray res;
+    Curves2d samples = c.sample(params);
+    for (vgc::geometry::Curves2dCommandRef command : samples.commands()) {
+        res.append(command.p());
+    }
+    return res;
+}
+
+// Returns the distance between the point p and the polyline.
+//
+double distanceToPolyline(const Vec2d& p, const Vec2dArray& polyline) {
+    double res = (p - polyline.first()).length();
+    for (Int i = 1; i < polyline.length(); ++i) {
+        Vec2d a = polyline[i - 1];
+        Vec2d ab = polyline[i] - a;
+        double l2 = ab.squaredLength();
+        double t = l2 > 0 ? std::clamp((p - a).dot(ab) / l2, 0.0, 1.0) : 0.0;
+        res = (std::min)(res, (p - (a + t * ab)).length());
+    }
+    return res;
+}
+
+} // namespace
+
+TEST(TestCurves2d, SampleUniform) {
+    Curves2d c = openCurve();
+    Curves2d samples = c.sample(Curves2dSampleParams::uniform(4));
+    DoubleArray expected = {0, 0};
+    for (Int j = 1; j <= 4; ++j) {
+        Vec2d p = vgc::geometry::cubicBezier(
+            Vec2d(0, 0), Vec2d(10, 20), Vec2d(30, 20), Vec2d(40, 0), 0.25 * j);
+        expected.extend({p[0], p[1]});
+    }
+    expected.extend({60, 10});
+    DoubleArray actual;
+    for (vgc::geometry::Curves2dCommandRef command : samples.commands()) {
+        Vec2d p = command.p();
+        actual.extend({p[0], p[1]});
+    }
+    ASSERT_EQ(actual.length(), expected.length());
+    for (Int i = 0; i < actual.length(); ++i) {
+        EXPECT_NEAR(actual[i], expected[i], 1e-12);
+    }
+}
+
+TEST(TestCurves2d, SampleErrorBounded) {
+    Vec2d p0(0, 0);
+    Vec2d p1(10, 20);
+    Vec2d p2(30, 20);
+    Vec2d p3(40, 0);
+    Curves2d quadratic;
+    quadratic.moveTo(p0);
+    quadratic.quadraticBezierTo(p1, p3);
+    Curves2d cubic;
+    cubic.moveTo(p0);
+    cubic.cubicBezierTo(p1, p2, p3);
+
+    for (double maxError : {1.0, 0.1, 0.01}) {
+        Curves2dSampleParams params = Curves2dSampleParams::errorBounded(maxError, 1024);
+        for (const Curves2d* c : {&quadratic, &cubic}) {
+            Vec2dArray polyline = samplePositions(*c, params);
+            EXPECT_EQ(polyline.first(), p0);
+            EXPECT_EQ(polyline.last(), p3);
+            for (Int i = 0; i <= 1000; ++i) {
+                double u = i / 1000.0;
+                Vec2d p = (c == &cubic) ? vgc::geometry::cubicBezier(p0, p1, p2, p3, u)
+                                        : vgc::geometry::quadraticBezier(p0, p1, p3, u);
+                EXPECT_LE(distanceToPolyline(p, polyline), maxError);
+            }
+        }
+    }
+
+    // Smaller errors require more samples, but never more than the max
+    using Params = Curves2dSampleParams;
+    Int n1 = samplePositions(cubic, Params::errorBounded(1.0)).length();
+    Int n2 = samplePositions(cubic, Params::errorBounded(0.1)).length();
+    Int n3 = samplePositions(cubic, Params::errorBounded(0.1, 6)).length();
+    EXPECT_LT(n1, n2);
+    EXPECT_EQ(n3, 1 + 4);
+}
+
+TEST(TestCurves2d, StrokeIndexed) {
+    Curves2dSampleParams params = Curves2dSampleParams::adaptive();
+    for (const Curves2d& c : {openCurve(), closedCurve()}) {
+        DoubleArray soup;
+        c.stroke(soup, 2.0, params);
+
+        DoubleArray vertices;
+        vgc::core::Array<UInt32> indices;
+        c.stroke(vertices, indices, 2.0, params);
+
+        ASSERT_EQ(indices.length() % 3, 0);
+        EXPECT_EQ(expand(vertices, indices), soup);
+        EXPECT_LT(vertices.length(), soup.length() / 2);
+    }
+}
+
+TEST(TestCurves2d, StrokeIndexedStitched) {
+    Curves2dSampleParams params = Curves2dSampleParams::adaptive();
+    Curves2d c1 = openCurve();
+    Curves2d c2 = closedCurve();
+
+    DoubleArray soup;
+    c1.stroke(soup, 3.0, params);
+    c2.stroke(soup, 3.0, params);
+
+    FloatArray vertices;
+    vgc::core::Array<UInt16> indices;
+    c1.stroke(vertices, indices, 3.0, params);
+    c2.stroke(vertices, indices, 3.0, params);
+
+    DoubleArray expanded = expand(vertices, indices);
+    ASSERT_EQ(expanded.length(), soup.length());
+    for (Int i = 0; i < soup.length(); ++i) {
+        EXPECT_NEAR(expanded[i], soup[i], 1e-4);
+    }
+}
+
+TEST(TestCurves2d, StrokeIndexedOverflow) {
+    Curves2dSampleParams params = Curves2dSampleParams::adaptive();
+    Curves2d c = openCurve();
+
+    // Fill the vertex array almost up to the maximum 16-bit index, so that
+    // stroking the curve overflows half-way through.
+    FloatArray vertices(2 * (65536 - 4), 0.0f);
+    vgc::core::Array<UInt16> indices = {0, 1, 2};
+    FloatArray oldVertices = vertices;
+    vgc::core::Array<UInt16> oldIndices = indices;
+
+    EXPECT_THROW(
+        c.stroke(vertices, indices, 2.0, params), vgc::core::IntegerOverflowError);
+    EXPECT_EQ(vertices, oldVertices);
+    EXPECT_EQ(indices, oldIndices);
+}
+
+TEST(TestCurves2d, TransformAffine) {
+    Curves2d c = openCurve();
+    EXPECT_EQ(c.controlPointsBoundingRect(), vgc::geometry::Rect2d(0, 0, 60, 20));
+    c.transformAffine(vgc::geometry::Mat3d(2, 0, 1, 0, -1, 0, 0, 0, 1));
+    EXPECT_EQ(c.controlPointsBoundingRect(), vgc::geometry::Rect2d(1, -20, 121, 0));
+    EXPECT_EQ(Curves2d().controlPointsBoundingRect(), vgc::geometry::Rect2d::empty);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,299 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <vgc/core/format.h>
+#include <vgc/core/stopwatch.h>
+#include <vgc/geometry/mat3f.h>
+#include <vgc/geometry/mat4d.h>
+#include <vgc/geometry/mat4f.h>
+
+using vgc::Int;
+using vgc::geometry::Mat3f;
+using vgc::geometry::Mat4d;
+using vgc::geometry::Mat4f;
+using vgc::geometry::Vec2f;
+using vgc::geometry::Vec3f;
+using vgc::geometry::Vec4f;
+
+namespace {
+
+// Deterministic pseudo-random numbers in [-1, 1)
+class Random {
+public:
+    float operator()() {
+        state_ = state_ * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<float>(state_ >> 40) / (1 << 23) - 1.0f;
+    }
+
+private:
+    vgc::UInt64 state_ = 1;
+};
+
+template<typename TMat>
+TMat randomMat(Random& random) {
+    TMat m;
+    for (Int i = 0; i < TMat::dimension; ++i) {
+        for (Int j = 0; j < TMat::dimension; ++j) {
+            m(i, j) = random();
+        }
+    }
+    return m;
+}
+
+// Straightforward scalar implementations, computed in double precision
+template<typename TMat>
+TMat referenceMultiply(const TMat& m1, const TMat& m2) {
+    TMat res;
+    for (Int i = 0; i < TMat::dimension; ++i) {
+        for (Int j = 0; j < TMat::dimension; ++j) {
+            double x = 0;
+            for (Int k = 0; k < TMat::dimension; ++k) {
+                x += static_cast<double>(m1(i, k)) * m2(k, j);
+            }
+            res(i, j) = static_cast<float>(x);
+        }
+    }
+    return res;
+}
+
+template<typename TMat>
+void expectNear(const TMat& m1, const TMat& m2, float tol) {
+    for (Int i = 0; i < TMat::dimension; ++i) {
+        for (Int j = 0; j < TMat::dimension; ++j) {
+            EXPECT_NEAR(m1(i, j), m2(i, j), tol) << "i = " << i << ", j = " << j;
+        }
+    }
+}
+
+} // namespace
+
+TEST(TestMatSimd, Multiply) {
+    Random random;
+    for (int k = 0; k < 100; ++k) {
+        Mat3f a3 = randomMat<Mat3f>(random);
+        Mat3f b3 = randomMat<Mat3f>(random);
+        expectNear(a3 * b3, referenceMultiply(a3, b3), 1e-5f);
+        Mat4f a4 = randomMat<Mat4f>(random);
+        Mat4f b4 = randomMat<Mat4f>(random);
+        expectNear(a4 * b4, referenceMultiply(a4, b4), 1e-5f);
+    }
+}
+
+TEST(TestMatSimd, Transform) {
+    Random random;
+    for (int k = 0; k < 100; ++k) {
+        Mat3f m3 = randomMat<Mat3f>(random);
+        Mat4f m4 = randomMat<Mat4f>(random);
+        Vec3f v(random(), random(), random());
+        Vec4f v4(v[0], v[1], v[2], 1);
+
+        Vec3f r3 = m3 * v;
+        Vec4f r4 = m4 * v4;
+        for (Int i = 0; i < 3; ++i) {
+            double x3 = 0;
+            for (Int j = 0; j < 3; ++j) {
+                x3 += static_cast<double>(m3(i, j)) * v[j];
+            }
+            EXPECT_NEAR(r3[i], x3, 1e-5);
+        }
+        for (Int i = 0; i < 4; ++i) {
+            double x4 = 0;
+            for (Int j = 0; j < 4; ++j) {
+                x4 += static_cast<double>(m4(i, j)) * v4[j];
+            }
+            EXPECT_NEAR(r4[i], x4, 1e-5);
+        }
+
+        Vec3f p = m4.transformPointAffine(v);
+        EXPECT_EQ(p, Vec3f(r4[0], r4[1], r4[2]));
+        Vec3f q = m4.transformPoint(v);
+        EXPECT_NEAR(q[0] * r4[3], r4[0], 1e-5);
+        Vec2f w = m3.transformPoint(Vec2f(v[0], v[1]));
+        Vec3f w3 = m3 * Vec3f(v[0], v[1], 1);
+        EXPECT_NEAR(w[1] * w3[2], w3[1], 1e-5);
+    }
+}
+
+TEST(TestMatSimd, Translate) {
+    Random random;
+    for (int k = 0; k < 100; ++k) {
+        float x = random();
+        float y = random();
+        float z = random();
+        Mat3f m3 = randomMat<Mat3f>(random);
+        Mat3f t3 = Mat3f::identity;
+        t3(0, 2) = x;
+        t3(1, 2) = y;
+        expectNear(Mat3f(m3).translate(x, y), m3 * t3, 1e-5f);
+        Mat4f m4 = randomMat<Mat4f>(random);
+        Mat4f t4 = Mat4f::identity;
+        t4(0, 3) = x;
+        t4(1, 3) = y;
+        t4(2, 3) = z;
+        expectNear(Mat4f(m4).translate(x, y, z), m4 * t4, 1e-5f);
+    }
+}
+
+TEST(TestMatSimd, Inverse) {
+    // Integer matrices have exact cofactors and determinant
+    Mat4f m(+1,  2,  3,   4,
+            -1, -3, -12, -4,
+            +7,  8,  9,   5,
+            -6, -5, -8,  -9);
+    Mat4f inv = (1.0f / 589) * Mat4f(-365, 17, -13, -177,
+                                     +347, 50, 135, 207,
+                                     -104, -71, -15, -23,
+                                     +143, 24, -53, -42);
+    bool isInvertible = false;
+    EXPECT_EQ(m.inverted(&isInvertible), inv);
+    EXPECT_TRUE(isInvertible);
+    EXPECT_EQ(Mat4d(m).inverted(), (1.0 / 589) * Mat4d(-365, 17, -13, -177,
+                                                        +347, 50, 135, 207,
+                                                        -104, -71, -15, -23,
+                                                        +143, 24, -53, -42));
+
+    Mat4f singular(1, 2, 3, 4,
+                   2, 4, 6, 8,
+                   0, 1, 0, 1,
+                   1, 0, 0, 1);
+    Mat4f infs = singular.inverted(&isInvertible);
+    EXPECT_FALSE(isInvertible);
+    EXPECT_TRUE(std::isinf(infs(0, 0)));
+    EXPECT_TRUE(std::isinf(infs(3, 3)));
+    m.inverted(&isInvertible, 1000);
+    EXPECT_FALSE(isInvertible);
+
+    Random random;
+    for (int k = 0; k < 100; ++k) {
+        // Diagonally dominant, hence well-conditioned
+        Mat4f a = randomMat<Mat4f>(random) + 4 * Mat4f::identity;
+        expectNear(a * a.inverted(), Mat4f::identity, 1e-5f);
+        expectNear(a.inverted() * a, Mat4f::identity, 1e-5f);
+    }
+}
+
+#ifndef VGC_DEBUG_BUILD
+
+template<typename T>
+float checksum(const std::vector<T>& v) {
+    float res = 0;
+    for (const T& x : v) {
+        const float* p = reinterpret_cast<const float*>(&x);
+        for (size_t i = 0; i < sizeof(T) / sizeof(float); ++i) {
+            res += p[i];
+        }
+    }
+    return res;
+}
+
+TEST(TestMatSimd, Perf) {
+    // Applies each operation to arrays of random inputs, so that timings
+    // measure throughput rather than latency, and values stay normalized.
+    constexpr Int n = 1000;
+    constexpr Int repeat = 1000;
+    Random random;
+    std::vector<Mat3f> m3s;
+    std::vector<Mat4f> m4s;
+    std::vector<Vec2f> v2s;
+    std::vector<Vec3f> v3s;
+    for (Int i = 0; i < n; ++i) {
+        m3s.push_back(randomMat<Mat3f>(random) + 4 * Mat3f::identity);
+        m4s.push_back(randomMat<Mat4f>(random) + 4 * Mat4f::identity);
+        v2s.push_back(Vec2f(random(), random()));
+        v3s.push_back(Vec3f(random(), random(), random()));
+    }
+    Mat3f a3 = randomMat<Mat3f>(random);
+    Mat4f a4 = randomMat<Mat4f>(random);
+    std::vector<Mat3f> out3(n);
+    std::vector<Mat4f> out4(n);
+    std::vector<Vec2f> out2f(n);
+    std::vector<Vec3f> out3f(n);
+    float sum = 0;
+
+    auto report = [](const char* name, double seconds) {
+        vgc::core::print("{:<28} {:.2f} ns\n", name, seconds * 1e9 / (n * repeat));
+    };
+
+    vgc::core::Stopwatch s;
+    for (Int k = 0; k < repeat; ++k) {
+        for (Int i = 0; i < n; ++i) {
+            out3[i] = m3s[i] * a3;
+        }
+    }
+    report("Mat3f * Mat3f", s.elapsed());
+    sum += checksum(out3);
+
+    s.restart();
+    for (Int k = 0; k < repeat; ++k) {
+        for (Int i = 0; i < n; ++i) {
+            out4[i] = m4s[i] * a4;
+        }
+    }
+    report("Mat4f * Mat4f", s.elapsed());
+    sum += checksum(out4);
+
+    s.restart();
+    for (Int k = 0; k < repeat; ++k) {
+        for (Int i = 0; i < n; ++i) {
+            out4[i] = m4s[i].inverted();
+        }
+    }
+    report("Mat4f::inverted()", s.elapsed());
+    sum += checksum(out4);
+
+    s.restart();
+    for (Int k = 0; k < repeat; ++k) {
+        for (Int i = 0; i < n; ++i) {
+            out4[i] = m4s[i];
+            out4[i].translate(v3s[i]);
+        }
+    }
+    report("Mat4f::translate()", s.elapsed());
+    sum += checksum(out4);
+
+    s.restart();
+    for (Int k = 0; k < repeat; ++k) {
+        for (Int i = 0; i < n; ++i) {
+            out3f[i] = m4s[i].transformPoint(v3s[i]);
+        }
+    }
+    report("Mat4f::transformPoint(Vec3f)", s.elapsed());
+    sum += checksum(out3f);
+
+    s.restart();
+    for (Int k = 0; k < repeat; ++k) {
+        for (Int i = 0; i < n; ++i) {
+            out2f[i] = m3s[i].transformPoint(v2s[i]);
+        }
+    }
+    report("Mat3f::transformPoint(Vec2f)", s.elapsed());
+    sum += checksum(out2f);
+
+    // Prevents the compiler from optimizing away the computations
+    EXPECT_FALSE(std::isnan(sum));
+}
+
+#endif // VGC_DEBUG_BUILD
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,297 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+#include <vgc/core/stopwatch.h>
+#include <vgc/geometry/points.h>
+
+using vgc::Int;
+using vgc::geometry::Mat3d;
+using vgc::geometry::Mat3f;
+using vgc::geometry::Mat4f;
+using vgc::geometry::Rect2d;
+using vgc::geometry::Rect2f;
+using vgc::geometry::Vec2d;
+using vgc::geometry::Vec2dArray;
+using vgc::geometry::Vec2dSoA;
+using vgc::geometry::Vec2f;
+using vgc::geometry::Vec2fArray;
+
+namespace {
+
+Vec2dArray pointsd(Int n) {
+    Vec2dArray res;
+    for (Int i = 0; i < n; ++i) {
+        res.append(Vec2d(std::cos(0.7 * i) * i, std::sin(1.3 * i) - 0.5 * i));
+    }
+    return res;
+}
+
+Vec2fArray pointsf(Int n) {
+    Vec2fArray res;
+    for (const Vec2d& p : pointsd(n)) {
+        res.append(Vec2f(static_cast<float>(p[0]), static_cast<float>(p[1])));
+    }
+    return res;
+}
+
+Mat3d affined() {
+    return Mat3d(2, 0.5, 10, -0.3, 3, 20, 0, 0, 1);
+}
+
+Mat3d projectived() {
+    return Mat3d(2, 0.5, 10, -0.3, 3, 20, 0.01, 0.02, 1);
+}
+
+Mat3f toMat3f(const Mat3d& m) {
+    Mat3f res;
+    for (Int i = 0; i < 3; ++i) {
+        for (Int j = 0; j < 3; ++j) {
+            res(i, j) = static_cast<float>(m(i, j));
+        }
+    }
+    return res;
+}
+
+Mat4f toMat4f(const Mat3d& m) {
+    Mat4f res = Mat4f::identity;
+    Int k[3] = {0, 1, 3};
+    for (Int i = 0; i < 3; ++i) {
+        for (Int j = 0; j < 3; ++j) {
+            res(k[i], k[j]) = static_cast<float>(m(i, j));
+        }
+    }
+    return res;
+}
+
+template<typename TVec2>
+void expectNear(const TVec2& p, const TVec2& q) {
+    EXPECT_NEAR(p[0], q[0], 1e-5 * (1 + std::abs(q[0])));
+    EXPECT_NEAR(p[1], q[1], 1e-5 * (1 + std::abs(q[1])));
+}
+
+} // namespace
+
+TEST(TestPoints, TransformPoints) {
+    // Test all sizes up to 9 to cover the remainder handling of the SIMD loops
+    for (Int n = 0; n < 10; ++n) {
+        for (const Mat3d& m : {affined(), projectived()}) {
+            Vec2dArray in = pointsd(n);
+            Vec2dArray out(n);
+            vgc::geometry::transformPoints(m, in.data(), out.data(), n);
+            for (Int i = 0; i < n; ++i) {
+                expectNear(out[i], m.transformPoint(in[i]));
+            }
+            vgc::geometry::transformPoints(m, in); // in place
+            EXPECT_EQ(in, out);
+
+            Vec2fArray inf = pointsf(n);
+            Vec2fArray outf(n);
+            Mat3f mf = toMat3f(m);
+            vgc::geometry::transformPoints(mf, inf.data(), outf.data(), n);
+            for (Int i = 0; i < n; ++i) {
+                expectNear(outf[i], mf.transformPoint(inf[i]));
+            }
+            Mat4f m4 = toMat4f(m);
+            vgc::geometry::transformPoints(m4, inf);
+            for (Int i = 0; i < n; ++i) {
+                expectNear(inf[i], outf[i]);
+            }
+        }
+    }
+}
+
+TEST(TestPoints, TransformPointsAffine) {
+    Mat3d m = projectived();
+    Vec2dArray in = pointsd(7);
+    Vec2dArray out = in;
+    vgc::geometry::transformPointsAffine(m, out);
+    Vec2fArray inf = pointsf(7);
+    Vec2fArray outf = inf;
+    vgc::geometry::transformPointsAffine(toMat4f(m), outf);
+    for (Int i = 0; i < in.length(); ++i) {
+        expectNear(out[i], m.transformPointAffine(in[i]));
+        expectNear(outf[i], toMat3f(m).transformPointAffine(inf[i]));
+    }
+}
+
+TEST(TestPoints, BoundingRect) {
+    EXPECT_EQ(vgc::geometry::boundingRect(Vec2dArray()), Rect2d::empty);
+    EXPECT_EQ(vgc::geometry::boundingRect(Vec2fArray()), Rect2f::empty);
+    for (Int n = 1; n < 10; ++n) {
+        Vec2dArray points = pointsd(n);
+        Rect2d expected = Rect2d::empty;
+        for (const Vec2d& p : points) {
+            expected.uniteWith(p);
+        }
+        EXPECT_EQ(vgc::geometry::boundingRect(points), expected);
+
+        Vec2fArray pointsf_ = pointsf(n);
+        Rect2f expectedf = Rect2f::empty;
+        for (const Vec2f& p : pointsf_) {
+            expectedf.uniteWith(p);
+        }
+        EXPECT_EQ(vgc::geometry::boundingRect(pointsf_), expectedf);
+    }
+}
+
+TEST(TestPoints, ContainsPoints) {
+    Vec2dArray points = pointsd(50);
+    Rect2d rect(-10, -10, 10, 5);
+    vgc::core::Array<bool> isContained(points.length());
+    Int n = vgc::geometry::containsPoints(
+        rect, points.data(), points.length(), isContained.data());
+    Int expected = 0;
+    for (Int i = 0; i < points.length(); ++i) {
+        EXPECT_EQ(isContained[i], rect.contains(points[i]));
+        expected += rect.contains(points[i]) ? 1 : 0;
+    }
+    EXPECT_EQ(n, expected);
+    EXPECT_GT(n, 0);
+    EXPECT_LT(n, points.length());
+}
+
+TEST(TestPoints, SoA) {
+    for (Int n = 0; n < 10; ++n) {
+        Vec2dArray points = pointsd(n);
+        for (const Mat3d& m : {affined(), projectived()}) {
+            Vec2dArray expected = points;
+            vgc::geometry::transformPoints(m, expected);
+            Vec2dSoA soa(points);
+            vgc::geometry::transformPoints(m, soa);
+            for (Int i = 0; i < n; ++i) {
+                expectNear(soa[i], expected[i]);
+            }
+            vgc::geometry::transformPointsAffine(m, expected);
+            vgc::geometry::transformPointsAffine(m, soa);
+            for (Int i = 0; i < n; ++i) {
+                expectNear(soa[i], expected[i]);
+            }
+        }
+        Vec2dSoA soa(points);
+        EXPECT_EQ(vgc::geometry::boundingRect(soa), vgc::geometry::boundingRect(points));
+
+        Rect2d rect(-3, -2, 4, 1);
+        vgc::core::Array<bool> expected(n);
+        vgc::core::Array<bool> isContained(n);
+        EXPECT_EQ(
+            vgc::geometry::containsPoints(rect, soa, isContained.data()),
+            vgc::geometry::containsPoints(rect, points.data(), n, expected.data()));
+        EXPECT_EQ(isContained, expected);
+    }
+}
+
+#ifndef VGC_DEBUG_BUILD
+
+TEST(TestPoints, Perf) {
+    Int n = 1000000;
+    Vec2fArray points = pointsf(n);
+    Mat3f m = toMat3f(projectived());
+
+    vgc::core::Stopwatch s;
+    Vec2fArray expected = points;
+    for (Vec2f& p : expected) {
+        p = m.transformPoint(p);
+    }
+    double scalarTime = s.elapsed();
+
+    s.restart();
+    vgc::geometry::transformPoints(m, points);
+    double batchTime = s.elapsed();
+    EXPECT_EQ(points.length(), expected.length());
+
+    vgc::core::print(
+        "Transform {} points: scalar = {:.7f} sec, batch = {:.7f} sec.\n",
+        n,
+        scalarTime,
+        batchTime);
+
+    s.restart();
+    Rect2f expectedRect = Rect2f::empty;
+    for (const Vec2f& p : points) {
+        expectedRect.uniteWith(p);
+    }
+    scalarTime = s.elapsed();
+
+    s.restart();
+    Rect2f rect = vgc::geometry::boundingRect(points);
+    batchTime = s.elapsed();
+    EXPECT_EQ(rect, expectedRect);
+
+    vgc::core::print(
+        "Bounding rect of {} points: scalar = {:.7f} sec, batch = {:.7f} sec.\n",
+        n,
+        scalarTime,
+        batchTime);
+}
+
+TEST(TestPoints, PerfAoSvsSoA) {
+    Int n = 1000000;
+    Vec2dArray aos = pointsd(n);
+    Vec2dSoA soa(aos);
+    Mat3d affine = affined();
+    Mat3d projective = projectived();
+    Rect2d rect(-100, -100, 100, 100);
+    vgc::core::Array<bool> isContained(n);
+
+    vgc::core::Stopwatch s;
+    vgc::geometry::transformPoints(affine, aos);
+    double aosAffine = s.elapsed();
+    s.restart();
+    vgc::geometry::transformPoints(affine, soa);
+    double soaAffine = s.elapsed();
+
+    s.restart();
+    vgc::geometry::transformPoints(projective, aos);
+    double aosProjective = s.elapsed();
+    s.restart();
+    vgc::geometry::transformPoints(projective, soa);
+    double soaProjective = s.elapsed();
+
+    s.restart();
+    Rect2d aosRect = vgc::geometry::boundingRect(aos);
+    double aosBounds = s.elapsed();
+    s.restart();
+    Rect2d soaRect = vgc::geometry::boundingRect(soa);
+    double soaBounds = s.elapsed();
+    EXPECT_EQ(aosRect, soaRect);
+
+    s.restart();
+    Int aosContained =
+        vgc::geometry::containsPoints(rect, aos.data(), n, isContained.data());
+    double aosContains = s.elapsed();
+    s.restart();
+    Int soaContained = vgc::geometry::containsPoints(rect, soa, isContained.data());
+    double soaContains = s.elapsed();
+    EXPECT_EQ(aosContained, soaContained);
+
+    vgc::core::print("{} points, AoS vs SoA, in seconds:\n", n);
+    vgc::core::print("  affine transform:     {:.7f} vs {:.7f}\n", aosAffine, soaAffine);
+    vgc::core::print(
+        "  projective transform: {:.7f} vs {:.7f}\n", aosProjective, soaProjective);
+    vgc::core::print("  bounding rect:        {:.7f} vs {:.7f}\n", aosBounds, soaBounds);
+    vgc::core::print(
+        "  contains points:      {:.7f} vs {:.7f}\n", aosContains, soaContains);
+}
+
+#endif // VGC_DEBUG_BUILD
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,381 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <gtest/gtest.h>
+#include <tesselator.h> // libtess2
+#include <vgc/core/stopwatch.h>
+#include <vgc/geometry/curves2d.h>
+#include <vgc/geometry/polygontriangulator.h>
+
+using vgc::Int;
+using vgc::geometry::Curves2d;
+using vgc::geometry::PolygonTriangulator;
+using vgc::geometry::Vec2d;
+using vgc::geometry::Vec2dArray;
+using vgc::geometry::WindingRule;
+
+namespace {
+
+using Contours = vgc::core::Array<Vec2dArray>;
+
+Vec2dArray rect(double x1, double y1, double x2, double y2) {
+    return Vec2dArray{{x1, y1}, {x2, y1}, {x2, y2}, {x1, y2}};
+}
+
+Vec2dArray circle(const Vec2d& center, double radius, Int n, bool clockwise) {
+    Vec2dArray res;
+    double pi = 3.141592653589793;
+    for (Int i = 0; i < n; ++i) {
+        double t = (clockwise ? -2 : 2) * pi * i / n;
+        res.append(center + radius * Vec2d(std::cos(t), std::sin(t)));
+    }
+    return res;
+}
+
+// Returns the contours of the closed subcurves of a Curves2d, sampled
+// like Curves2d::fill() does.
+//
+Contours contours(const Curves2d& curves) {
+    Contours res;
+    Curves2d samples = curves.sample(vgc::geometry::Curves2dSampleParams::adaptive());
+    for (vgc::geometry::Curves2dCommandRef c : samples.commands()) {
+        if (c.type() == vgc::geometry::CurveCommandType::MoveTo) {
+            res.append(Vec2dArray{c.p()});
+        }
+        else if (c.type() == vgc::geometry::CurveCommandType::LineTo) {
+            res.last().append(c.p());
+        }
+    }
+    return res;
+}
+
+// Glyph-like outline of the letter 'S', made of Bézier curves.
+//
+Curves2d glyphS() {
+    Curves2d c;
+    c.moveTo(80, 10);
+    c.cubicBezierTo(60, -5, 10, -5, 5, 30);
+    c.lineTo(25, 32);
+    c.cubicBezierTo(30, 12, 55, 12, 60, 22);
+    c.cubicBezierTo(65, 35, 40, 40, 30, 45);
+    c.cubicBezierTo(5, 55, 0, 75, 20, 90);
+    c.cubicBezierTo(40, 100, 70, 100, 80, 75);
+    c.lineTo(62, 70);
+    c.quadraticBezierTo(55, 85, 40, 82);
+    c.cubicBezierTo(20, 78, 25, 65, 40, 60);
+    c.cubicBezierTo(70, 50, 90, 40, 80, 10);
+    c.close();
+    return c;
+}
+
+// Returns the winding number of the contours around p.
+//
+Int windingNumber(const Contours& contours, const Vec2d& p) {
+    Int res = 0;
+    for (const Vec2dArray& contour : contours) {
+        Int n = contour.length();
+        for (Int i = 0; i < n; ++i) {
+            const Vec2d& a = contour[i];
+            const Vec2d& b = contour[(i + 1) % n];
+            if (a.y() <= p.y() && b.y() > p.y() && (b - a).det(p - a) > 0) {
+                ++res;
+            }
+            else if (a.y() > p.y() && b.y() <= p.y() && (b - a).det(p - a) < 0) {
+                --res;
+            }
+        }
+    }
+    return res;
+}
+
+// Returns the distance between p and the closest contour edge.
+//
+double distanceToContours(const Contours& contours, const Vec2d& p) {
+    double res = vgc::core::infinity<double>;
+    for (const Vec2dArray& contour : contours) {
+        Int n = contour.length();
+        for (Int i = 0; i < n; ++i) {
+            const Vec2d& a = contour[i];
+            Vec2d ab = contour[(i + 1) % n] - a;
+            double l2 = ab.squaredLength();
+            double t = l2 > 0 ? (p - a).dot(ab) / l2 : 0;
+            t = (std::max)(0.0, (std::min)(1.0, t));
+            res = (std::min)(res, (a + t * ab - p).length());
+        }
+    }
+    return res;
+}
+
+// Returns the number of triangles of the triangulation containing p.
+//
+Int numTrianglesContaining(const PolygonTriangulator& triangulator, const Vec2d& p) {
+    const Vec2dArray& v = triangulator.vertices();
+    const vgc::core::IntArray& indices = triangulator.indices();
+    Int res = 0;
+    for (Int i = 0; i < indices.length(); i += 3) {
+        const Vec2d& a = v[indices[i]];
+        const Vec2d& b = v[indices[i + 1]];
+        const Vec2d& c = v[indices[i + 2]];
+        double d1 = (b - a).det(p - a);
+        double d2 = (c - b).det(p - b);
+        double d3 = (a - c).det(p - c);
+        if ((d1 > 0 && d2 > 0 && d3 > 0) || (d1 < 0 && d2 < 0 && d3 < 0)) {
+            ++res;
+        }
+    }
+    return res;
+}
+
+double area(const Vec2dArray& vertices, const vgc::core::IntArray& indices) {
+    double res = 0;
+    for (Int i = 0; i < indices.length(); i += 3) {
+        const Vec2d& a = vertices[indices[i]];
+        const Vec2d& b = vertices[indices[i + 1]];
+        const Vec2d& c = vertices[indices[i + 2]];
+        res += 0.5 * std::abs((b - a).det(c - a));
+    }
+    return res;
+}
+
+// Area of the libtess2 triangulation of the given contours.
+//
+double libtess2Area(const Contours& contours, WindingRule windingRule) {
+    TESStesselator* tess = tessNewTess(nullptr);
+    for (const Vec2dArray& contour : contours) {
+        vgc::core::Array<TESSreal> coords;
+        for (const Vec2d& p : contour) {
+            coords.append(static_cast<TESSreal>(p.x()));
+            coords.append(static_cast<TESSreal>(p.y()));
+        }
+        tessAddContour(
+            tess,
+            2,
+            coords.data(),
+            sizeof(TESSreal) * 2,
+            vgc::core::int_cast<int>(contour.length()));
+    }
+    int rule = windingRule == WindingRule::NonZero ? TESS_WINDING_NONZERO
+                                                   : TESS_WINDING_ODD;
+    tessTesselate(tess, rule, TESS_POLYGONS, 3, 2, nullptr);
+    const TESSreal* tessVertices = tessGetVertices(tess);
+    const TESSindex* elements = tessGetElements(tess);
+    Vec2dArray vertices;
+    for (int i = 0; i < tessGetVertexCount(tess); ++i) {
+        vertices.append(Vec2d(tessVertices[2 * i], tessVertices[2 * i + 1]));
+    }
+    vgc::core::IntArray indices;
+    for (int i = 0; i < 3 * tessGetElementCount(tess); ++i) {
+        indices.append(elements[i]);
+    }
+    tessDeleteTess(tess);
+    return area(vertices, indices);
+}
+
+// Checks that random points are covered by exactly one triangle if they are
+// inside the polygon, and by no triangles otherwise. Points too close to the
+// contours are skipped, since their classification is sensitive to rounding.
+//
+void checkTriangulation(const Contours& contours, WindingRule windingRule) {
+    PolygonTriangulator triangulator;
+    double xMin = vgc::core::infinity<double>;
+    double xMax = -xMin;
+    double yMin = xMin;
+    double yMax = -xMin;
+    for (const Vec2dArray& contour : contours) {
+        triangulator.addContour(contour);
+        for (const Vec2d& p : contour) {
+            xMin = (std::min)(xMin, p.x());
+            xMax = (std::max)(xMax, p.x());
+            yMin = (std::min)(yMin, p.y());
+            yMax = (std::max)(yMax, p.y());
+        }
+    }
+    triangulator.triangulate(windingRule);
+    for (Int i : triangulator.indices()) {
+        ASSERT_GE(i, 0);
+        ASSERT_LT(i, triangulator.vertices().length());
+    }
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> x(xMin - 1, xMax + 1);
+    std::uniform_real_distribution<double> y(yMin - 1, yMax + 1);
+    for (Int i = 0; i < 2000; ++i) {
+        Vec2d p(x(generator), y(generator));
+        if (distanceToContours(contours, p) < 1e-6) {
+            continue;
+        }
+        Int winding = windingNumber(contours, p);
+        bool isInside = windingRule == WindingRule::NonZero ? winding != 0
+                                                            : winding % 2 != 0;
+        ASSERT_EQ(numTrianglesContaining(triangulator, p), isInside ? 1 : 0)
+            << "p = (" << p.x() << ", " << p.y() << ")";
+    }
+}
+
+} // namespace
+
+TEST(TestPolygonTriangulator, Empty) {
+    PolygonTriangulator triangulator;
+    triangulator.triangulate(WindingRule::NonZero);
+    EXPECT_TRUE(triangulator.vertices().isEmpty());
+    EXPECT_TRUE(triangulator.indices().isEmpty());
+    triangulator.addContour(Vec2dArray{{0, 0}, {1, 1}});
+    triangulator.triangulate(WindingRule::NonZero);
+    EXPECT_TRUE(triangulator.indices().isEmpty());
+}
+
+TEST(TestPolygonTriangulator, Square) {
+    PolygonTriangulator triangulator;
+    triangulator.addContour(rect(0, 0, 1, 1));
+    triangulator.triangulate(WindingRule::NonZero);
+    EXPECT_EQ(triangulator.vertices().length(), 4);
+    EXPECT_EQ(triangulator.indices().length(), 6);
+    EXPECT_DOUBLE_EQ(area(triangulator.vertices(), triangulator.indices()), 1);
+}
+
+TEST(TestPolygonTriangulator, Hole) {
+    // Letter 'O'
+    Contours c = {circle({0, 0}, 10, 64, false), circle({0, 0}, 6, 48, true)};
+    checkTriangulation(c, WindingRule::NonZero);
+    checkTriangulation(c, WindingRule::EvenOdd);
+}
+
+TEST(TestPolygonTriangulator, OverlappingRects) {
+    Contours c = {rect(0, 0, 10, 10), rect(5, 5, 15, 15), rect(10, 0, 12, 20)};
+    checkTriangulation(c, WindingRule::NonZero);
+    checkTriangulation(c, WindingRule::EvenOdd);
+
+    PolygonTriangulator triangulator;
+    for (const Vec2dArray& contour : c) {
+        triangulator.addContour(contour);
+    }
+    triangulator.triangulate(WindingRule::NonZero);
+    EXPECT_NEAR(area(triangulator.vertices(), triangulator.indices()), 195, 1e-9);
+    triangulator.triangulate(WindingRule::EvenOdd);
+    EXPECT_NEAR(area(triangulator.vertices(), triangulator.indices()), 150, 1e-9);
+}
+
+TEST(TestPolygonTriangulator, Pentagram) {
+    Vec2dArray star;
+    double pi = 3.141592653589793;
+    for (Int i = 0; i < 5; ++i) {
+        double t = 0.5 * pi + 4 * pi * i / 5;
+        star.append(Vec2d(std::cos(t), std::sin(t)));
+    }
+    Contours c = {star};
+    checkTriangulation(c, WindingRule::NonZero);
+    checkTriangulation(c, WindingRule::EvenOdd);
+}
+
+TEST(TestPolygonTriangulator, SharedEdges) {
+    // Collinear overlapping edges and T-junctions
+    Contours c = {rect(0, 0, 4, 4), rect(4, 1, 6, 3), rect(0, 1, 4, 2), rect(2, 4, 3, 5)};
+    checkTriangulation(c, WindingRule::NonZero);
+    checkTriangulation(c, WindingRule::EvenOdd);
+}
+
+TEST(TestPolygonTriangulator, Glyph) {
+    Contours c = contours(glyphS());
+    checkTriangulation(c, WindingRule::NonZero);
+    checkTriangulation(c, WindingRule::EvenOdd);
+}
+
+TEST(TestPolygonTriangulator, CompareWithLibtess2) {
+    Contours corpus[] = {
+        contours(glyphS()),
+        {circle({0, 0}, 10, 64, false), circle({0, 0}, 6, 48, true)},
+        {rect(0, 0, 10, 10), rect(5, 5, 15, 15), rect(10, 0, 12, 20)}};
+    PolygonTriangulator triangulator;
+    for (const Contours& c : corpus) {
+        for (WindingRule rule : {WindingRule::NonZero, WindingRule::EvenOdd}) {
+            triangulator.clear();
+            for (const Vec2dArray& contour : c) {
+                triangulator.addContour(contour);
+            }
+            triangulator.triangulate(rule);
+            double a = area(triangulator.vertices(), triangulator.indices());
+            EXPECT_NEAR(a, libtess2Area(c, rule), 1e-4 * a);
+        }
+    }
+}
+
+TEST(TestPolygonTriangulator, Curves2dFill) {
+    Curves2d c;
+    c.moveTo(0, 0);
+    c.lineTo(10, 0);
+    c.lineTo(10, 10);
+    c.lineTo(0, 10);
+    c.close();
+    c.moveTo(2, 2);
+    c.lineTo(8, 2);
+    c.lineTo(8, 8);
+    c.lineTo(2, 8);
+    c.close();
+    auto params = vgc::geometry::Curves2dSampleParams::adaptive();
+    auto method = vgc::geometry::FillMethod::PolygonTriangulator;
+
+    vgc::core::DoubleArray vertices;
+    vgc::core::Array<vgc::UInt32> indices;
+    c.fill(vertices, indices, params, WindingRule::NonZero, method);
+    EXPECT_EQ(indices.length(), 3 * 2);
+    c.fill(vertices, indices, params, WindingRule::EvenOdd, method);
+    EXPECT_EQ(indices.length(), 3 * 2 + 3 * 8);
+
+    vgc::core::FloatArray data;
+    c.fill(data, params, WindingRule::EvenOdd, method);
+    EXPECT_EQ(data.length(), 2 * 3 * 8);
+}
+
+#ifndef VGC_DEBUG_BUILD
+
+TEST(TestPolygonTriangulator, Perf) {
+    Contours c = contours(glyphS());
+    Int numPoints = 0;
+    for (const Vec2dArray& contour : c) {
+        numPoints += contour.length();
+    }
+    PolygonTriangulator triangulator;
+    Int numGlyphs = 10000;
+    Int numTriangles = 0;
+    vgc::core::Stopwatch s;
+    for (Int i = 0; i < numGlyphs; ++i) {
+        triangulator.clear();
+        for (const Vec2dArray& contour : c) {
+            triangulator.addContour(contour);
+        }
+        triangulator.triangulate(WindingRule::NonZero);
+        numTriangles += triangulator.indices().length() / 3;
+    }
+    double elapsed = s.elapsed();
+    EXPECT_GT(numTriangles, 0);
+    vgc::core::print(
+        "{} glyphs of {} points = {:.7f} sec ({:.0f} glyphs/sec).\n",
+        numGlyphs,
+        numPoints,
+        elapsed,
+        numGlyphs / elapsed);
+}
+
+#endif // VGC_DEBUG_BUILD
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
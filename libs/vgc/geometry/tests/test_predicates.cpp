@@ -0,0 +1,178 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+#include <vgc/geometry/predicates.h>
+
+using vgc::Int;
+using vgc::geometry::compareIntersection;
+using vgc::geometry::compareIntersections;
+using vgc::geometry::directionOrientationSign;
+using vgc::geometry::intersectionOrientationSign;
+using vgc::geometry::orientationSign;
+using vgc::geometry::Vec2d;
+
+namespace {
+
+int sign(Int x) {
+    return (x > 0) ? 1 : (x < 0) ? -1 : 0;
+}
+
+Int det(Int ax, Int ay, Int bx, Int by) {
+    return ax * by - ay * bx;
+}
+
+// Exact intersection of the lines (a, b) and (c, d) with small integer
+// coordinates, as the rational point (x / w, y / w), with w > 0.
+//
+struct RationalPoint {
+    Int x, y, w;
+};
+
+RationalPoint intersection(const Int* a, const Int* b, const Int* c, const Int* d) {
+    Int den = det(b[0] - a[0], b[1] - a[1], d[0] - c[0], d[1] - c[1]);
+    Int num = det(c[0] - a[0], c[1] - a[1], d[0] - c[0], d[1] - c[1]);
+    RationalPoint res = {
+        a[0] * den + num * (b[0] - a[0]), a[1] * den + num * (b[1] - a[1]), den};
+    if (den < 0) {
+        res = {-res.x, -res.y, -res.w};
+    }
+    return res;
+}
+
+int compare(const RationalPoint& p, const RationalPoint& q) {
+    int s = sign(p.x * q.w - q.x * p.w);
+    return s != 0 ? s : sign(p.y * q.w - q.y * p.w);
+}
+
+Vec2d toVec2d(const Int* p) {
+    return Vec2d(static_cast<double>(p[0]), static_cast<double>(p[1]));
+}
+
+} // namespace
+
+TEST(TestPredicates, OrientationSign) {
+    Vec2d a(0, 0);
+    Vec2d b(1, 0);
+    EXPECT_EQ(orientationSign(a, b, Vec2d(0.5, 1)), 1);
+    EXPECT_EQ(orientationSign(a, b, Vec2d(0.5, -1)), -1);
+    EXPECT_EQ(orientationSign(a, b, Vec2d(2, 0)), 0);
+    EXPECT_EQ(orientationSign(a, a, Vec2d(2, 3)), 0);
+}
+
+TEST(TestPredicates, OrientationSignNearlyDegenerate) {
+    // Points nearly aligned on the line y = x, where the naive computation
+    // returns inconsistent signs (see Kettner et al., "Classroom examples of
+    // robustness problems in geometric computations").
+    Vec2d a(0.5, 0.5);
+    Vec2d b(12, 12);
+    Vec2d c(24, 24);
+    double eps = std::ldexp(1.0, -53);
+    for (int i = 0; i < 64; ++i) {
+        for (int j = 0; j < 64; ++j) {
+            Vec2d p(0.5 + i * eps, 0.5 + j * eps);
+            // Exact sign, since b and c are exactly on y = x
+            int expected = (j > i) ? 1 : (j < i) ? -1 : 0;
+            EXPECT_EQ(orientationSign(b, c, p), expected);
+            EXPECT_EQ(orientationSign(c, p, b), expected);
+            EXPECT_EQ(orientationSign(p, b, c), expected);
+        }
+    }
+    EXPECT_EQ(orientationSign(a, b, c), 0);
+
+    // Large coordinates with a tiny offset
+    Vec2d d(1e15, 1e15 + 2);
+    Vec2d e(-1e15, -1e15);
+    EXPECT_EQ(orientationSign(e, Vec2d(0, 0), d), 1);
+    EXPECT_EQ(orientationSign(Vec2d(0, 0), e, d), -1);
+}
+
+TEST(TestPredicates, Intersections) {
+    // Compare with exact integer arithmetic on small integer coordinates,
+    // which have many degenerate configurations.
+    vgc::UInt64 state = 1;
+    auto random = [&state]() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<Int>((state >> 33) % 7) - 3;
+    };
+    for (int k = 0; k < 10000; ++k) {
+        Int p[8][2];
+        for (auto& v : p) {
+            v[0] = random();
+            v[1] = random();
+        }
+        auto directionDet = [&p](int i) {
+            Int ux = p[i + 1][0] - p[i][0];
+            Int uy = p[i + 1][1] - p[i][1];
+            Int vx = p[i + 3][0] - p[i + 2][0];
+            Int vy = p[i + 3][1] - p[i + 2][1];
+            return det(ux, uy, vx, vy);
+        };
+        Int d1 = directionDet(0);
+        Int d2 = directionDet(4);
+        Vec2d v[8];
+        for (int i = 0; i < 8; ++i) {
+            v[i] = toVec2d(p[i]);
+        }
+        EXPECT_EQ(directionOrientationSign(v[0], v[1], v[2], v[3]), sign(d1));
+        if (d1 == 0 || d2 == 0) {
+            continue;
+        }
+        RationalPoint x1 = intersection(p[0], p[1], p[2], p[3]);
+        RationalPoint x2 = intersection(p[4], p[5], p[6], p[7]);
+        RationalPoint q = {p[4][0], p[4][1], 1};
+        int orientation = sign(det(
+            p[5][0] - p[4][0],
+            p[5][1] - p[4][1],
+            x1.x - p[4][0] * x1.w,
+            x1.y - p[4][1] * x1.w));
+        EXPECT_EQ(compareIntersection(v[0], v[1], v[2], v[3], v[4]), compare(x1, q));
+        EXPECT_EQ(
+            compareIntersections(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]),
+            compare(x1, x2));
+        EXPECT_EQ(
+            intersectionOrientationSign(v[4], v[5], v[0], v[1], v[2], v[3]), orientation);
+    }
+}
+
+TEST(TestPredicates, IntersectionsNearlyDegenerate) {
+    // The lines (a, b) and (a, c) exactly intersect at a, which is not a
+    // "nice" floating point number.
+    Vec2d a(0.1, 0.3);
+    Vec2d b(1.7, -2.9);
+    Vec2d c(-0.3, 4.1);
+    double eps = std::ldexp(1.0, -55);
+    EXPECT_EQ(compareIntersection(a, b, a, c, a), 0);
+    EXPECT_EQ(compareIntersection(a, b, c, a, Vec2d(0.1 + eps, 0.3)), -1);
+    EXPECT_EQ(compareIntersection(a, b, c, a, Vec2d(0.1 - eps, 0.3)), 1);
+    EXPECT_EQ(compareIntersection(b, a, a, c, Vec2d(0.1, 0.3 + eps)), -1);
+    EXPECT_EQ(compareIntersection(b, a, c, a, Vec2d(0.1, 0.3 - eps)), 1);
+
+    // The lines (d, e) and (d, f) also intersect at a
+    Vec2d d = a;
+    Vec2d e(2.3, 0.7);
+    Vec2d f(0.3, -1.1);
+    EXPECT_EQ(compareIntersections(a, b, a, c, d, e, f, d), 0);
+    EXPECT_EQ(intersectionOrientationSign(b, c, d, e, f, d), orientationSign(b, c, a));
+    EXPECT_EQ(intersectionOrientationSign(a, e, a, b, f, a), 0);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,304 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <utility>
+
+#include <gtest/gtest.h>
+#include <vgc/core/stopwatch.h>
+#include <vgc/geometry/predicates.h>
+#include <vgc/geometry/segmentintersector.h>
+
+using vgc::Int;
+using vgc::geometry::orientationSign;
+using vgc::geometry::SegmentIntersection;
+using vgc::geometry::SegmentIntersector;
+using vgc::geometry::Vec2d;
+using vgc::geometry::Vec2dArray;
+
+namespace {
+
+// A segment is identified by its polyline index and its index in the polyline
+using SegmentId = std::pair<Int, Int>;
+using SegmentIdPair = std::pair<SegmentId, SegmentId>;
+
+struct Polyline {
+    Vec2dArray points;
+    bool isClosed;
+};
+
+bool isBefore(const Vec2d& p, const Vec2d& q) {
+    return p.x() < q.x() || (p.x() == q.x() && p.y() < q.y());
+}
+
+bool contains(const Vec2d& a, const Vec2d& b, const Vec2d& p) {
+    if (isBefore(b, a)) {
+        return contains(b, a, p);
+    }
+    return orientationSign(a, b, p) == 0 && !isBefore(p, a) && !isBefore(b, p);
+}
+
+bool intersects(const Vec2d& a, const Vec2d& b, const Vec2d& c, const Vec2d& d) {
+    using std::max;
+    using std::min;
+    if (max(a.x(), b.x()) < min(c.x(), d.x()) || max(c.x(), d.x()) < min(a.x(), b.x())
+        || max(a.y(), b.y()) < min(c.y(), d.y())
+        || max(c.y(), d.y()) < min(a.y(), b.y())) {
+        return false;
+    }
+    int o1 = orientationSign(a, b, c);
+    int o2 = orientationSign(a, b, d);
+    int o3 = orientationSign(c, d, a);
+    int o4 = orientationSign(c, d, b);
+    if (o1 * o2 < 0 && o3 * o4 < 0) {
+        return true;
+    }
+    return contains(a, b, c) || contains(a, b, d) || contains(c, d, a)
+           || contains(c, d, b);
+}
+
+// Computes the intersecting pairs of segments by testing all pairs.
+//
+std::set<SegmentIdPair> bruteForce(const std::vector<Polyline>& polylines) {
+    // Zero-length segments are skipped, so the segments before and after
+    // them are consecutive.
+    struct Segment {
+        SegmentId id;
+        Vec2d a, b;
+        Int rank;        // among non-zero-length segments of its polyline
+        Int numSegments; // non-zero-length segments of its polyline
+        bool isClosed;
+    };
+    std::vector<Segment> segments;
+    for (Int i = 0; i < static_cast<Int>(polylines.size()); ++i) {
+        const Polyline& polyline = polylines[i];
+        Int n = polyline.points.length();
+        Int numSegments = polyline.isClosed ? n : n - 1;
+        size_t first = segments.size();
+        for (Int j = 0; j < numSegments; ++j) {
+            Vec2d a = polyline.points[j];
+            Vec2d b = polyline.points[(j + 1) % n];
+            if (a != b) {
+                Int rank = static_cast<Int>(segments.size() - first);
+                segments.push_back({{i, j}, a, b, rank, 0, polyline.isClosed});
+            }
+        }
+        for (size_t k = first; k < segments.size(); ++k) {
+            segments[k].numSegments = static_cast<Int>(segments.size() - first);
+        }
+    }
+    auto isConsecutive = [](const Segment& s, const Segment& t) {
+        if (s.id.first != t.id.first) {
+            return false;
+        }
+        Int i = s.rank;
+        Int j = t.rank;
+        Int n = s.numSegments;
+        return (j == i + 1) || (i == j + 1)
+               || (s.isClosed && (i + 1) % n == j) || (t.isClosed && (j + 1) % n == i);
+    };
+    std::set<SegmentIdPair> res;
+    for (size_t k = 0; k < segments.size(); ++k) {
+        for (size_t l = k + 1; l < segments.size(); ++l) {
+            const Segment& s = segments[k];
+            const Segment& t = segments[l];
+            if (!isConsecutive(s, t) && intersects(s.a, s.b, t.a, t.b)) {
+                res.insert({s.id, t.id});
+            }
+        }
+    }
+    return res;
+}
+
+std::set<SegmentIdPair> sweep(const std::vector<Polyline>& polylines) {
+    SegmentIntersector intersector;
+    for (const Polyline& polyline : polylines) {
+        intersector.addPolyline(polyline.points, polyline.isClosed);
+    }
+    intersector.computeIntersections();
+    std::set<SegmentIdPair> res;
+    for (const SegmentIntersection& i : intersector.intersections()) {
+        SegmentId s1 = {i.polyline1(), i.segment1()};
+        SegmentId s2 = {i.polyline2(), i.segment2()};
+        EXPECT_LT(s1, s2);
+        EXPECT_TRUE(res.insert({s1, s2}).second); // reported once
+    }
+    return res;
+}
+
+// Deterministic pseudo-random numbers in [0, 1)
+//
+class Random {
+public:
+    double operator()() {
+        state_ = state_ * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<double>(state_ >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+private:
+    vgc::UInt64 state_ = 42;
+};
+
+// Random walks, similar to sampled hand-drawn strokes.
+//
+std::vector<Polyline> strokes(Int numStrokes, Int numPoints, double size) {
+    Random random;
+    std::vector<Polyline> res;
+    for (Int i = 0; i < numStrokes; ++i) {
+        Polyline polyline{{}, false};
+        Vec2d p(random() * size, random() * size);
+        double angle = random() * 6.28;
+        for (Int j = 0; j < numPoints; ++j) {
+            polyline.points.append(p);
+            angle += (random() - 0.5) * 0.6;
+            p += Vec2d(std::cos(angle), std::sin(angle));
+        }
+        res.push_back(polyline);
+    }
+    return res;
+}
+
+} // namespace
+
+TEST(TestSegmentIntersector, Cross) {
+    SegmentIntersector intersector;
+    intersector.addPolyline({Vec2d(0, 0), Vec2d(4, 4)});
+    intersector.addPolyline({Vec2d(0, 4), Vec2d(2, 2), Vec2d(4, 0)});
+    intersector.addPolyline({Vec2d(10, 0), Vec2d(11, 0)});
+    intersector.computeIntersections();
+    EXPECT_EQ(intersector.numPolylines(), 3);
+    ASSERT_EQ(intersector.intersections().length(), 2);
+    const SegmentIntersection& i0 = intersector.intersections()[0];
+    const SegmentIntersection& i1 = intersector.intersections()[1];
+    EXPECT_EQ(i0.position(), Vec2d(2, 2));
+    EXPECT_EQ(i0.polyline1(), 0);
+    EXPECT_EQ(i0.segment1(), 0);
+    EXPECT_EQ(i0.parameter1(), 0.5);
+    EXPECT_EQ(i0.polyline2(), 1);
+    EXPECT_EQ(i0.segment2(), 0);
+    EXPECT_EQ(i0.parameter2(), 1);
+    EXPECT_EQ(i1.segment2(), 1);
+    EXPECT_EQ(i1.parameter2(), 0);
+}
+
+TEST(TestSegmentIntersector, SelfIntersection) {
+    // Figure-eight: one self-intersection, between segments 0 and 2
+    SegmentIntersector intersector;
+    intersector.addPolyline(
+        {Vec2d(0, 0), Vec2d(2, 2), Vec2d(2, 0), Vec2d(0, 2)}, true);
+    intersector.computeIntersections();
+    ASSERT_EQ(intersector.intersections().length(), 1);
+    const SegmentIntersection& i = intersector.intersections()[0];
+    EXPECT_EQ(i.segment1(), 0);
+    EXPECT_EQ(i.segment2(), 2);
+    EXPECT_NEAR(i.position().x(), 1, 1e-12);
+    EXPECT_NEAR(i.position().y(), 1, 1e-12);
+    EXPECT_NEAR(i.parameter1(), 0.5, 1e-12);
+    EXPECT_NEAR(i.parameter2(), 0.5, 1e-12);
+}
+
+TEST(TestSegmentIntersector, Curves2d) {
+    vgc::geometry::Curves2d curves;
+    curves.moveTo(0, 0);
+    curves.lineTo(10, 0);
+    curves.lineTo(10, 10);
+    curves.lineTo(0, 10);
+    curves.lineTo(0, 0); // zero-length closing segment
+    curves.close();
+    curves.moveTo(5, -5);
+    curves.quadraticBezierTo(5, 5, 5, 15);
+    SegmentIntersector intersector;
+    intersector.addPolylines(curves);
+    intersector.computeIntersections();
+    EXPECT_EQ(intersector.numPolylines(), 2);
+    ASSERT_EQ(intersector.intersections().length(), 2);
+    EXPECT_EQ(intersector.intersections()[0].position(), Vec2d(5, 0));
+    EXPECT_EQ(intersector.intersections()[1].position(), Vec2d(5, 10));
+}
+
+TEST(TestSegmentIntersector, Degenerate) {
+    // Many segments crossing at the same points, collinear overlaps,
+    // vertical segments, endpoints on other segments, and shared endpoints.
+    std::vector<Polyline> polylines;
+    for (Int i = 0; i < 5; ++i) {
+        double x = static_cast<double>(i);
+        polylines.push_back({{Vec2d(x, 0), Vec2d(4 - x, 4)}, false});
+        polylines.push_back({{Vec2d(x, 0), Vec2d(x, 4)}, false});
+        polylines.push_back({{Vec2d(0, x), Vec2d(4, x)}, false});
+        polylines.push_back({{Vec2d(0, x), Vec2d(2, x), Vec2d(2, x + 1)}, false});
+    }
+    polylines.push_back({{Vec2d(0, 0), Vec2d(2, 2), Vec2d(1, 1), Vec2d(3, 3)}, false});
+    polylines.push_back({{Vec2d(1, 1), Vec2d(3, 1), Vec2d(3, 3)}, true});
+    EXPECT_EQ(sweep(polylines), bruteForce(polylines));
+}
+
+TEST(TestSegmentIntersector, Grid) {
+    // Integer grid points, with many degeneracies
+    Random random;
+    std::vector<Polyline> polylines;
+    for (Int i = 0; i < 100; ++i) {
+        Polyline polyline{{}, i % 3 == 0};
+        for (Int j = 0; j < 5; ++j) {
+            double x = std::floor(random() * 8);
+            double y = std::floor(random() * 8);
+            polyline.points.append(Vec2d(x, y));
+        }
+        polylines.push_back(polyline);
+    }
+    EXPECT_EQ(sweep(polylines), bruteForce(polylines));
+}
+
+TEST(TestSegmentIntersector, Strokes) {
+    std::vector<Polyline> polylines = strokes(50, 50, 30);
+    std::set<SegmentIdPair> expected = bruteForce(polylines);
+    EXPECT_GT(expected.size(), 100u);
+    EXPECT_EQ(sweep(polylines), expected);
+}
+
+#ifndef VGC_DEBUG_BUILD
+
+TEST(TestSegmentIntersector, Perf) {
+    for (Int numStrokes : {100, 300}) {
+        std::vector<Polyline> polylines = strokes(numStrokes, 100, 300);
+        Int numSegments = numStrokes * 99;
+
+        vgc::core::Stopwatch s;
+        std::set<SegmentIdPair> res = sweep(polylines);
+        double sweepTime = s.elapsed();
+
+        s.restart();
+        std::set<SegmentIdPair> expected = bruteForce(polylines);
+        double bruteForceTime = s.elapsed();
+        EXPECT_EQ(res, expected);
+
+        vgc::core::print(
+            "{} segments, {} intersections: sweep = {:.5f} sec, brute force = {:.5f} "
+            "sec.\n",
+            numSegments,
+            res.size(),
+            sweepTime,
+            bruteForceTime);
+    }
+}
+
+#endif // VGC_DEBUG_BUILD
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
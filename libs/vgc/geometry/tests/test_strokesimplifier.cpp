@@ -0,0 +1,99 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+
+#include <gtest/gtest.h>
+#include <vgc/geometry/strokesimplifier.h>
+
+using vgc::Int;
+using vgc::geometry::StrokeSimplifier;
+using vgc::geometry::Vec2d;
+using vgc::geometry::Vec2dArray;
+
+namespace {
+
+// Returns the distance between p and the polyline.
+//
+double distance(const Vec2dArray& polyline, const Vec2d& p) {
+    double res = (polyline.first() - p).length();
+    for (Int i = 1; i < polyline.length(); ++i) {
+        Vec2d a = polyline[i - 1];
+        Vec2d ab = polyline[i] - a;
+        double l2 = ab.squaredLength();
+        double t = l2 > 0 ? (std::max)(0.0, (std::min)(1.0, (p - a).dot(ab) / l2)) : 0;
+        res = (std::min)(res, (a + t * ab - p).length());
+    }
+    return res;
+}
+
+} // namespace
+
+TEST(TestStrokeSimplifier, Line) {
+    StrokeSimplifier s(0.5);
+    for (Int i = 0; i <= 1000; ++i) {
+        s.addSample(Vec2d(0.1 * i, 0.05 * i), 2.0);
+    }
+    EXPECT_TRUE(s.hasPendingSample());
+    EXPECT_EQ(s.lastPosition(), Vec2d(100, 50));
+    s.finish();
+    EXPECT_FALSE(s.hasPendingSample());
+
+    // The window size is bounded, so a few intermediate samples are kept
+    EXPECT_LT(s.positions().length(), 1000 / 32);
+    EXPECT_EQ(s.positions().first(), Vec2d(0, 0));
+    EXPECT_EQ(s.positions().last(), Vec2d(100, 50));
+    EXPECT_EQ(s.numInputSamples(), 1001);
+}
+
+TEST(TestStrokeSimplifier, WithinTolerance) {
+    double tolerance = 0.5;
+    StrokeSimplifier s(tolerance);
+    Vec2dArray input;
+    for (Int i = 0; i <= 2000; ++i) {
+        double t = 0.01 * i;
+        Vec2d p(10 * t, 20 * std::sin(t));
+        input.append(p);
+        s.addSample(p, 1.0);
+    }
+    s.finish();
+    EXPECT_LT(4 * s.positions().length(), input.length());
+    for (const Vec2d& p : input) {
+        EXPECT_LE(distance(s.positions(), p), tolerance);
+    }
+}
+
+TEST(TestStrokeSimplifier, Widths) {
+    // Straight line with a bump in width: samples must be kept around the bump
+    StrokeSimplifier s(0.5);
+    for (Int i = 0; i <= 100; ++i) {
+        double width = (i == 50) ? 10.0 : 1.0;
+        s.addSample(Vec2d(i, 0), width);
+    }
+    s.finish();
+    bool hasBump = false;
+    for (double w : s.widths()) {
+        hasBump = hasBump || w == 10.0;
+    }
+    EXPECT_TRUE(hasBump);
+    EXPECT_LT(s.positions().length(), 10);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
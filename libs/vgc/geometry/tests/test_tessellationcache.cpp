@@ -0,0 +1,155 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <vgc/geometry/tessellationcache.h>
+
+using vgc::Int;
+using vgc::core::DoubleArray;
+using vgc::geometry::Curve;
+using vgc::geometry::Curves2d;
+using vgc::geometry::Curves2dSampleParams;
+using vgc::geometry::TessellationCache;
+using vgc::geometry::Vec2d;
+using vgc::geometry::Vec2dArray;
+
+namespace {
+
+Curve makeCurve(double offset = 0) {
+    Curve curve;
+    curve.addControlPoint(0, 0 + offset, 2);
+    curve.addControlPoint(10, 5, 3);
+    curve.addControlPoint(20, 0, 1);
+    curve.addControlPoint(30, 10, 2);
+    return curve;
+}
+
+Curves2d makeCurves2d(double offset = 0) {
+    Curves2d curves;
+    curves.moveTo(0, 0);
+    curves.lineTo(10, 0 + offset);
+    curves.lineTo(10, 10);
+    curves.lineTo(0, 10);
+    return curves;
+}
+
+} // namespace
+
+TEST(TestTessellationCache, Triangulate) {
+    TessellationCache cache;
+    Curve curve = makeCurve();
+    Vec2dArray expected = curve.triangulate(0.05, 1, 64);
+
+    EXPECT_EQ(cache.triangulate(curve), expected);
+    EXPECT_EQ(cache.numHits(), 0);
+    EXPECT_EQ(cache.numMisses(), 1);
+    EXPECT_EQ(cache.numEntries(), 1);
+    EXPECT_GT(cache.memoryUsage(), 0);
+
+    EXPECT_EQ(cache.triangulate(curve), expected);
+    EXPECT_EQ(cache.triangulate(makeCurve()), expected);
+    EXPECT_EQ(cache.numHits(), 2);
+    EXPECT_EQ(cache.numMisses(), 1);
+    EXPECT_EQ(cache.numEntries(), 1);
+
+    // Different parameters or control points are different entries
+    EXPECT_EQ(cache.triangulate(curve, 0.05, 10, 10), curve.triangulate(0.05, 10, 10));
+    Curve curve2 = makeCurve(1);
+    EXPECT_EQ(cache.triangulate(curve2), curve2.triangulate());
+    curve2.setControlPoint(0, Vec2d(0, 0), 5);
+    EXPECT_EQ(cache.triangulate(curve2), curve2.triangulate());
+    EXPECT_EQ(cache.numHits(), 2);
+    EXPECT_EQ(cache.numMisses(), 4);
+    EXPECT_EQ(cache.numEntries(), 4);
+
+    // Undo: back to a previous state
+    curve2.setControlPoint(0, Vec2d(0, 1), 2);
+    EXPECT_EQ(cache.triangulate(curve2), curve2.triangulate());
+    EXPECT_EQ(cache.numHits(), 3);
+
+    cache.resetCounters();
+    EXPECT_EQ(cache.numHits(), 0);
+    EXPECT_EQ(cache.numMisses(), 0);
+    cache.clear();
+    EXPECT_EQ(cache.numEntries(), 0);
+    EXPECT_EQ(cache.memoryUsage(), 0);
+}
+
+TEST(TestTessellationCache, StrokeAndFill) {
+    TessellationCache cache;
+    Curves2d curves = makeCurves2d();
+    Curves2dSampleParams params = Curves2dSampleParams::adaptive();
+
+    DoubleArray expected = {1, 2};
+    curves.stroke(expected, 1.0, params);
+    DoubleArray data = {1, 2};
+    cache.stroke(curves, data, 1.0, params);
+    EXPECT_EQ(data, expected);
+    data = {1, 2};
+    cache.stroke(curves, data, 1.0, params);
+    EXPECT_EQ(data, expected);
+    EXPECT_EQ(cache.numHits(), 1);
+    EXPECT_EQ(cache.numMisses(), 1);
+
+    // Fill is cached separately from stroke
+    expected.clear();
+    curves.fill(expected, params);
+    data.clear();
+    cache.fill(curves, data, params);
+    EXPECT_EQ(data, expected);
+    EXPECT_EQ(cache.numMisses(), 2);
+
+    // Different width, parameters, or data
+    data.clear();
+    cache.stroke(curves, data, 2.0, params);
+    cache.stroke(curves, data, 1.0, Curves2dSampleParams::uniform());
+    cache.fill(makeCurves2d(1), data, params);
+    EXPECT_EQ(cache.numHits(), 1);
+    EXPECT_EQ(cache.numMisses(), 5);
+    EXPECT_EQ(cache.numEntries(), 5);
+}
+
+TEST(TestTessellationCache, Eviction) {
+    TessellationCache cache;
+    Curve c0 = makeCurve(0);
+    Curve c1 = makeCurve(1);
+    Curve c2 = makeCurve(2);
+    cache.triangulate(c0);
+    Int entrySize = cache.memoryUsage();
+    cache.setMaxMemoryUsage(entrySize * 2 + entrySize / 2);
+
+    cache.triangulate(c1);
+    cache.triangulate(c0); // c0 becomes most recently used
+    cache.triangulate(c2); // c1 is evicted
+    EXPECT_EQ(cache.numEntries(), 2);
+    EXPECT_EQ(cache.numEvictions(), 1);
+    EXPECT_LE(cache.memoryUsage(), cache.maxMemoryUsage());
+
+    cache.resetCounters();
+    cache.triangulate(c0);
+    cache.triangulate(c2);
+    EXPECT_EQ(cache.numHits(), 2);
+    cache.triangulate(c1);
+    EXPECT_EQ(cache.numMisses(), 1);
+
+    // An entry larger than the max is returned correctly but not kept
+    cache.setMaxMemoryUsage(1);
+    EXPECT_EQ(cache.numEntries(), 0);
+    EXPECT_EQ(cache.triangulate(c0), c0.triangulate());
+    cache.triangulate(c1);
+    EXPECT_EQ(cache.numEntries(), 1);
+}
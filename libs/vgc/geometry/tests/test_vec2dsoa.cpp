@@ -0,0 +1,70 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <vgc/core/exceptions.h>
+#include <vgc/geometry/vec2dsoa.h>
+
+using vgc::geometry::Vec2d;
+using vgc::geometry::Vec2dArray;
+using vgc::geometry::Vec2dConstSpan;
+using vgc::geometry::Vec2dSoA;
+
+TEST(TestVec2dSoA, Construct) {
+    Vec2dSoA a;
+    EXPECT_TRUE(a.isEmpty());
+    Vec2dSoA b(3);
+    EXPECT_EQ(b.length(), 3);
+    EXPECT_EQ(b[2], Vec2d(0, 0));
+}
+
+TEST(TestVec2dSoA, ConvertFromAndToArray) {
+    Vec2dArray points = {{1, 2}, {3, 4}, {5, 6}};
+    Vec2dSoA a(points);
+    EXPECT_EQ(a.length(), 3);
+    EXPECT_EQ(a.xs(), vgc::core::DoubleArray({1, 3, 5}));
+    EXPECT_EQ(a.ys(), vgc::core::DoubleArray({2, 4, 6}));
+    EXPECT_EQ(a[1], Vec2d(3, 4));
+    EXPECT_EQ(a.toArray(), points);
+
+    // Interleaved coordinates with a stride, e.g., [x, y, width, ...]
+    vgc::core::DoubleArray data = {1, 2, 10, 3, 4, 20};
+    Vec2dSoA b(Vec2dConstSpan(data.data(), 2, 3));
+    EXPECT_EQ(b.toArray(), Vec2dArray({{1, 2}, {3, 4}}));
+}
+
+TEST(TestVec2dSoA, Modify) {
+    Vec2dSoA a;
+    a.append(Vec2d(1, 2));
+    a.append(Vec2d(3, 4));
+    a.set(0, Vec2d(5, 6));
+    EXPECT_EQ(a.toArray(), Vec2dArray({{5, 6}, {3, 4}}));
+    a.xData()[1] = 7;
+    EXPECT_EQ(a[1], Vec2d(7, 4));
+    EXPECT_THROW(a[2], vgc::core::IndexError);
+    EXPECT_THROW(a.set(-1, Vec2d()), vgc::core::IndexError);
+    a.resize(3);
+    EXPECT_EQ(a[2], Vec2d(0, 0));
+    a.clear();
+    EXPECT_TRUE(a.isEmpty());
+    EXPECT_NE(a, Vec2dSoA(1));
+    EXPECT_EQ(a, Vec2dSoA());
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,254 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VGC_GEOMETRY_VEC2DSOA_H
+#define VGC_GEOMETRY_VEC2DSOA_H
+
+#include <vgc/core/array.h>
+#include <vgc/geometry/api.h>
+#include <vgc/geometry/vec2d.h>
+
+namespace vgc::geometry {
+
+/// \class vgc::geometry::Vec2dSoA
+/// \brief Sequence of 2D points stored as two separate arrays of coordinates.
+///
+/// Unlike `Vec2dArray`, which stores points as an "array of structures"
+/// `[x0, y0, x1, y1, ...]`, a `Vec2dSoA` stores them as a "structure of
+/// arrays": all the x-coordinates `[x0, x1, ...]` are contiguous in memory,
+/// and all the y-coordinates `[y0, y1, ...]` are contiguous in memory.
+///
+/// This layout makes it possible for per-coordinate computations to process
+/// several points at once using SIMD instructions without any shuffling, see
+/// for example the `Vec2dSoA` overloads of `transformPoints()` and
+/// `boundingRect()`. It is therefore preferable for large sets of points
+/// which undergo the same computations many times.
+///
+/// ```cpp
+/// Vec2dSoA points(curvePositions); // copy from Vec2dArray
+/// transformPointsAffine(viewMatrix, points);
+/// Rect2d bounds = boundingRect(points);
+/// ```
+///
+/// Elements are accessed by value via `operator[]`, since there is no
+/// `Vec2d` stored in memory to which a reference could be returned. Use
+/// `set()`, or `xData()` and `yData()`, to modify the points.
+///
+class Vec2dSoA {
+public:
+    /// Creates an empty `Vec2dSoA`.
+    ///
+    Vec2dSoA() {
+    }
+
+    /// Creates a `Vec2dSoA` of the given `length`, with all points
+    /// initialized to `(0, 0)`.
+    ///
+    explicit Vec2dSoA(Int length)
+        : xs_(length)
+        , ys_(length) {
+    }
+
+    /// Creates a `Vec2dSoA` with a copy of the `count` points starting at
+    /// `points`.
+    ///
+    Vec2dSoA(const Vec2d* points, Int count) {
+        assign(points, count);
+    }
+
+    /// Creates a `Vec2dSoA` with a copy of the given points.
+    ///
+    explicit Vec2dSoA(const Vec2dArray& points) {
+        assign(points.data(), points.length());
+    }
+
+    /// Creates a `Vec2dSoA` with a copy of the given points, for example an
+    /// interleaved `DoubleArray` of coordinates viewed as a `Vec2dConstSpan`.
+    ///
+    explicit Vec2dSoA(Vec2dConstSpan points) {
+        assign(points);
+    }
+
+    /// Replaces the content of this `Vec2dSoA` by a copy of the `count`
+    /// points starting at `points`.
+    ///
+    void assign(const Vec2d* points, Int count) {
+        xs_.resizeNoInit(count);
+        ys_.resizeNoInit(count);
+        double* xs = xs_.data();
+        double* ys = ys_.data();
+        for (Int i = 0; i < count; ++i) {
+            xs[i] = points[i][0];
+            ys[i] = points[i][1];
+        }
+    }
+
+    /// \overload
+    ///
+    void assign(Vec2dConstSpan points) {
+        Int count = points.length();
+        xs_.resizeNoInit(count);
+        ys_.resizeNoInit(count);
+        double* xs = xs_.data();
+        double* ys = ys_.data();
+        for (const Vec2d& p : points) {
+            *xs++ = p[0];
+            *ys++ = p[1];
+        }
+    }
+
+    /// Copies the points of this `Vec2dSoA` to the `length()` points
+    /// starting at `out`.
+    ///
+    void copyTo(Vec2d* out) const {
+        const double* xs = xs_.data();
+        const double* ys = ys_.data();
+        Int count = length();
+        for (Int i = 0; i < count; ++i) {
+            out[i][0] = xs[i];
+            out[i][1] = ys[i];
+        }
+    }
+
+    /// Returns a copy of the points of this `Vec2dSoA` as a `Vec2dArray`.
+    ///
+    Vec2dArray toArray() const {
+        Vec2dArray res;
+        res.resizeNoInit(length());
+        copyTo(res.data());
+        return res;
+    }
+
+    /// Returns the number of points.
+    ///
+    Int length() const {
+        return xs_.length();
+    }
+
+    /// Returns whether there are no points.
+    ///
+    bool isEmpty() const {
+        return xs_.isEmpty();
+    }
+
+    /// Removes all the points, but keeps the allocated memory.
+    ///
+    void clear() {
+        xs_.clear();
+        ys_.clear();
+    }
+
+    /// Increases the capacity to be at least the given `capacity`.
+    ///
+    void reserve(Int capacity) {
+        xs_.reserve(capacity);
+        ys_.reserve(capacity);
+    }
+
+    /// Resizes to the given `length`. New points are initialized to `(0, 0)`.
+    ///
+    void resize(Int length) {
+        xs_.resize(length);
+        ys_.resize(length);
+    }
+
+    /// Resizes to the given `length`. New points are left uninitialized.
+    ///
+    void resizeNoInit(Int length) {
+        xs_.resizeNoInit(length);
+        ys_.resizeNoInit(length);
+    }
+
+    /// Appends the given point.
+    ///
+    void append(const Vec2d& point) {
+        xs_.append(point[0]);
+        ys_.append(point[1]);
+    }
+
+    /// Returns the point at index `i`.
+    ///
+    /// Throws `IndexError` if `i` is not in the range `[0, length() - 1]`.
+    ///
+    Vec2d operator[](Int i) const {
+        return Vec2d(xs_[i], ys_[i]);
+    }
+
+    /// Replaces the point at index `i` by the given point.
+    ///
+    /// Throws `IndexError` if `i` is not in the range `[0, length() - 1]`.
+    ///
+    void set(Int i, const Vec2d& point) {
+        xs_[i] = point[0];
+        ys_[i] = point[1];
+    }
+
+    /// Returns the x-coordinates of the points.
+    ///
+    const core::DoubleArray& xs() const {
+        return xs_;
+    }
+
+    /// Returns the y-coordinates of the points.
+    ///
+    const core::DoubleArray& ys() const {
+        return ys_;
+    }
+
+    /// Returns a pointer to the `length()` contiguous x-coordinates.
+    ///
+    double* xData() {
+        return xs_.data();
+    }
+
+    /// \overload
+    ///
+    const double* xData() const {
+        return xs_.data();
+    }
+
+    /// Returns a pointer to the `length()` contiguous y-coordinates.
+    ///
+    double* yData() {
+        return ys_.data();
+    }
+
+    /// \overload
+    ///
+    const double* yData() const {
+        return ys_.data();
+    }
+
+    /// Returns whether the two given `Vec2dSoA` have the same points.
+    ///
+    friend bool operator==(const Vec2dSoA& a, const Vec2dSoA& b) {
+        return a.xs_ == b.xs_ && a.ys_ == b.ys_;
+    }
+
+    /// Returns whether the two given `Vec2dSoA` have different points.
+    ///
+    friend bool operator!=(const Vec2dSoA& a, const Vec2dSoA& b) {
+        return !(a == b);
+    }
+
+private:
+    core::DoubleArray xs_;
+    core::DoubleArray ys_;
+};
+
+} // namespace vgc::geometry
+
+#endif // VGC_GEOMETRY_VEC2DSOA_H
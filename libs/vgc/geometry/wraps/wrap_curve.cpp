@@ -18,6 +18,7 @@
 #include <vgc/geometry/curve.h>
 #include <vgc/geometry/vec2d.h>
 
+using vgc::Int;
 using vgc::geometry::Curve;
 using vgc::geometry::Vec2d;
 
@@ -37,6 +38,13 @@ void wrap_curve(py::module& m) {
         .def(
             "addControlPoint",
             py::overload_cast<const Vec2d&, double>(&Curve::addControlPoint))
+        .def("numControlPoints", &Curve::numControlPoints)
+        .def(
+            "setControlPoint",
+            py::overload_cast<Int, const Vec2d&>(&Curve::setControlPoint))
+        .def(
+            "setControlPoint",
+            py::overload_cast<Int, const Vec2d&, double>(&Curve::setControlPoint))
 
         .def("__repr__", [](const Curve& c) {
             return "<Curve containing "                          //
@@ -0,0 +1,243 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <vgc/graphics/batch.h>
+
+#include <array>
+#include <atomic>
+
+#include <vgc/core/exceptions.h>
+
+namespace vgc::graphics {
+
+namespace {
+
+Int vertexSizeInFloats(BuiltinGeometryLayout layout) {
+    switch (layout) {
+    case BuiltinGeometryLayout::XY:
+        return 2;
+    case BuiltinGeometryLayout::XYRGB:
+        return 5;
+    case BuiltinGeometryLayout::XYZ:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+// Transforms in place the vertices in [begin, end).
+//
+void transformVertices(
+    BuiltinGeometryLayout layout,
+    float* begin,
+    float* end,
+    const geometry::Mat4f& transform) {
+
+    if (transform == geometry::Mat4f::identity) {
+        return;
+    }
+    float* p = begin;
+    Int stride = vertexSizeInFloats(layout);
+    if (layout == BuiltinGeometryLayout::XYZ) {
+        for (; p + stride <= end; p += stride) {
+            geometry::Vec3f v(p[0], p[1], p[2]);
+            v = transform.transformPointAffine(v);
+            p[0] = v[0];
+            p[1] = v[1];
+            p[2] = v[2];
+        }
+    }
+    else {
+        for (; p + stride <= end; p += stride) {
+            geometry::Vec2f v(p[0], p[1]);
+            v = transform.transformPointAffine(v);
+            p[0] = v[0];
+            p[1] = v[1];
+        }
+    }
+}
+
+// Returns a new ID for a BatchedTriangles. IDs are never re-used, so that a
+// content key can't match a destroyed BatchedTriangles.
+//
+UInt64 newBatchedTrianglesId() {
+    static std::atomic<UInt64> lastId = 0;
+    return ++lastId;
+}
+
+} // namespace
+
+BatchedTriangles::BatchedTriangles(BuiltinGeometryLayout layout)
+    : layout_(layout)
+    , id_(newBatchedTrianglesId()) {
+}
+
+void BatchedTriangles::setVertices(core::FloatArray vertices) {
+    vertices_ = std::move(vertices);
+    isTransformedDirty_ = true;
+}
+
+const core::FloatArray&
+BatchedTriangles::transformedVertices(const geometry::Mat4f& transform) {
+    if (isTransformedDirty_ || transform != transform_) {
+        transformed_ = vertices_;
+        transformVertices(
+            layout_,
+            transformed_.data(),
+            transformed_.data() + transformed_.length(),
+            transform);
+        transform_ = transform;
+        isTransformedDirty_ = false;
+        ++transformedVersion_;
+    }
+    return transformed_;
+}
+
+Int GeometryBatch::numVertices() const {
+    return data_.length() / vertexSizeInFloats(layout_);
+}
+
+bool GeometryBatch::isBatchable(
+    BuiltinGeometryLayout layout,
+    const geometry::Mat4f& transform) {
+
+    const geometry::Mat4f& m = transform;
+    if (vertexSizeInFloats(layout) == 0) {
+        return false;
+    }
+    bool isAffine = m(3, 0) == 0 && m(3, 1) == 0 && m(3, 2) == 0 && m(3, 3) == 1;
+    if (layout == BuiltinGeometryLayout::XYZ) {
+        return isAffine;
+    }
+    else {
+        // The z-coordinate is not stored, so it must stay equal to zero.
+        return isAffine && m(2, 0) == 0 && m(2, 1) == 0 && m(2, 3) == 0;
+    }
+}
+
+geometry::Rect2f GeometryBatch::boundingRect(
+    BuiltinGeometryLayout layout,
+    const core::FloatArray& vertices,
+    const geometry::Mat4f& transform) {
+
+    geometry::Rect2f rect = geometry::Rect2f::empty;
+    const float* p = vertices.data();
+    const float* end = p + vertices.length();
+    Int stride = vertexSizeInFloats(layout);
+    if (stride == 0) {
+        return rect;
+    }
+    if (layout == BuiltinGeometryLayout::XYZ) {
+        for (; p + stride <= end; p += stride) {
+            geometry::Vec3f v(p[0], p[1], p[2]);
+            v = transform.transformPointAffine(v);
+            rect.uniteWith(geometry::Vec2f(v[0], v[1]));
+        }
+        return rect;
+    }
+
+    // The image of the bounding rectangle of the untransformed vertices
+    // contains the transformed vertices, so only its corners are transformed.
+    for (; p + stride <= end; p += stride) {
+        rect.uniteWith(geometry::Vec2f(p[0], p[1]));
+    }
+    if (rect.isEmpty() || transform == geometry::Mat4f::identity) {
+        return rect;
+    }
+    std::array<geometry::Vec2f, 4> corners = {
+        rect.pMin(),
+        geometry::Vec2f(rect.xMax(), rect.yMin()),
+        geometry::Vec2f(rect.xMin(), rect.yMax()),
+        rect.pMax()};
+    geometry::Rect2f transformed = geometry::Rect2f::empty;
+    for (const geometry::Vec2f& corner : corners) {
+        transformed.uniteWith(transform.transformPointAffine(corner));
+    }
+    return transformed;
+}
+
+void GeometryBatch::append(
+    BuiltinGeometryLayout layout,
+    const core::FloatArray& vertices,
+    const geometry::Mat4f& transform) {
+
+    checkAppend_(layout, transform);
+    Int begin = data_.length();
+    data_.extend(vertices);
+    float* end = data_.data() + data_.length();
+    transformVertices(layout, data_.data() + begin, end, transform);
+    contentKey_.clear();
+    hasContentKey_ = false;
+}
+
+void GeometryBatch::append(
+    BatchedTriangles& triangles,
+    const geometry::Mat4f& transform) {
+
+    checkAppend_(triangles.layout(), transform);
+    data_.extend(triangles.transformedVertices(transform));
+    if (hasContentKey_) {
+        contentKey_.append(triangles.id());
+        contentKey_.append(triangles.transformedVersion());
+    }
+}
+
+void GeometryBatch::checkAppend_(
+    BuiltinGeometryLayout layout,
+    const geometry::Mat4f& transform) {
+
+    if (!isEmpty() && layout != layout_) {
+        throw core::LogicError(
+            "Cannot append vertices with a different layout to a GeometryBatch.");
+    }
+    if (!isBatchable(layout, transform)) {
+        throw core::LogicError("Cannot batch vertices with a non-batchable transform.");
+    }
+    layout_ = layout;
+}
+
+bool TextBatch::isBatchable(const geometry::Mat4f& transform) {
+    const geometry::Mat4f& m = transform;
+    return GeometryBatch::isBatchable(BuiltinGeometryLayout::XY, m) && m(0, 1) == 0
+           && m(1, 0) == 0;
+}
+
+void TextBatch::append(
+    const core::Array<TextAtlasVertex>& quads,
+    const geometry::Mat4f& transform) {
+
+    if (!isBatchable(transform)) {
+        throw core::LogicError(
+            "Cannot batch glyph quads with a non-batchable transform.");
+    }
+    const geometry::Mat4f& m = transform;
+    geometry::Vec2f scale(m(0, 0), m(1, 1));
+    Int begin = quads_.length();
+    quads_.extend(quads);
+    for (auto it = quads_.begin() + begin; it != quads_.end(); ++it) {
+        TextAtlasVertex& quad = *it;
+        if (transform != geometry::Mat4f::identity) {
+            quad.position = m.transformPointAffine(quad.position);
+            quad.size[0] *= scale[0];
+            quad.size[1] *= scale[1];
+        }
+        boundingRect_.uniteWith(quad.position);
+        boundingRect_.uniteWith(quad.position + quad.size);
+    }
+}
+
+} // namespace vgc::graphics
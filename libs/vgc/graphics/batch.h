@@ -19,59 +19,268 @@
 
 #include <vgc/core/arithmetic.h>
 #include <vgc/core/array.h>
+#include <vgc/geometry/mat4f.h>
 #include <vgc/geometry/rect2f.h>
-#include <vgc/geometry/vec2f.h>
 #include <vgc/graphics/api.h>
-#include <vgc/graphics/buffer.h>
 #include <vgc/graphics/enums.h>
-#include <vgc/graphics/font.h>
-#include <vgc/graphics/geometryview.h>
-#include <vgc/graphics/resource.h>
+#include <vgc/graphics/glyphatlas.h>
 
 namespace vgc::graphics {
 
-VGC_DECLARE_OBJECT(Engine);
+/// \class vgc::graphics::BatchedTriangles
+/// \brief Triangle list meant to be drawn via `Engine::drawBatchedTriangles()`.
+///
+/// A `BatchedTriangles` stores the vertices of a triangle list in a builtin
+/// layout, typically the geometry of a widget. It also caches these vertices
+/// transformed by the last view matrix they were drawn with, so that drawing
+/// the same vertices with the same view matrix in the next frame doesn't
+/// transform them again.
+///
+/// Each `BatchedTriangles` has a unique ID, and a version number which
+/// changes whenever its transformed vertices change. This allows the engine
+/// to detect that a batch has exactly the same content as in the previous
+/// frame, in which case its vertices are not uploaded again. See
+/// `GeometryBatch::contentKey()`.
+///
+class VGC_GRAPHICS_API BatchedTriangles {
+public:
+    /// Creates an empty `BatchedTriangles` with the given builtin `layout`.
+    ///
+    explicit BatchedTriangles(
+        BuiltinGeometryLayout layout = BuiltinGeometryLayout::XYRGB);
+
+    // Not copyable nor movable, since the ID must stay unique.
+    BatchedTriangles(const BatchedTriangles&) = delete;
+    BatchedTriangles& operator=(const BatchedTriangles&) = delete;
+
+    /// Returns the builtin layout of the vertices.
+    ///
+    BuiltinGeometryLayout layout() const {
+        return layout_;
+    }
+
+    /// Returns whether there are no vertices.
+    ///
+    bool isEmpty() const {
+        return vertices_.isEmpty();
+    }
+
+    /// Returns the untransformed vertices.
+    ///
+    const core::FloatArray& vertices() const {
+        return vertices_;
+    }
+
+    /// Sets the untransformed vertices. This invalidates the cached
+    /// transformed vertices.
+    ///
+    void setVertices(core::FloatArray vertices);
+
+    /// Returns the vertices transformed by the given `transform`, re-using
+    /// the result of the previous call if the vertices and the transform
+    /// haven't changed since.
+    ///
+    const core::FloatArray& transformedVertices(const geometry::Mat4f& transform);
+
+    /// Returns the unique ID of this `BatchedTriangles`.
+    ///
+    UInt64 id() const {
+        return id_;
+    }
+
+    /// Returns the version of the last vertices returned by
+    /// `transformedVertices()`. The version changes whenever they change.
+    ///
+    UInt64 transformedVersion() const {
+        return transformedVersion_;
+    }
+
+private:
+    BuiltinGeometryLayout layout_;
+    UInt64 id_;
+    core::FloatArray vertices_;
+    core::FloatArray transformed_;
+    geometry::Mat4f transform_;
+    UInt64 transformedVersion_ = 0;
+    bool isTransformedDirty_ = true;
+};
 
 /// \class vgc::graphics::GeometryBatch
-/// \brief Batch of geometry data.
+/// \brief Batch of triangles accumulated from several draw calls.
 ///
-class VGC_GRAPHICS_API GeometryBatch : public Resource {
-protected:
-    using Resource::Resource;
-
-    void releaseSubResources_() override {
-        vertexBuffer_.reset();
-        indexBuffer_.reset();
-        view_.reset();
+/// A `GeometryBatch` accumulates the vertices of triangle lists that share the
+/// same builtin layout, after transforming them by the view matrix that was
+/// current when they were appended. This makes it possible to draw triangles
+/// coming from many widgets, each with its own view matrix, in a single draw
+/// call using an identity view matrix.
+///
+/// Only affine view matrices can be batched, and for 2D layouts, they must
+/// also preserve the plane `z = 0`. See `isBatchable()`.
+///
+/// This class is used by `Engine::drawBatchedTriangles()`.
+///
+class VGC_GRAPHICS_API GeometryBatch {
+public:
+    /// Creates an empty `GeometryBatch`.
+    ///
+    GeometryBatch() = default;
+
+    /// Returns the builtin layout of the vertices in this batch.
+    ///
+    BuiltinGeometryLayout layout() const {
+        return layout_;
+    }
+
+    /// Returns whether this batch is empty.
+    ///
+    bool isEmpty() const {
+        return data_.isEmpty();
     }
 
+    /// Returns the number of vertices in this batch.
+    ///
+    Int numVertices() const;
+
+    /// Returns the vertex data of this batch, already transformed.
+    ///
+    const core::FloatArray& data() const {
+        return data_;
+    }
+
+    /// Returns a sequence of integers identifying the content of this batch,
+    /// or an empty array if the content can't be identified. Two batches
+    /// with the same non-empty content key have the same layout and data.
+    ///
+    /// The content can be identified if all the vertices were appended from
+    /// `BatchedTriangles`, in which case the key is made of their IDs and
+    /// versions.
+    ///
+    const core::Array<UInt64>& contentKey() const {
+        return contentKey_;
+    }
+
+    /// Removes all the vertices of this batch. This keeps the allocated
+    /// memory so that it can be reused for the next batch.
+    ///
+    void clear() {
+        data_.clear();
+        contentKey_.clear();
+        hasContentKey_ = true;
+    }
+
+    /// Returns whether vertices in the given `layout` transformed by the given
+    /// `transform` can be batched, that is, whether applying `transform` on
+    /// the CPU gives the same result as applying it in the vertex shader.
+    ///
+    static bool
+    isBatchable(BuiltinGeometryLayout layout, const geometry::Mat4f& transform);
+
+    /// Returns a rectangle of the xy-plane containing the given `vertices`, in
+    /// the given `layout`, once transformed by the given affine `transform`.
+    /// Returns `Rect2f::empty` if there are no vertices.
+    ///
+    static geometry::Rect2f boundingRect(
+        BuiltinGeometryLayout layout,
+        const core::FloatArray& vertices,
+        const geometry::Mat4f& transform);
+
+    /// Appends the given `vertices`, in the given `layout`, transformed by the
+    /// given `transform`.
+    ///
+    /// Throws `core::LogicError` if this batch is not empty and `layout` is
+    /// not the layout of this batch, or if `isBatchable(layout, transform)`
+    /// is false.
+    ///
+    void append(
+        BuiltinGeometryLayout layout,
+        const core::FloatArray& vertices,
+        const geometry::Mat4f& transform);
+
+    /// Appends the vertices of the given `triangles`, transformed by the
+    /// given `transform`. The transformed vertices cached in `triangles` are
+    /// re-used if possible.
+    ///
+    /// Throws `core::LogicError` in the same cases as the other overload.
+    ///
+    void append(BatchedTriangles& triangles, const geometry::Mat4f& transform);
+
 private:
-    BufferPtr vertexBuffer_;
-    BufferPtr indexBuffer_;
-    GeometryViewPtr view_;
+    BuiltinGeometryLayout layout_ = BuiltinGeometryLayout::XYRGB;
+    core::FloatArray data_;
+    core::Array<UInt64> contentKey_;
+    bool hasContentKey_ = true;
+
+    void checkAppend_(BuiltinGeometryLayout layout, const geometry::Mat4f& transform);
 };
-using GeometryBatchPtr = ResourcePtr<GeometryBatch>;
 
-namespace detail {
+/// \class vgc::graphics::TextBatch
+/// \brief Batch of glyph quads accumulated from several draw calls.
+///
+/// A `TextBatch` is to `Engine::drawText()` what a `GeometryBatch` is to
+/// `Engine::drawBatchedTriangles()`: it accumulates glyph quads after
+/// transforming them by the view matrix that was current when they were
+/// appended, so that the text of many widgets can be drawn in a single
+/// instanced draw call using an identity view matrix.
+///
+/// Since quads are stored as a position and a size, only the view matrices
+/// made of a translation and a scale can be batched. See `isBatchable()`.
+///
+class VGC_GRAPHICS_API TextBatch {
+public:
+    /// Creates an empty `TextBatch`.
+    ///
+    TextBatch() = default;
 
-struct VGC_GRAPHICS_API TextAtlasVertex {
-    geometry::Vec2f pos_;
-    geometry::Vec2f size_;
-    geometry::Rect2f preClip_;
-    unsigned int glyphIndex_;
-    unsigned int colorIndex_;
-    //unsigned int clipIndex_;
-};
+    /// Returns whether this batch is empty.
+    ///
+    bool isEmpty() const {
+        return quads_.isEmpty();
+    }
+
+    /// Returns the number of quads in this batch.
+    ///
+    Int numQuads() const {
+        return quads_.length();
+    }
 
-} // namespace detail
+    /// Returns the quads of this batch, already transformed.
+    ///
+    const core::Array<TextAtlasVertex>& quads() const {
+        return quads_;
+    }
+
+    /// Returns the bounding rectangle of the quads of this batch, or
+    /// `Rect2f::empty` if this batch is empty.
+    ///
+    const geometry::Rect2f& boundingRect() const {
+        return boundingRect_;
+    }
 
-class VGC_GRAPHICS_API TextAtlasResource : public Resource {
-protected:
-    friend Engine;
+    /// Removes all the quads of this batch. This keeps the allocated memory
+    /// so that it can be reused for the next batch.
+    ///
+    void clear() {
+        quads_.clear();
+        boundingRect_ = geometry::Rect2f::empty;
+    }
+
+    /// Returns whether glyph quads transformed by the given `transform` can be
+    /// batched, that is, whether `transform` maps the xy-plane to itself
+    /// using only a translation and a scale.
+    ///
+    static bool isBatchable(const geometry::Mat4f& transform);
 
-    using Resource::Resource;
+    /// Appends the given `quads` transformed by the given `transform`.
+    ///
+    /// Throws `core::LogicError` if `isBatchable(transform)` is false.
+    ///
+    void append(
+        const core::Array<TextAtlasVertex>& quads,
+        const geometry::Mat4f& transform);
 
-    core::Array<detail::TextAtlasVertex> data_;
+private:
+    core::Array<TextAtlasVertex> quads_;
+    geometry::Rect2f boundingRect_ = geometry::Rect2f::empty;
 };
 
 } // namespace vgc::graphics
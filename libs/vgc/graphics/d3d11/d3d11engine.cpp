@@ -841,6 +841,139 @@ void D3d11Engine::createBuiltinShaders_() {
         simpleProgram->pixelShader_ = pixelShader;
     }
 
+    D3d11ProgramPtr glyphAtlasProgram(
+        new D3d11Program(resourceRegistry_, BuiltinProgram::GlyphAtlas));
+    glyphAtlasProgram_ = glyphAtlasProgram;
+
+    // Create the glyph atlas shaders. Each instance is a glyph quad drawn as
+    // a 4-vertex triangle strip, whose corner is given by the vertex index.
+    {
+        static const char* vertexShaderSrc = R"hlsl(
+
+            cbuffer vertexBuffer : register(b0)
+            {
+                float4x4 projMatrix;
+                float4x4 viewMatrix;
+                unsigned int frameStartTimeInMs;
+            };
+            struct VS_INPUT
+            {
+                float2 pos : POSITION;
+                float2 size : SIZE;
+                float4 uvs : TEXCOORD0;
+                float3 col : COLOR0;
+                uint vertexId : SV_VertexID;
+            };
+            struct PS_INPUT
+            {
+                float4 pos : SV_POSITION;
+                float2 uv : TEXCOORD0;
+                float3 col : COLOR0;
+            };
+
+            PS_INPUT main(VS_INPUT input)
+            {
+                PS_INPUT output;
+                float2 corner = float2(input.vertexId & 1, input.vertexId >> 1);
+                float2 pos = input.pos + corner * input.size;
+                float4 viewPos = mul(viewMatrix, float4(pos, 0.f, 1.f));
+                output.pos = mul(projMatrix, viewPos);
+                output.uv = lerp(input.uvs.xy, input.uvs.zw, corner);
+                output.col = input.col;
+                return output;
+            }
+
+        )hlsl";
+
+        static const char* pixelShaderSrc = R"hlsl(
+
+            Texture2D atlas : register(t0);
+            SamplerState atlasSampler : register(s0);
+            struct PS_INPUT
+            {
+                float4 pos : SV_POSITION;
+                float2 uv : TEXCOORD0;
+                float3 col : COLOR0;
+            };
+
+            float4 main(PS_INPUT input) : SV_Target
+            {
+                return float4(input.col, atlas.Sample(atlasSampler, input.uv).r);
+            }
+
+        )hlsl";
+
+        ComPtr<ID3DBlob> errorBlob;
+        ComPtr<ID3DBlob> vertexShaderBlob;
+        HRESULT hres = D3DCompile(
+            vertexShaderSrc, strlen(vertexShaderSrc),
+            NULL, NULL, NULL, "main", "vs_4_0", 0, 0,
+            vertexShaderBlob.releaseAndGetAddressOf(),
+            errorBlob.releaseAndGetAddressOf());
+        if (hres < 0) {
+            std::string errString =
+                (errorBlob ? std::string(
+                     static_cast<const char*>(errorBlob->GetBufferPointer()))
+                           : core::format("unknown D3DCompile error (0x{:X}).", hres));
+            throw core::RuntimeError(errString);
+        }
+        errorBlob.reset();
+
+        ComPtr<ID3D11VertexShader> vertexShader;
+        device_->CreateVertexShader(
+            vertexShaderBlob->GetBufferPointer(),
+            vertexShaderBlob->GetBufferSize(),
+            NULL,
+            vertexShader.releaseAndGetAddressOf());
+        glyphAtlasProgram->vertexShader_ = vertexShader;
+
+        // Create the input layout, with per-instance data only
+        ComPtr<ID3D11InputLayout> inputLayout;
+        UINT posOffset = static_cast<UINT>(offsetof(TextAtlasVertex, position));
+        UINT sizeOffset = static_cast<UINT>(offsetof(TextAtlasVertex, size));
+        UINT uvsOffset = static_cast<UINT>(offsetof(TextAtlasVertex, texCoords));
+        UINT colOffset = static_cast<UINT>(offsetof(TextAtlasVertex, color));
+        D3D11_INPUT_CLASSIFICATION slotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+        D3D11_INPUT_ELEMENT_DESC layout[] = {
+            {"POSITION", 0, DXGI_FORMAT_R32G32_FLOAT,       0, posOffset,  slotClass, 1},
+            {"SIZE",     0, DXGI_FORMAT_R32G32_FLOAT,       0, sizeOffset, slotClass, 1},
+            {"TEXCOORD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, uvsOffset,  slotClass, 1},
+            {"COLOR",    0, DXGI_FORMAT_R32G32B32_FLOAT,    0, colOffset,  slotClass, 1},
+        };
+        device_->CreateInputLayout(
+            layout, 4,
+            vertexShaderBlob->GetBufferPointer(),
+            vertexShaderBlob->GetBufferSize(),
+            inputLayout.releaseAndGetAddressOf());
+
+        constexpr Int8 layoutIndex =
+            core::toUnderlying(BuiltinGeometryLayout::TextAtlasQuad);
+        glyphAtlasProgram->builtinLayouts_[layoutIndex] = inputLayout;
+
+        ComPtr<ID3DBlob> pixelShaderBlob;
+        hres = D3DCompile(
+            pixelShaderSrc, strlen(pixelShaderSrc),
+            NULL, NULL, NULL, "main", "ps_4_0", 0, 0,
+            pixelShaderBlob.releaseAndGetAddressOf(),
+            errorBlob.releaseAndGetAddressOf());
+        if (hres < 0) {
+            std::string errString =
+                (errorBlob ? std::string(
+                     static_cast<const char*>(errorBlob->GetBufferPointer()))
+                           : core::format("unknown D3DCompile error (0x{:X}).", hres));
+            throw core::RuntimeError(errString);
+        }
+        errorBlob.reset();
+
+        ComPtr<ID3D11PixelShader> pixelShader;
+        device_->CreatePixelShader(
+            pixelShaderBlob->GetBufferPointer(),
+            pixelShaderBlob->GetBufferSize(),
+            NULL,
+            pixelShader.releaseAndGetAddressOf());
+        glyphAtlasProgram->pixelShader_ = pixelShader;
+    }
+
     // Create depth-stencil State
     {
         D3D11_DEPTH_STENCIL_DESC desc = {};
@@ -1673,10 +1806,85 @@ void D3d11Engine::updateBufferData_(
     loadBuffer_(buffer, data, lengthInBytes);
 }
 
-void D3d11Engine::draw_(GeometryView* view, UInt numIndices, UInt numInstances) {
+void D3d11Engine::updateImageData_(
+    Image* aImage,
+    Int x,
+    Int y,
+    Int width,
+    Int height,
+    const void* data,
+    Int lengthInBytes) {
+
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    D3d11Image* image = static_cast<D3d11Image*>(aImage);
+    D3D11_BOX box = {};
+    box.left = static_cast<UINT>(x);
+    box.top = static_cast<UINT>(y);
+    box.front = 0;
+    box.right = static_cast<UINT>(x + width);
+    box.bottom = static_cast<UINT>(y + height);
+    box.back = 1;
+    UINT rowPitch = static_cast<UINT>(lengthInBytes / height);
+    deviceCtx_->UpdateSubresource(image->object(), 0, &box, data, rowPitch, 0);
+}
+
+void D3d11Engine::uploadTransientVertexData_(
+    Buffer* aBuffer,
+    Int regionIndex,
+    Int offsetInBytes,
+    const void* data,
+    Int lengthInBytes) {
+
+    D3d11Buffer* buffer = static_cast<D3d11Buffer*>(aBuffer);
+    if (regionIndex >= isTransientRegionUsed_.length()) {
+        isTransientRegionUsed_.resize(regionIndex + 1, false);
+    }
+
+    // Append with no-overwrite, unless this is the first upload of a frame
+    // into a region that may still be in use by the GPU: in this case we
+    // discard the whole buffer so that the driver renames it instead of
+    // waiting for the GPU.
+    D3D11_MAP mapType = D3D11_MAP_WRITE_NO_OVERWRITE;
+    if (!isTransientFrameStarted_ && isTransientRegionUsed_[regionIndex]) {
+        mapType = D3D11_MAP_WRITE_DISCARD;
+        for (bool& isUsed : isTransientRegionUsed_) {
+            isUsed = false;
+        }
+    }
+    isTransientRegionUsed_[regionIndex] = true;
+    isTransientFrameStarted_ = true;
+
+    D3D11_MAPPED_SUBRESOURCE mappedResource = {};
+    if (deviceCtx_->Map(buffer->object(), 0, mapType, 0, &mappedResource) < 0) {
+        return;
+    }
+    memcpy(static_cast<char*>(mappedResource.pData) + offsetInBytes, data, lengthInBytes);
+    deviceCtx_->Unmap(buffer->object(), 0);
+}
+
+void D3d11Engine::fenceTransientVertexData_(Buffer* /*buffer*/, Int /*regionIndex*/) {
+    // Ordering is handled by the discard/no-overwrite map types.
+    isTransientFrameStarted_ = false;
+}
+
+void D3d11Engine::draw_(
+    GeometryView* view,
+    UInt numIndices,
+    UInt numInstances,
+    UInt startVertex) {
 
     UINT nIdx = core::int_cast<UINT>(numIndices);
     UINT nInst = core::int_cast<UINT>(numInstances);
+    UINT first = core::int_cast<UINT>(startVertex);
+    INT baseVertex = core::int_cast<INT>(startVertex);
+    UINT firstInstance = 0;
+    if (view->hasPerInstanceVertexData()) {
+        firstInstance = first;
+        first = 0;
+        baseVertex = 0;
+    }
 
     if (nIdx == 0) {
         return;
@@ -1733,19 +1941,19 @@ void D3d11Engine::draw_(GeometryView* view, UInt numIndices, UInt numInstances)
     if (numInstances == 0) {
         if (indexBuffer) {
             deviceCtx_->IASetIndexBuffer(indexBuffer->object(), indexFormat, 0);
-            deviceCtx_->DrawIndexed(nIdx, 0, 0);
+            deviceCtx_->DrawIndexed(nIdx, 0, baseVertex);
         }
         else {
-            deviceCtx_->Draw(nIdx, 0);
+            deviceCtx_->Draw(nIdx, first);
         }
     }
     else {
         if (indexBuffer) {
             deviceCtx_->IASetIndexBuffer(indexBuffer->object(), indexFormat, 0);
-            deviceCtx_->DrawIndexedInstanced(nIdx, nInst, 0, 0, 0);
+            deviceCtx_->DrawIndexedInstanced(nIdx, nInst, 0, baseVertex, firstInstance);
         }
         else {
-            deviceCtx_->DrawInstanced(nIdx, nInst, 0, 0);
+            deviceCtx_->DrawInstanced(nIdx, nInst, first, firstInstance);
         }
     }
 }
@@ -149,7 +149,28 @@ protected:
 
     void updateBufferData_(Buffer* buffer, const void* data, Int lengthInBytes) override;
 
-    void draw_(GeometryView* view, UInt numIndices, UInt numInstances) override;
+    void updateImageData_(
+        Image* image,
+        Int x,
+        Int y,
+        Int width,
+        Int height,
+        const void* data,
+        Int lengthInBytes) override;
+
+    void uploadTransientVertexData_(
+        Buffer* buffer,
+        Int regionIndex,
+        Int offsetInBytes,
+        const void* data,
+        Int lengthInBytes) override;
+    void fenceTransientVertexData_(Buffer* buffer, Int regionIndex) override;
+
+    void draw_(
+        GeometryView* view,
+        UInt numIndices,
+        UInt numInstances,
+        UInt startVertex) override;
     void clear_(const core::Color& color) override;
 
     UInt64
@@ -182,6 +203,11 @@ private:
     std::array<StageImageViewArray, numShaderStages> boundImageViewArrays_;
     SwapChainPtr currentSwapchain_;
     FramebufferPtr boundFramebuffer_;
+
+    // Transient vertex regions written since the last discard of the
+    // transient vertex buffer.
+    core::Array<bool> isTransientRegionUsed_;
+    bool isTransientFrameStarted_ = false;
 };
 
 } // namespace vgc::graphics
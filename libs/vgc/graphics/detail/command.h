@@ -17,9 +17,16 @@
 #ifndef VGC_GRAPHICS_DETAIL_COMMANDS_H
 #define VGC_GRAPHICS_DETAIL_COMMANDS_H
 
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
 #include <string_view>
 #include <type_traits>
 #include <utility>
+#include <vector>
+
+#include <vgc/core/array.h>
 
 #include <vgc/core/format.h>
 #include <vgc/core/object.h>
@@ -107,6 +114,157 @@ template<typename U, typename Lambda, typename Data>
 LambdaCommandWithParameters(U, Lambda, Data)
     -> LambdaCommandWithParameters<std::decay_t<Data>, std::decay_t<Lambda>>;
 
+// Sequence of commands stored contiguously in a few large memory blocks.
+//
+// Instead of allocating each command separately, commands are constructed in
+// place at the end of the current block, and destroyed in place by `clear()`.
+// Blocks are kept when the stream is cleared, so a stream that is reused for
+// each frame typically stops allocating memory after the first few frames.
+//
+class VGC_GRAPHICS_API CommandStream {
+public:
+    CommandStream() = default;
+
+    ~CommandStream() {
+        clear();
+    }
+
+    CommandStream(const CommandStream&) = delete;
+    CommandStream& operator=(const CommandStream&) = delete;
+
+    CommandStream(CommandStream&& other) noexcept
+        : blocks_(std::move(other.blocks_))
+        , commands_(std::move(other.commands_))
+        , blockIndex_(other.blockIndex_)
+        , blockOffset_(other.blockOffset_) {
+
+        other.blocks_.clear();
+        other.commands_.clear();
+        other.blockIndex_ = 0;
+        other.blockOffset_ = 0;
+    }
+
+    CommandStream& operator=(CommandStream&& other) noexcept {
+        if (this != &other) {
+            clear();
+            blocks_ = std::move(other.blocks_);
+            commands_ = std::move(other.commands_);
+            blockIndex_ = other.blockIndex_;
+            blockOffset_ = other.blockOffset_;
+            other.blocks_.clear();
+            other.commands_.clear();
+            other.blockIndex_ = 0;
+            other.blockOffset_ = 0;
+        }
+        return *this;
+    }
+
+    bool isEmpty() const {
+        return commands_.isEmpty();
+    }
+
+    Int length() const {
+        return commands_.length();
+    }
+
+    // Returns the number of memory blocks owned by this stream, including
+    // the blocks kept for reuse after `clear()`.
+    //
+    Int numBlocks() const {
+        return static_cast<Int>(blocks_.size());
+    }
+
+    // Constructs a new command of type TCommand at the end of the stream.
+    //
+    template<typename TCommand, typename... Args>
+    void emplaceLast(Args&&... args) {
+        static_assert(std::is_base_of_v<Command, TCommand>);
+        static_assert(alignof(TCommand) <= alignof(std::max_align_t));
+        void* p = allocate_(sizeof(TCommand), alignof(TCommand));
+        Command* command = new (p) TCommand(std::forward<Args>(args)...);
+        commands_.append(command);
+    }
+
+    // Executes all the commands in order.
+    //
+    void execute(Engine* engine) {
+        for (Command* command : commands_) {
+            command->execute(engine);
+        }
+    }
+
+    // Calls the given function on each command, in order.
+    //
+    template<typename Function>
+    void forEach(Function&& function) {
+        for (Command* command : commands_) {
+            function(command);
+        }
+    }
+
+    // Destroys all the commands, but keeps the memory blocks for reuse.
+    //
+    void clear() {
+        for (Command* command : commands_) {
+            command->~Command();
+        }
+        commands_.clear();
+        blockIndex_ = 0;
+        blockOffset_ = 0;
+    }
+
+private:
+    static constexpr size_t minBlockSize_ = 64 * 1024;
+
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks_;
+    core::Array<Command*> commands_;
+    size_t blockIndex_ = 0;
+    size_t blockOffset_ = 0;
+
+    void* allocate_(size_t size, size_t alignment) {
+        while (blockIndex_ < blocks_.size()) {
+            Block& block = blocks_[blockIndex_];
+            size_t offset = (blockOffset_ + alignment - 1) & ~(alignment - 1);
+            if (offset + size <= block.size) {
+                blockOffset_ = offset + size;
+                return block.data.get() + offset;
+            }
+            ++blockIndex_;
+            blockOffset_ = 0;
+        }
+        // Note: `new char[n]` is suitably aligned for any fundamental type.
+        size_t blockSize = (std::max)(minBlockSize_, size);
+        blocks_.push_back(Block{std::unique_ptr<char[]>(new char[blockSize]), blockSize});
+        blockIndex_ = blocks_.size() - 1;
+        blockOffset_ = size;
+        return blocks_.back().data.get();
+    }
+};
+
+// Command executing all the commands of a stream, in order. This is used to
+// append a secondary command list to the command list being recorded, see
+// `Engine::executeSecondaryCommandList()`.
+//
+class ExecuteStreamCommand : public Command {
+public:
+    explicit ExecuteStreamCommand(CommandStream&& commands)
+        : Command("executeSecondaryCommandList")
+        , commands_(std::move(commands)) {
+    }
+
+    void execute(Engine* engine) override {
+        commands_.execute(engine);
+    }
+
+private:
+    CommandStream commands_;
+};
+
 } // namespace vgc::graphics::detail
 
 #endif // VGC_GRAPHICS_DETAIL_COMMANDS_H
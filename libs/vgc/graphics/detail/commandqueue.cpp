@@ -0,0 +1,113 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <vgc/graphics/detail/commandqueue.h>
+
+#include <vgc/core/exceptions.h>
+
+namespace vgc::graphics::detail {
+
+CommandQueue::CommandQueue(Int capacity) {
+    if (capacity < 1) {
+        throw core::LogicError("CommandQueue: capacity must be at least 1.");
+    }
+    slots_.resize(static_cast<size_t>(capacity));
+}
+
+Int CommandQueue::push(CommandStream& commands) {
+    Int tail = tail_.load(std::memory_order_relaxed);
+    Int capacity = static_cast<Int>(slots_.size());
+    Int id = tail + 1;
+    if (tail - head_.load(std::memory_order_acquire) >= capacity) {
+        wait_([&] { return tail - head_.load(std::memory_order_acquire) < capacity; });
+    }
+    // The slot is either unused or contains an already executed and cleared
+    // stream, which we give back to the caller for reuse.
+    std::swap(slot_(id), commands);
+    tail_.store(id, std::memory_order_seq_cst);
+    notify_();
+    return id;
+}
+
+CommandStream* CommandQueue::waitFront() {
+    auto isReady = [&] {
+        return stopRequested_.load(std::memory_order_acquire)
+               || head_.load(std::memory_order_relaxed)
+                      != tail_.load(std::memory_order_acquire);
+    };
+    if (!isReady()) {
+        wait_(isReady);
+    }
+    if (stopRequested_.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return &slot_(head_.load(std::memory_order_relaxed) + 1);
+}
+
+void CommandQueue::popFront() {
+    Int id = head_.load(std::memory_order_relaxed) + 1;
+    slot_(id).clear();
+    head_.store(id, std::memory_order_seq_cst);
+    notify_();
+}
+
+void CommandQueue::cancelAll() {
+    Int head = head_.load(std::memory_order_relaxed);
+    Int tail = tail_.load(std::memory_order_acquire);
+    for (Int id = head + 1; id <= tail; ++id) {
+        slot_(id).clear();
+    }
+    head_.store(tail, std::memory_order_seq_cst);
+    notify_();
+}
+
+void CommandQueue::waitExecuted(Int id) {
+    if (head_.load(std::memory_order_acquire) < id) {
+        wait_([&] { return head_.load(std::memory_order_acquire) >= id; });
+    }
+}
+
+void CommandQueue::requestStop() {
+    stopRequested_.store(true, std::memory_order_seq_cst);
+    notify_();
+}
+
+// The waiting thread registers itself in numWaiters_ before checking the
+// predicate under the mutex, and the notifying thread checks numWaiters_
+// after publishing its change. Since all these operations are sequentially
+// consistent, either the waiter sees the change, or the notifier sees the
+// waiter and wakes it up.
+//
+template<typename Predicate>
+void CommandQueue::wait_(Predicate predicate) {
+    numWaiters_.fetch_add(1, std::memory_order_seq_cst);
+    std::unique_lock<std::mutex> lock(mutex_);
+    conditionVariable_.wait(lock, predicate);
+    lock.unlock();
+    numWaiters_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void CommandQueue::notify_() {
+    if (numWaiters_.load(std::memory_order_seq_cst) > 0) {
+        // Locking ensures that the waiter is either before its predicate
+        // check or already sleeping, so the notification cannot be lost.
+        { std::lock_guard<std::mutex> lock(mutex_); }
+        conditionVariable_.notify_all();
+    }
+}
+
+} // namespace vgc::graphics::detail
@@ -0,0 +1,124 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef VGC_GRAPHICS_DETAIL_COMMANDQUEUE_H
+#define VGC_GRAPHICS_DETAIL_COMMANDQUEUE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include <vgc/graphics/api.h>
+#include <vgc/graphics/detail/command.h>
+
+namespace vgc::graphics::detail {
+
+// Bounded single-producer single-consumer queue of command streams, used to
+// send command lists from the user thread (producer) to the render thread
+// (consumer).
+//
+// Pushing and popping only use atomics. The mutex and condition variable are
+// only used when one of the threads actually needs to sleep (empty queue,
+// full queue, or waiting for a command list to be executed), and the other
+// thread only takes the mutex to wake it up if it is known to be sleeping.
+//
+// Each command list is identified by an ID, which is the number of lists
+// pushed before it plus one. The slots of the ring keep the memory of the
+// streams they contained, and this memory is given back to the producer
+// when it pushes a new stream into the same slot.
+//
+class VGC_GRAPHICS_API CommandQueue {
+public:
+    // Creates a queue that can store up to `capacity` command lists.
+    //
+    explicit CommandQueue(Int capacity);
+
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    // -- producer (user thread) --
+
+    // Moves the given commands at the end of the queue, replacing them with
+    // an empty stream whose memory can be reused. Waits if the queue is full.
+    // Returns the ID of the pushed command list.
+    //
+    Int push(CommandStream& commands);
+
+    // Returns the ID of the last pushed command list, or 0 if none.
+    //
+    Int lastPushedId() const {
+        return tail_.load(std::memory_order_relaxed);
+    }
+
+    // -- consumer (render thread) --
+
+    // Waits until the queue is non-empty or a stop is requested, and returns
+    // the first command list, or nullptr if a stop was requested.
+    //
+    CommandStream* waitFront();
+
+    // Clears the first command list, marks it as executed, and removes it
+    // from the queue.
+    //
+    void popFront();
+
+    // Clears all the command lists in the queue and marks them as executed.
+    //
+    void cancelAll();
+
+    // -- any thread --
+
+    // Returns the ID of the last executed command list, or 0 if none.
+    //
+    Int lastExecutedId() const {
+        return head_.load(std::memory_order_acquire);
+    }
+
+    // Waits until the command list with the given ID has been executed.
+    //
+    void waitExecuted(Int id);
+
+    // Requests waitFront() to return nullptr.
+    //
+    void requestStop();
+
+private:
+    std::vector<CommandStream> slots_;
+
+    // Number of popped lists (= last executed ID) and pushed lists (= last
+    // pushed ID). They are on different cache lines to avoid false sharing.
+    alignas(64) std::atomic<Int> head_ = 0;
+    alignas(64) std::atomic<Int> tail_ = 0;
+    std::atomic<bool> stopRequested_ = false;
+
+    std::atomic<Int> numWaiters_ = 0;
+    std::mutex mutex_;
+    std::condition_variable conditionVariable_;
+
+    CommandStream& slot_(Int id) {
+        return slots_[static_cast<size_t>(id % static_cast<Int>(slots_.size()))];
+    }
+
+    template<typename Predicate>
+    void wait_(Predicate predicate);
+    void notify_();
+};
+
+} // namespace vgc::graphics::detail
+
+#endif // VGC_GRAPHICS_DETAIL_COMMANDQUEUE_H
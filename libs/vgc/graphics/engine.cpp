@@ -16,60 +16,94 @@
 
 #include <vgc/graphics/engine.h>
 
+#include <algorithm> // std::stable_sort, std::lexicographical_compare
+#include <cstring> // std::memcpy
+#include <functional> // std::less
 #include <tuple> // std::tuple_size
+#include <utility> // std::swap
 
 namespace vgc::graphics {
 
-Engine::Engine(const EngineCreateInfo& createInfo)
-    : Object()
-    , resourceRegistry_(new detail::ResourceRegistry())
-    , createInfo_(createInfo) {
-
-    framebufferStack_.emplaceLast();
+Engine::RecordingContext_::RecordingContext_() {
+    framebufferStack.emplaceLast();
 
-    viewportStack_.emplaceLast(0, 0, 0, 0);
-    programStack_.emplaceLast();
-    blendStateStack_.emplaceLast();
-    blendConstantFactorStack_.emplaceLast();
-    rasterizerStateStack_.emplaceLast();
+    viewportStack.emplaceLast(0, 0, 0, 0);
+    programStack.emplaceLast();
+    blendStateStack.emplaceLast();
+    blendConstantFactorStack.emplaceLast();
+    rasterizerStateStack.emplaceLast();
 
     for (Int i = 0; i < numShaderStages; ++i) {
-        constantBufferArrayStacks_[i].emplaceLast();
-        imageViewArrayStacks_[i].emplaceLast();
-        samplerStateArrayStacks_[i].emplaceLast();
+        constantBufferArrayStacks[i].emplaceLast();
+        imageViewArrayStacks[i].emplaceLast();
+        samplerStateArrayStacks[i].emplaceLast();
     }
 
-    projectionMatrixStack_.emplaceLast(geometry::Mat4f::identity);
-    viewMatrixStack_.emplaceLast(geometry::Mat4f::identity);
+    projectionMatrixStack.emplaceLast(geometry::Mat4f::identity);
+    viewMatrixStack.emplaceLast(geometry::Mat4f::identity);
 }
 
-void Engine::onDestroyed() {
+void Engine::RecordingContext_::clear() {
+    framebufferStack.clear();
 
-    swapChain_.reset();
+    viewportStack.clear();
+    programStack.clear();
+    blendStateStack.clear();
+    blendConstantFactorStack.clear();
+    rasterizerStateStack.clear();
 
-    framebufferStack_.clear();
+    for (Int i = 0; i < numShaderStages; ++i) {
+        constantBufferArrayStacks[i].clear();
+        imageViewArrayStacks[i].clear();
+        samplerStateArrayStacks[i].clear();
+    }
 
-    viewportStack_.clear();
-    programStack_.clear();
-    blendStateStack_.clear();
-    blendConstantFactorStack_.clear();
-    rasterizerStateStack_.clear();
+    projectionMatrixStack.clear();
+    viewMatrixStack.clear();
 
-    for (Int i = 0; i < numShaderStages; ++i) {
-        constantBufferArrayStacks_[i].clear();
-        imageViewArrayStacks_[i].clear();
-        samplerStateArrayStacks_[i].clear();
+    appliedPipelineState = PipelineState_();
+    knownAppliedParameters = PipelineParameter::None;
+    deferredDraws.clear();
+    deferredDrawStates.clear();
+
+    geometryBatch.clear();
+    textBatch.clear();
+    for (GeometryViewPtr& view : geometryBatchViews) {
+        view.reset();
     }
+    for (GeometryViewPtr& view : geometryBatchOverflowViews) {
+        view.reset();
+    }
+    textQuadsOverflowView.reset();
+    retainedGeometryBatches.clear();
+    numRetainedGeometryBatches = 0;
+}
 
-    projectionMatrixStack_.clear();
-    viewMatrixStack_.clear();
+Engine::Engine(const EngineCreateInfo& createInfo)
+    : Object()
+    , resourceRegistry_(new detail::ResourceRegistry())
+    , createInfo_(createInfo)
+    , commandQueue_(commandQueueCapacity_) {
+
+    Int maxFramesInFlight = (std::max)(Int(1), createInfo.maxFramesInFlight());
+    inFlightFrameCommandListIds_.resize(maxFramesInFlight, 0);
+}
+
+void Engine::onDestroyed() {
+
+    swapChain_.reset();
+
+    primaryContext_.clear();
+    secondaryContextPool_.clear();
 
     colorGradientsBuffer_.reset(); // 1D buffer
     colorGradientsBufferImageView_.reset();
 
     glyphAtlasProgram_.reset();
-    glyphAtlasBuffer_.reset();
-    glyphAtlasBufferImageView_.reset();
+    glyphAtlasImage_.reset();
+    glyphAtlasImageView_.reset();
+    glyphAtlasSamplerState_.reset();
+    textQuadsView_.reset();
 
     iconAtlasProgram_.reset();
     iconAtlasImage_.reset();
@@ -77,6 +111,8 @@ void Engine::onDestroyed() {
 
     roundedRectangleProgram_.reset();
 
+    transientVertexBuffer_.reset();
+
     if (isMultithreadingEnabled()) {
         stopRenderThread_();
     }
@@ -162,6 +198,63 @@ Engine::createDynamicTriangleListView(BuiltinGeometryLayout vertexLayout) {
     return createGeometryView(createInfo);
 }
 
+GeometryViewPtr
+Engine::createTransientTriangleListView(BuiltinGeometryLayout vertexLayout) {
+    if (!transientVertexBuffer_) {
+        createTransientVertexBuffer_();
+    }
+    GeometryViewCreateInfo createInfo = {};
+    createInfo.setBuiltinGeometryLayout(vertexLayout);
+    createInfo.setPrimitiveType(PrimitiveType::TriangleList);
+    createInfo.setVertexBuffer(0, transientVertexBuffer_);
+    return createGeometryView(createInfo);
+}
+
+Span<float> Engine::allocateTransientVertices(
+    const GeometryViewPtr& geometryView,
+    Int numVertices,
+    Int& startVertex) {
+
+    startVertex = 0;
+    if (!checkResourceIsValid_(geometryView)) {
+        return {nullptr, 0};
+    }
+    if (context_().isSecondary) {
+        // Transient vertex memory is owned by the user thread.
+        return {nullptr, 0};
+    }
+    const BufferPtr& vertexBuffer = geometryView->vertexBuffer(0);
+    if (!transientVertexBuffer_ || vertexBuffer != transientVertexBuffer_) {
+        VGC_ERROR(LogVgcGraphics, "Geometry view does not use transient vertex memory.");
+        return {nullptr, 0};
+    }
+    if (numVertices <= 0) {
+        return {nullptr, 0};
+    }
+
+    // Align the allocation on the vertex size so that it can be addressed
+    // with a vertex index.
+    Int stride = geometryView->strides()[0];
+    Int begin = (transientVertexAllocatedEnd_ + stride - 1) / stride * stride;
+    Int end = begin + numVertices * stride;
+    Int regionSize = transientVertexData_.length() / numTransientVertexRegions_();
+    Int regionEnd = (transientVertexRegionIndex_ + 1) * regionSize;
+    if (end > regionEnd) {
+        VGC_WARNING(
+            LogVgcGraphics,
+            "Transient vertex memory exhausted ({} bytes per frame).",
+            regionSize);
+        return {nullptr, 0};
+    }
+    if (transientVertexUploadedEnd_ == transientVertexAllocatedEnd_) {
+        transientVertexUploadedEnd_ = begin; // don't upload the alignment padding
+    }
+    transientVertexAllocatedEnd_ = end;
+    startVertex = begin / stride;
+    float* data = reinterpret_cast<float*>(transientVertexData_.data() + begin);
+    return {data, numVertices * stride / core::int_cast<Int>(sizeof(float))};
+}
+
 ImagePtr Engine::createImage(const ImageCreateInfo& createInfo) {
 
     // sanitize create info
@@ -319,22 +412,25 @@ Engine::createRasterizerState(const RasterizerStateCreateInfo& createInfo) {
 }
 
 void Engine::setFramebuffer(const FramebufferPtr& framebuffer) {
+    RecordingContext_& context = context_();
 
     if (framebuffer && !checkResourceIsValid_(framebuffer)) {
         return;
     }
-    if (framebufferStack_.last() != framebuffer) {
-        framebufferStack_.last() = framebuffer;
-        dirtyPipelineParameters_ |= PipelineParameter::Framebuffer;
+    if (context.framebufferStack.last() != framebuffer) {
+        context.framebufferStack.last() = framebuffer;
+        context.dirtyPipelineParameters |= PipelineParameter::Framebuffer;
     }
 }
 
 void Engine::setViewport(Int x, Int y, Int width, Int height) {
-    viewportStack_.last() = Viewport(x, y, width, height);
-    dirtyPipelineParameters_ |= PipelineParameter::Viewport;
+    RecordingContext_& context = context_();
+    context.viewportStack.last() = Viewport(x, y, width, height);
+    context.dirtyPipelineParameters |= PipelineParameter::Viewport;
 }
 
 void Engine::setProgram(BuiltinProgram builtinProgram) {
+    RecordingContext_& context = context_();
 
     ProgramPtr program = {};
     switch (builtinProgram) {
@@ -342,42 +438,49 @@ void Engine::setProgram(BuiltinProgram builtinProgram) {
         program = simpleProgram_;
         break;
     }
+    case BuiltinProgram::GlyphAtlas: {
+        program = glyphAtlasProgram_;
+        break;
+    }
     default:
         break;
     }
-    if (programStack_.last() != program) {
-        programStack_.last() = program;
+    if (context.programStack.last() != program) {
+        context.programStack.last() = program;
         if (true /*program->usesBuiltinConstants()*/) {
-            BufferPtr& constantBufferRef =
-                constantBufferArrayStacks_[toIndex_(ShaderStage::Vertex)].last()[0];
+            StageConstantBufferArrayStack& constantBufferArrayStack =
+                context.constantBufferArrayStacks[toIndex_(ShaderStage::Vertex)];
+            BufferPtr& constantBufferRef = constantBufferArrayStack.last()[0];
             if (constantBufferRef != builtinConstantsBuffer_) {
                 constantBufferRef = builtinConstantsBuffer_;
-                dirtyPipelineParameters_ |=
+                context.dirtyPipelineParameters |=
                     PipelineParameter::VertexShaderConstantBuffers;
             }
         }
-        dirtyPipelineParameters_ |= PipelineParameter::Program;
+        context.dirtyPipelineParameters |= PipelineParameter::Program;
     }
 }
 
 void Engine::setBlendState(
     const BlendStatePtr& state,
     const geometry::Vec4f& blendConstantFactor) {
+    RecordingContext_& context = context_();
 
-    if (blendStateStack_.last() != state) {
-        blendStateStack_.last() = state;
-        dirtyPipelineParameters_ |= PipelineParameter::BlendState;
+    if (context.blendStateStack.last() != state) {
+        context.blendStateStack.last() = state;
+        context.dirtyPipelineParameters |= PipelineParameter::BlendState;
     }
-    if (blendConstantFactorStack_.last() != blendConstantFactor) {
-        blendConstantFactorStack_.last() = blendConstantFactor;
-        dirtyPipelineParameters_ |= PipelineParameter::BlendState;
+    if (context.blendConstantFactorStack.last() != blendConstantFactor) {
+        context.blendConstantFactorStack.last() = blendConstantFactor;
+        context.dirtyPipelineParameters |= PipelineParameter::BlendState;
     }
 }
 
 void Engine::setRasterizerState(const RasterizerStatePtr& state) {
-    if (rasterizerStateStack_.last() != state) {
-        rasterizerStateStack_.last() = state;
-        dirtyPipelineParameters_ |= PipelineParameter::RasterizerState;
+    RecordingContext_& context = context_();
+    if (context.rasterizerStateStack.last() != state) {
+        context.rasterizerStateStack.last() = state;
+        context.dirtyPipelineParameters |= PipelineParameter::RasterizerState;
     }
 }
 
@@ -386,14 +489,15 @@ void Engine::setStageConstantBuffers(
     Int startIndex,
     Int count,
     ShaderStage shaderStage) {
+    RecordingContext_& context = context_();
 
     size_t stageIndex = toIndex_(shaderStage);
     StageConstantBufferArray& constantBufferArray =
-        constantBufferArrayStacks_[stageIndex].emplaceLast();
+        context.constantBufferArrayStacks[stageIndex].last();
     for (Int i = 0; i < count; ++i) {
         constantBufferArray[startIndex + i] = buffers[i];
     }
-    dirtyPipelineParameters_ |= std::array{
+    context.dirtyPipelineParameters |= std::array{
         PipelineParameter::VertexShaderConstantBuffers,
         PipelineParameter::GeometryShaderConstantBuffers,
         PipelineParameter::PixelShaderConstantBuffers}[stageIndex];
@@ -404,13 +508,14 @@ void Engine::setStageImageViews(
     Int startIndex,
     Int count,
     ShaderStage shaderStage) {
+    RecordingContext_& context = context_();
 
     size_t stageIndex = toIndex_(shaderStage);
-    StageImageViewArray& imageViewArray = imageViewArrayStacks_[stageIndex].emplaceLast();
+    StageImageViewArray& imageViewArray = context.imageViewArrayStacks[stageIndex].last();
     for (Int i = 0; i < count; ++i) {
         imageViewArray[startIndex + i] = views[i];
     }
-    dirtyPipelineParameters_ |= std::array{
+    context.dirtyPipelineParameters |= std::array{
         PipelineParameter::VertexShaderImageViews,
         PipelineParameter::GeometryShaderImageViews,
         PipelineParameter::PixelShaderImageViews}[stageIndex];
@@ -421,171 +526,178 @@ void Engine::setStageSamplers(
     Int startIndex,
     Int count,
     ShaderStage shaderStage) {
+    RecordingContext_& context = context_();
 
     size_t stageIndex = toIndex_(shaderStage);
     StageSamplerStateArray& samplerStateArray =
-        samplerStateArrayStacks_[stageIndex].emplaceLast();
+        context.samplerStateArrayStacks[stageIndex].last();
     for (Int i = 0; i < count; ++i) {
         samplerStateArray[startIndex + i] = states[i];
     }
-    dirtyPipelineParameters_ |= std::array{
+    context.dirtyPipelineParameters |= std::array{
         PipelineParameter::VertexShaderSamplers,
         PipelineParameter::GeometryShaderSamplers,
         PipelineParameter::PixelShaderSamplers}[stageIndex];
 }
 
 void Engine::pushPipelineParameters(PipelineParameters parameters) {
+    RecordingContext_& context = context_();
 
     if (parameters & PipelineParameter::Framebuffer) {
-        framebufferStack_.emplaceLast(framebufferStack_.last());
+        context.framebufferStack.emplaceLast(context.framebufferStack.last());
     }
     if (parameters & PipelineParameter::Viewport) {
-        viewportStack_.emplaceLast(viewportStack_.last());
+        context.viewportStack.emplaceLast(context.viewportStack.last());
     }
     if (parameters & PipelineParameter::Program) {
-        programStack_.emplaceLast(programStack_.last());
+        context.programStack.emplaceLast(context.programStack.last());
     }
     if (parameters & PipelineParameter::BlendState) {
-        blendStateStack_.emplaceLast(blendStateStack_.last());
+        context.blendStateStack.emplaceLast(context.blendStateStack.last());
     }
     if (parameters & PipelineParameter::DepthStencilState) {
         // todo
     }
     if (parameters & PipelineParameter::RasterizerState) {
-        rasterizerStateStack_.emplaceLast(rasterizerStateStack_.last());
+        context.rasterizerStateStack.emplaceLast(context.rasterizerStateStack.last());
     }
     if (parameters & PipelineParameter::AllShadersResources) {
         if (parameters & PipelineParameter::VertexShaderConstantBuffers) {
             StageConstantBufferArrayStack& constantBufferArrayStack =
-                constantBufferArrayStacks_[toIndex_(ShaderStage::Vertex)];
+                context.constantBufferArrayStacks[toIndex_(ShaderStage::Vertex)];
             constantBufferArrayStack.emplaceLast(constantBufferArrayStack.last());
         }
         if (parameters & PipelineParameter::VertexShaderImageViews) {
             StageImageViewArrayStack& imageViewArrayStack =
-                imageViewArrayStacks_[toIndex_(ShaderStage::Vertex)];
+                context.imageViewArrayStacks[toIndex_(ShaderStage::Vertex)];
             imageViewArrayStack.emplaceLast(imageViewArrayStack.last());
         }
         if (parameters & PipelineParameter::VertexShaderSamplers) {
             StageSamplerStateArrayStack& samplerStateArrayStack =
-                samplerStateArrayStacks_[toIndex_(ShaderStage::Vertex)];
+                context.samplerStateArrayStacks[toIndex_(ShaderStage::Vertex)];
             samplerStateArrayStack.emplaceLast(samplerStateArrayStack.last());
         }
         if (parameters & PipelineParameter::GeometryShaderConstantBuffers) {
             StageConstantBufferArrayStack& constantBufferArrayStack =
-                constantBufferArrayStacks_[toIndex_(ShaderStage::Geometry)];
+                context.constantBufferArrayStacks[toIndex_(ShaderStage::Geometry)];
             constantBufferArrayStack.emplaceLast(constantBufferArrayStack.last());
         }
         if (parameters & PipelineParameter::GeometryShaderImageViews) {
             StageImageViewArrayStack& imageViewArrayStack =
-                imageViewArrayStacks_[toIndex_(ShaderStage::Geometry)];
+                context.imageViewArrayStacks[toIndex_(ShaderStage::Geometry)];
             imageViewArrayStack.emplaceLast(imageViewArrayStack.last());
         }
         if (parameters & PipelineParameter::GeometryShaderSamplers) {
             StageSamplerStateArrayStack& samplerStateArrayStack =
-                samplerStateArrayStacks_[toIndex_(ShaderStage::Geometry)];
+                context.samplerStateArrayStacks[toIndex_(ShaderStage::Geometry)];
             samplerStateArrayStack.emplaceLast(samplerStateArrayStack.last());
         }
         if (parameters & PipelineParameter::PixelShaderConstantBuffers) {
             StageConstantBufferArrayStack& constantBufferArrayStack =
-                constantBufferArrayStacks_[toIndex_(ShaderStage::Pixel)];
+                context.constantBufferArrayStacks[toIndex_(ShaderStage::Pixel)];
             constantBufferArrayStack.emplaceLast(constantBufferArrayStack.last());
         }
         if (parameters & PipelineParameter::PixelShaderImageViews) {
             StageImageViewArrayStack& imageViewArrayStack =
-                imageViewArrayStacks_[toIndex_(ShaderStage::Pixel)];
+                context.imageViewArrayStacks[toIndex_(ShaderStage::Pixel)];
             imageViewArrayStack.emplaceLast(imageViewArrayStack.last());
         }
         if (parameters & PipelineParameter::PixelShaderSamplers) {
             StageSamplerStateArrayStack& samplerStateArrayStack =
-                samplerStateArrayStacks_[toIndex_(ShaderStage::Pixel)];
+                context.samplerStateArrayStacks[toIndex_(ShaderStage::Pixel)];
             samplerStateArrayStack.emplaceLast(samplerStateArrayStack.last());
         }
     }
 }
 
 void Engine::popPipelineParameters(PipelineParameters parameters) {
+    RecordingContext_& context = context_();
 
     if (parameters == PipelineParameter::None) {
         return;
     }
 
     if (parameters & PipelineParameter::Framebuffer) {
-        framebufferStack_.removeLast();
-        dirtyPipelineParameters_ |= PipelineParameter::Framebuffer;
+        context.framebufferStack.removeLast();
+        context.dirtyPipelineParameters |= PipelineParameter::Framebuffer;
     }
     if (parameters & PipelineParameter::Viewport) {
-        viewportStack_.removeLast();
-        dirtyPipelineParameters_ |= PipelineParameter::Viewport;
+        context.viewportStack.removeLast();
+        context.dirtyPipelineParameters |= PipelineParameter::Viewport;
     }
     if (parameters & PipelineParameter::Program) {
-        programStack_.removeLast();
-        dirtyPipelineParameters_ |= PipelineParameter::Program;
+        context.programStack.removeLast();
+        context.dirtyPipelineParameters |= PipelineParameter::Program;
     }
     if (parameters & PipelineParameter::BlendState) {
-        blendStateStack_.removeLast();
-        dirtyPipelineParameters_ |= PipelineParameter::BlendState;
+        context.blendStateStack.removeLast();
+        context.dirtyPipelineParameters |= PipelineParameter::BlendState;
     }
     if (parameters & PipelineParameter::DepthStencilState) {
-        //dirtyPipelineParameters_ |= PipelineParameter::DepthStencilState;
+        //context.dirtyPipelineParameters |= PipelineParameter::DepthStencilState;
     }
     if (parameters & PipelineParameter::RasterizerState) {
-        rasterizerStateStack_.removeLast();
-        dirtyPipelineParameters_ |= PipelineParameter::RasterizerState;
+        context.rasterizerStateStack.removeLast();
+        context.dirtyPipelineParameters |= PipelineParameter::RasterizerState;
     }
     if (parameters & PipelineParameter::AllShadersResources) {
         if (parameters & PipelineParameter::VertexShaderConstantBuffers) {
             StageConstantBufferArrayStack& constantBufferArrayStack =
-                constantBufferArrayStacks_[toIndex_(ShaderStage::Vertex)];
+                context.constantBufferArrayStacks[toIndex_(ShaderStage::Vertex)];
             constantBufferArrayStack.removeLast();
-            dirtyPipelineParameters_ |= PipelineParameter::VertexShaderConstantBuffers;
+            context.dirtyPipelineParameters |=
+                PipelineParameter::VertexShaderConstantBuffers;
         }
         if (parameters & PipelineParameter::VertexShaderImageViews) {
             StageImageViewArrayStack& imageViewArrayStack =
-                imageViewArrayStacks_[toIndex_(ShaderStage::Vertex)];
+                context.imageViewArrayStacks[toIndex_(ShaderStage::Vertex)];
             imageViewArrayStack.removeLast();
-            dirtyPipelineParameters_ |= PipelineParameter::VertexShaderImageViews;
+            context.dirtyPipelineParameters |= PipelineParameter::VertexShaderImageViews;
         }
         if (parameters & PipelineParameter::VertexShaderSamplers) {
             StageSamplerStateArrayStack& samplerStateArrayStack =
-                samplerStateArrayStacks_[toIndex_(ShaderStage::Vertex)];
+                context.samplerStateArrayStacks[toIndex_(ShaderStage::Vertex)];
             samplerStateArrayStack.removeLast();
-            dirtyPipelineParameters_ |= PipelineParameter::VertexShaderSamplers;
+            context.dirtyPipelineParameters |= PipelineParameter::VertexShaderSamplers;
         }
         if (parameters & PipelineParameter::GeometryShaderConstantBuffers) {
             StageConstantBufferArrayStack& constantBufferArrayStack =
-                constantBufferArrayStacks_[toIndex_(ShaderStage::Geometry)];
+                context.constantBufferArrayStacks[toIndex_(ShaderStage::Geometry)];
             constantBufferArrayStack.removeLast();
-            dirtyPipelineParameters_ |= PipelineParameter::GeometryShaderConstantBuffers;
+            context.dirtyPipelineParameters |=
+                PipelineParameter::GeometryShaderConstantBuffers;
         }
         if (parameters & PipelineParameter::GeometryShaderImageViews) {
             StageImageViewArrayStack& imageViewArrayStack =
-                imageViewArrayStacks_[toIndex_(ShaderStage::Geometry)];
+                context.imageViewArrayStacks[toIndex_(ShaderStage::Geometry)];
             imageViewArrayStack.removeLast();
-            dirtyPipelineParameters_ |= PipelineParameter::GeometryShaderImageViews;
+            context.dirtyPipelineParameters |=
+                PipelineParameter::GeometryShaderImageViews;
         }
         if (parameters & PipelineParameter::GeometryShaderSamplers) {
             StageSamplerStateArrayStack& samplerStateArrayStack =
-                samplerStateArrayStacks_[toIndex_(ShaderStage::Geometry)];
+                context.samplerStateArrayStacks[toIndex_(ShaderStage::Geometry)];
             samplerStateArrayStack.removeLast();
-            dirtyPipelineParameters_ |= PipelineParameter::GeometryShaderSamplers;
+            context.dirtyPipelineParameters |= PipelineParameter::GeometryShaderSamplers;
         }
         if (parameters & PipelineParameter::PixelShaderConstantBuffers) {
             StageConstantBufferArrayStack& constantBufferArrayStack =
-                constantBufferArrayStacks_[toIndex_(ShaderStage::Pixel)];
+                context.constantBufferArrayStacks[toIndex_(ShaderStage::Pixel)];
             constantBufferArrayStack.removeLast();
-            dirtyPipelineParameters_ |= PipelineParameter::PixelShaderConstantBuffers;
+            context.dirtyPipelineParameters |=
+                PipelineParameter::PixelShaderConstantBuffers;
         }
         if (parameters & PipelineParameter::PixelShaderImageViews) {
             StageImageViewArrayStack& imageViewArrayStack =
-                imageViewArrayStacks_[toIndex_(ShaderStage::Pixel)];
+                context.imageViewArrayStacks[toIndex_(ShaderStage::Pixel)];
             imageViewArrayStack.removeLast();
-            dirtyPipelineParameters_ |= PipelineParameter::PixelShaderImageViews;
+            context.dirtyPipelineParameters |= PipelineParameter::PixelShaderImageViews;
         }
         if (parameters & PipelineParameter::PixelShaderSamplers) {
             StageSamplerStateArrayStack& samplerStateArrayStack =
-                samplerStateArrayStacks_[toIndex_(ShaderStage::Pixel)];
+                context.samplerStateArrayStacks[toIndex_(ShaderStage::Pixel)];
             samplerStateArrayStack.removeLast();
-            dirtyPipelineParameters_ |= PipelineParameter::PixelShaderSamplers;
+            context.dirtyPipelineParameters |= PipelineParameter::PixelShaderSamplers;
         }
     }
 }
@@ -601,76 +713,107 @@ UInt32 toMilliseconds(const std::chrono::steady_clock::duration& d) {
 } // namespace
 
 void Engine::syncState_() {
+    if (profiler_ && !context_().isSecondary) {
+        double startTime = profiler_->now_();
+        syncStateImpl_();
+        profiler_->addSyncStateTime_(profiler_->now_() - startTime);
+    }
+    else {
+        syncStateImpl_();
+    }
+}
 
-    if (dirtyBuiltinConstantBuffer_) {
-        detail::BuiltinConstants constants = {};
-        constants.projMatrix = projectionMatrixStack_.last();
-        constants.viewMatrix = viewMatrixStack_.last();
-        constants.frameStartTimeInMs = toMilliseconds(frameStartTime_ - engineStartTime_);
-        struct CommandParameters {
-            Buffer* buffer;
-            detail::BuiltinConstants constants;
-        };
-        queueLambdaCommandWithParameters_<CommandParameters>(
-            "updateBuiltinConstantBufferData",
-            [](Engine* engine, const CommandParameters& p) {
-                engine->updateBufferData_(
-                    p.buffer, &p.constants, sizeof(detail::BuiltinConstants));
-            },
-            builtinConstantsBuffer_.get(),
-            constants);
-        dirtyBuiltinConstantBuffer_ = false;
+void Engine::syncStateImpl_() {
+    RecordingContext_& context = context_();
+
+    // The pending batch must be drawn with the state it was started with.
+    flushGeometryBatch_();
+
+    if (context.dirtyBuiltinConstantBuffer) {
+        updateBuiltinConstants_(context.viewMatrixStack.last());
+        context.dirtyBuiltinConstantBuffer = false;
     }
 
-    const PipelineParameters parameters = dirtyPipelineParameters_;
+    const PipelineParameters parameters = context.dirtyPipelineParameters;
     if (parameters == PipelineParameter::None) {
         return;
     }
 
+    PipelineState_& applied = context.appliedPipelineState;
     if (parameters & PipelineParameter::Framebuffer) {
-        FramebufferPtr framebuffer = framebufferStack_.last();
-        queueLambdaCommandWithParameters_<FramebufferPtr>(
-            "setFramebuffer",
-            [](Engine* engine, const FramebufferPtr& p) { engine->setFramebuffer_(p); },
-            framebuffer);
+        const FramebufferPtr& framebuffer = context.framebufferStack.last();
+        bool isApplied = applied.framebuffer == framebuffer;
+        if (shouldSyncParameter_(PipelineParameter::Framebuffer, isApplied)) {
+            applied.framebuffer = framebuffer;
+            queueLambdaCommandWithParameters_<FramebufferPtr>(
+                "setFramebuffer",
+                [](Engine* engine, const FramebufferPtr& p) {
+                    engine->setFramebuffer_(p);
+                },
+                framebuffer);
+        }
     }
     if (parameters & PipelineParameter::Viewport) {
-        queueLambdaCommandWithParameters_<Viewport>(
-            "setViewport",
-            [](Engine* engine, const Viewport& vp) {
-                engine->setViewport_(vp.x(), vp.y(), vp.width(), vp.height());
-            },
-            viewportStack_.last());
+        const Viewport& viewport = context.viewportStack.last();
+        bool isApplied = applied.viewport == viewport;
+        if (shouldSyncParameter_(PipelineParameter::Viewport, isApplied)) {
+            applied.viewport = viewport;
+            queueLambdaCommandWithParameters_<Viewport>(
+                "setViewport",
+                [](Engine* engine, const Viewport& vp) {
+                    engine->setViewport_(vp.x(), vp.y(), vp.width(), vp.height());
+                },
+                viewport);
+        }
     }
     if (parameters & PipelineParameter::Program) {
-        queueLambdaCommandWithParameters_<ProgramPtr>(
-            "setProgram",
-            [](Engine* engine, const ProgramPtr& p) { engine->setProgram_(p); },
-            programStack_.last());
+        const ProgramPtr& program = context.programStack.last();
+        bool isApplied = applied.program == program;
+        if (shouldSyncParameter_(PipelineParameter::Program, isApplied)) {
+            applied.program = program;
+            queueLambdaCommandWithParameters_<ProgramPtr>(
+                "setProgram",
+                [](Engine* engine, const ProgramPtr& p) { engine->setProgram_(p); },
+                program);
+        }
     }
     if (parameters & PipelineParameter::BlendState) {
-        struct CommandParameters {
-            BlendStatePtr blendState;
-            geometry::Vec4f blendConstantFactor;
-        };
-        queueLambdaCommandWithParameters_<CommandParameters>(
-            "setBlendState",
-            [](Engine* engine, const CommandParameters& p) {
-                engine->setBlendState_(p.blendState, p.blendConstantFactor);
-            },
-            blendStateStack_.last(),
-            blendConstantFactorStack_.last());
+        const BlendStatePtr& blendState = context.blendStateStack.last();
+        const geometry::Vec4f& blendConstantFactor =
+            context.blendConstantFactorStack.last();
+        bool isApplied = applied.blendState == blendState
+                         && applied.blendConstantFactor == blendConstantFactor;
+        if (shouldSyncParameter_(PipelineParameter::BlendState, isApplied)) {
+            applied.blendState = blendState;
+            applied.blendConstantFactor = blendConstantFactor;
+            struct CommandParameters {
+                BlendStatePtr blendState;
+                geometry::Vec4f blendConstantFactor;
+            };
+            queueLambdaCommandWithParameters_<CommandParameters>(
+                "setBlendState",
+                [](Engine* engine, const CommandParameters& p) {
+                    engine->setBlendState_(p.blendState, p.blendConstantFactor);
+                },
+                blendState,
+                blendConstantFactor);
+        }
     }
     if (parameters & PipelineParameter::DepthStencilState) {
-        //dirtyPipelineParameters_ |= PipelineParameter::DepthStencilState;
+        //context.dirtyPipelineParameters |= PipelineParameter::DepthStencilState;
     }
     if (parameters & PipelineParameter::RasterizerState) {
-        queueLambdaCommandWithParameters_<RasterizerStatePtr>(
-            "setRasterizerState",
-            [](Engine* engine, const RasterizerStatePtr& p) {
-                engine->setRasterizerState_(p);
-            },
-            rasterizerStateStack_.last());
+        const RasterizerStatePtr& rasterizerState = context.rasterizerStateStack.last();
+        bool isApplied = applied.rasterizerState == rasterizerState;
+        if (shouldSyncParameter_(PipelineParameter::RasterizerState, isApplied)) {
+            applied.rasterizerState = rasterizerState;
+            queueLambdaCommandWithParameters_<RasterizerStatePtr>(
+                "setRasterizerState",
+                [](Engine* engine, const RasterizerStatePtr& p) {
+                    engine->setRasterizerState_(p);
+                },
+                rasterizerState);
+        }
     }
     if (parameters & PipelineParameter::AllShadersResources) {
 
@@ -707,10 +850,24 @@ void Engine::syncState_() {
         }
     }
 
-    dirtyPipelineParameters_ = PipelineParameter::None;
+    context.dirtyPipelineParameters = PipelineParameter::None;
 }
 
 void Engine::syncStageConstantBuffers_(ShaderStage shaderStage) {
+    RecordingContext_& context = context_();
+    size_t stageIndex = toIndex_(shaderStage);
+    const StageConstantBufferArray& buffers =
+        context.constantBufferArrayStacks[stageIndex].last();
+    StageConstantBufferArray& appliedBuffers =
+        context.appliedPipelineState.constantBufferArrays[stageIndex];
+    PipelineParameter parameter = std::array{
+        PipelineParameter::VertexShaderConstantBuffers,
+        PipelineParameter::GeometryShaderConstantBuffers,
+        PipelineParameter::PixelShaderConstantBuffers}[stageIndex];
+    if (!shouldSyncParameter_(parameter, appliedBuffers == buffers)) {
+        return;
+    }
+    appliedBuffers = buffers;
     struct CommandParameters {
         StageConstantBufferArray buffers;
         ShaderStage shaderStage;
@@ -721,11 +878,24 @@ void Engine::syncStageConstantBuffers_(ShaderStage shaderStage) {
             engine->setStageConstantBuffers_(
                 p.buffers.data(), 0, p.buffers.size(), p.shaderStage);
         },
-        constantBufferArrayStacks_[toIndex_(shaderStage)].last(),
+        buffers,
         shaderStage);
 }
 
 void Engine::syncStageImageViews_(ShaderStage shaderStage) {
+    RecordingContext_& context = context_();
+    size_t stageIndex = toIndex_(shaderStage);
+    const StageImageViewArray& views = context.imageViewArrayStacks[stageIndex].last();
+    StageImageViewArray& appliedViews =
+        context.appliedPipelineState.imageViewArrays[stageIndex];
+    PipelineParameter parameter = std::array{
+        PipelineParameter::VertexShaderImageViews,
+        PipelineParameter::GeometryShaderImageViews,
+        PipelineParameter::PixelShaderImageViews}[stageIndex];
+    if (!shouldSyncParameter_(parameter, appliedViews == views)) {
+        return;
+    }
+    appliedViews = views;
     struct CommandParameters {
         StageImageViewArray views;
         ShaderStage shaderStage;
@@ -735,11 +905,25 @@ void Engine::syncStageImageViews_(ShaderStage shaderStage) {
         [](Engine* engine, const CommandParameters& p) {
             engine->setStageImageViews_(p.views.data(), 0, p.views.size(), p.shaderStage);
         },
-        imageViewArrayStacks_[toIndex_(shaderStage)].last(),
+        views,
         shaderStage);
 }
 
 void Engine::syncStageSamplers_(ShaderStage shaderStage) {
+    RecordingContext_& context = context_();
+    size_t stageIndex = toIndex_(shaderStage);
+    const StageSamplerStateArray& states =
+        context.samplerStateArrayStacks[stageIndex].last();
+    StageSamplerStateArray& appliedStates =
+        context.appliedPipelineState.samplerStateArrays[stageIndex];
+    PipelineParameter parameter = std::array{
+        PipelineParameter::VertexShaderSamplers,
+        PipelineParameter::GeometryShaderSamplers,
+        PipelineParameter::PixelShaderSamplers}[stageIndex];
+    if (!shouldSyncParameter_(parameter, appliedStates == states)) {
+        return;
+    }
+    appliedStates = states;
     struct CommandParameters {
         StageSamplerStateArray states;
         ShaderStage shaderStage;
@@ -749,22 +933,82 @@ void Engine::syncStageSamplers_(ShaderStage shaderStage) {
         [](Engine* engine, const CommandParameters& p) {
             engine->setStageSamplers_(p.states.data(), 0, p.states.size(), p.shaderStage);
         },
-        samplerStateArrayStacks_[toIndex_(shaderStage)].last(),
+        states,
         shaderStage);
 }
 
+bool Engine::shouldSyncParameter_(PipelineParameter parameter, bool isApplied) {
+    RecordingContext_& context = context_();
+    if (isApplied && context.knownAppliedParameters.has(parameter)) {
+        ++context.frameStats.numSkippedStateChanges_;
+        return false;
+    }
+    context.knownAppliedParameters |= parameter;
+    ++context.frameStats.numStateChanges_;
+    return true;
+}
+
+Engine::PipelineState_
+Engine::currentPipelineState_(const RecordingContext_& context) const {
+    PipelineState_ state;
+    state.framebuffer = context.framebufferStack.last();
+    state.viewport = context.viewportStack.last();
+    state.program = context.programStack.last();
+    state.blendState = context.blendStateStack.last();
+    state.blendConstantFactor = context.blendConstantFactorStack.last();
+    state.rasterizerState = context.rasterizerStateStack.last();
+    for (Int i = 0; i < numShaderStages; ++i) {
+        state.constantBufferArrays[i] = context.constantBufferArrayStacks[i].last();
+        state.imageViewArrays[i] = context.imageViewArrayStacks[i].last();
+        state.samplerStateArrays[i] = context.samplerStateArrayStacks[i].last();
+    }
+    return state;
+}
+
+void Engine::restorePipelineState_(
+    RecordingContext_& context,
+    const PipelineState_& state) {
+
+    context.framebufferStack.last() = state.framebuffer;
+    context.viewportStack.last() = state.viewport;
+    context.programStack.last() = state.program;
+    context.blendStateStack.last() = state.blendState;
+    context.blendConstantFactorStack.last() = state.blendConstantFactor;
+    context.rasterizerStateStack.last() = state.rasterizerState;
+    for (Int i = 0; i < numShaderStages; ++i) {
+        context.constantBufferArrayStacks[i].last() = state.constantBufferArrays[i];
+        context.imageViewArrayStacks[i].last() = state.imageViewArrays[i];
+        context.samplerStateArrayStacks[i].last() = state.samplerStateArrays[i];
+    }
+    // Parameters that are already applied are skipped by syncState_().
+    context.dirtyPipelineParameters |= PipelineParameter::All;
+}
+
 bool Engine::beginFrame(const SwapChainPtr& swapChain, FrameKind kind) {
 
+    if (isSecondaryContextBound_("beginFrame")) {
+        return false;
+    }
     if (swapChain && !checkResourceIsValid_(swapChain)) {
         return false;
     }
+    RecordingContext_& context = primaryContext_;
 
     frameStartTime_ = std::chrono::steady_clock::now();
-    dirtyBuiltinConstantBuffer_ = true;
+    if (profiler_) {
+        profiler_->beginFrame_(profiler_->now_());
+    }
+    context.dirtyBuiltinConstantBuffer = true;
+    context.hasUploadedBuiltinConstants = false; // frameStartTimeInMs changed
+    context.frameStats = EngineFrameStats();
+    context.numRetainedGeometryBatches = 0;
+    glyphAtlas_.beginFrame();
     if (kind == FrameKind::QWidget) {
-        dirtyPipelineParameters_ |= PipelineParameter::All;
-        dirtyPipelineParameters_.unset(PipelineParameter::Framebuffer);
-        dirtyPipelineParameters_.unset(PipelineParameter::Viewport);
+        // The backend state may have been modified by Qt.
+        context.dirtyPipelineParameters |= PipelineParameter::All;
+        context.dirtyPipelineParameters.unset(PipelineParameter::Framebuffer);
+        context.dirtyPipelineParameters.unset(PipelineParameter::Viewport);
+        context.knownAppliedParameters = PipelineParameter::None;
         setStateDirty_();
     }
 
@@ -781,8 +1025,11 @@ bool Engine::beginFrame(const SwapChainPtr& swapChain, FrameKind kind) {
     }
 
     if (kind != FrameKind::QWidget) {
+        // Always rebind the default framebuffer, since its render target
+        // changes with each presented back buffer.
         setDefaultFramebuffer();
-        dirtyPipelineParameters_ |= PipelineParameter::Framebuffer;
+        context.dirtyPipelineParameters |= PipelineParameter::Framebuffer;
+        context.knownAppliedParameters.unset(PipelineParameter::Framebuffer);
     }
 
     return true;
@@ -790,6 +1037,11 @@ bool Engine::beginFrame(const SwapChainPtr& swapChain, FrameKind kind) {
 
 void Engine::endFrame(Int syncInterval, PresentFlags flags) {
 
+    if (isSecondaryContextBound_("endFrame")) {
+        return;
+    }
+    RecordingContext_& context = primaryContext_;
+
     // check syncInterval >= 0
     syncInterval = syncInterval > 0 ? syncInterval : 0;
     UInt32 uSyncInterval = core::int_cast<UInt32>(syncInterval);
@@ -797,8 +1049,20 @@ void Engine::endFrame(Int syncInterval, PresentFlags flags) {
     ++swapChain_->numPendingPresents_;
     bool shouldWait = syncInterval > 0;
 
+    if (context.areDrawsUnordered) {
+        VGC_WARNING(
+            LogVgcGraphics, "endFrame() called before endUnorderedDraws().");
+        endUnorderedDraws();
+    }
+    flushGeometryBatch_();
+    endTransientVertexFrame_();
+    lastFrameStats_ = context.frameStats;
+
     if (!isMultithreadingEnabled()) {
-        UInt64 timestamp = present_(swapChain_.get(), uSyncInterval, flags);
+        UInt64 timestamp = 0;
+        executeInline_("present", [&] {
+            timestamp = present_(swapChain_.get(), uSyncInterval, flags);
+        });
         --swapChain_->numPendingPresents_;
         if (presentCallback_) {
             presentCallback_(timestamp);
@@ -808,8 +1072,10 @@ void Engine::endFrame(Int syncInterval, PresentFlags flags) {
         // Preventing dead-locks
         // See https://docs.microsoft.com/en-us/windows/win32/api/DXGI1_2/nf-dxgi1_2-idxgiswapchain1-present1#remarks
         flushWait();
-        UInt64 timestamp =
-            present_(swapChain_.get(), core::int_cast<UInt32>(syncInterval), flags);
+        UInt64 timestamp = 0;
+        executeInline_("present", [&] {
+            timestamp = present_(swapChain_.get(), uSyncInterval, flags);
+        });
         --swapChain_->numPendingPresents_;
         if (presentCallback_) {
             presentCallback_(timestamp);
@@ -843,10 +1109,32 @@ void Engine::endFrame(Int syncInterval, PresentFlags flags) {
         }
     }
 
-    submitPendingCommandList_();
-    if (!isMultithreadingEnabled()) {
+    UInt id = submitPendingCommandList_();
+    if (isMultithreadingEnabled()) {
+        waitFramesInFlight_(static_cast<Int>(id));
+    }
+    else {
         resourceRegistry_->releaseAndDeleteGarbagedResources(this);
     }
+
+    if (profiler_) {
+        profiler_->endFrame_(
+            profiler_->now_(), static_cast<Int>(id), commandQueue_.lastExecutedId());
+    }
+}
+
+void Engine::setProfilingEnabled(bool enabled) {
+    if (enabled == isProfilingEnabled()) {
+        return;
+    }
+    // The render thread must be idle since it reads profiler_.
+    flushWait();
+    if (enabled) {
+        profiler_ = std::make_unique<EngineProfiler>(engineStartTime_);
+    }
+    else {
+        profiler_.reset();
+    }
 }
 
 void Engine::resizeSwapChain(const SwapChainPtr& swapChain, Int width, Int height) {
@@ -854,11 +1142,22 @@ void Engine::resizeSwapChain(const SwapChainPtr& swapChain, Int width, Int heigh
         return;
     }
     flushWait();
+    RecordingContext_& context = primaryContext_;
     resizeSwapChain_(
         swapChain.get(), core::int_cast<UInt32>(width), core::int_cast<UInt32>(height));
+
+    // Resizing may unbind the render target of the swap chain.
+    context.knownAppliedParameters.unset(PipelineParameter::Framebuffer);
+    context.knownAppliedParameters.unset(PipelineParameter::Viewport);
 }
 
-void Engine::draw(const GeometryViewPtr& geometryView, Int numIndices, Int numInstances) {
+void Engine::draw(
+    const GeometryViewPtr& geometryView,
+    Int numIndices,
+    Int numInstances,
+    Int startVertex) {
+    RecordingContext_& context = context_();
+
     if (!checkResourceIsValid_(geometryView)) {
         return;
     }
@@ -870,13 +1169,267 @@ void Engine::draw(const GeometryViewPtr& geometryView, Int numIndices, Int numIn
             LogVgcGraphics, "Negative numInstances ({}), skipping draw.", numInstances);
         return;
     }
+    if (startVertex < 0) {
+        VGC_WARNING(
+            LogVgcGraphics, "Negative startVertex ({}), skipping draw.", startVertex);
+        return;
+    }
+    Int n = (numIndices >= 0) ? numIndices : geometryView->numVertices() - startVertex;
+    bool hasTransientVertexData =
+        !context.isSecondary
+        && transientVertexUploadedEnd_ < transientVertexAllocatedEnd_;
+    if (context.areDrawsUnordered) {
+        if (hasTransientVertexData) {
+            flushTransientVertexData_();
+        }
+        deferDraw_(
+            geometryView,
+            core::int_cast<UInt>(n),
+            numInstances,
+            core::int_cast<UInt>(startVertex));
+        return;
+    }
     syncState_();
-    Int n = (numIndices >= 0) ? numIndices : geometryView->numVertices();
-    UInt un = core::int_cast<UInt>(n);
-    queueLambdaCommandWithParameters_<GeometryView*>(
-        "draw",
-        [=](Engine* engine, GeometryView* gv) { engine->draw_(gv, un, numInstances); },
-        geometryView.get());
+    if (hasTransientVertexData) {
+        flushTransientVertexData_();
+    }
+    queueDraw_(
+        geometryView.get(),
+        core::int_cast<UInt>(n),
+        numInstances,
+        core::int_cast<UInt>(startVertex));
+}
+
+void Engine::drawBatchedTriangles(
+    BuiltinGeometryLayout layout,
+    const core::FloatArray& vertices) {
+    RecordingContext_& context = context_();
+
+    if (vertices.isEmpty()) {
+        return;
+    }
+    if (context.areDrawsUnordered) {
+        // Merging into a batch would fix the position of the draw, so each
+        // call is recorded as a separate draw using transient memory.
+        if (!context.isSecondary) {
+            Int layoutIndex = core::toUnderlying(layout);
+            GeometryViewPtr& view = context.geometryBatchViews[layoutIndex];
+            if (!view) {
+                view = createTransientTriangleListView(layout);
+            }
+            Int stride = view->strides()[0];
+            Int numFloats = vertices.length();
+            Int numVertices = numFloats * core::int_cast<Int>(sizeof(float)) / stride;
+            Int startVertex = 0;
+            Span<float> data = allocateTransientVertices(view, numVertices, startVertex);
+            if (data.length() == numFloats) {
+                std::memcpy(data.data(), vertices.data(), numFloats * sizeof(float));
+                draw(view, numVertices, 0, startVertex);
+                return;
+            }
+        }
+        // Otherwise, fall back to drawing immediately, that is, before the
+        // unordered draws. This is allowed since their order doesn't matter.
+        context.areDrawsUnordered = false;
+        drawBatchedTriangles(layout, vertices);
+        flushGeometryBatch_();
+        context.areDrawsUnordered = true;
+        return;
+    }
+    const geometry::Mat4f& viewMatrix = context.viewMatrixStack.last();
+    if (!GeometryBatch::isBatchable(layout, viewMatrix)) {
+        // Draw immediately with the view matrix applied by the vertex shader.
+        flushGeometryBatch_();
+        Int layoutIndex = core::toUnderlying(layout);
+        GeometryViewPtr& view = context.geometryBatchOverflowViews[layoutIndex];
+        if (!view) {
+            view = createDynamicTriangleListView(layout);
+        }
+        updateVertexBufferData(view, vertices);
+        draw(view, -1, 0);
+        return;
+    }
+    prepareGeometryBatch_(layout, vertices);
+    context.geometryBatch.append(layout, vertices, viewMatrix);
+}
+
+void Engine::drawBatchedTriangles(BatchedTriangles& triangles) {
+    RecordingContext_& context = context_();
+
+    if (triangles.isEmpty()) {
+        return;
+    }
+    BuiltinGeometryLayout layout = triangles.layout();
+    const geometry::Mat4f& viewMatrix = context.viewMatrixStack.last();
+    if (context.areDrawsUnordered || !GeometryBatch::isBatchable(layout, viewMatrix)) {
+        drawBatchedTriangles(layout, triangles.vertices());
+        return;
+    }
+    prepareGeometryBatch_(layout, triangles.vertices());
+    context.geometryBatch.append(triangles, viewMatrix);
+}
+
+void Engine::drawText(const core::Array<TextAtlasVertex>& quads) {
+    RecordingContext_& context = context_();
+
+    if (quads.isEmpty()) {
+        return;
+    }
+
+    // For secondary contexts, the atlas image is created by
+    // beginSecondaryCommandList() and updated by executeSecondaryCommandList().
+    if (!context.isSecondary) {
+        if (!glyphAtlasImage_) {
+            createGlyphAtlasResources_();
+        }
+        else if (glyphAtlas_.isDirty()) {
+            updateGlyphAtlasImage_();
+        }
+    }
+
+    // Glyphs are never evicted from the atlas during a frame, so updating
+    // the atlas image before drawing a pending batch doesn't affect it.
+    const geometry::Mat4f& viewMatrix = context.viewMatrixStack.last();
+    if (!context.areDrawsUnordered && TextBatch::isBatchable(viewMatrix)) {
+        prepareTextBatch_();
+        context.textBatch.append(quads, viewMatrix);
+        return;
+    }
+
+    // Otherwise, draw immediately with the view matrix applied by the
+    // vertex shader.
+    Int startInstance = 0;
+    GeometryViewPtr view = copyTextQuads_(quads, startInstance);
+    if (view == context.textQuadsOverflowView && context.areDrawsUnordered) {
+        // The overflow buffer only holds the data of the last call, so it
+        // cannot be used by draws whose execution is deferred.
+        context.areDrawsUnordered = false;
+        drawText_(view, quads.length(), startInstance);
+        context.areDrawsUnordered = true;
+        return;
+    }
+    drawText_(view, quads.length(), startInstance);
+}
+
+void Engine::beginUnorderedDraws() {
+    RecordingContext_& context = context_();
+    if (context.areDrawsUnordered) {
+        VGC_WARNING(LogVgcGraphics, "Unordered draws have already begun.");
+        return;
+    }
+    flushGeometryBatch_();
+    context.areDrawsUnordered = true;
+}
+
+namespace {
+
+template<typename T>
+bool isPtrLess(const T& p1, const T& p2) {
+    return std::less<const void*>()(p1.get(), p2.get());
+}
+
+template<typename Array>
+bool isPtrArrayLess(const Array& a1, const Array& a2) {
+    using T = typename Array::value_type;
+    return std::lexicographical_compare(
+        a1.begin(), a1.end(), a2.begin(), a2.end(), isPtrLess<T>);
+}
+
+} // namespace
+
+void Engine::endUnorderedDraws() {
+    RecordingContext_& context = context_();
+    if (!context.areDrawsUnordered) {
+        VGC_WARNING(LogVgcGraphics, "Unordered draws have not begun.");
+        return;
+    }
+    context.areDrawsUnordered = false;
+    if (context.deferredDraws.isEmpty()) {
+        context.deferredDrawStates.clear();
+        return;
+    }
+
+    // Rank the recorded states by the cost of switching between them: first
+    // the framebuffer (which must keep its order), then the program, then
+    // the other pipeline parameters. States that compare equal get the same
+    // rank, so that their draws keep their relative order.
+    const Int numStates = context.deferredDrawStates.length();
+    core::Array<Int> stateIndices(numStates);
+    for (Int i = 0; i < numStates; ++i) {
+        stateIndices[i] = i;
+    }
+    auto isStateLess = [&context](Int i1, Int i2) {
+        const DeferredDrawState_& s1 = context.deferredDrawStates[i1];
+        const DeferredDrawState_& s2 = context.deferredDrawStates[i2];
+        if (s1.framebufferIndex != s2.framebufferIndex) {
+            return s1.framebufferIndex < s2.framebufferIndex;
+        }
+        const PipelineState_& p1 = s1.pipelineState;
+        const PipelineState_& p2 = s2.pipelineState;
+        if (p1.program != p2.program) {
+            return isPtrLess(p1.program, p2.program);
+        }
+        if (p1.blendState != p2.blendState) {
+            return isPtrLess(p1.blendState, p2.blendState);
+        }
+        if (p1.rasterizerState != p2.rasterizerState) {
+            return isPtrLess(p1.rasterizerState, p2.rasterizerState);
+        }
+        for (Int i = 0; i < numShaderStages; ++i) {
+            if (p1.imageViewArrays[i] != p2.imageViewArrays[i]) {
+                return isPtrArrayLess(p1.imageViewArrays[i], p2.imageViewArrays[i]);
+            }
+            if (p1.samplerStateArrays[i] != p2.samplerStateArrays[i]) {
+                return isPtrArrayLess(p1.samplerStateArrays[i], p2.samplerStateArrays[i]);
+            }
+            if (p1.constantBufferArrays[i] != p2.constantBufferArrays[i]) {
+                return isPtrArrayLess(
+                    p1.constantBufferArrays[i], p2.constantBufferArrays[i]);
+            }
+        }
+        return false;
+    };
+    std::stable_sort(stateIndices.begin(), stateIndices.end(), isStateLess);
+    core::Array<Int> stateRanks(numStates);
+    Int rank = 0;
+    for (Int i = 0; i < numStates; ++i) {
+        if (i > 0 && isStateLess(stateIndices[i - 1], stateIndices[i])) {
+            ++rank;
+        }
+        stateRanks[stateIndices[i]] = rank;
+    }
+    std::stable_sort(
+        context.deferredDraws.begin(),
+        context.deferredDraws.end(),
+        [&stateRanks](const DeferredDraw_& d1, const DeferredDraw_& d2) {
+            return stateRanks[d1.stateIndex] < stateRanks[d2.stateIndex];
+        });
+
+    // Queue the draws, restoring their state when it changes. Redundant
+    // state changes are skipped by syncState_().
+    PipelineState_ finalState = currentPipelineState_(context);
+    geometry::Mat4f finalProjectionMatrix = context.projectionMatrixStack.last();
+    geometry::Mat4f finalViewMatrix = context.viewMatrixStack.last();
+    Int stateIndex = -1;
+    for (const DeferredDraw_& draw : context.deferredDraws) {
+        if (draw.stateIndex != stateIndex) {
+            stateIndex = draw.stateIndex;
+            const DeferredDrawState_& state = context.deferredDrawStates[stateIndex];
+            restorePipelineState_(context, state.pipelineState);
+            context.projectionMatrixStack.last() = state.projectionMatrix;
+            context.viewMatrixStack.last() = state.viewMatrix;
+            context.dirtyBuiltinConstantBuffer = true;
+            syncState_();
+        }
+        queueDraw_(draw.view.get(), draw.numIndices, draw.numInstances, draw.startVertex);
+    }
+    restorePipelineState_(context, finalState);
+    context.projectionMatrixStack.last() = finalProjectionMatrix;
+    context.viewMatrixStack.last() = finalViewMatrix;
+    context.dirtyBuiltinConstantBuffer = true;
+
+    context.deferredDraws.clear();
+    context.deferredDrawStates.clear();
 }
 
 void Engine::clear(const core::Color& color) {
@@ -919,51 +1472,237 @@ void Engine::createBuiltinResources_() {
     createBuiltinShaders_();
 }
 
+// -- secondary command lists --
+
+namespace {
+
+// Secondary recording context bound to the calling thread, and the engine it
+// belongs to. See Engine::setThreadCommandList().
+struct ThreadRecordingContext {
+    const Engine* engine = nullptr;
+    void* context = nullptr;
+};
+
+thread_local ThreadRecordingContext threadRecordingContext;
+
+} // namespace
+
+Engine::RecordingContext_& Engine::threadContext_() {
+    const ThreadRecordingContext& bound = threadRecordingContext;
+    if (bound.engine == this) {
+        return *static_cast<RecordingContext_*>(bound.context);
+    }
+    return primaryContext_;
+}
+
+bool Engine::isSecondaryContextBound_(std::string_view functionName) const {
+    if (context_().isSecondary) {
+        VGC_WARNING(
+            LogVgcGraphics,
+            "Engine::{}() cannot be called while a secondary command list is bound "
+            "to the calling thread.",
+            functionName);
+        return true;
+    }
+    return false;
+}
+
+SecondaryCommandList Engine::beginSecondaryCommandList() {
+    RecordingContext_& context = context_();
+    if (!context.isSecondary && !glyphAtlasImage_) {
+        createGlyphAtlasResources_();
+    }
+    std::unique_ptr<RecordingContext_> secondary;
+    if (!context.isSecondary && !secondaryContextPool_.isEmpty()) {
+        secondary = std::move(secondaryContextPool_.last());
+        secondaryContextPool_.removeLast();
+    }
+    else {
+        secondary = std::make_unique<RecordingContext_>();
+        secondary->isSecondary = true;
+    }
+    RecordingContext_& s = *secondary;
+
+    // Start from the current parameters and matrices of the calling thread.
+    auto copyTop = [](auto& stack, const auto& otherStack) {
+        stack.clear();
+        stack.append(otherStack.last());
+    };
+    copyTop(s.framebufferStack, context.framebufferStack);
+    copyTop(s.viewportStack, context.viewportStack);
+    copyTop(s.programStack, context.programStack);
+    copyTop(s.blendStateStack, context.blendStateStack);
+    copyTop(s.blendConstantFactorStack, context.blendConstantFactorStack);
+    copyTop(s.rasterizerStateStack, context.rasterizerStateStack);
+    for (Int i = 0; i < numShaderStages; ++i) {
+        copyTop(s.constantBufferArrayStacks[i], context.constantBufferArrayStacks[i]);
+        copyTop(s.imageViewArrayStacks[i], context.imageViewArrayStacks[i]);
+        copyTop(s.samplerStateArrayStacks[i], context.samplerStateArrayStacks[i]);
+    }
+    copyTop(s.projectionMatrixStack, context.projectionMatrixStack);
+    copyTop(s.viewMatrixStack, context.viewMatrixStack);
+
+    // The backend state at the time the list is executed is unknown, so all
+    // parameters are synced before the first draw. Parameters that are
+    // neither dirty nor known to be applied are managed by external code
+    // (e.g., the framebuffer of a QWidget frame) and are left untouched.
+    PipelineParameters managedParameters =
+        context.dirtyPipelineParameters | context.knownAppliedParameters;
+    s.dirtyPipelineParameters = PipelineParameter::All & managedParameters;
+    s.appliedPipelineState = PipelineState_();
+    s.knownAppliedParameters = PipelineParameter::None;
+    s.dirtyBuiltinConstantBuffer = true;
+    s.hasUploadedBuiltinConstants = false;
+    s.frameStats = EngineFrameStats();
+    s.areDrawsUnordered = false;
+    s.geometryBatch.clear();
+    s.textBatch.clear();
+    s.numRetainedGeometryBatches = 0;
+
+    return SecondaryCommandList(std::move(secondary));
+}
+
+void Engine::setThreadCommandList(SecondaryCommandList* commandList) {
+    ThreadRecordingContext& bound = threadRecordingContext;
+    if (bound.engine == this) {
+        RecordingContext_& context = *static_cast<RecordingContext_*>(bound.context);
+        if (context.areDrawsUnordered) {
+            endUnorderedDraws();
+        }
+        flushGeometryBatch_();
+        context.isBound = false;
+        bound = ThreadRecordingContext();
+        --numBoundSecondaryContexts_;
+    }
+    if (!commandList || commandList->isEmpty()) {
+        return;
+    }
+    if (bound.engine) {
+        VGC_WARNING(
+            LogVgcGraphics,
+            "A secondary command list of another engine is already bound to the "
+            "calling thread.");
+        return;
+    }
+    RecordingContext_* context = commandList->context_.get();
+    if (context->isBound.exchange(true)) {
+        VGC_WARNING(
+            LogVgcGraphics,
+            "The secondary command list is already bound to another thread.");
+        return;
+    }
+    bound.engine = this;
+    bound.context = context;
+    ++numBoundSecondaryContexts_;
+}
+
+void Engine::executeSecondaryCommandList(SecondaryCommandList& commandList) {
+    if (commandList.isEmpty()) {
+        return;
+    }
+    RecordingContext_& secondary = *commandList.context_;
+    if (secondary.isBound) {
+        VGC_WARNING(
+            LogVgcGraphics,
+            "Cannot execute a secondary command list that is still bound to a "
+            "thread.");
+        return;
+    }
+    RecordingContext_& context = context_();
+    flushGeometryBatch_();
+    if (!context.isSecondary && glyphAtlasImage_ && glyphAtlas_.isDirty()) {
+        // Glyphs added to the atlas while recording the secondary list.
+        updateGlyphAtlasImage_();
+    }
+    if (!secondary.commands.isEmpty()) {
+        queueCommand_<detail::ExecuteStreamCommand>(std::move(secondary.commands));
+    }
+
+    // The parameters applied by the secondary command list replace the ones
+    // known to be applied by the calling thread.
+    PipelineParameters changedParameters = secondary.knownAppliedParameters;
+    context.knownAppliedParameters.unset(changedParameters);
+    context.dirtyPipelineParameters |= changedParameters;
+    if (secondary.hasUploadedBuiltinConstants) {
+        context.hasUploadedBuiltinConstants = false;
+        context.dirtyBuiltinConstantBuffer = true;
+    }
+
+    EngineFrameStats& stats = context.frameStats;
+    const EngineFrameStats& secondaryStats = secondary.frameStats;
+    stats.numDraws_ += secondaryStats.numDraws_;
+    stats.numStateChanges_ += secondaryStats.numStateChanges_;
+    stats.numSkippedStateChanges_ += secondaryStats.numSkippedStateChanges_;
+    stats.numBuiltinConstantUpdates_ += secondaryStats.numBuiltinConstantUpdates_;
+
+    if (context.isSecondary) {
+        commandList.context_.reset();
+    }
+    else {
+        secondaryContextPool_.append(std::move(commandList.context_));
+    }
+}
+
+SecondaryCommandList::SecondaryCommandList() = default;
+
+SecondaryCommandList::SecondaryCommandList(
+    std::unique_ptr<Engine::RecordingContext_> context)
+    : context_(std::move(context)) {
+}
+
+SecondaryCommandList::SecondaryCommandList(SecondaryCommandList&& other) noexcept =
+    default;
+
+SecondaryCommandList&
+SecondaryCommandList::operator=(SecondaryCommandList&& other) noexcept = default;
+
+SecondaryCommandList::~SecondaryCommandList() {
+    if (context_ && context_->isBound) {
+        VGC_ERROR(
+            LogVgcGraphics,
+            "Destroying a secondary command list that is still bound to a thread.");
+    }
+}
+
 // -- render thread + sync --
 
 // XXX add try/catch ?
 void Engine::renderThreadProc_() {
 
     initContext_();
-    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
     while (1) {
-        lock.lock();
 
         // wait for work or stop request
-        wakeRenderThreadConditionVariable_.wait(
-            lock, [&] { return !commandQueue_.isEmpty() || stopRequested_; });
+        detail::CommandStream* commands = commandQueue_.waitFront();
 
         // userResourcesToSetAsInternalOnly_
 
         // if requested, stop
-        if (stopRequested_) {
+        if (!commands) {
             // cancel submitted lists
-            commandQueue_.clear();
-            lastExecutedCommandListId_ = lastSubmittedCommandListId_;
+            commandQueue_.cancelAll();
             // release all resources..
             resourceRegistry_->releaseAllResources(this);
-            // notify
-            lock.unlock();
-            renderThreadEventConditionVariable_.notify_all();
             return;
         }
 
-        // else commandQueue_ is not empty, so prepare some work
-        CommandList commandList = std::move(commandQueue_.first());
-        commandQueue_.removeFirst();
-
-        lock.unlock();
-
-        // execute commands
-        for (const CommandUPtr& command : commandList.commands) {
-            command->execute(this);
+        // execute commands, then destroy them (keeping their memory for
+        // reuse) and notify waiting threads
+        if (EngineProfiler* profiler = profiler_.get()) {
+            Int id = commandQueue_.lastExecutedId() + 1;
+            profiler->beginCommandList_(id, profiler->now_());
+            commands->forEach([this, profiler](detail::Command* command) {
+                double startTime = profiler->now_();
+                command->execute(this);
+                double duration = profiler->now_() - startTime;
+                profiler->addCommand_(command->name(), startTime, duration);
+            });
+            profiler->endCommandList_(profiler->now_());
         }
-
-        lock.lock();
-        ++lastExecutedCommandListId_;
-        lock.unlock();
-
-        renderThreadEventConditionVariable_.notify_all();
+        else {
+            commands->execute(this);
+        }
+        commandQueue_.popFront();
 
         // release garbaged resources (locking)
         resourceRegistry_->releaseAndDeleteGarbagedResources(this);
@@ -981,13 +1720,11 @@ void Engine::startRenderThread_() {
 }
 
 void Engine::stopRenderThread_() {
-    pendingCommands_.clear();
+    primaryContext_.commands.clear();
     swapChain_.reset();
     if (isThreadRunning_) {
-        std::unique_lock<std::mutex> lock(mutex_);
         stopRequested_ = true;
-        lock.unlock();
-        wakeRenderThreadConditionVariable_.notify_all();
+        commandQueue_.requestStop();
         VGC_CORE_ASSERT(renderThread_.joinable());
         renderThread_.join();
         isThreadRunning_ = false;
@@ -996,30 +1733,494 @@ void Engine::stopRenderThread_() {
 }
 
 UInt Engine::submitPendingCommandList_() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    bool notifyRenderThread = false;
-    UInt id = lastSubmittedCommandListId_;
-    if (!pendingCommands_.empty()) {
-        notifyRenderThread = commandQueue_.isEmpty();
-        commandQueue_.emplaceLast(std::move(pendingCommands_));
-        pendingCommands_.clear();
-        id = ++lastSubmittedCommandListId_;
-    }
-    lock.unlock();
-    if (notifyRenderThread) {
-        wakeRenderThreadConditionVariable_.notify_all();
+    Int id = commandQueue_.lastPushedId();
+    detail::CommandStream& commands = primaryContext_.commands;
+    if (!commands.isEmpty()) {
+        if (profiler_) {
+            profiler_->addSubmit_(profiler_->now_());
+        }
+        id = commandQueue_.push(commands);
     }
-    return id;
+    return static_cast<UInt>(id);
 }
 
 void Engine::waitCommandListTranslationFinished_(Int commandListId) {
-    std::unique_lock<std::mutex> lock(mutex_);
     if (commandListId == 0) {
-        commandListId = lastSubmittedCommandListId_;
+        commandListId = commandQueue_.lastPushedId();
+    }
+    waitExecuted_(commandListId);
+}
+
+void Engine::waitExecuted_(Int commandListId) {
+    if (profiler_ && commandQueue_.lastExecutedId() < commandListId) {
+        double startTime = profiler_->now_();
+        commandQueue_.waitExecuted(commandListId);
+        profiler_->addWait_(startTime, profiler_->now_() - startTime);
+    }
+    else {
+        commandQueue_.waitExecuted(commandListId);
     }
-    renderThreadEventConditionVariable_.wait(
-        lock, [&] { return lastExecutedCommandListId_ == commandListId; });
-    lock.unlock();
+}
+
+void Engine::waitFramesInFlight_(Int frameCommandListId) {
+    // The slot contains the ID of the frame ended maxFramesInFlight() frames
+    // ago, which must be executed before we can have one more frame in flight.
+    Int& slot = inFlightFrameCommandListIds_[numEndedFrames_ % maxFramesInFlight()];
+    if (slot > 0) {
+        waitExecuted_(slot);
+    }
+    slot = frameCommandListId;
+    ++numEndedFrames_;
+}
+
+void Engine::createTransientVertexBuffer_() {
+
+    // Regions are kept 16-byte aligned.
+    Int regionSize = (std::max)(Int(0), createInfo_.transientVertexMemorySize());
+    regionSize = (regionSize + 15) / 16 * 16;
+    Int lengthInBytes = regionSize * numTransientVertexRegions_();
+    transientVertexData_.resize(lengthInBytes);
+    transientVertexBuffer_ = createVertexBuffer(lengthInBytes);
+    transientVertexAllocatedEnd_ = transientVertexRegionIndex_ * regionSize;
+    transientVertexUploadedEnd_ = transientVertexAllocatedEnd_;
+}
+
+void Engine::createGlyphAtlasResources_() {
+
+    ImageCreateInfo imageCreateInfo = {};
+    imageCreateInfo.setWidth(glyphAtlas_.width());
+    imageCreateInfo.setHeight(glyphAtlas_.height());
+    imageCreateInfo.setRank(ImageRank::_2D);
+    imageCreateInfo.setPixelFormat(PixelFormat::R_8_UNORM);
+    imageCreateInfo.setNumMipLevels(1);
+    imageCreateInfo.setMipGenerationEnabled(false);
+    imageCreateInfo.setUsage(Usage::Default);
+    imageCreateInfo.setBindFlags(ImageBindFlag::ShaderResource);
+    const core::Array<UInt8>& pixels = glyphAtlas_.pixels();
+    core::Array<char> initialData(pixels.length());
+    std::memcpy(initialData.data(), pixels.data(), pixels.length());
+    glyphAtlasImage_ = createImage(imageCreateInfo, std::move(initialData));
+    glyphAtlas_.clearDirtyRect();
+
+    ImageViewCreateInfo viewCreateInfo = {};
+    viewCreateInfo.setBindFlags(ImageBindFlag::ShaderResource);
+    glyphAtlasImageView_ = createImageView(viewCreateInfo, glyphAtlasImage_);
+
+    // Quads are aligned on texels, so there is no need for filtering.
+    SamplerStateCreateInfo samplerCreateInfo = {};
+    samplerCreateInfo.setMagFilter(FilterMode::Point);
+    samplerCreateInfo.setMinFilter(FilterMode::Point);
+    samplerCreateInfo.setMipFilter(FilterMode::Point);
+    samplerCreateInfo.setWrapModeU(ImageWrapMode::Clamp);
+    samplerCreateInfo.setWrapModeV(ImageWrapMode::Clamp);
+    samplerCreateInfo.setWrapModeW(ImageWrapMode::Clamp);
+    glyphAtlasSamplerState_ = createSamplerState(samplerCreateInfo);
+
+    if (!transientVertexBuffer_) {
+        createTransientVertexBuffer_();
+    }
+    GeometryViewCreateInfo createInfo = {};
+    createInfo.setBuiltinGeometryLayout(BuiltinGeometryLayout::TextAtlasQuad);
+    createInfo.setPrimitiveType(PrimitiveType::TriangleStrip);
+    createInfo.setVertexBuffer(0, transientVertexBuffer_);
+    textQuadsView_ = createGeometryView(createInfo);
+}
+
+void Engine::updateGlyphAtlasImage_() {
+
+    // Only the rows of the dirty rect are copied, since the atlas is much
+    // larger than what typically changes in a frame.
+    geometry::Rect2f rect = glyphAtlas_.dirtyRect();
+    Int x = static_cast<Int>(rect.xMin());
+    Int y = static_cast<Int>(rect.yMin());
+    Int width = static_cast<Int>(rect.xMax()) - x;
+    Int height = static_cast<Int>(rect.yMax()) - y;
+    const core::Array<UInt8>& pixels = glyphAtlas_.pixels();
+    Int atlasWidth = glyphAtlas_.width();
+    core::Array<UInt8> data(width * height);
+    for (Int i = 0; i < height; ++i) {
+        std::memcpy(
+            data.data() + i * width, pixels.data() + (y + i) * atlasWidth + x, width);
+    }
+    glyphAtlas_.clearDirtyRect();
+
+    struct CommandParameters {
+        Image* image;
+        Int x;
+        Int y;
+        Int width;
+        Int height;
+        core::Array<UInt8> data;
+    };
+    queueLambdaCommandWithParameters_<CommandParameters>(
+        "updateImageData",
+        [](Engine* engine, const CommandParameters& p) {
+            engine->updateImageData_(
+                p.image, p.x, p.y, p.width, p.height, p.data.data(), p.data.length());
+        },
+        glyphAtlasImage_.get(),
+        x,
+        y,
+        width,
+        height,
+        std::move(data));
+}
+
+GeometryViewPtr Engine::copyTextQuads_(
+    const core::Array<TextAtlasVertex>& quads,
+    Int& startInstance) {
+    RecordingContext_& context = context_();
+
+    // Copy the quads as per-instance data, preferably in transient memory.
+    static_assert(sizeof(TextAtlasVertex) == 11 * sizeof(float));
+    Int numQuads = quads.length();
+    Int numFloats = numQuads * 11;
+    if (!context.isSecondary) {
+        Span<float> data =
+            allocateTransientVertices(textQuadsView_, numQuads, startInstance);
+        if (data.length() == numFloats) {
+            std::memcpy(data.data(), quads.data(), numFloats * sizeof(float));
+            return textQuadsView_;
+        }
+    }
+    GeometryViewPtr& overflowView = context.textQuadsOverflowView;
+    if (!overflowView) {
+        GeometryViewCreateInfo createInfo = {};
+        createInfo.setBuiltinGeometryLayout(BuiltinGeometryLayout::TextAtlasQuad);
+        createInfo.setPrimitiveType(PrimitiveType::TriangleStrip);
+        createInfo.setVertexBuffer(0, createVertexBuffer(0));
+        overflowView = createGeometryView(createInfo);
+    }
+    core::FloatArray floats(numFloats);
+    std::memcpy(floats.data(), quads.data(), numFloats * sizeof(float));
+    updateVertexBufferData(overflowView, std::move(floats));
+    startInstance = 0;
+    return overflowView;
+}
+
+namespace {
+
+constexpr PipelineParameters textPipelineParameters =
+    PipelineParameter::Program | PipelineParameter::PixelShaderImageViews
+    | PipelineParameter::PixelShaderSamplers;
+
+} // namespace
+
+void Engine::drawText_(const GeometryViewPtr& view, Int numQuads, Int startInstance) {
+    pushPipelineParameters(textPipelineParameters);
+    setProgram(BuiltinProgram::GlyphAtlas);
+    setStageImageViews(&glyphAtlasImageView_, 0, 1, ShaderStage::Pixel);
+    setStageSamplers(&glyphAtlasSamplerState_, 0, 1, ShaderStage::Pixel);
+    draw(view, 4, numQuads, startInstance);
+    popPipelineParameters(textPipelineParameters);
+}
+
+void Engine::flushTextBatch_() {
+    RecordingContext_& context = context_();
+    if (context.textBatch.isEmpty()) {
+        return;
+    }
+
+    // The batch is swapped out first since syncing the state below flushes
+    // the pending batches.
+    std::swap(context.textBatch, context.flushedTextBatch);
+    const core::Array<TextAtlasVertex>& quads = context.flushedTextBatch.quads();
+    Int startInstance = 0;
+    GeometryViewPtr view = copyTextQuads_(quads, startInstance);
+
+    // Only the parameters specific to text are synced: the others, as well
+    // as the builtin constants, must stay the ones the batch was started
+    // with, even if they have been changed since then.
+    PipelineParameters dirtyParameters = context.dirtyPipelineParameters;
+    context.dirtyPipelineParameters = PipelineParameter::None;
+    pushPipelineParameters(textPipelineParameters);
+    setProgram(BuiltinProgram::GlyphAtlas);
+    setStageImageViews(&glyphAtlasImageView_, 0, 1, ShaderStage::Pixel);
+    setStageSamplers(&glyphAtlasSamplerState_, 0, 1, ShaderStage::Pixel);
+    bool dirtyBuiltinConstantBuffer = context.dirtyBuiltinConstantBuffer;
+    context.dirtyBuiltinConstantBuffer = false;
+    syncState_();
+    context.dirtyBuiltinConstantBuffer = dirtyBuiltinConstantBuffer;
+    if (!context.isSecondary
+        && transientVertexUploadedEnd_ < transientVertexAllocatedEnd_) {
+        flushTransientVertexData_();
+    }
+    queueDraw_(view.get(), 4, quads.length(), core::int_cast<UInt>(startInstance));
+    popPipelineParameters(textPipelineParameters);
+    context.dirtyPipelineParameters |= dirtyParameters;
+    context.flushedTextBatch.clear();
+}
+
+void Engine::flushTransientVertexData_() {
+    struct CommandParameters {
+        Buffer* buffer;
+        Int regionIndex;
+        Int offsetInBytes;
+        const char* data;
+        Int lengthInBytes;
+    };
+    Int offset = transientVertexUploadedEnd_;
+    queueLambdaCommandWithParameters_<CommandParameters>(
+        "uploadTransientVertexData",
+        [](Engine* engine, const CommandParameters& p) {
+            engine->uploadTransientVertexData_(
+                p.buffer, p.regionIndex, p.offsetInBytes, p.data, p.lengthInBytes);
+        },
+        transientVertexBuffer_.get(),
+        transientVertexRegionIndex_,
+        offset,
+        transientVertexData_.data() + offset,
+        transientVertexAllocatedEnd_ - offset);
+    transientVertexUploadedEnd_ = transientVertexAllocatedEnd_;
+}
+
+void Engine::endTransientVertexFrame_() {
+    if (!transientVertexBuffer_) {
+        return;
+    }
+    Int numRegions = numTransientVertexRegions_();
+    Int regionSize = transientVertexData_.length() / numRegions;
+    if (transientVertexAllocatedEnd_ > transientVertexRegionIndex_ * regionSize) {
+        struct CommandParameters {
+            Buffer* buffer;
+            Int regionIndex;
+        };
+        queueLambdaCommandWithParameters_<CommandParameters>(
+            "fenceTransientVertexData",
+            [](Engine* engine, const CommandParameters& p) {
+                engine->fenceTransientVertexData_(p.buffer, p.regionIndex);
+            },
+            transientVertexBuffer_.get(),
+            transientVertexRegionIndex_);
+    }
+
+    // The next region was last used maxFramesInFlight() + 1 frames ago, so
+    // it is no longer read by the render thread once endFrame() returns.
+    transientVertexRegionIndex_ = (transientVertexRegionIndex_ + 1) % numRegions;
+    transientVertexAllocatedEnd_ = transientVertexRegionIndex_ * regionSize;
+    transientVertexUploadedEnd_ = transientVertexAllocatedEnd_;
+}
+
+void Engine::prepareGeometryBatch_(
+    BuiltinGeometryLayout layout,
+    const core::FloatArray& vertices) {
+
+    RecordingContext_& context = context_();
+    const GeometryBatch& geometryBatch = context.geometryBatch;
+    const TextBatch& textBatch = context.textBatch;
+    bool isStarted = !geometryBatch.isEmpty() || !textBatch.isEmpty();
+    if (isStarted) {
+        // Text is drawn after the triangles of the batch, so triangles that
+        // must be drawn over the text of the batch require a new batch.
+        if ((!geometryBatch.isEmpty() && layout != geometryBatch.layout())
+            || context.dirtyPipelineParameters != PipelineParameter::None
+            || context.projectionMatrixStack.last()
+                   != context.geometryBatchProjectionMatrix
+            || (!textBatch.isEmpty()
+                && textBatch.boundingRect().intersects(GeometryBatch::boundingRect(
+                    layout, vertices, context.viewMatrixStack.last())))) {
+
+            flushGeometryBatch_();
+            isStarted = false;
+        }
+    }
+    if (!isStarted) {
+        startGeometryBatch_();
+    }
+}
+
+void Engine::prepareTextBatch_() {
+    RecordingContext_& context = context_();
+    bool isStarted = !context.geometryBatch.isEmpty() || !context.textBatch.isEmpty();
+    if (isStarted) {
+        if (context.dirtyPipelineParameters != PipelineParameter::None
+            || context.projectionMatrixStack.last()
+                   != context.geometryBatchProjectionMatrix) {
+
+            flushGeometryBatch_();
+            isStarted = false;
+        }
+    }
+    if (!isStarted) {
+        startGeometryBatch_();
+    }
+}
+
+void Engine::startGeometryBatch_() {
+    RecordingContext_& context = context_();
+
+    // Sync the pipeline state, but with an identity view matrix since the
+    // vertices of the batch are already transformed. The actual view matrix
+    // is synced again before the next regular draw.
+    context.dirtyBuiltinConstantBuffer = false;
+    syncState_();
+    updateBuiltinConstants_(geometry::Mat4f::identity);
+    context.dirtyBuiltinConstantBuffer = true;
+    context.geometryBatchProjectionMatrix = context.projectionMatrixStack.last();
+}
+
+void Engine::flushGeometryBatch_() {
+    RecordingContext_& context = context_();
+    if (context.geometryBatch.isEmpty()) {
+        flushTextBatch_();
+        return;
+    }
+    BuiltinGeometryLayout layout = context.geometryBatch.layout();
+    Int layoutIndex = core::toUnderlying(layout);
+    const core::FloatArray& data = context.geometryBatch.data();
+    Int numVertices = context.geometryBatch.numVertices();
+    const core::Array<UInt64>& contentKey = context.geometryBatch.contentKey();
+
+    // Batches whose content can be identified are drawn from a retained
+    // vertex buffer, only updated if the content changed since the previous
+    // frame. Other batches use transient vertex memory when available, and
+    // otherwise fall back to a dynamic vertex buffer.
+    Int startVertex = 0;
+    GeometryView* drawnView = nullptr;
+    if (!contentKey.isEmpty()) {
+        Int index = context.numRetainedGeometryBatches;
+        ++context.numRetainedGeometryBatches;
+        if (index == context.retainedGeometryBatches.length()) {
+            context.retainedGeometryBatches.emplaceLast();
+        }
+        RetainedGeometryBatch_& retained = context.retainedGeometryBatches[index];
+        if (!retained.view || retained.layout != layout) {
+            retained.view = createDynamicTriangleListView(layout);
+            retained.layout = layout;
+            retained.contentKey.clear();
+        }
+        if (retained.contentKey != contentKey) {
+            updateVertexBufferData(retained.view, data);
+            retained.contentKey = contentKey;
+        }
+        drawnView = retained.view.get();
+    }
+    else if (!context.isSecondary) {
+        GeometryViewPtr& view = context.geometryBatchViews[layoutIndex];
+        if (!view) {
+            view = createTransientTriangleListView(layout);
+        }
+        Span<float> vertices = allocateTransientVertices(view, numVertices, startVertex);
+        if (vertices.length() == data.length()) {
+            std::memcpy(vertices.data(), data.data(), data.length() * sizeof(float));
+            flushTransientVertexData_();
+            drawnView = view.get();
+        }
+    }
+    if (!drawnView) {
+        GeometryViewPtr& overflowView = context.geometryBatchOverflowViews[layoutIndex];
+        if (!overflowView) {
+            overflowView = createDynamicTriangleListView(layout);
+        }
+        updateVertexBufferData(overflowView, data);
+        drawnView = overflowView.get();
+        startVertex = 0;
+    }
+    queueDraw_(
+        drawnView,
+        core::int_cast<UInt>(numVertices),
+        0,
+        core::int_cast<UInt>(startVertex));
+    context.geometryBatch.clear();
+    flushTextBatch_();
+}
+
+void Engine::updateBuiltinConstants_(const geometry::Mat4f& viewMatrix) {
+    RecordingContext_& context = context_();
+    const geometry::Mat4f& projectionMatrix = context.projectionMatrixStack.last();
+    if (context.hasUploadedBuiltinConstants
+        && context.uploadedViewMatrix == viewMatrix
+        && context.uploadedProjectionMatrix == projectionMatrix) {
+
+        return;
+    }
+    context.hasUploadedBuiltinConstants = true;
+    context.uploadedProjectionMatrix = projectionMatrix;
+    context.uploadedViewMatrix = viewMatrix;
+    ++context.frameStats.numBuiltinConstantUpdates_;
+
+    detail::BuiltinConstants constants = {};
+    constants.projMatrix = projectionMatrix;
+    constants.viewMatrix = viewMatrix;
+    constants.frameStartTimeInMs = toMilliseconds(frameStartTime_ - engineStartTime_);
+    struct CommandParameters {
+        Buffer* buffer;
+        detail::BuiltinConstants constants;
+    };
+    queueLambdaCommandWithParameters_<CommandParameters>(
+        "updateBuiltinConstantBufferData",
+        [](Engine* engine, const CommandParameters& p) {
+            engine->updateBufferData_(
+                p.buffer, &p.constants, sizeof(detail::BuiltinConstants));
+        },
+        builtinConstantsBuffer_.get(),
+        constants);
+}
+
+void Engine::deferDraw_(
+    const GeometryViewPtr& view,
+    UInt numIndices,
+    Int numInstances,
+    UInt startVertex) {
+    RecordingContext_& context = context_();
+
+    // Record a new state only if the state may have changed since the last
+    // recorded state, that is, if there are unsynced changes.
+    bool isStateDirty = context.dirtyPipelineParameters != PipelineParameter::None
+                        || context.dirtyBuiltinConstantBuffer;
+    bool isNewState = context.deferredDrawStates.isEmpty();
+    if (!isNewState && isStateDirty) {
+        const DeferredDrawState_& last = context.deferredDrawStates.last();
+        const PipelineState_& p = last.pipelineState;
+        isNewState = p.framebuffer != context.framebufferStack.last()
+                     || p.viewport != context.viewportStack.last()
+                     || p.program != context.programStack.last()
+                     || p.blendState != context.blendStateStack.last()
+                     || p.blendConstantFactor != context.blendConstantFactorStack.last()
+                     || p.rasterizerState != context.rasterizerStateStack.last()
+                     || last.projectionMatrix != context.projectionMatrixStack.last()
+                     || last.viewMatrix != context.viewMatrixStack.last();
+        for (Int i = 0; !isNewState && i < numShaderStages; ++i) {
+            isNewState =
+                p.constantBufferArrays[i] != context.constantBufferArrayStacks[i].last()
+                || p.imageViewArrays[i] != context.imageViewArrayStacks[i].last()
+                || p.samplerStateArrays[i] != context.samplerStateArrayStacks[i].last();
+        }
+    }
+    if (isNewState) {
+        Int framebufferIndex = 0;
+        if (!context.deferredDrawStates.isEmpty()) {
+            const DeferredDrawState_& last = context.deferredDrawStates.last();
+            framebufferIndex = last.framebufferIndex;
+            if (last.pipelineState.framebuffer != context.framebufferStack.last()) {
+                ++framebufferIndex;
+            }
+        }
+        DeferredDrawState_& state = context.deferredDrawStates.emplaceLast();
+        state.pipelineState = currentPipelineState_(context);
+        state.projectionMatrix = context.projectionMatrixStack.last();
+        state.viewMatrix = context.viewMatrixStack.last();
+        state.framebufferIndex = framebufferIndex;
+    }
+    Int stateIndex = context.deferredDrawStates.length() - 1;
+    context.deferredDraws.append(
+        {view, numIndices, numInstances, startVertex, stateIndex});
+}
+
+void Engine::queueDraw_(
+    GeometryView* view,
+    UInt numIndices,
+    Int numInstances,
+    UInt startVertex) {
+    RecordingContext_& context = context_();
+
+    ++context.frameStats.numDraws_;
+    queueLambdaCommandWithParameters_<GeometryView*>(
+        "draw",
+        [=](Engine* engine, GeometryView* gv) {
+            engine->draw_(gv, numIndices, numInstances, startVertex);
+        },
+        view);
 }
 
 void Engine::sanitize_(SwapChainCreateInfo& /*createInfo*/) {
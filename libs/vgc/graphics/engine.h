@@ -20,9 +20,7 @@
 #include <array>
 #include <atomic>
 #include <chrono>
-#include <condition_variable>
 #include <functional>
-#include <list>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -41,14 +39,17 @@
 #include <vgc/graphics/buffer.h>
 #include <vgc/graphics/constants.h>
 #include <vgc/graphics/detail/command.h>
+#include <vgc/graphics/detail/commandqueue.h>
 #include <vgc/graphics/detail/pipelinestate.h>
 #include <vgc/graphics/enums.h>
 #include <vgc/graphics/font.h>
 #include <vgc/graphics/framebuffer.h>
 #include <vgc/graphics/geometryview.h>
+#include <vgc/graphics/glyphatlas.h>
 #include <vgc/graphics/image.h>
 #include <vgc/graphics/imageview.h>
 #include <vgc/graphics/logcategories.h>
+#include <vgc/graphics/profiler.h>
 #include <vgc/graphics/program.h>
 #include <vgc/graphics/rasterizerstate.h>
 #include <vgc/graphics/resource.h>
@@ -59,6 +60,8 @@ namespace vgc::graphics {
 
 VGC_DECLARE_OBJECT(Engine);
 
+class SecondaryCommandList;
+
 namespace detail {
 
 struct BuiltinConstants {
@@ -153,12 +156,89 @@ public:
         isMultithreadingEnabled_ = enabled;
     }
 
+    /// Returns the maximum number of frames that the user thread can submit
+    /// before they are executed by the render thread. When this limit is
+    /// reached, `Engine::endFrame()` waits for the oldest frame to be
+    /// executed.
+    ///
+    /// This is only used when multithreading is enabled. The default is 3.
+    ///
+    Int maxFramesInFlight() const {
+        return maxFramesInFlight_;
+    }
+
+    /// Sets the maximum number of frames in flight. Values less than 1 are
+    /// treated as 1.
+    ///
+    void setMaxFramesInFlight(Int maxFramesInFlight) {
+        maxFramesInFlight_ = maxFramesInFlight;
+    }
+
+    /// Returns the number of bytes of transient vertex memory available per
+    /// frame (see `Engine::allocateTransientVertices()`). The default is 1 MiB.
+    ///
+    Int transientVertexMemorySize() const {
+        return transientVertexMemorySize_;
+    }
+
+    /// Sets the number of bytes of transient vertex memory available per
+    /// frame.
+    ///
+    void setTransientVertexMemorySize(Int transientVertexMemorySize) {
+        transientVertexMemorySize_ = transientVertexMemorySize;
+    }
+
 private:
     WindowSwapChainFormat windowSwapChainFormat_ = {};
     bool isMultithreadingEnabled_ = false;
+    Int maxFramesInFlight_ = 3;
+    Int transientVertexMemorySize_ = 1 << 20;
 };
 
-// XXX add something to limit the number of pending frames for each swapchain..
+/// \class vgc::graphics::EngineFrameStats
+/// \brief Statistics about the commands queued by an `Engine` during a frame.
+///
+/// \sa `Engine::lastFrameStats()`.
+///
+class VGC_GRAPHICS_API EngineFrameStats {
+public:
+    /// Returns the number of draw calls queued during the frame.
+    ///
+    Int numDraws() const {
+        return numDraws_;
+    }
+
+    /// Returns the number of pipeline state changes queued during the frame,
+    /// such as changing the program, the blend state, or the image views of
+    /// a shader stage.
+    ///
+    Int numStateChanges() const {
+        return numStateChanges_;
+    }
+
+    /// Returns the number of pipeline state changes that were not queued
+    /// during the frame because the new state was equal to the state already
+    /// applied.
+    ///
+    Int numSkippedStateChanges() const {
+        return numSkippedStateChanges_;
+    }
+
+    /// Returns the number of updates of the builtin constant buffer (that is,
+    /// of the projection and view matrices) queued during the frame.
+    ///
+    Int numBuiltinConstantUpdates() const {
+        return numBuiltinConstantUpdates_;
+    }
+
+private:
+    friend Engine;
+
+    Int numDraws_ = 0;
+    Int numStateChanges_ = 0;
+    Int numSkippedStateChanges_ = 0;
+    Int numBuiltinConstantUpdates_ = 0;
+};
 
 /// \class vgc::graphics::Engine
 /// \brief Abstract interface for graphics rendering.
@@ -181,7 +261,6 @@ protected:
     VGC_PRIVATIZE_OBJECT_TREE_MUTATORS
 
     using Command = detail::Command;
-    using CommandUPtr = std::unique_ptr<Command>;
 
 protected:
     /// Constructs an Engine. This constructor is an implementation detail only
@@ -200,6 +279,10 @@ public:
         return createInfo_.isMultithreadingEnabled();
     }
 
+    Int maxFramesInFlight() const {
+        return inFlightFrameCommandListIds_.length();
+    }
+
     // !! public methods should be called on user thread !!
 
     /// Creates a swap chain for the given window.
@@ -221,6 +304,11 @@ public:
 
     GeometryViewPtr createDynamicTriangleListView(BuiltinGeometryLayout vertexLayout);
 
+    /// Creates a triangle list view whose vertices are stored in the transient
+    /// vertex memory of this engine. See `allocateTransientVertices()`.
+    ///
+    GeometryViewPtr createTransientTriangleListView(BuiltinGeometryLayout vertexLayout);
+
     ImagePtr createImage(const ImageCreateInfo& createInfo);
 
     ImagePtr
@@ -302,6 +390,12 @@ public:
     /// Assigns `m` to the top-most matrix of the view matrix stack.
     /// `m` becomes the current view matrix.
     ///
+    /// Batched triangles and text (see `drawBatchedTriangles()` and
+    /// `drawText()`) are transformed on the CPU, so changing the view matrix
+    /// between them doesn't require uploading the builtin constants. However,
+    /// each `draw()` performed with a view matrix different from the last
+    /// uploaded one uploads the builtin constants again.
+    ///
     void setViewMatrix(const geometry::Mat4f& viewMatrix);
 
     /// Duplicates the top-most matrix on the view matrix stack.
@@ -347,11 +441,129 @@ public:
     template<typename T>
     void updateVertexBufferData(const GeometryViewPtr& geometry, core::Array<T> data);
 
-    void draw(const GeometryViewPtr& geometryView, Int numIndices, Int numInstances);
+    /// Allocates `numVertices` vertices of the given transient view (see
+    /// `createTransientTriangleListView()`) in the transient vertex memory of
+    /// the current frame, and returns the floats that the caller must fill
+    /// with the vertex data before calling `draw()`. This avoids allocating
+    /// a new array and reallocating a GPU buffer for geometry that changes
+    /// every frame.
+    ///
+    /// `startVertex` is set to the index of the first allocated vertex, which
+    /// must be passed to `draw()`.
+    ///
+    /// The returned memory is only valid until `endFrame()`. An empty span is
+    /// returned if the transient vertex memory of the current frame is
+    /// exhausted (see `EngineCreateInfo::setTransientVertexMemorySize()`), or
+    /// if a secondary command list is bound to the calling thread (see
+    /// `setThreadCommandList()`).
+    ///
+    Span<float> allocateTransientVertices(
+        const GeometryViewPtr& geometryView,
+        Int numVertices,
+        Int& startVertex);
+
+    void draw(
+        const GeometryViewPtr& geometryView,
+        Int numIndices,
+        Int numInstances,
+        Int startVertex = 0);
+
+    /// Draws the given triangle list, whose vertices are in the given builtin
+    /// layout, using the current program, pipeline state, and matrices.
+    ///
+    /// Unlike `draw()`, the triangles are not submitted immediately: they are
+    /// transformed by the current view matrix and appended to a
+    /// `GeometryBatch`. Consecutive calls with the same layout, pipeline
+    /// state, and projection matrix are then drawn with a single draw call,
+    /// even if the view matrix changes in-between. The batch is drawn before
+    /// any other command that depends on the drawing order, so the result is
+    /// the same as calling `draw()` for each triangle list.
+    ///
+    /// This is typically used by widgets to draw their geometry, so that a
+    /// window with many widgets can be drawn with only a few draw calls.
+    ///
+    void drawBatchedTriangles(
+        BuiltinGeometryLayout layout,
+        const core::FloatArray& vertices);
+
+    /// Draws the given triangles, similarly to
+    /// `drawBatchedTriangles(triangles.layout(), triangles.vertices())`.
+    ///
+    /// However, the transformed vertices are cached in `triangles`, so they
+    /// are only transformed again if the vertices or the view matrix
+    /// changed. Also, if a batch is made of the same triangles, with the same
+    /// transformed vertices, as the batch drawn at the same position in the
+    /// previous frame, then its vertex buffer is re-used instead of uploading
+    /// the vertices again. Therefore, static widgets drawn this way don't
+    /// cause any vertex transformation nor upload.
+    ///
+    void drawBatchedTriangles(BatchedTriangles& triangles);
 
-    //void createTextAtlasResource();
+    /// Starts a sequence of `draw()` calls whose drawing order doesn't
+    /// matter, for example because they don't overlap or because they use
+    /// an order-independent blend state.
+    ///
+    /// Until `endUnorderedDraws()` is called, draws are not queued
+    /// immediately: they are recorded along with the pipeline state and
+    /// matrices current when calling `draw()`, then sorted by pipeline state
+    /// so that the number of state changes is minimized. Draws using
+    /// different framebuffers are never reordered relative to each other.
+    ///
+    /// Other commands, such as `clear()` or `updateBufferData()`, are still
+    /// queued immediately, that is, before the unordered draws. Therefore,
+    /// the resources used by the unordered draws should not be modified
+    /// before calling `endUnorderedDraws()`.
+    ///
+    void beginUnorderedDraws();
 
-    //void drawText(const TextAtlasResource& gaText);
+    /// Queues all the draws recorded since `beginUnorderedDraws()`, sorted by
+    /// pipeline state, then restores the current pipeline state and matrices.
+    ///
+    void endUnorderedDraws();
+
+    /// Returns whether draws are currently recorded without preserving their
+    /// order. See `beginUnorderedDraws()`.
+    ///
+    bool areDrawsUnordered() const {
+        return context_().areDrawsUnordered;
+    }
+
+    /// Returns the `GlyphAtlas` storing the glyphs drawn by `drawText()`.
+    ///
+    /// The atlas starts a new frame at each `beginFrame()`, and its modified
+    /// pixels are uploaded to the GPU by `drawText()`.
+    ///
+    GlyphAtlas& glyphAtlas() {
+        return glyphAtlas_;
+    }
+
+    /// Draws the given glyph quads, typically generated with `glyphAtlas()`
+    /// by `ShapedText::fillAtlasQuads()`, using the current pipeline state
+    /// and matrices.
+    ///
+    /// Each quad is drawn as an instance of a 4-vertex triangle strip with
+    /// the `BuiltinProgram::GlyphAtlas` program, sampling the coverage of the
+    /// glyphs from an image kept in sync with `glyphAtlas()`: the pixels of
+    /// the atlas modified since the previous call are uploaded first. The
+    /// current program, and pixel shader image views and samplers, are left
+    /// unchanged.
+    ///
+    /// Like with `drawBatchedTriangles()`, the quads are not submitted
+    /// immediately: they are transformed by the current view matrix and
+    /// appended to a `TextBatch`, which is drawn with a single draw call right
+    /// after the triangles of the pending `GeometryBatch`. Since the text is
+    /// then drawn after all the triangles of the batch, triangles overlapping
+    /// text drawn before them cause the batch to be drawn first. Quads are
+    /// drawn immediately if the view matrix is not made of a translation and
+    /// a scale, or if draws are unordered.
+    ///
+    /// When called from a thread bound to a secondary command list, the
+    /// modified pixels of the atlas are only uploaded when the list is
+    /// executed. The atlas itself is not thread-safe: the quads should be
+    /// generated on the user thread, or the caller must otherwise ensure that
+    /// the atlas is not modified concurrently.
+    ///
+    void drawText(const core::Array<TextAtlasVertex>& quads);
 
     /// Clears the whole render area with the given color.
     ///
@@ -370,10 +582,95 @@ public:
     ///
     void flushWait();
 
+    /// Starts recording a secondary command list, which can be recorded on a
+    /// worker thread (see `setThreadCommandList()`) then executed in order
+    /// as part of the current command list (see
+    /// `executeSecondaryCommandList()`). This makes it possible to record
+    /// independent parts of a frame, such as the panels of a window, in
+    /// parallel.
+    ///
+    /// The recording starts with the current pipeline parameters, projection
+    /// matrix, and view matrix of the calling thread.
+    ///
+    /// Draws recorded in a secondary command list never use transient vertex
+    /// memory (see `allocateTransientVertices()`). The image of the glyph
+    /// atlas is created if it doesn't exist yet, so that text can be drawn
+    /// in the secondary command list (see `drawText()`).
+    ///
+    /// Using secondary command lists has no cost on the functions called
+    /// from the user thread while no secondary command list is bound to a
+    /// thread. Otherwise, each call looks up the list bound to the calling
+    /// thread, if any.
+    ///
+    SecondaryCommandList beginSecondaryCommandList();
+
+    /// Makes all the functions of this engine called from the calling thread
+    /// record into the given secondary command list, until this function is
+    /// called again. Passing `nullptr` finishes the recording of the
+    /// secondary command list bound to the calling thread, if any, and makes
+    /// the calling thread record into the current command list again.
+    ///
+    /// A secondary command list can only be bound to one thread at a time,
+    /// and a thread can only be bound to one secondary command list at a
+    /// time. While a secondary command list is bound to a thread, this thread
+    /// cannot call `beginFrame()`, `endFrame()`, `flush()`, or `flushWait()`.
+    ///
+    /// Note that while the functions recording commands can be called from
+    /// several threads at the same time, each with their own secondary command
+    /// list, the objects passed to these functions (resources, widgets, etc.)
+    /// are not made thread-safe by this: it is the responsibility of the
+    /// caller to ensure that they are not mutated concurrently.
+    ///
+    void setThreadCommandList(SecondaryCommandList* commandList);
+
+    /// Appends the commands recorded in the given secondary command list to
+    /// the command list of the calling thread, and resets `commandList` to an
+    /// empty state. The secondary command list must not be bound to any
+    /// thread.
+    ///
+    /// Since the pipeline state set by the secondary command list is unknown
+    /// to the calling thread, all the current pipeline parameters and
+    /// builtin constants are synced again before the next draw.
+    ///
+    void executeSecondaryCommandList(SecondaryCommandList& commandList);
+
     std::chrono::steady_clock::time_point engineStartTime() const {
         return engineStartTime_;
     }
 
+    /// Returns statistics about the commands queued between the last calls
+    /// to `beginFrame()` and `endFrame()`.
+    ///
+    const EngineFrameStats& lastFrameStats() const {
+        return lastFrameStats_;
+    }
+
+    /// Enables or disables profiling of this engine. When enabled, the time
+    /// spent by the user thread and the render thread on each command and
+    /// each frame is measured and can be accessed via `profiler()`.
+    ///
+    /// Profiling is disabled by default. Disabling profiling destroys the
+    /// current `profiler()` and its results.
+    ///
+    void setProfilingEnabled(bool enabled);
+
+    /// Returns whether profiling is enabled.
+    ///
+    /// \sa `setProfilingEnabled()`.
+    ///
+    bool isProfilingEnabled() const {
+        return profiler_ != nullptr;
+    }
+
+    /// Returns the profiler of this engine, or `nullptr` if profiling is
+    /// disabled.
+    ///
+    /// \sa `setProfilingEnabled()`.
+    ///
+    EngineProfiler* profiler() const {
+        return profiler_.get();
+    }
+
 protected:
     using StageConstantBufferArray = std::array<BufferPtr, maxConstantBuffersPerStage>;
     using StageImageViewArray = std::array<ImageViewPtr, maxImageViewsPerStage>;
@@ -453,7 +750,36 @@ protected:
     virtual void
     updateBufferData_(Buffer* buffer, const void* data, Int lengthInBytes) = 0;
 
-    virtual void draw_(GeometryView* view, UInt numPrimitives, UInt numInstances) = 0;
+    // Updates the given rectangle of the first layer and mip level of a 2D
+    // image. The data contains `height` rows of `width` pixels, without any
+    // padding between rows.
+    virtual void updateImageData_(
+        Image* image,
+        Int x,
+        Int y,
+        Int width,
+        Int height,
+        const void* data,
+        Int lengthInBytes) = 0;
+
+    // The transient vertex buffer is split into one region per frame in
+    // flight (plus the one being recorded). The data of a region is uploaded
+    // in one or more ranges during a frame, then the region is fenced at the
+    // end of the frame. The backend must make sure that the GPU is done with
+    // a fenced region before uploading new data into it.
+    virtual void uploadTransientVertexData_(
+        Buffer* buffer,
+        Int regionIndex,
+        Int offsetInBytes,
+        const void* data,
+        Int lengthInBytes) = 0;
+    virtual void fenceTransientVertexData_(Buffer* buffer, Int regionIndex) = 0;
+
+    virtual void draw_(
+        GeometryView* view,
+        UInt numPrimitives,
+        UInt numInstances,
+        UInt startVertex) = 0;
     virtual void clear_(const core::Color& color) = 0;
 
     virtual UInt64
@@ -477,16 +803,7 @@ protected:
     BufferPtr colorGradientsBuffer_; // 1D buffer
     ImageViewPtr colorGradientsBufferImageView_;
 
-    ProgramPtr glyphAtlasProgram_;
-    BufferPtr glyphAtlasBuffer_; // 1D layered
-    ImageViewPtr glyphAtlasBufferImageView_;
-    BufferPtr textBatch_;
-    struct GlyphAtlasGlyphInfo {
-        unsigned int texelIdx;
-        unsigned int width;
-        unsigned int height;
-    };
-    std::unordered_map<SizedGlyph*, GlyphAtlasGlyphInfo> allocatedGlyphs_;
+    ProgramPtr glyphAtlasProgram_; // (created by api-specific engine implementations)
 
     ProgramPtr iconAtlasProgram_;
     ImagePtr iconAtlasImage_; // 2D
@@ -495,31 +812,32 @@ protected:
 
     // -- QUEUING --
 
-    // XXX future possible optimization: don't allocate commands but serialize them in a single storage.
-
+    // Commands are queued in the recording context of the calling thread
+    // (see context_()).
+    //
     // cannot be flushed in out-of-order chunks unless userGarbagedResources is only sent with the last
-    std::list<CommandUPtr> pendingCommands_;
 
     template<typename TCommand, typename... Args>
     void queueCommand_(Args&&... args) {
-        if (!isMultithreadingEnabled()) {
-            TCommand(std::forward<Args>(args)...).execute(this);
+        RecordingContext_& context = context_();
+        if (!isMultithreadingEnabled() && !context.isSecondary) {
+            TCommand command(std::forward<Args>(args)...);
+            executeInline_(command.name(), [&] { command.execute(this); });
             return;
         }
-        pendingCommands_.emplace_back(new TCommand(std::forward<Args>(args)...));
+        context.commands.emplaceLast<TCommand>(std::forward<Args>(args)...);
     }
 
     template<typename Lambda>
     void queueLambdaCommand_(std::string_view name, Lambda&& lambda) {
-        if (!isMultithreadingEnabled()) {
-            lambda(this);
+        RecordingContext_& context = context_();
+        if (!isMultithreadingEnabled() && !context.isSecondary) {
+            executeInline_(name, [&] { lambda(this); });
             return;
         }
-        pendingCommands_.emplace_back(
-            // our deduction guide doesn't work on gcc 7.5.0
-            // new detail::LambdaCommand(name, std::forward<Lambda>(lambda)));
-            new detail::LambdaCommand<std::decay_t<Lambda>>(
-                name, std::forward<Lambda>(lambda)));
+        // our deduction guide doesn't work on gcc 7.5.0
+        context.commands.emplaceLast<detail::LambdaCommand<std::decay_t<Lambda>>>(
+            name, std::forward<Lambda>(lambda));
     }
 
     template<typename Data, typename Lambda, typename... Args>
@@ -527,13 +845,15 @@ protected:
         std::string_view name,
         Lambda&& lambda,
         Args&&... args) {
-        if (!isMultithreadingEnabled()) {
-            lambda(this, Data{std::forward<Args>(args)...});
+        RecordingContext_& context = context_();
+        if (!isMultithreadingEnabled() && !context.isSecondary) {
+            executeInline_(
+                name, [&] { lambda(this, Data{std::forward<Args>(args)...}); });
             return;
         }
-        pendingCommands_.emplace_back(
-            new detail::LambdaCommandWithParameters<Data, std::decay_t<Lambda>>(
-                name, std::forward<Lambda>(lambda), std::forward<Args>(args)...));
+        context.commands.emplaceLast<
+            detail::LambdaCommandWithParameters<Data, std::decay_t<Lambda>>>(
+            name, std::forward<Lambda>(lambda), std::forward<Args>(args)...);
     }
 
     static constexpr size_t toIndex_(ShaderStage stage) {
@@ -541,6 +861,8 @@ protected:
     }
 
 private:
+    friend SecondaryCommandList;
+
     void createBuiltinResources_();
 
     EngineCreateInfo createInfo_;
@@ -548,40 +870,266 @@ private:
     // -- pipeline state on the user thread --
 
     SwapChainPtr swapChain_;
-    core::Array<FramebufferPtr> framebufferStack_;
-
-    // pushable pipeline parameters
-    core::Array<Viewport> viewportStack_;
-    core::Array<ProgramPtr> programStack_;
-    core::Array<BlendStatePtr> blendStateStack_;
-    core::Array<geometry::Vec4f> blendConstantFactorStack_;
-    core::Array<RasterizerStatePtr> rasterizerStateStack_;
 
     using StageConstantBufferArrayStack = core::Array<StageConstantBufferArray>;
-    std::array<StageConstantBufferArrayStack, numShaderStages> constantBufferArrayStacks_;
-
     using StageImageViewArrayStack = core::Array<StageImageViewArray>;
-    std::array<StageImageViewArrayStack, numShaderStages> imageViewArrayStacks_;
-
     using StageSamplerStateArrayStack = core::Array<StageSamplerStateArray>;
-    std::array<StageSamplerStateArrayStack, numShaderStages> samplerStateArrayStacks_;
 
-    PipelineParameters dirtyPipelineParameters_ = PipelineParameter::None;
+    // Values of all the pipeline parameters, that is, the top of each of the
+    // pipeline parameter stacks.
+    struct PipelineState_ {
+        FramebufferPtr framebuffer;
+        Viewport viewport = Viewport(0, 0, 0, 0);
+        ProgramPtr program;
+        BlendStatePtr blendState;
+        geometry::Vec4f blendConstantFactor;
+        RasterizerStatePtr rasterizerState;
+        std::array<StageConstantBufferArray, numShaderStages> constantBufferArrays;
+        std::array<StageImageViewArray, numShaderStages> imageViewArrays;
+        std::array<StageSamplerStateArray, numShaderStages> samplerStateArrays;
+    };
+
+    // -- unordered draws --
+
+    struct DeferredDrawState_ {
+        PipelineState_ pipelineState;
+        geometry::Mat4f projectionMatrix;
+        geometry::Mat4f viewMatrix;
+        Int framebufferIndex; // incremented when the framebuffer changes
+    };
+
+    struct DeferredDraw_ {
+        GeometryViewPtr view;
+        UInt numIndices;
+        Int numInstances;
+        UInt startVertex;
+        Int stateIndex;
+    };
+
+    // -- recording contexts --
+
+    using BuiltinGeometryViewArray =
+        std::array<GeometryViewPtr, numBuiltinGeometryLayouts>;
+
+    struct RetainedGeometryBatch_ {
+        core::Array<UInt64> contentKey;
+        BuiltinGeometryLayout layout = BuiltinGeometryLayout::XYRGB;
+        GeometryViewPtr view;
+    };
+
+    // State of the recording of a command list. The primary context records
+    // the command lists submitted by the user thread, and each secondary
+    // context records a secondary command list on the thread it is bound to
+    // (see setThreadCommandList()).
+    //
+    struct RecordingContext_ {
+        // Creates a context whose stacks contain default values.
+        RecordingContext_();
+
+        // Releases all the resources referenced by this context.
+        void clear();
+
+        bool isSecondary = false;
+        std::atomic<bool> isBound = false;
+
+        // Commands recorded but not submitted yet. Commands are only recorded
+        // here if multithreading is enabled or if the context is secondary,
+        // otherwise they are executed immediately.
+        detail::CommandStream commands;
+
+        // Pushable pipeline parameters
+        core::Array<FramebufferPtr> framebufferStack;
+        core::Array<Viewport> viewportStack;
+        core::Array<ProgramPtr> programStack;
+        core::Array<BlendStatePtr> blendStateStack;
+        core::Array<geometry::Vec4f> blendConstantFactorStack;
+        core::Array<RasterizerStatePtr> rasterizerStateStack;
+        std::array<StageConstantBufferArrayStack, numShaderStages>
+            constantBufferArrayStacks;
+        std::array<StageImageViewArrayStack, numShaderStages> imageViewArrayStacks;
+        std::array<StageSamplerStateArrayStack, numShaderStages> samplerStateArrayStacks;
+        PipelineParameters dirtyPipelineParameters = PipelineParameter::None;
+
+        // Shadow copy of the pipeline state last queued for the render
+        // thread, used to skip the state changes that wouldn't change
+        // anything. Only the parameters in knownAppliedParameters are known
+        // to be applied: others are queued at the next sync even if their
+        // value is unchanged, which is required after external code may have
+        // modified the backend state.
+        PipelineState_ appliedPipelineState;
+        PipelineParameters knownAppliedParameters = PipelineParameter::None;
+
+        // Builtin constants. The matrices of the last builtin constants
+        // uploaded during this frame are kept so that setting back the same
+        // transforms (e.g., when popping the view matrix of a widget) doesn't
+        // cause a new upload. This only skips uploads identical to the last
+        // one: draws that are not batched still upload the constants each
+        // time their view matrix differs from the last uploaded one.
+        core::Array<geometry::Mat4f> projectionMatrixStack;
+        core::Array<geometry::Mat4f> viewMatrixStack;
+        bool dirtyBuiltinConstantBuffer = false;
+        bool hasUploadedBuiltinConstants = false;
+        geometry::Mat4f uploadedProjectionMatrix;
+        geometry::Mat4f uploadedViewMatrix;
+
+        EngineFrameStats frameStats;
+
+        // Unordered draws
+        bool areDrawsUnordered = false;
+        core::Array<DeferredDrawState_> deferredDrawStates;
+        core::Array<DeferredDraw_> deferredDraws;
+
+        // Geometry batching. The batch is drawn with the pipeline state and
+        // projection matrix that were synced when it was started, and an
+        // identity view matrix.
+        // The text batch is drawn after the triangles of the geometry batch,
+        // with the same pipeline state except for the program, image views,
+        // and samplers. Both batches are started and flushed together.
+        GeometryBatch geometryBatch;
+        TextBatch textBatch;
+        TextBatch flushedTextBatch; // (swapped with textBatch when flushed)
+        geometry::Mat4f geometryBatchProjectionMatrix;
+        BuiltinGeometryViewArray geometryBatchViews;
+        BuiltinGeometryViewArray geometryBatchOverflowViews;
+        GeometryViewPtr textQuadsOverflowView;
+
+        // Vertex buffers of the batches with a content key, indexed by their
+        // order in the frame, and kept for the next frames. A batch whose
+        // content key is the same as the batch at the same index in the
+        // previous frame is drawn from the same buffer without re-uploading.
+        core::Array<RetainedGeometryBatch_> retainedGeometryBatches;
+        Int numRetainedGeometryBatches = 0; // in the current frame
+    };
+
+    RecordingContext_ primaryContext_;
+
+    // Secondary contexts whose command lists have been executed, kept for
+    // reuse. Only accessed by the user thread.
+    core::Array<std::unique_ptr<RecordingContext_>> secondaryContextPool_;
+
+    // Number of secondary command lists currently bound to a thread. While it
+    // is zero, which is always the case unless secondary command lists are
+    // used, the calling thread is known to record into the primary context
+    // without looking up its thread-local binding.
+    std::atomic<Int> numBoundSecondaryContexts_ = 0;
+
+    // Returns the context bound to the calling thread, which is the primary
+    // context unless a secondary command list is bound to the thread.
+    RecordingContext_& context_() {
+        if (numBoundSecondaryContexts_.load(std::memory_order_relaxed) == 0) {
+            return primaryContext_;
+        }
+        return threadContext_();
+    }
+    const RecordingContext_& context_() const {
+        return const_cast<Engine*>(this)->context_();
+    }
+    RecordingContext_& threadContext_();
+
+    PipelineState_ currentPipelineState_(const RecordingContext_& context) const;
+    void restorePipelineState_(RecordingContext_& context, const PipelineState_& state);
+
+    // Returns whether a secondary command list is bound to the calling
+    // thread, in which case a warning is issued since the given function can
+    // only be called on the primary context.
+    bool isSecondaryContextBound_(std::string_view functionName) const;
+
+    bool shouldSyncParameter_(PipelineParameter parameter, bool isApplied);
 
     // called in user thread
     void syncState_();
+    void syncStateImpl_();
     void syncStageConstantBuffers_(ShaderStage shaderStage);
     void syncStageImageViews_(ShaderStage shaderStage);
     void syncStageSamplers_(ShaderStage shaderStage);
 
-    // -- builtin constants + dirty bool --
+    // -- builtin constants --
 
     std::chrono::steady_clock::time_point engineStartTime_;
     std::chrono::steady_clock::time_point frameStartTime_;
     BufferPtr builtinConstantsBuffer_;
-    core::Array<geometry::Mat4f> projectionMatrixStack_;
-    core::Array<geometry::Mat4f> viewMatrixStack_;
-    bool dirtyBuiltinConstantBuffer_ = false;
+
+    // -- frame stats --
+
+    EngineFrameStats lastFrameStats_;
+
+    // -- profiling --
+
+    // Only changed while the render thread is idle, see setProfilingEnabled().
+    std::unique_ptr<EngineProfiler> profiler_;
+
+    // Executes the given function on the user thread, as the command of the
+    // given name. This is how commands are executed when multithreading is
+    // disabled.
+    template<typename Function>
+    void executeInline_(std::string_view name, Function&& function) {
+        if (!profiler_) {
+            function();
+            return;
+        }
+        double startTime = profiler_->now_();
+        function();
+        profiler_->addInlineCommand_(name, startTime, profiler_->now_() - startTime);
+    }
+
+    // -- unordered draws --
+
+    void deferDraw_(
+        const GeometryViewPtr& view,
+        UInt numIndices,
+        Int numInstances,
+        UInt startVertex);
+
+    // -- transient vertex memory --
+
+    // CPU copy of the transient vertex buffer, written directly by the user
+    // thread and read by the render thread when uploading. Only the primary
+    // context uses transient vertex memory.
+    BufferPtr transientVertexBuffer_;
+    core::Array<char> transientVertexData_;
+    Int transientVertexRegionIndex_ = 0;
+    Int transientVertexAllocatedEnd_ = 0;
+    Int transientVertexUploadedEnd_ = 0;
+
+    Int numTransientVertexRegions_() const {
+        return maxFramesInFlight() + 1;
+    }
+
+    void createTransientVertexBuffer_();
+    void flushTransientVertexData_();
+    void endTransientVertexFrame_();
+
+    // -- text --
+
+    // The atlas image is created on the first drawText() from the current
+    // atlas pixels, then only the dirty rect of the atlas is uploaded.
+    GlyphAtlas glyphAtlas_;
+    ImagePtr glyphAtlasImage_;
+    ImageViewPtr glyphAtlasImageView_;
+    SamplerStatePtr glyphAtlasSamplerState_;
+    GeometryViewPtr textQuadsView_; // transient (see also textQuadsOverflowView)
+
+    void createGlyphAtlasResources_();
+    void updateGlyphAtlasImage_();
+    GeometryViewPtr
+    copyTextQuads_(const core::Array<TextAtlasVertex>& quads, Int& startInstance);
+    void drawText_(const GeometryViewPtr& view, Int numQuads, Int startInstance);
+    void flushTextBatch_();
+
+    // -- geometry batching --
+
+    void prepareGeometryBatch_(
+        BuiltinGeometryLayout layout,
+        const core::FloatArray& vertices);
+    void prepareTextBatch_();
+    void startGeometryBatch_();
+    void flushGeometryBatch_();
+
+    // -- helpers --
+
+    void updateBuiltinConstants_(const geometry::Mat4f& viewMatrix);
+    void
+    queueDraw_(GeometryView* view, UInt numIndices, Int numInstances, UInt startVertex);
 
     // -- builtin batching early impl --
 
@@ -591,23 +1139,20 @@ private:
     // -- render thread + sync --
 
     std::thread renderThread_;
-    std::mutex mutex_;
-    std::condition_variable wakeRenderThreadConditionVariable_;
-    std::condition_variable renderThreadEventConditionVariable_;
-    Int lastExecutedCommandListId_ = 0;
-    Int lastSubmittedCommandListId_ = 0;
+    std::mutex mutex_; // protects presentCallback_
     bool isThreadRunning_ = false;
     bool stopRequested_ = false;
     std::function<void(UInt64 /*timestamp*/)> presentCallback_;
 
-    struct CommandList {
-        CommandList(std::list<CommandUPtr>&& commands)
-            : commands(std::move(commands)) {
-        }
+    // Submitted command lists. Executed lists are given back to the user
+    // thread, so that their memory can be reused for the next frames.
+    static constexpr Int commandQueueCapacity_ = 16;
+    detail::CommandQueue commandQueue_;
 
-        std::list<CommandUPtr> commands;
-    };
-    core::Array<CommandList> commandQueue_;
+    // IDs of the last command list of each frame in flight, indexed by
+    // frame number modulo maxFramesInFlight().
+    core::Array<Int> inFlightFrameCommandListIds_;
+    Int numEndedFrames_ = 0;
 
     void renderThreadProc_();
     void startRenderThread_();
@@ -620,6 +1165,14 @@ private:
     // returns false if translation was cancelled by a stop request.
     void waitCommandListTranslationFinished_(Int commandListId = 0);
 
+    // Waits until the given command list has been executed, measuring the
+    // wait if profiling is enabled.
+    void waitExecuted_(Int commandListId);
+
+    // Waits until there are less than maxFramesInFlight() frames in flight,
+    // then registers the frame whose last command list is the given one.
+    void waitFramesInFlight_(Int frameCommandListId);
+
     // -- helpers --
 
     void sanitize_(SwapChainCreateInfo& createInfo);
@@ -655,40 +1208,87 @@ private:
     }
 };
 
+/// \class vgc::graphics::SecondaryCommandList
+/// \brief Commands recorded separately from the current command list.
+///
+/// A secondary command list is created by `Engine::beginSecondaryCommandList()`
+/// and records the commands issued by the thread it is bound to via
+/// `Engine::setThreadCommandList()`. Once its recording is finished, it can be
+/// executed as part of the current command list via
+/// `Engine::executeSecondaryCommandList()`.
+///
+/// Destroying a secondary command list without executing it discards its
+/// commands.
+///
+class VGC_GRAPHICS_API SecondaryCommandList {
+public:
+    /// Creates an empty secondary command list.
+    ///
+    SecondaryCommandList();
+
+    SecondaryCommandList(SecondaryCommandList&& other) noexcept;
+    SecondaryCommandList& operator=(SecondaryCommandList&& other) noexcept;
+    ~SecondaryCommandList();
+
+    SecondaryCommandList(const SecondaryCommandList&) = delete;
+    SecondaryCommandList& operator=(const SecondaryCommandList&) = delete;
+
+    /// Returns whether this secondary command list is empty, that is, whether
+    /// it was not created by `Engine::beginSecondaryCommandList()` or has
+    /// already been executed.
+    ///
+    bool isEmpty() const {
+        return context_ == nullptr;
+    }
+
+private:
+    friend Engine;
+
+    std::unique_ptr<Engine::RecordingContext_> context_;
+
+    SecondaryCommandList(std::unique_ptr<Engine::RecordingContext_> context);
+};
+
 inline const geometry::Mat4f& Engine::projectionMatrix() const {
-    return projectionMatrixStack_.last();
+    return context_().projectionMatrixStack.last();
 }
 
 inline void Engine::setProjectionMatrix(const geometry::Mat4f& projectionMatrix) {
-    projectionMatrixStack_.last() = projectionMatrix;
-    dirtyBuiltinConstantBuffer_ = true;
+    RecordingContext_& context = context_();
+    context.projectionMatrixStack.last() = projectionMatrix;
+    context.dirtyBuiltinConstantBuffer = true;
 }
 
 inline void Engine::pushProjectionMatrix() {
-    projectionMatrixStack_.emplaceLast(projectionMatrixStack_.last());
+    RecordingContext_& context = context_();
+    context.projectionMatrixStack.emplaceLast(context.projectionMatrixStack.last());
 }
 
 inline void Engine::popProjectionMatrix() {
-    projectionMatrixStack_.removeLast();
-    dirtyBuiltinConstantBuffer_ = true;
+    RecordingContext_& context = context_();
+    context.projectionMatrixStack.removeLast();
+    context.dirtyBuiltinConstantBuffer = true;
 }
 
 inline const geometry::Mat4f& Engine::viewMatrix() const {
-    return viewMatrixStack_.last();
+    return context_().viewMatrixStack.last();
 }
 
 inline void Engine::setViewMatrix(const geometry::Mat4f& viewMatrix) {
-    viewMatrixStack_.last() = viewMatrix;
-    dirtyBuiltinConstantBuffer_ = true;
+    RecordingContext_& context = context_();
+    context.viewMatrixStack.last() = viewMatrix;
+    context.dirtyBuiltinConstantBuffer = true;
 }
 
 inline void Engine::pushViewMatrix() {
-    viewMatrixStack_.emplaceLast(viewMatrixStack_.last());
+    RecordingContext_& context = context_();
+    context.viewMatrixStack.emplaceLast(context.viewMatrixStack.last());
 }
 
 inline void Engine::popViewMatrix() {
-    viewMatrixStack_.removeLast();
-    dirtyBuiltinConstantBuffer_ = true;
+    RecordingContext_& context = context_();
+    context.viewMatrixStack.removeLast();
+    context.dirtyBuiltinConstantBuffer = true;
 }
 
 //inline FramebufferPtr Engine::defaultFramebuffer() {
@@ -780,6 +1380,10 @@ Engine::updateVertexBufferData(const GeometryViewPtr& geometry, core::Array<T> d
 }
 
 inline Int Engine::flush() {
+    if (isSecondaryContextBound_("flush")) {
+        return 0;
+    }
+    flushGeometryBatch_();
     if (isMultithreadingEnabled()) {
         return static_cast<Int>(submitPendingCommandList_());
     }
@@ -787,6 +1391,10 @@ inline Int Engine::flush() {
 }
 
 inline void Engine::flushWait() {
+    if (isSecondaryContextBound_("flushWait")) {
+        return;
+    }
+    flushGeometryBatch_();
     if (isMultithreadingEnabled()) {
         UInt id = submitPendingCommandList_();
         waitCommandListTranslationFinished_(id);
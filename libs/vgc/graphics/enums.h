@@ -382,11 +382,11 @@ inline constexpr UInt8 numShaderStages = static_cast<UInt8>(ShaderStage::Max_) +
 enum class BuiltinProgram : Int8 {
     NotBuiltin = -1,
     Simple,
+    GlyphAtlas,
     // XXX publicize ?
-    //GlyphAtlas,
     //IconsAtlas,
     //RoundedRectangle,
-    Max_ = Simple,
+    Max_ = GlyphAtlas,
 };
 inline constexpr UInt8 numBuiltinPrograms = static_cast<UInt8>(BuiltinProgram::Max_) + 1;
 
@@ -395,7 +395,10 @@ enum class BuiltinGeometryLayout : Int8 {
     XY = 0,
     XYRGB = 1,
     XYZ = 2,
-    Max_ = XYZ,
+    // One TextAtlasVertex per instance. The startVertex of a draw is then the
+    // index of the first instance.
+    TextAtlasQuad = 3,
+    Max_ = TextAtlasQuad,
 };
 inline constexpr UInt8 numBuiltinGeometryLayouts = static_cast<UInt8>(BuiltinGeometryLayout::Max_) + 1;
 
@@ -16,6 +16,7 @@
 
 #include <vgc/graphics/font.h>
 
+#include <algorithm> // std::copy
 #include <mutex>
 
 #include <ft2build.h>
@@ -25,7 +26,10 @@
 #include <hb-ft.h>
 #include <hb.h>
 
+#include <vgc/core/exceptions.h>
+#include <vgc/core/format.h>
 #include <vgc/core/paths.h>
+#include <vgc/geometry/points.h>
 #include <vgc/graphics/exceptions.h>
 #include <vgc/graphics/logcategories.h>
 
@@ -47,6 +51,32 @@ const char* errorMsg(FT_Error err) {
 
 // clang-format on
 
+// Returns the FreeType load flags to use for loading glyphs of a SizedFont
+// with the given hinting.
+//
+// See https://freetype.org/freetype2/docs/reference/ft2-base_interface.html#ft_load_xxx
+//
+FT_Int32 loadFlags(FontHinting hinting) {
+    FT_Int32 flags = FT_LOAD_NO_BITMAP;
+    switch (hinting) {
+    case FontHinting::None:
+        flags |= FT_LOAD_NO_HINTING;
+        break;
+    case FontHinting::Native:
+        flags |= FT_LOAD_NO_AUTOHINT;
+        break;
+    case FontHinting::AutoLight:
+        flags |= FT_LOAD_FORCE_AUTOHINT;
+        flags |= FT_LOAD_TARGET_LIGHT;
+        break;
+    case FontHinting::AutoNormal:
+        flags |= FT_LOAD_FORCE_AUTOHINT;
+        flags |= FT_LOAD_TARGET_NORMAL;
+        break;
+    }
+    return flags;
+}
+
 } // namespace
 
 namespace detail {
@@ -392,11 +422,18 @@ public:
         FT_Outline_Funcs f{&moveTo, &lineTo, &conicTo, &cubicTo, shift, delta};
         FT_Outline_Decompose(&slot->outline, &f, static_cast<void*>(&outline));
         closeLastCurveIfOpen(outline);
-        outline.fill(triangles, geometry::Curves2dSampleParams::semiAdaptive(1.0));
-        for (const geometry::Vec2f& point :
-             geometry::Vec2fConstSpan(triangles.data(), triangles.length() / 2, 2)) {
-            boundingBox.uniteWith(point);
-        }
+        outline.fill(
+            triangles,
+            geometry::Curves2dSampleParams::errorBounded(0.1),
+            geometry::WindingRule::NonZero,
+            geometry::FillMethod::PolygonTriangulator);
+        boundingBox = geometry::boundingRect(points(), triangles.length() / 2);
+    }
+
+    // Returns the vertices of the triangles as an array of Vec2f.
+    //
+    const geometry::Vec2f* points() const {
+        return reinterpret_cast<const geometry::Vec2f*>(triangles.data());
     }
 };
 
@@ -619,26 +656,9 @@ SizedGlyph* SizedFont::getSizedGlyphFromIndex(Int glyphIndex) {
     // If no existing SizedGlyph*, create it
     if (!sizedGlyph) {
         // Load glyph
-        // See https://freetype.org/freetype2/docs/reference/ft2-base_interface.html#ft_load_xxx
         FT_Face face = impl_->ftFace;
         FT_UInt index = core::int_cast<FT_UInt>(glyphIndex);
-        FT_Int32 flags = FT_LOAD_NO_BITMAP;
-        switch (impl_->params.hinting()) {
-        case FontHinting::None:
-            flags |= FT_LOAD_NO_HINTING;
-            break;
-        case FontHinting::Native:
-            flags |= FT_LOAD_NO_AUTOHINT;
-            break;
-        case FontHinting::AutoLight:
-            flags |= FT_LOAD_FORCE_AUTOHINT;
-            flags |= FT_LOAD_TARGET_LIGHT;
-            break;
-        case FontHinting::AutoNormal:
-            flags |= FT_LOAD_FORCE_AUTOHINT;
-            flags |= FT_LOAD_TARGET_NORMAL;
-            break;
-        }
+        FT_Int32 flags = loadFlags(impl_->params.hinting());
         FT_Error error = FT_Load_Glyph(face, index, flags);
         if (error) {
             throw FontError(errorMsg(error));
@@ -668,6 +688,32 @@ void SizedFont::onDestroyed() {
     impl_.reset();
 }
 
+GlyphBitmap::GlyphBitmap(
+    Int width,
+    Int height,
+    Int left,
+    Int top,
+    core::Array<UInt8> pixels)
+
+    : width_(width)
+    , height_(height)
+    , left_(left)
+    , top_(top)
+    , pixels_(std::move(pixels)) {
+
+    if (width < 0 || height < 0) {
+        throw core::LogicError(core::format(
+            "Cannot create a GlyphBitmap of negative size ({}, {}).", width, height));
+    }
+    if (pixels_.length() != width * height) {
+        throw core::LogicError(core::format(
+            "Cannot create a GlyphBitmap of size ({}, {}) from {} pixels.",
+            width,
+            height,
+            pixels_.length()));
+    }
+}
+
 SizedGlyph::SizedGlyph(SizedFont* sizedFont)
     : Object()
     , impl_() {
@@ -712,17 +758,9 @@ void SizedGlyph::fill(core::FloatArray& data, const geometry::Mat3f& transform)
 
     data.resizeNoInit(oldLength + 2 * numVertices);
 
-    const float* in = impl_->triangles.begin();
-    float* out = data.begin() + oldLength;
-    float* end = data.end();
-
-    while (out != end) {
-        float x = *in++;
-        float y = *in++;
-        geometry::Vec2f v = transform.transformPoint({x, y});
-        *out++ = v[0];
-        *out++ = v[1];
-    }
+    const geometry::Vec2f* in = impl_->points();
+    geometry::Vec2f* out = reinterpret_cast<geometry::Vec2f*>(data.begin() + oldLength);
+    geometry::transformPoints(transform, in, out, numVertices);
 }
 
 void SizedGlyph::fill(core::FloatArray& data, const geometry::Vec2f& translation) const {
@@ -769,6 +807,54 @@ void SizedGlyph::fillYMirrored( //
     }
 }
 
+GlyphBitmap SizedGlyph::rasterize() const {
+
+    // Prevent other threads from using the FT_Face glyph slot, which is
+    // shared by all the glyphs of the SizedFont.
+    detail::SizedFontImpl* fontImpl = sizedFont()->impl_.get();
+    const std::lock_guard<std::mutex> lock(fontImpl->glyphsMutex);
+
+    // Reload the glyph in the slot, since the slot may now contain another
+    // glyph, then render it.
+    FT_Face face = fontImpl->ftFace;
+    FT_UInt index = core::int_cast<FT_UInt>(this->index());
+    FT_Int32 flags = loadFlags(fontImpl->params.hinting());
+    FT_Error error = FT_Load_Glyph(face, index, flags);
+    if (error) {
+        throw FontError(errorMsg(error));
+    }
+    FT_GlyphSlot slot = face->glyph;
+    error = FT_Render_Glyph(slot, FT_RENDER_MODE_NORMAL);
+    if (error) {
+        throw FontError(errorMsg(error));
+    }
+    const FT_Bitmap& bitmap = slot->bitmap;
+    if (bitmap.pixel_mode != FT_PIXEL_MODE_GRAY) {
+        throw FontError("Unsupported pixel mode of rendered glyph.");
+    }
+
+    // Copy pixels row by row, starting with the top row. Note that the pitch
+    // is negative when rows are stored bottom to top in FreeType's buffer.
+    Int width = core::int_cast<Int>(bitmap.width);
+    Int height = core::int_cast<Int>(bitmap.rows);
+    Int pitch = core::int_cast<Int>(bitmap.pitch);
+    core::Array<UInt8> pixels(width * height);
+    const UInt8* topRow = bitmap.buffer;
+    if (pitch < 0) {
+        topRow -= pitch * (height - 1);
+    }
+    for (Int i = 0; i < height; ++i) {
+        const UInt8* row = topRow + i * pitch;
+        std::copy(row, row + width, pixels.begin() + i * width);
+    }
+
+    // Note: bitmap_top is the distance from the baseline to the top row, with
+    // the Y-axis pointing up.
+    Int left = core::int_cast<Int>(slot->bitmap_left);
+    Int top = -core::int_cast<Int>(slot->bitmap_top);
+    return GlyphBitmap(width, height, left, top, std::move(pixels));
+}
+
 void SizedGlyph::onDestroyed() {
     impl_.reset();
 }
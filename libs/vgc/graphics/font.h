@@ -519,6 +519,82 @@ private:
     friend class Font;
     friend class detail::FontLibraryImpl;
     friend class detail::ShapedTextImpl;
+    friend class SizedGlyph;
+};
+
+/// \class vgc::graphics::GlyphBitmap
+/// \brief An 8-bit coverage bitmap of a rasterized `SizedGlyph`.
+///
+/// Pixels are stored row by row, starting with the top row, with one byte per
+/// pixel representing the coverage of the pixel by the glyph (0 means
+/// transparent, 255 means fully covered).
+///
+/// The position of the bitmap relative to the glyph origin is given by
+/// `left()` and `top()`, following the VGC convention of having the Y-axis
+/// pointing down. This means that `top()` is typically negative, since most
+/// glyphs are above the baseline.
+///
+/// \sa `SizedGlyph::rasterize()`.
+///
+class VGC_GRAPHICS_API GlyphBitmap {
+public:
+    /// Creates an empty `GlyphBitmap`.
+    ///
+    GlyphBitmap() = default;
+
+    /// Creates a `GlyphBitmap` of the given size and position, with the given
+    /// `pixels`.
+    ///
+    /// Throws `core::LogicError` if `width` or `height` is negative, or if
+    /// `pixels` doesn't contain exactly `width * height` elements.
+    ///
+    GlyphBitmap(Int width, Int height, Int left, Int top, core::Array<UInt8> pixels);
+
+    /// Returns the width of this bitmap, in pixels.
+    ///
+    Int width() const {
+        return width_;
+    }
+
+    /// Returns the height of this bitmap, in pixels.
+    ///
+    Int height() const {
+        return height_;
+    }
+
+    /// Returns the X coordinate of the left side of this bitmap, relative to
+    /// the glyph origin.
+    ///
+    Int left() const {
+        return left_;
+    }
+
+    /// Returns the Y coordinate of the top side of this bitmap, relative to
+    /// the glyph origin, with the Y-axis pointing down.
+    ///
+    Int top() const {
+        return top_;
+    }
+
+    /// Returns whether this bitmap has no pixels. This is for example the
+    /// case for the bitmap of a space character.
+    ///
+    bool isEmpty() const {
+        return width_ == 0 || height_ == 0;
+    }
+
+    /// Returns the pixels of this bitmap.
+    ///
+    const core::Array<UInt8>& pixels() const {
+        return pixels_;
+    }
+
+private:
+    Int width_ = 0;
+    Int height_ = 0;
+    Int left_ = 0;
+    Int top_ = 0;
+    core::Array<UInt8> pixels_;
 };
 
 /// \class vgc::graphics::SizedGlyph
@@ -605,6 +681,17 @@ public:
     ///
     void fillYMirrored(core::FloatArray& data, const geometry::Vec2f& translation) const;
 
+    /// Rasterizes this glyph into an 8-bit coverage bitmap, using the same
+    /// size and hinting parameters as its `sizedFont()`.
+    ///
+    /// The glyph is rasterized as if its origin was at integer pixel
+    /// coordinates, so the returned bitmap is only pixel-exact when drawn at
+    /// integer positions.
+    ///
+    /// Throws `FontError` if FreeType fails to load or render the glyph.
+    ///
+    GlyphBitmap rasterize() const;
+
 protected:
     /// \reimp
     void onDestroyed() override;
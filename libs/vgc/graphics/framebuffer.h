@@ -52,6 +52,17 @@ public:
         return height_;
     }
 
+    friend bool operator==(const Viewport& v1, const Viewport& v2) {
+        return v1.x_ == v2.x_
+            && v1.y_ == v2.y_
+            && v1.width_ == v2.width_
+            && v1.height_ == v2.height_;
+    }
+
+    friend bool operator!=(const Viewport& v1, const Viewport& v2) {
+        return !(v1 == v2);
+    }
+
 private:
     Int x_;
     Int y_;
@@ -167,9 +167,10 @@ protected:
             Int layoutIndex = core::toUnderlying(builtinLayout);
             if (info_.strides_[0] == 0) {
                 info_.strides_[0] = std::array{
-                    2 * 4, // XY
-                    5 * 4, // XYRGB
-                    3 * 4, // XYZ
+                    2 * 4,  // XY
+                    5 * 4,  // XYRGB
+                    3 * 4,  // XYZ
+                    11 * 4, // TextAtlasQuad
                 }[layoutIndex];
             }
         }
@@ -184,6 +185,14 @@ public:
         return info_.builtinGeometryLayout();
     }
 
+    /// Returns whether the vertex buffers of this view contain per-instance
+    /// data rather than per-vertex data, in which case the `startVertex` given
+    /// to `Engine::draw()` is the index of the first instance.
+    ///
+    bool hasPerInstanceVertexData() const {
+        return info_.builtinGeometryLayout() == BuiltinGeometryLayout::TextAtlasQuad;
+    }
+
     const BufferPtr& indexBuffer() const {
         return info_.indexBuffer();
     }
@@ -214,9 +223,10 @@ public:
             Int layoutIndex = core::toUnderlying(builtinLayout);
             if (i == 0) {
                 return std::array{
-                    2 * 4, // XY
-                    5 * 4, // XYRGB
-                    3 * 4, // XYZ
+                    2 * 4,  // XY
+                    5 * 4,  // XYRGB
+                    3 * 4,  // XYZ
+                    11 * 4, // TextAtlasQuad
                 }[layoutIndex];
             }
             return 0;
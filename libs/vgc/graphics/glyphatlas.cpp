@@ -0,0 +1,324 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <vgc/graphics/glyphatlas.h>
+
+#include <algorithm> // std::copy, std::fill, std::max, std::min
+#include <limits>
+
+#include <vgc/core/exceptions.h>
+#include <vgc/core/format.h>
+
+namespace vgc::graphics {
+
+namespace detail {
+
+SkylinePacker::SkylinePacker(Int width, Int height)
+    : width_(width)
+    , height_(height) {
+
+    clear();
+}
+
+void SkylinePacker::clear() {
+    skyline_.clear();
+    skyline_.append({0, 0, width_});
+}
+
+bool SkylinePacker::insert(Int width, Int height, Int& x, Int& y) {
+
+    if (width <= 0 || height <= 0 || width > width_ || height > height_) {
+        return false;
+    }
+
+    // Find the position minimizing the bottom side of the rectangle. Using a
+    // strict comparison means that ties are broken by the leftmost position.
+    Int bestIndex = -1;
+    Int bestY = 0;
+    Int bestBottom = (std::numeric_limits<Int>::max)();
+    for (Int i = 0; i < skyline_.length(); ++i) {
+        Int candidateY = 0;
+        if (fits_(i, width, height, candidateY) && candidateY + height < bestBottom) {
+            bestIndex = i;
+            bestY = candidateY;
+            bestBottom = candidateY + height;
+        }
+    }
+    if (bestIndex == -1) {
+        return false;
+    }
+    x = skyline_[bestIndex].x;
+    y = bestY;
+
+    // Insert the top of the new rectangle as a new segment, then shrink or
+    // remove the segments that are now below it.
+    skyline_.insert(bestIndex, {x, bestBottom, width});
+    Int xEnd = x + width;
+    Int i = bestIndex + 1;
+    while (i < skyline_.length()) {
+        Segment& s = skyline_[i];
+        if (s.x >= xEnd) {
+            break;
+        }
+        Int overlap = xEnd - s.x;
+        if (overlap < s.width) {
+            s.x += overlap;
+            s.width -= overlap;
+            break;
+        }
+        skyline_.removeAt(i);
+    }
+
+    // Merge adjacent segments of equal height
+    for (Int j = skyline_.length() - 1; j > 0; --j) {
+        Segment& s1 = skyline_[j - 1];
+        const Segment& s2 = skyline_[j];
+        if (s1.y == s2.y) {
+            s1.width += s2.width;
+            skyline_.removeAt(j);
+        }
+    }
+
+    return true;
+}
+
+// Returns whether a rectangle of the given size can be placed with its left
+// side at the beginning of the given segment. If true, `y` is set to the
+// lowest possible top side of the rectangle at this position.
+//
+bool SkylinePacker::fits_(Int index, Int width, Int height, Int& y) const {
+    Int x = skyline_[index].x;
+    if (x + width > width_) {
+        return false;
+    }
+    Int remainingWidth = width;
+    Int maxY = 0;
+    Int i = index;
+    while (remainingWidth > 0) {
+        const Segment& s = skyline_[i];
+        maxY = (std::max)(maxY, s.y);
+        if (maxY + height > height_) {
+            return false;
+        }
+        remainingWidth -= s.width;
+        ++i;
+    }
+    y = maxY;
+    return true;
+}
+
+} // namespace detail
+
+namespace {
+
+// Number of empty texels kept on the right and bottom of each glyph bitmap
+// in the atlas, so that bilinear filtering never samples other glyphs.
+//
+constexpr Int glyphPadding = 1;
+
+} // namespace
+
+GlyphAtlas::GlyphAtlas(Int width, Int height, Int plotSize)
+    : width_(width)
+    , height_(height)
+    , plotSize_(plotSize) {
+
+    if (plotSize <= 0 || width <= 0 || height <= 0 //
+        || width % plotSize != 0 || height % plotSize != 0) {
+
+        throw core::LogicError(core::format(
+            "Cannot create a GlyphAtlas of size ({}, {}) with plots of size {}.",
+            width,
+            height,
+            plotSize));
+    }
+    pixels_ = core::Array<UInt8>(width * height);
+    for (Int y = 0; y < height; y += plotSize) {
+        for (Int x = 0; x < width; x += plotSize) {
+            plots_.emplaceLast(x, y, plotSize);
+        }
+    }
+}
+
+const GlyphAtlasEntry* GlyphAtlas::find(SizedGlyph* glyph) {
+    auto it = entries_.find(glyph);
+    if (it == entries_.end()) {
+        return nullptr;
+    }
+    const GlyphAtlasEntry& entry = it->second;
+    if (entry.plotIndex_ != -1) {
+        plots_[entry.plotIndex_].lastUsedFrame = frame_;
+    }
+    return &entry;
+}
+
+const GlyphAtlasEntry* GlyphAtlas::insert(SizedGlyph* glyph, const GlyphBitmap& bitmap) {
+
+    if (const GlyphAtlasEntry* entry = find(glyph)) {
+        return entry;
+    }
+
+    GlyphAtlasEntry entry;
+    entry.left_ = bitmap.left();
+    entry.top_ = bitmap.top();
+
+    // Empty bitmaps (e.g., spaces) are cached without using any room in the
+    // atlas, so that they are not rasterized again.
+    if (!bitmap.isEmpty()) {
+        Int w = bitmap.width();
+        Int h = bitmap.height();
+        Int plotIndex = -1;
+        Int x = 0;
+        Int y = 0;
+        if (!allocate_(w + glyphPadding, h + glyphPadding, plotIndex, x, y)) {
+            return nullptr;
+        }
+        const UInt8* src = bitmap.pixels().data();
+        for (Int i = 0; i < h; ++i) {
+            const UInt8* row = src + i * w;
+            std::copy(row, row + w, pixels_.begin() + (y + i) * width_ + x);
+        }
+        addDirtyRect_(x, y, w, h);
+
+        Plot& plot = plots_[plotIndex];
+        plot.lastUsedFrame = frame_;
+        plot.glyphs.append(glyph);
+
+        float sx = 1.0f / static_cast<float>(width_);
+        float sy = 1.0f / static_cast<float>(height_);
+        entry.x_ = x;
+        entry.y_ = y;
+        entry.width_ = w;
+        entry.height_ = h;
+        entry.plotIndex_ = plotIndex;
+        entry.texCoords_ = geometry::Rect2f(
+            static_cast<float>(x) * sx,
+            static_cast<float>(y) * sy,
+            static_cast<float>(x + w) * sx,
+            static_cast<float>(y + h) * sy);
+    }
+
+    return &(entries_[glyph] = entry);
+}
+
+const GlyphAtlasEntry* GlyphAtlas::getOrInsert(SizedGlyph* glyph) {
+    if (const GlyphAtlasEntry* entry = find(glyph)) {
+        return entry;
+    }
+    return insert(glyph, glyph->rasterize());
+}
+
+void GlyphAtlas::clear() {
+    for (Plot& plot : plots_) {
+        plot.packer.clear();
+        plot.lastUsedFrame = -1;
+        plot.glyphs.clear();
+    }
+    entries_.clear();
+    std::fill(pixels_.begin(), pixels_.end(), UInt8(0));
+    addDirtyRect_(0, 0, width_, height_);
+    ++numEvictions_;
+}
+
+geometry::Rect2f GlyphAtlas::dirtyRect() const {
+    if (!isDirty()) {
+        return geometry::Rect2f::empty;
+    }
+    return geometry::Rect2f(
+        static_cast<float>(dirtyXMin_),
+        static_cast<float>(dirtyYMin_),
+        static_cast<float>(dirtyXMax_),
+        static_cast<float>(dirtyYMax_));
+}
+
+void GlyphAtlas::clearDirtyRect() {
+    dirtyXMin_ = 0;
+    dirtyYMin_ = 0;
+    dirtyXMax_ = 0;
+    dirtyYMax_ = 0;
+}
+
+bool GlyphAtlas::allocate_(Int width, Int height, Int& plotIndex, Int& x, Int& y) {
+
+    if (width > plotSize_ || height > plotSize_) {
+        return false;
+    }
+
+    // Insert in the first plot with enough room, and keep track of the least
+    // recently used plot in case none has enough room.
+    Int lruIndex = 0;
+    for (Int i = 0; i < plots_.length(); ++i) {
+        Plot& plot = plots_[i];
+        if (plot.packer.insert(width, height, x, y)) {
+            plotIndex = i;
+            x += plot.x;
+            y += plot.y;
+            return true;
+        }
+        if (plot.lastUsedFrame < plots_[lruIndex].lastUsedFrame) {
+            lruIndex = i;
+        }
+    }
+
+    // Otherwise, evict the least recently used plot, unless it was used
+    // during the current frame.
+    if (plots_[lruIndex].lastUsedFrame == frame_) {
+        return false;
+    }
+    evictPlot_(lruIndex);
+    Plot& plot = plots_[lruIndex];
+    if (!plot.packer.insert(width, height, x, y)) {
+        return false;
+    }
+    plotIndex = lruIndex;
+    x += plot.x;
+    y += plot.y;
+    return true;
+}
+
+void GlyphAtlas::evictPlot_(Int plotIndex) {
+    Plot& plot = plots_[plotIndex];
+    for (SizedGlyph* glyph : plot.glyphs) {
+        entries_.erase(glyph);
+    }
+    plot.glyphs.clear();
+    plot.packer.clear();
+    plot.lastUsedFrame = -1;
+    for (Int i = 0; i < plotSize_; ++i) {
+        UInt8* row = pixels_.begin() + (plot.y + i) * width_ + plot.x;
+        std::fill(row, row + plotSize_, UInt8(0));
+    }
+    addDirtyRect_(plot.x, plot.y, plotSize_, plotSize_);
+    ++numEvictions_;
+}
+
+void GlyphAtlas::addDirtyRect_(Int x, Int y, Int width, Int height) {
+    if (isDirty()) {
+        dirtyXMin_ = (std::min)(dirtyXMin_, x);
+        dirtyYMin_ = (std::min)(dirtyYMin_, y);
+        dirtyXMax_ = (std::max)(dirtyXMax_, x + width);
+        dirtyYMax_ = (std::max)(dirtyYMax_, y + height);
+    }
+    else {
+        dirtyXMin_ = x;
+        dirtyYMin_ = y;
+        dirtyXMax_ = x + width;
+        dirtyYMax_ = y + height;
+    }
+}
+
+} // namespace vgc::graphics
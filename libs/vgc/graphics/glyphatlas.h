@@ -0,0 +1,371 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef VGC_GRAPHICS_GLYPHATLAS_H
+#define VGC_GRAPHICS_GLYPHATLAS_H
+
+#include <unordered_map>
+
+#include <vgc/core/arithmetic.h>
+#include <vgc/core/array.h>
+#include <vgc/geometry/rect2f.h>
+#include <vgc/geometry/vec2f.h>
+#include <vgc/geometry/vec3f.h>
+#include <vgc/graphics/api.h>
+#include <vgc/graphics/font.h>
+
+namespace vgc::graphics {
+
+namespace detail {
+
+/// \class vgc::graphics::detail::SkylinePacker
+/// \brief Packs rectangles into a fixed-size area using the skyline
+/// bottom-left heuristic.
+///
+/// The packer maintains the "skyline" of the rectangles inserted so far, that
+/// is, the list of horizontal segments delimiting the used area from the free
+/// area. Each new rectangle is placed on top of the skyline, at the position
+/// that minimizes its resulting bottom side, with ties broken by choosing the
+/// leftmost position.
+///
+/// Coordinates follow the Y-axis pointing down convention: the skyline grows
+/// from the top of the area towards its bottom.
+///
+/// Rectangles cannot be individually removed: the only way to free space is
+/// to `clear()` the packer.
+///
+class VGC_GRAPHICS_API SkylinePacker {
+public:
+    /// Creates an empty `SkylinePacker` for an area of the given size.
+    ///
+    SkylinePacker(Int width, Int height);
+
+    /// Returns the width of the packed area.
+    ///
+    Int width() const {
+        return width_;
+    }
+
+    /// Returns the height of the packed area.
+    ///
+    Int height() const {
+        return height_;
+    }
+
+    /// Removes all the rectangles inserted so far.
+    ///
+    void clear();
+
+    /// Finds room for a rectangle of the given size, and marks it as used.
+    ///
+    /// Returns whether there was enough room for the rectangle. If true, then
+    /// the position of its top-left corner is written to `x` and `y`.
+    /// Otherwise, `x` and `y` are left unchanged.
+    ///
+    bool insert(Int width, Int height, Int& x, Int& y);
+
+private:
+    struct Segment {
+        Int x;
+        Int y;
+        Int width;
+    };
+    Int width_;
+    Int height_;
+    core::Array<Segment> skyline_;
+
+    bool fits_(Int index, Int width, Int height, Int& y) const;
+};
+
+} // namespace detail
+
+/// \class vgc::graphics::GlyphAtlasEntry
+/// \brief The location of a rasterized glyph in a `GlyphAtlas`.
+///
+class VGC_GRAPHICS_API GlyphAtlasEntry {
+public:
+    /// Returns the X coordinate, in texels, of the left side of the glyph
+    /// bitmap in the atlas.
+    ///
+    Int x() const {
+        return x_;
+    }
+
+    /// Returns the Y coordinate, in texels, of the top side of the glyph
+    /// bitmap in the atlas.
+    ///
+    Int y() const {
+        return y_;
+    }
+
+    /// Returns the width of the glyph bitmap, in texels.
+    ///
+    Int width() const {
+        return width_;
+    }
+
+    /// Returns the height of the glyph bitmap, in texels.
+    ///
+    Int height() const {
+        return height_;
+    }
+
+    /// Returns whether the glyph has an empty bitmap, for example if it is a
+    /// space character. Such glyphs do not use any room in the atlas.
+    ///
+    bool isEmpty() const {
+        return width_ == 0 || height_ == 0;
+    }
+
+    /// Returns the X coordinate of the left side of the glyph bitmap,
+    /// relative to the glyph origin. See `GlyphBitmap::left()`.
+    ///
+    Int left() const {
+        return left_;
+    }
+
+    /// Returns the Y coordinate of the top side of the glyph bitmap, relative
+    /// to the glyph origin, with the Y-axis pointing down. See
+    /// `GlyphBitmap::top()`.
+    ///
+    Int top() const {
+        return top_;
+    }
+
+    /// Returns the normalized texture coordinates of the glyph bitmap in the
+    /// atlas.
+    ///
+    const geometry::Rect2f& texCoords() const {
+        return texCoords_;
+    }
+
+private:
+    friend class GlyphAtlas;
+
+    Int x_ = 0;
+    Int y_ = 0;
+    Int width_ = 0;
+    Int height_ = 0;
+    Int left_ = 0;
+    Int top_ = 0;
+    Int plotIndex_ = -1;
+    geometry::Rect2f texCoords_ = geometry::Rect2f::empty;
+};
+
+/// \class vgc::graphics::GlyphAtlas
+/// \brief An 8-bit texture atlas caching rasterized glyphs.
+///
+/// A `GlyphAtlas` stores the coverage bitmaps of many `SizedGlyph` objects in
+/// a single image, so that text can be drawn as one textured quad per glyph
+/// (see `TextAtlasVertex`) rather than as the triangulation of each glyph
+/// outline.
+///
+/// The atlas is divided into square plots of `plotSize()` texels, and glyphs
+/// are packed within each plot using a `detail::SkylinePacker`. When no plot
+/// has enough room for a new glyph, the least recently used plot is cleared
+/// and reused, evicting all of its glyphs. A plot used during the current
+/// frame is never evicted, which guarantees that the texture coordinates of
+/// all the glyphs returned during a frame stay valid until the end of the
+/// frame.
+///
+/// The atlas does not own any GPU resource: it keeps track of the region of
+/// `pixels()` modified since the last call to `clearDirtyRect()`, which the
+/// caller is responsible for uploading to a `PixelFormat::R_8_UNORM` image.
+///
+/// Glyphs are identified by their address, so a `SizedGlyph` should not be
+/// destroyed while it is in the atlas, or the atlas should be cleared first.
+///
+class VGC_GRAPHICS_API GlyphAtlas {
+public:
+    /// Creates an empty `GlyphAtlas` of the given size, in texels, divided
+    /// into square plots of the given size.
+    ///
+    /// Throws `core::LogicError` if `plotSize` is not positive, or if
+    /// `width` or `height` is not a positive multiple of `plotSize`.
+    ///
+    GlyphAtlas(Int width = 1024, Int height = 1024, Int plotSize = 256);
+
+    /// Returns the width of the atlas, in texels.
+    ///
+    Int width() const {
+        return width_;
+    }
+
+    /// Returns the height of the atlas, in texels.
+    ///
+    Int height() const {
+        return height_;
+    }
+
+    /// Returns the width and height of the plots of the atlas, in texels.
+    ///
+    Int plotSize() const {
+        return plotSize_;
+    }
+
+    /// Returns the number of plots of the atlas.
+    ///
+    Int numPlots() const {
+        return plots_.length();
+    }
+
+    /// Returns the number of glyphs currently in the atlas.
+    ///
+    Int numEntries() const {
+        return static_cast<Int>(entries_.size());
+    }
+
+    /// Returns the pixels of the atlas, stored row by row, starting with the
+    /// top row, with one byte per texel.
+    ///
+    const core::Array<UInt8>& pixels() const {
+        return pixels_;
+    }
+
+    /// Returns the index of the current frame.
+    ///
+    Int frame() const {
+        return frame_;
+    }
+
+    /// Starts a new frame. All the glyphs used during previous frames become
+    /// candidates for eviction.
+    ///
+    void beginFrame() {
+        ++frame_;
+    }
+
+    /// Returns the entry of the given `glyph` if it is in the atlas, and marks
+    /// it as used during the current frame. Returns `nullptr` otherwise.
+    ///
+    const GlyphAtlasEntry* find(SizedGlyph* glyph);
+
+    /// Inserts the given `bitmap` of the given `glyph` in the atlas, evicting
+    /// the least recently used plot if necessary, and returns its entry. If
+    /// the glyph is already in the atlas, its existing entry is returned.
+    ///
+    /// Returns `nullptr` if the bitmap is larger than a plot, or if all the
+    /// plots are full and have been used during the current frame.
+    ///
+    const GlyphAtlasEntry* insert(SizedGlyph* glyph, const GlyphBitmap& bitmap);
+
+    /// Returns the entry of the given `glyph`, rasterizing and inserting it in
+    /// the atlas if it is not already there.
+    ///
+    /// Returns `nullptr` if the glyph cannot be inserted. See `insert()`.
+    ///
+    const GlyphAtlasEntry* getOrInsert(SizedGlyph* glyph);
+
+    /// Removes all the glyphs from the atlas.
+    ///
+    void clear();
+
+    /// Returns the number of times glyphs were removed from the atlas, that
+    /// is, the number of evicted plots plus the number of calls to `clear()`.
+    ///
+    /// Quads generated with this atlas (see `ShapedText::fillAtlasQuads()`)
+    /// can be cached and drawn during subsequent frames as long as this number
+    /// doesn't change, since their texture coordinates are still valid.
+    ///
+    Int numEvictions() const {
+        return numEvictions_;
+    }
+
+    /// Returns whether some pixels of the atlas were modified since the last
+    /// call to `clearDirtyRect()`.
+    ///
+    bool isDirty() const {
+        return dirtyXMax_ > dirtyXMin_;
+    }
+
+    /// Returns the smallest rectangle, in texels, containing all the pixels
+    /// modified since the last call to `clearDirtyRect()`. Returns an empty
+    /// rectangle if there is no such pixel.
+    ///
+    geometry::Rect2f dirtyRect() const;
+
+    /// Marks all the pixels of the atlas as up-to-date, typically after they
+    /// have been uploaded to the GPU.
+    ///
+    void clearDirtyRect();
+
+private:
+    struct Plot {
+        Plot(Int x, Int y, Int size)
+            : packer(size, size)
+            , x(x)
+            , y(y) {
+        }
+
+        detail::SkylinePacker packer;
+        Int x;
+        Int y;
+        Int lastUsedFrame = -1;
+        core::Array<SizedGlyph*> glyphs;
+    };
+
+    Int width_;
+    Int height_;
+    Int plotSize_;
+    Int frame_ = 0;
+    Int numEvictions_ = 0;
+    core::Array<UInt8> pixels_;
+    core::Array<Plot> plots_;
+    std::unordered_map<SizedGlyph*, GlyphAtlasEntry> entries_;
+
+    // Dirty rect, as [xMin, xMax) x [yMin, yMax)
+    Int dirtyXMin_ = 0;
+    Int dirtyYMin_ = 0;
+    Int dirtyXMax_ = 0;
+    Int dirtyYMax_ = 0;
+
+    bool allocate_(Int width, Int height, Int& plotIndex, Int& x, Int& y);
+    void evictPlot_(Int plotIndex);
+    void addDirtyRect_(Int x, Int y, Int width, Int height);
+};
+
+/// \class vgc::graphics::TextAtlasVertex
+/// \brief The per-instance data of a glyph quad drawn from a `GlyphAtlas`.
+///
+/// Text drawn via a `GlyphAtlas` is represented as an array of
+/// `TextAtlasVertex`, one per visible glyph, meant to be used as per-instance
+/// vertex data for drawing one textured quad per glyph.
+///
+/// \sa `ShapedText::fillAtlasQuads()`.
+///
+struct VGC_GRAPHICS_API TextAtlasVertex {
+    /// The position of the top-left corner of the quad.
+    ///
+    geometry::Vec2f position;
+
+    /// The size of the quad.
+    ///
+    geometry::Vec2f size;
+
+    /// The normalized texture coordinates, in the atlas, of the part of the
+    /// glyph bitmap covered by the quad.
+    ///
+    geometry::Rect2f texCoords;
+
+    /// The color of the text.
+    ///
+    geometry::Vec3f color;
+};
+
+} // namespace vgc::graphics
+
+#endif // VGC_GRAPHICS_GLYPHATLAS_H
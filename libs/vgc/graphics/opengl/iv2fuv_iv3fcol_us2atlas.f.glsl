@@ -0,0 +1,11 @@
+#version 330 core
+
+in vec2 fuv;
+in vec3 fcol;
+uniform sampler2D atlas;
+out highp vec4 fragColor;
+
+void main()
+{
+   fragColor = vec4(fcol, texture(atlas, fuv).r);
+}
@@ -0,0 +1,25 @@
+#version 330 core
+
+// Per-instance attributes: each instance is a quad drawn as a 4-vertex
+// triangle strip, whose corner is given by gl_VertexID.
+in vec2 pos;
+in vec2 size;
+in vec4 uvs;
+in vec3 col;
+
+layout(std140) uniform BuiltinConstants {
+	mat4 proj;
+	mat4 view;
+	uint frameStartTimeInMs;
+};
+
+out vec2 fuv;
+out vec3 fcol;
+
+void main()
+{
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    fuv = mix(uvs.xy, uvs.zw, corner);
+    fcol = col;
+    gl_Position = proj * view * vec4(pos + corner * size, 0.0, 1.0);
+}
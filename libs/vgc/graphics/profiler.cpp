@@ -0,0 +1,336 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vgc/graphics/profiler.h>
+
+#include <algorithm> // std::max, std::stable_sort
+
+#include <vgc/core/format.h>
+
+namespace vgc::graphics {
+
+EngineProfiler::EngineProfiler(std::chrono::steady_clock::time_point startTime)
+    : startTime_(startTime)
+    , engineTask_("Graphics Engine")
+    , syncStateTask_("Sync State")
+    , waitTask_("Wait")
+    , executeTask_("Execute") {
+}
+
+void EngineProfiler::setMaxFrames(Int maxFrames) {
+    maxFrames_ = (std::max)(Int(1), maxFrames);
+    if (frames_.length() > maxFrames_) {
+        frames_.removeFirst(frames_.length() - maxFrames_);
+    }
+}
+
+void EngineProfiler::clear() {
+    frames_.clear();
+}
+
+void EngineProfiler::startLoggingUnder(core::PerformanceLog* parent) {
+    if (logParents_.contains(parent)) {
+        return;
+    }
+    logParents_.append(parent);
+    core::PerformanceLog* engineLog = engineTask_.startLoggingUnder(parent);
+    syncStateTask_.startLoggingUnder(engineLog);
+    waitTask_.startLoggingUnder(engineLog);
+    core::PerformanceLog* executeLog = executeTask_.startLoggingUnder(engineLog);
+    for (core::PerformanceLogTask& commandTask : commandTasks_) {
+        commandTask.startLoggingUnder(executeLog);
+    }
+}
+
+void EngineProfiler::stopLoggingUnder(core::PerformanceLog* parent) {
+    if (!logParents_.contains(parent)) {
+        return;
+    }
+    logParents_.removeOne(parent);
+    core::PerformanceLogPtr engineLog = engineTask_.stopLoggingUnder(parent);
+    syncStateTask_.stopLoggingUnder(engineLog.get());
+    waitTask_.stopLoggingUnder(engineLog.get());
+    core::PerformanceLogPtr executeLog = executeTask_.stopLoggingUnder(engineLog.get());
+    for (core::PerformanceLogTask& commandTask : commandTasks_) {
+        commandTask.stopLoggingUnder(executeLog.get());
+    }
+}
+
+namespace {
+
+void appendJsonString(std::string& out, std::string_view s) {
+    out += '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            out += core::format("\\u{:04x}", static_cast<int>(c));
+        }
+        else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+// Thread IDs of the trace. The process ID is always 1.
+Int traceThreadId(ProfiledThread thread) {
+    return thread == ProfiledThread::User ? 1 : 2;
+}
+
+} // namespace
+
+std::string EngineProfiler::toTraceJson() const {
+    std::string out = "{\"traceEvents\":[\n";
+    out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,"
+           "\"args\":{\"name\":\"User Thread\"}},\n";
+    out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,"
+           "\"args\":{\"name\":\"Render Thread\"}}";
+    for (const EngineFrameProfile& frame : frames_) {
+        for (const EngineTraceEvent& event : frame.events()) {
+            out += ",\n{\"name\":";
+            appendJsonString(out, event.name());
+            // Timestamps are in microseconds
+            double ts = event.startTime() * 1e6;
+            if (event.duration() > 0) {
+                double dur = event.duration() * 1e6;
+                out += core::format(
+                    ",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f}", ts, dur);
+            }
+            else {
+                out += core::format(",\"ph\":\"i\",\"s\":\"t\",\"ts\":{:.3f}", ts);
+            }
+            out += core::format(
+                ",\"pid\":1,\"tid\":{},\"args\":{{\"frame\":{}}}}}",
+                traceThreadId(event.thread()),
+                frame.frameIndex());
+        }
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+EngineProfiler::PendingFrame_* EngineProfiler::currentFrame_() {
+    return isInFrame_ ? &pendingFrames_.last() : nullptr;
+}
+
+void EngineProfiler::beginFrame_(double startTime) {
+    if (isInFrame_) {
+        // beginFrame() without endFrame(): discard the previous frame.
+        pendingFrames_.removeLast();
+    }
+    PendingFrame_& frame = pendingFrames_.emplaceLast();
+    frame.profile.frameIndex_ = numBegunFrames_;
+    frame.profile.startTime_ = startTime;
+    ++numBegunFrames_;
+    isInFrame_ = true;
+}
+
+void EngineProfiler::endFrame_(double endTime, Int lastListId, Int lastExecutedListId) {
+    if (PendingFrame_* frame = currentFrame_()) {
+        frame->endTime = endTime;
+        frame->lastListId = lastListId;
+        frame->profile.userTime_ = endTime - frame->profile.startTime_;
+        isInFrame_ = false;
+    }
+    finishFrames_(lastExecutedListId);
+}
+
+void EngineProfiler::addSyncStateTime_(double duration) {
+    if (PendingFrame_* frame = currentFrame_()) {
+        frame->profile.syncStateTime_ += duration;
+    }
+}
+
+void EngineProfiler::addWait_(double startTime, double duration) {
+    if (PendingFrame_* frame = currentFrame_()) {
+        frame->profile.waitTime_ += duration;
+        frame->profile.events_.append(
+            EngineTraceEvent("wait", ProfiledThread::User, startTime, duration));
+    }
+}
+
+void EngineProfiler::addSubmit_(double time) {
+    if (PendingFrame_* frame = currentFrame_()) {
+        frame->profile.events_.append(
+            EngineTraceEvent("submit", ProfiledThread::User, time, 0));
+    }
+}
+
+void EngineProfiler::addInlineCommand_(
+    std::string_view name,
+    double startTime,
+    double duration) {
+
+    if (PendingFrame_* frame = currentFrame_()) {
+        frame->inlineCommands.append(
+            EngineTraceEvent(name, ProfiledThread::User, startTime, duration));
+    }
+}
+
+void EngineProfiler::finishFrames_(Int lastExecutedListId) {
+    {
+        std::lock_guard<std::mutex> lock(executedListsMutex_);
+        for (CommandList_& list : executedListsShared_) {
+            executedLists_.append(std::move(list));
+        }
+        executedListsShared_.clear();
+    }
+    Int numFinishedFrames = 0;
+    for (PendingFrame_& frame : pendingFrames_) {
+        bool isEnded = !isInFrame_ || &frame != &pendingFrames_.last();
+        if (!isEnded || frame.lastListId > lastExecutedListId) {
+            break;
+        }
+        finishFrame_(frame);
+        ++numFinishedFrames;
+    }
+    if (numFinishedFrames > 0) {
+        publishToLogs_(frames_.last());
+        pendingFrames_.removeFirst(numFinishedFrames);
+    }
+}
+
+void EngineProfiler::finishFrame_(PendingFrame_& frame) {
+    EngineFrameProfile& profile = frame.profile;
+    core::Array<EngineTraceEvent>& events = profile.events_;
+    events.prepend(EngineTraceEvent(
+        "frame", ProfiledThread::User, profile.startTime_, profile.userTime_));
+
+    // Command lists executed on the render thread, and commands executed
+    // inline on the user thread when multithreading is disabled.
+    Int numLists = 0;
+    for (const CommandList_& list : executedLists_) {
+        if (list.id > frame.lastListId) {
+            break;
+        }
+        ++numLists;
+        profile.executeTime_ += list.duration;
+        events.append(EngineTraceEvent(
+            "commandList", ProfiledThread::Render, list.startTime, list.duration));
+        events.extend(list.commands.begin(), list.commands.end());
+    }
+    for (const EngineTraceEvent& command : frame.inlineCommands) {
+        profile.executeTime_ += command.duration();
+        events.append(command);
+    }
+    profile.numCommandLists_ = numLists;
+
+    // Aggregate command timings by name
+    auto aggregate = [&profile](const EngineTraceEvent& command) {
+        EngineCommandTimings* timings = nullptr;
+        for (EngineCommandTimings& t : profile.commandTimings_) {
+            if (t.name_ == command.name()) {
+                timings = &t;
+                break;
+            }
+        }
+        if (!timings) {
+            timings = &profile.commandTimings_.emplaceLast();
+            timings->name_ = command.name();
+        }
+        timings->count_ += 1;
+        timings->totalTime_ += command.duration();
+    };
+    for (Int i = 0; i < numLists; ++i) {
+        for (const EngineTraceEvent& command : executedLists_[i].commands) {
+            aggregate(command);
+        }
+    }
+    for (const EngineTraceEvent& command : frame.inlineCommands) {
+        aggregate(command);
+    }
+    std::stable_sort(
+        profile.commandTimings_.begin(),
+        profile.commandTimings_.end(),
+        [](const EngineCommandTimings& t1, const EngineCommandTimings& t2) {
+            return t1.totalTime() > t2.totalTime();
+        });
+    for (const EngineCommandTimings& timings : profile.commandTimings_) {
+        if (timings.name() == "present") {
+            profile.presentTime_ = timings.totalTime();
+        }
+    }
+    executedLists_.removeFirst(numLists);
+
+    std::stable_sort(
+        events.begin(),
+        events.end(),
+        [](const EngineTraceEvent& e1, const EngineTraceEvent& e2) {
+            if (e1.thread() != e2.thread()) {
+                return e1.thread() < e2.thread();
+            }
+            return e1.startTime() < e2.startTime();
+        });
+
+    if (frames_.length() >= maxFrames_) {
+        frames_.removeFirst();
+    }
+    frames_.append(std::move(profile));
+}
+
+void EngineProfiler::publishToLogs_(const EngineFrameProfile& frame) {
+    if (logParents_.isEmpty()) {
+        return;
+    }
+    engineTask_.log(frame.userTime());
+    syncStateTask_.log(frame.syncStateTime());
+    waitTask_.log(frame.waitTime());
+    executeTask_.log(frame.executeTime());
+    for (const EngineCommandTimings& timings : frame.commandTimings()) {
+        commandTask_(timings.name()).log(timings.totalTime());
+    }
+}
+
+core::PerformanceLogTask& EngineProfiler::commandTask_(std::string_view name) {
+    for (core::PerformanceLogTask& commandTask : commandTasks_) {
+        if (commandTask.name() == name) {
+            return commandTask;
+        }
+    }
+    core::PerformanceLogTask& commandTask = commandTasks_.emplace_back(std::string(name));
+    for (core::PerformanceLog* parent : logParents_) {
+        core::PerformanceLog* engineLog = engineTask_.getLogUnder(parent);
+        commandTask.startLoggingUnder(executeTask_.getLogUnder(engineLog));
+    }
+    return commandTask;
+}
+
+void EngineProfiler::beginCommandList_(Int id, double startTime) {
+    renderThreadList_.id = id;
+    renderThreadList_.startTime = startTime;
+    renderThreadList_.commands.clear();
+}
+
+void EngineProfiler::addCommand_(
+    std::string_view name,
+    double startTime,
+    double duration) {
+
+    renderThreadList_.commands.append(
+        EngineTraceEvent(name, ProfiledThread::Render, startTime, duration));
+}
+
+void EngineProfiler::endCommandList_(double endTime) {
+    renderThreadList_.duration = endTime - renderThreadList_.startTime;
+    std::lock_guard<std::mutex> lock(executedListsMutex_);
+    executedListsShared_.append(std::move(renderThreadList_));
+    renderThreadList_ = CommandList_();
+}
+
+} // namespace vgc::graphics
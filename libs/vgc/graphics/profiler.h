@@ -0,0 +1,391 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VGC_GRAPHICS_PROFILER_H
+#define VGC_GRAPHICS_PROFILER_H
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <vgc/core/arithmetic.h>
+#include <vgc/core/array.h>
+#include <vgc/core/performancelog.h>
+#include <vgc/graphics/api.h>
+
+namespace vgc::graphics {
+
+class Engine;
+
+/// \enum vgc::graphics::ProfiledThread
+/// \brief Specifies the thread on which a profiled event occurred.
+///
+enum class ProfiledThread : UInt8 {
+
+    /// The thread calling the `Engine` API, which records the commands.
+    ///
+    User,
+
+    /// The render thread of the `Engine`, which translates the recorded
+    /// commands to GPU commands. When multithreading is disabled, commands are
+    /// translated on the user thread instead.
+    ///
+    Render
+};
+
+/// \class vgc::graphics::EngineTraceEvent
+/// \brief A timed span of work of an `Engine`, on a given thread.
+///
+/// \sa `EngineFrameProfile::events()`.
+///
+class VGC_GRAPHICS_API EngineTraceEvent {
+public:
+    /// Creates an `EngineTraceEvent`.
+    ///
+    /// The given `name` must outlive the event, which is the case of the
+    /// string literals used as command names.
+    ///
+    EngineTraceEvent(
+        std::string_view name,
+        ProfiledThread thread,
+        double startTime,
+        double duration)
+
+        : name_(name)
+        , thread_(thread)
+        , startTime_(startTime)
+        , duration_(duration) {
+    }
+
+    /// Returns the name of this event, for example the name of a command.
+    ///
+    std::string_view name() const {
+        return name_;
+    }
+
+    /// Returns the thread on which this event occurred.
+    ///
+    ProfiledThread thread() const {
+        return thread_;
+    }
+
+    /// Returns the start time of this event, in seconds since the engine was
+    /// created.
+    ///
+    double startTime() const {
+        return startTime_;
+    }
+
+    /// Returns the duration of this event, in seconds. Events marking a point
+    /// in time, such as the submission of a command list, have a zero duration.
+    ///
+    double duration() const {
+        return duration_;
+    }
+
+private:
+    std::string_view name_;
+    ProfiledThread thread_;
+    double startTime_;
+    double duration_;
+};
+
+/// \class vgc::graphics::EngineCommandTimings
+/// \brief The total time spent executing all the commands of a given name
+///        during a frame.
+///
+/// \sa `EngineFrameProfile::commandTimings()`.
+///
+class VGC_GRAPHICS_API EngineCommandTimings {
+public:
+    /// Returns the name of the commands, for example "draw" or "setProgram".
+    ///
+    std::string_view name() const {
+        return name_;
+    }
+
+    /// Returns the number of executed commands with this name.
+    ///
+    Int count() const {
+        return count_;
+    }
+
+    /// Returns the total execution time of the commands with this name, in
+    /// seconds.
+    ///
+    double totalTime() const {
+        return totalTime_;
+    }
+
+private:
+    friend class EngineProfiler;
+
+    std::string_view name_;
+    Int count_ = 0;
+    double totalTime_ = 0;
+};
+
+/// \class vgc::graphics::EngineFrameProfile
+/// \brief Timings of the work done by an `Engine` for a given frame.
+///
+/// A frame includes the work done on the user thread from `beginFrame()` to
+/// the end of `endFrame()`, and the execution of the command lists submitted
+/// during the frame (or since the previous frame), which may happen on the
+/// render thread after `endFrame()` has returned.
+///
+/// \sa `EngineProfiler::frames()`.
+///
+class VGC_GRAPHICS_API EngineFrameProfile {
+public:
+    /// Returns the index of this frame, counting from the first frame begun
+    /// after profiling was enabled.
+    ///
+    Int frameIndex() const {
+        return frameIndex_;
+    }
+
+    /// Returns the time at which `beginFrame()` was called, in seconds since
+    /// the engine was created.
+    ///
+    double startTime() const {
+        return startTime_;
+    }
+
+    /// Returns the time spent on the user thread from the start of
+    /// `beginFrame()` to the end of `endFrame()`, in seconds.
+    ///
+    double userTime() const {
+        return userTime_;
+    }
+
+    /// Returns the part of `userTime()` spent synchronizing the pipeline
+    /// state before draws, in seconds.
+    ///
+    double syncStateTime() const {
+        return syncStateTime_;
+    }
+
+    /// Returns the part of `userTime()` spent waiting for the render thread,
+    /// in seconds. This is typically caused by too many frames in flight or
+    /// by waiting for vertical synchronization.
+    ///
+    double waitTime() const {
+        return waitTime_;
+    }
+
+    /// Returns the time spent executing the commands of this frame, in
+    /// seconds, including presenting the frame.
+    ///
+    /// When multithreading is enabled, this is time spent on the render
+    /// thread. Otherwise, this is a part of `userTime()`.
+    ///
+    double executeTime() const {
+        return executeTime_;
+    }
+
+    /// Returns the part of `executeTime()` spent presenting the frame, in
+    /// seconds.
+    ///
+    double presentTime() const {
+        return presentTime_;
+    }
+
+    /// Returns the number of command lists submitted to the render thread
+    /// for this frame. This is always zero if multithreading is disabled.
+    ///
+    Int numCommandLists() const {
+        return numCommandLists_;
+    }
+
+    /// Returns the execution time of the commands of this frame, aggregated
+    /// by command name, sorted by decreasing total time.
+    ///
+    const core::Array<EngineCommandTimings>& commandTimings() const {
+        return commandTimings_;
+    }
+
+    /// Returns all the events of this frame, sorted by thread then start
+    /// time: the frame itself, waits, and submissions of command lists on the
+    /// user thread, and the execution of command lists and of each of their
+    /// commands on the render thread.
+    ///
+    const core::Array<EngineTraceEvent>& events() const {
+        return events_;
+    }
+
+private:
+    friend class EngineProfiler;
+
+    Int frameIndex_ = 0;
+    double startTime_ = 0;
+    double userTime_ = 0;
+    double syncStateTime_ = 0;
+    double waitTime_ = 0;
+    double executeTime_ = 0;
+    double presentTime_ = 0;
+    Int numCommandLists_ = 0;
+    core::Array<EngineCommandTimings> commandTimings_;
+    core::Array<EngineTraceEvent> events_;
+};
+
+/// \class vgc::graphics::EngineProfiler
+/// \brief Measures the time spent by an `Engine` on the user thread and on the
+///        render thread.
+///
+/// An `EngineProfiler` is created by `Engine::setProfilingEnabled()` and
+/// can be accessed via `Engine::profiler()`. It records when each command
+/// list is submitted by the user thread, when each command list and each
+/// command is executed, and how long the user thread spends waiting for the
+/// render thread. These timings are grouped by frame once all the command
+/// lists of a frame have been executed.
+///
+/// The results can be inspected via `frames()`, published in a
+/// `core::PerformanceLog` tree (see `startLoggingUnder()`), or exported as a
+/// trace (see `toTraceJson()`).
+///
+/// All the methods of this class must be called from the user thread.
+///
+class VGC_GRAPHICS_API EngineProfiler {
+public:
+    /// Creates an `EngineProfiler` whose timestamps are relative to the given
+    /// `startTime`.
+    ///
+    explicit EngineProfiler(std::chrono::steady_clock::time_point startTime);
+
+    /// Returns the maximum number of frames kept in `frames()`. The default
+    /// is 120.
+    ///
+    Int maxFrames() const {
+        return maxFrames_;
+    }
+
+    /// Sets the maximum number of frames kept in `frames()`.
+    ///
+    void setMaxFrames(Int maxFrames);
+
+    /// Returns the last profiled frames, from oldest to newest.
+    ///
+    /// Frames are added once all their command lists have been executed,
+    /// which may be up to `EngineCreateInfo::maxFramesInFlight()` frames
+    /// after their `endFrame()`.
+    ///
+    const core::Array<EngineFrameProfile>& frames() const {
+        return frames_;
+    }
+
+    /// Returns the last profiled frame, if any.
+    ///
+    const EngineFrameProfile* lastFrame() const {
+        return frames_.isEmpty() ? nullptr : &frames_.last();
+    }
+
+    /// Removes all the profiled frames.
+    ///
+    void clear();
+
+    /// Starts publishing the timings of each profiled frame in a tree of
+    /// logs created as children of the given `parent`:
+    ///
+    /// \verbatim
+    /// Graphics Engine:    userTime()
+    ///   Sync State:       syncStateTime()
+    ///   Wait:             waitTime()
+    ///   Execute:          executeTime()
+    ///     <command name>: totalTime() of each command name
+    /// \endverbatim
+    ///
+    void startLoggingUnder(core::PerformanceLog* parent);
+
+    /// Stops publishing the timings of profiled frames under the given
+    /// `parent`.
+    ///
+    void stopLoggingUnder(core::PerformanceLog* parent);
+
+    /// Returns the events of the profiled frames in the JSON trace event
+    /// format, which can be loaded in trace viewers such as `chrome://tracing`
+    /// or Perfetto.
+    ///
+    std::string toTraceJson() const;
+
+private:
+    friend Engine;
+
+    std::chrono::steady_clock::time_point startTime_;
+    Int maxFrames_ = 120;
+    core::Array<EngineFrameProfile> frames_;
+
+    // Execution of a command list. Written by the render thread, then moved
+    // to the user thread via executedLists_.
+    struct CommandList_ {
+        Int id = 0;
+        double startTime = 0;
+        double duration = 0;
+        core::Array<EngineTraceEvent> commands;
+    };
+    CommandList_ renderThreadList_;
+    std::mutex executedListsMutex_;
+    core::Array<CommandList_> executedListsShared_;
+    core::Array<CommandList_> executedLists_;
+
+    // Frames ended on the user thread but whose command lists may not have
+    // been executed yet.
+    struct PendingFrame_ {
+        EngineFrameProfile profile;
+        double endTime = 0;
+        Int lastListId = 0;
+        core::Array<EngineTraceEvent> inlineCommands;
+    };
+    core::Array<PendingFrame_> pendingFrames_;
+    bool isInFrame_ = false;
+    Int numBegunFrames_ = 0;
+
+    // Logs
+    core::PerformanceLogTask engineTask_;
+    core::PerformanceLogTask syncStateTask_;
+    core::PerformanceLogTask waitTask_;
+    core::PerformanceLogTask executeTask_;
+    std::vector<core::PerformanceLogTask> commandTasks_;
+    core::Array<core::PerformanceLog*> logParents_;
+
+    double now_() const {
+        std::chrono::duration<double> d = std::chrono::steady_clock::now() - startTime_;
+        return d.count();
+    }
+
+    // User thread
+    PendingFrame_* currentFrame_();
+    void beginFrame_(double startTime);
+    void endFrame_(double endTime, Int lastListId, Int lastExecutedListId);
+    void addSyncStateTime_(double duration);
+    void addWait_(double startTime, double duration);
+    void addSubmit_(double time);
+    void addInlineCommand_(std::string_view name, double startTime, double duration);
+    void finishFrames_(Int lastExecutedListId);
+    void finishFrame_(PendingFrame_& frame);
+    void publishToLogs_(const EngineFrameProfile& frame);
+    core::PerformanceLogTask& commandTask_(std::string_view name);
+
+    // Render thread
+    void beginCommandList_(Int id, double startTime);
+    void addCommand_(std::string_view name, double startTime, double duration);
+    void endCommandList_(double endTime);
+};
+
+} // namespace vgc::graphics
+
+#endif // VGC_GRAPHICS_PROFILER_H
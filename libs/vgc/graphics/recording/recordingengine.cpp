@@ -0,0 +1,395 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <vgc/graphics/recording/recordingengine.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace vgc::graphics {
+
+// Concrete resources. They don't hold any API object, but we still need
+// these classes since the constructors of the abstract resources are
+// protected.
+
+class RecordingBuffer : public Buffer {
+protected:
+    friend RecordingEngine;
+    using Buffer::Buffer;
+};
+
+class RecordingImage : public Image {
+protected:
+    friend RecordingEngine;
+    using Image::Image;
+};
+
+class RecordingImageView : public ImageView {
+protected:
+    friend RecordingEngine;
+    using ImageView::ImageView;
+};
+
+class RecordingSamplerState : public SamplerState {
+protected:
+    friend RecordingEngine;
+    using SamplerState::SamplerState;
+};
+
+class RecordingGeometryView : public GeometryView {
+protected:
+    friend RecordingEngine;
+    using GeometryView::GeometryView;
+};
+
+class RecordingProgram : public Program {
+protected:
+    friend RecordingEngine;
+    using Program::Program;
+};
+
+class RecordingBlendState : public BlendState {
+protected:
+    friend RecordingEngine;
+    using BlendState::BlendState;
+};
+
+class RecordingRasterizerState : public RasterizerState {
+protected:
+    friend RecordingEngine;
+    using RasterizerState::RasterizerState;
+};
+
+class RecordingFramebuffer : public Framebuffer {
+protected:
+    friend RecordingEngine;
+    using Framebuffer::Framebuffer;
+
+protected:
+    void releaseSubResources_() override {
+        colorView_.reset();
+    }
+
+private:
+    ImageViewPtr colorView_;
+};
+
+class RecordingSwapChain : public SwapChain {
+protected:
+    friend RecordingEngine;
+    using SwapChain::SwapChain;
+};
+
+RecordingEngine::RecordingEngine(const EngineCreateInfo& createInfo)
+    : Engine(createInfo) {
+}
+
+void RecordingEngine::onDestroyed() {
+    Engine::onDestroyed();
+}
+
+/* static */
+RecordingEnginePtr RecordingEngine::create(const EngineCreateInfo& createInfo) {
+    RecordingEnginePtr engine(new RecordingEngine(createInfo));
+    engine->init_();
+    return engine;
+}
+
+Int RecordingEngine::numCommands() const {
+    Int res = 0;
+    for (Int n : numCommandsPerType_) {
+        res += n;
+    }
+    return res;
+}
+
+void RecordingEngine::resetRecording() {
+    commands_.clear();
+    numCommandsPerType_.fill(0);
+    numUploadedBytes_ = 0;
+    numDrawnVertices_ = 0;
+}
+
+// -- USER THREAD implementation functions --
+
+void RecordingEngine::createBuiltinShaders_() {
+    simpleProgram_.reset(new RecordingProgram(resourceRegistry_, BuiltinProgram::Simple));
+    glyphAtlasProgram_.reset(
+        new RecordingProgram(resourceRegistry_, BuiltinProgram::GlyphAtlas));
+}
+
+SwapChainPtr
+RecordingEngine::constructSwapChain_(const SwapChainCreateInfo& createInfo) {
+    // Note: any WindowNativeHandleType is accepted, including None, since
+    // there is no window to present to.
+    auto swapChain = makeUnique<RecordingSwapChain>(resourceRegistry_, createInfo);
+    return SwapChainPtr(swapChain.release());
+}
+
+FramebufferPtr
+RecordingEngine::constructFramebuffer_(const ImageViewPtr& colorImageView) {
+    auto framebuffer = makeUnique<RecordingFramebuffer>(resourceRegistry_);
+    framebuffer->colorView_ = colorImageView;
+    return FramebufferPtr(framebuffer.release());
+}
+
+BufferPtr RecordingEngine::constructBuffer_(const BufferCreateInfo& createInfo) {
+    auto buffer = makeUnique<RecordingBuffer>(resourceRegistry_, createInfo);
+    return BufferPtr(buffer.release());
+}
+
+ImagePtr RecordingEngine::constructImage_(const ImageCreateInfo& createInfo) {
+    auto image = makeUnique<RecordingImage>(resourceRegistry_, createInfo);
+    return ImagePtr(image.release());
+}
+
+ImageViewPtr RecordingEngine::constructImageView_(
+    const ImageViewCreateInfo& createInfo,
+    const ImagePtr& image) {
+
+    auto view = makeUnique<RecordingImageView>(resourceRegistry_, createInfo, image);
+    return ImageViewPtr(view.release());
+}
+
+ImageViewPtr RecordingEngine::constructImageView_(
+    const ImageViewCreateInfo& createInfo,
+    const BufferPtr& buffer,
+    PixelFormat format,
+    UInt32 numElements) {
+
+    auto view = makeUnique<RecordingImageView>(
+        resourceRegistry_, createInfo, buffer, format, numElements);
+    return ImageViewPtr(view.release());
+}
+
+SamplerStatePtr
+RecordingEngine::constructSamplerState_(const SamplerStateCreateInfo& createInfo) {
+    auto state = makeUnique<RecordingSamplerState>(resourceRegistry_, createInfo);
+    return SamplerStatePtr(state.release());
+}
+
+GeometryViewPtr
+RecordingEngine::constructGeometryView_(const GeometryViewCreateInfo& createInfo) {
+    auto view = makeUnique<RecordingGeometryView>(resourceRegistry_, createInfo);
+    return GeometryViewPtr(view.release());
+}
+
+BlendStatePtr
+RecordingEngine::constructBlendState_(const BlendStateCreateInfo& createInfo) {
+    auto state = makeUnique<RecordingBlendState>(resourceRegistry_, createInfo);
+    return BlendStatePtr(state.release());
+}
+
+RasterizerStatePtr
+RecordingEngine::constructRasterizerState_(const RasterizerStateCreateInfo& createInfo) {
+    auto state = makeUnique<RecordingRasterizerState>(resourceRegistry_, createInfo);
+    return RasterizerStatePtr(state.release());
+}
+
+void RecordingEngine::resizeSwapChain_(
+    SwapChain* /*swapChain*/,
+    UInt32 /*width*/,
+    UInt32 /*height*/) {
+}
+
+//--  RENDER THREAD implementation functions --
+
+void RecordingEngine::initFramebuffer_(Framebuffer* /*framebuffer*/) {
+    record_(RecordedCommandType::InitFramebuffer);
+}
+
+void RecordingEngine::initBuffer_(
+    Buffer* /*buffer*/,
+    const char* data,
+    Int lengthInBytes) {
+
+    // Note: no data is uploaded when the buffer is zero-initialized
+    record_(RecordedCommandType::InitBuffer, data ? lengthInBytes : 0);
+}
+
+void RecordingEngine::initImage_(
+    Image* /*image*/,
+    const Span<const char>* mipLevelDataSpans,
+    Int numMipLevels) {
+
+    Int numBytes = 0;
+    for (Int i = 0; i < numMipLevels; ++i) {
+        numBytes += mipLevelDataSpans[i].length();
+    }
+    record_(RecordedCommandType::InitImage, numBytes);
+}
+
+void RecordingEngine::initImageView_(ImageView* /*view*/) {
+    record_(RecordedCommandType::InitImageView);
+}
+
+void RecordingEngine::initSamplerState_(SamplerState* /*state*/) {
+    record_(RecordedCommandType::InitSamplerState);
+}
+
+void RecordingEngine::initGeometryView_(GeometryView* /*view*/) {
+    record_(RecordedCommandType::InitGeometryView);
+}
+
+void RecordingEngine::initBlendState_(BlendState* /*state*/) {
+    record_(RecordedCommandType::InitBlendState);
+}
+
+void RecordingEngine::initRasterizerState_(RasterizerState* /*state*/) {
+    record_(RecordedCommandType::InitRasterizerState);
+}
+
+void RecordingEngine::setSwapChain_(const SwapChainPtr& /*swapChain*/) {
+    record_(RecordedCommandType::SetSwapChain);
+}
+
+void RecordingEngine::setFramebuffer_(const FramebufferPtr& /*framebuffer*/) {
+    record_(RecordedCommandType::SetFramebuffer);
+}
+
+void RecordingEngine::setViewport_(
+    Int /*x*/,
+    Int /*y*/,
+    Int /*width*/,
+    Int /*height*/) {
+
+    record_(RecordedCommandType::SetViewport);
+}
+
+void RecordingEngine::setProgram_(const ProgramPtr& /*program*/) {
+    record_(RecordedCommandType::SetProgram);
+}
+
+void RecordingEngine::setBlendState_(
+    const BlendStatePtr& /*state*/,
+    const geometry::Vec4f& /*blendFactor*/) {
+
+    record_(RecordedCommandType::SetBlendState);
+}
+
+void RecordingEngine::setRasterizerState_(const RasterizerStatePtr& /*state*/) {
+    record_(RecordedCommandType::SetRasterizerState);
+}
+
+void RecordingEngine::setStageConstantBuffers_(
+    const BufferPtr* /*buffers*/,
+    Int /*startIndex*/,
+    Int /*count*/,
+    ShaderStage /*shaderStage*/) {
+
+    record_(RecordedCommandType::SetStageConstantBuffers);
+}
+
+void RecordingEngine::setStageImageViews_(
+    const ImageViewPtr* /*views*/,
+    Int /*startIndex*/,
+    Int /*count*/,
+    ShaderStage /*shaderStage*/) {
+
+    record_(RecordedCommandType::SetStageImageViews);
+}
+
+void RecordingEngine::setStageSamplers_(
+    const SamplerStatePtr* /*states*/,
+    Int /*startIndex*/,
+    Int /*count*/,
+    ShaderStage /*shaderStage*/) {
+
+    record_(RecordedCommandType::SetStageSamplers);
+}
+
+void RecordingEngine::updateBufferData_(
+    Buffer* /*buffer*/,
+    const void* /*data*/,
+    Int lengthInBytes) {
+
+    record_(RecordedCommandType::UpdateBufferData, lengthInBytes);
+}
+
+void RecordingEngine::updateImageData_(
+    Image* /*image*/,
+    Int /*x*/,
+    Int /*y*/,
+    Int /*width*/,
+    Int /*height*/,
+    const void* /*data*/,
+    Int lengthInBytes) {
+
+    record_(RecordedCommandType::UpdateImageData, lengthInBytes);
+}
+
+void RecordingEngine::uploadTransientVertexData_(
+    Buffer* /*buffer*/,
+    Int /*regionIndex*/,
+    Int /*offsetInBytes*/,
+    const void* /*data*/,
+    Int lengthInBytes) {
+
+    record_(RecordedCommandType::UploadTransientVertexData, lengthInBytes);
+}
+
+void RecordingEngine::fenceTransientVertexData_(
+    Buffer* /*buffer*/,
+    Int /*regionIndex*/) {
+
+    record_(RecordedCommandType::FenceTransientVertexData);
+}
+
+void RecordingEngine::draw_(
+    GeometryView* /*view*/,
+    UInt numIndices,
+    UInt numInstances,
+    UInt /*startVertex*/) {
+
+    record_(
+        RecordedCommandType::Draw,
+        0,
+        core::int_cast<Int>(numIndices),
+        core::int_cast<Int>(numInstances));
+}
+
+void RecordingEngine::clear_(const core::Color& /*color*/) {
+    record_(RecordedCommandType::Clear);
+}
+
+UInt64 RecordingEngine::present_(
+    SwapChain* /*swapChain*/,
+    UInt32 /*syncInterval*/,
+    PresentFlags /*flags*/) {
+
+    record_(RecordedCommandType::Present);
+    return std::chrono::nanoseconds(std::chrono::steady_clock::now() - engineStartTime())
+        .count();
+}
+
+// Private methods
+
+void RecordingEngine::record_(
+    RecordedCommandType type,
+    Int numBytes,
+    Int numVertices,
+    Int numInstances) {
+
+    ++numCommandsPerType_[core::toUnderlying(type)];
+    numUploadedBytes_ += numBytes;
+    numDrawnVertices_ += numVertices * (std::max)(Int(1), numInstances);
+    if (isCommandRecordingEnabled_) {
+        commands_.emplaceLast(type, numBytes, numVertices, numInstances);
+    }
+}
+
+} // namespace vgc::graphics
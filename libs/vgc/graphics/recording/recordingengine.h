@@ -0,0 +1,335 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef VGC_GRAPHICS_RECORDING_RECORDINGENGINE_H
+#define VGC_GRAPHICS_RECORDING_RECORDINGENGINE_H
+
+#include <array>
+
+#include <vgc/core/array.h>
+#include <vgc/graphics/api.h>
+#include <vgc/graphics/engine.h>
+
+namespace vgc::graphics {
+
+VGC_DECLARE_OBJECT(RecordingEngine);
+
+/// \enum vgc::graphics::RecordedCommandType
+/// \brief The type of a command recorded by a `RecordingEngine`.
+///
+/// Each value corresponds to one of the render thread implementation
+/// functions of `Engine`.
+///
+enum class RecordedCommandType : UInt8 {
+    InitFramebuffer,
+    InitBuffer,
+    InitImage,
+    InitImageView,
+    InitSamplerState,
+    InitGeometryView,
+    InitBlendState,
+    InitRasterizerState,
+    SetSwapChain,
+    SetFramebuffer,
+    SetViewport,
+    SetProgram,
+    SetBlendState,
+    SetRasterizerState,
+    SetStageConstantBuffers,
+    SetStageImageViews,
+    SetStageSamplers,
+    UpdateBufferData,
+    UpdateImageData,
+    UploadTransientVertexData,
+    FenceTransientVertexData,
+    Draw,
+    Clear,
+    Present
+};
+
+inline constexpr Int numRecordedCommandTypes =
+    core::toUnderlying(RecordedCommandType::Present) + 1;
+
+/// \class vgc::graphics::RecordedCommand
+/// \brief A command recorded by a `RecordingEngine`.
+///
+class VGC_GRAPHICS_API RecordedCommand {
+public:
+    /// Creates a `RecordedCommand`.
+    ///
+    RecordedCommand(
+        RecordedCommandType type,
+        Int numBytes = 0,
+        Int numVertices = 0,
+        Int numInstances = 0)
+
+        : type_(type)
+        , numBytes_(numBytes)
+        , numVertices_(numVertices)
+        , numInstances_(numInstances) {
+    }
+
+    /// Returns the type of this command.
+    ///
+    RecordedCommandType type() const {
+        return type_;
+    }
+
+    /// Returns the number of bytes uploaded by this command, for
+    /// `InitBuffer`, `InitImage`, `UpdateBufferData`, `UpdateImageData`, and
+    /// `UploadTransientVertexData` commands.
+    ///
+    Int numBytes() const {
+        return numBytes_;
+    }
+
+    /// Returns the number of vertices (or indices) drawn by this command, for
+    /// `Draw` commands.
+    ///
+    Int numVertices() const {
+        return numVertices_;
+    }
+
+    /// Returns the number of instances drawn by this command, for `Draw`
+    /// commands.
+    ///
+    Int numInstances() const {
+        return numInstances_;
+    }
+
+private:
+    RecordedCommandType type_;
+    Int numBytes_;
+    Int numVertices_;
+    Int numInstances_;
+};
+
+/// \class vgc::graphics::RecordingEngine
+/// \brief A graphics::Engine that records commands instead of rendering.
+///
+/// This class is an implementation of Engine which does not use any graphics
+/// API and does not require a GPU or a window. Instead of issuing API calls,
+/// it records the commands it receives from the render thread (or from the
+/// user thread if multithreading is disabled), as well as statistics such as
+/// the number of draw calls and the number of uploaded bytes.
+///
+/// This makes it possible to run, test, and benchmark drawing code such as
+/// `ui::Widget::paint()` on headless machines, without measuring the cost
+/// of the driver or GPU.
+///
+/// ```cpp
+/// RecordingEnginePtr engine = RecordingEngine::create(EngineCreateInfo());
+/// SwapChainPtr swapChain = engine->createSwapChain(SwapChainCreateInfo());
+/// engine->beginFrame(swapChain);
+/// widget->paint(engine.get());
+/// engine->endFrame();
+/// engine->flushWait();
+/// std::cout << engine->numCommands(RecordedCommandType::Draw) << " draw calls";
+/// ```
+///
+/// The recorded data is written by the render thread, so when multithreading
+/// is enabled, you should call `flushWait()` before accessing it.
+///
+class VGC_GRAPHICS_API RecordingEngine final : public Engine {
+private:
+    VGC_OBJECT(RecordingEngine, Engine)
+
+protected:
+    RecordingEngine(const EngineCreateInfo& createInfo);
+
+    void onDestroyed() override;
+
+public:
+    /// Creates a new RecordingEngine.
+    ///
+    static RecordingEnginePtr create(const EngineCreateInfo& createInfo);
+
+    /// Returns whether the sequence of commands is recorded. If false, only
+    /// the statistics (number of commands, bytes, and vertices) are updated.
+    ///
+    /// This is true by default.
+    ///
+    bool isCommandRecordingEnabled() const {
+        return isCommandRecordingEnabled_;
+    }
+
+    /// Sets whether the sequence of commands is recorded. Disabling it is
+    /// useful for long benchmarks, since memory usage then stays constant.
+    ///
+    void setCommandRecordingEnabled(bool enabled) {
+        isCommandRecordingEnabled_ = enabled;
+    }
+
+    /// Returns the commands recorded since the engine was created or since
+    /// the last call to `resetRecording()`.
+    ///
+    const core::Array<RecordedCommand>& commands() const {
+        return commands_;
+    }
+
+    /// Returns the total number of commands executed.
+    ///
+    Int numCommands() const;
+
+    /// Returns the number of commands of the given type executed.
+    ///
+    Int numCommands(RecordedCommandType type) const {
+        return numCommandsPerType_[core::toUnderlying(type)];
+    }
+
+    /// Returns the total number of bytes uploaded by `InitBuffer`,
+    /// `InitImage`, `UpdateBufferData`, `UpdateImageData`, and
+    /// `UploadTransientVertexData` commands.
+    ///
+    Int numUploadedBytes() const {
+        return numUploadedBytes_;
+    }
+
+    /// Returns the total number of vertices drawn by `Draw` commands,
+    /// counting each instance separately.
+    ///
+    Int numDrawnVertices() const {
+        return numDrawnVertices_;
+    }
+
+    /// Clears the recorded commands and sets all statistics to zero.
+    ///
+    void resetRecording();
+
+protected:
+    // Implementation of Engine API
+
+    // -- USER THREAD implementation functions --
+
+    void createBuiltinShaders_() override;
+
+    SwapChainPtr constructSwapChain_(const SwapChainCreateInfo& createInfo) override;
+    FramebufferPtr constructFramebuffer_(const ImageViewPtr& colorImageView) override;
+    BufferPtr constructBuffer_(const BufferCreateInfo& createInfo) override;
+    ImagePtr constructImage_(const ImageCreateInfo& createInfo) override;
+    ImageViewPtr constructImageView_(
+        const ImageViewCreateInfo& createInfo,
+        const ImagePtr& image) override;
+    ImageViewPtr constructImageView_(
+        const ImageViewCreateInfo& createInfo,
+        const BufferPtr& buffer,
+        PixelFormat format,
+        UInt32 numElements) override;
+    SamplerStatePtr
+    constructSamplerState_(const SamplerStateCreateInfo& createInfo) override;
+    GeometryViewPtr
+    constructGeometryView_(const GeometryViewCreateInfo& createInfo) override;
+    BlendStatePtr constructBlendState_(const BlendStateCreateInfo& createInfo) override;
+    RasterizerStatePtr
+    constructRasterizerState_(const RasterizerStateCreateInfo& createInfo) override;
+
+    void resizeSwapChain_(SwapChain* swapChain, UInt32 width, UInt32 height) override;
+
+    //--  RENDER THREAD implementation functions --
+
+    void initContext_() override {
+    }
+
+    void initBuiltinResources_() override {
+    }
+
+    void initFramebuffer_(Framebuffer* framebuffer) override;
+    void initBuffer_(Buffer* buffer, const char* data, Int lengthInBytes) override;
+    void initImage_(
+        Image* image,
+        const Span<const char>* mipLevelDataSpans,
+        Int numMipLevels) override;
+    void initImageView_(ImageView* view) override;
+    void initSamplerState_(SamplerState* state) override;
+    void initGeometryView_(GeometryView* view) override;
+    void initBlendState_(BlendState* state) override;
+    void initRasterizerState_(RasterizerState* state) override;
+
+    void setSwapChain_(const SwapChainPtr& swapChain) override;
+    void setFramebuffer_(const FramebufferPtr& framebuffer) override;
+    void setViewport_(Int x, Int y, Int width, Int height) override;
+    void setProgram_(const ProgramPtr& program) override;
+    void setBlendState_(const BlendStatePtr& state, const geometry::Vec4f& blendFactor)
+        override;
+    void setRasterizerState_(const RasterizerStatePtr& state) override;
+    void setStageConstantBuffers_(
+        const BufferPtr* buffers,
+        Int startIndex,
+        Int count,
+        ShaderStage shaderStage) override;
+    void setStageImageViews_(
+        const ImageViewPtr* views,
+        Int startIndex,
+        Int count,
+        ShaderStage shaderStage) override;
+    void setStageSamplers_(
+        const SamplerStatePtr* states,
+        Int startIndex,
+        Int count,
+        ShaderStage shaderStage) override;
+
+    void updateBufferData_(Buffer* buffer, const void* data, Int lengthInBytes) override;
+
+    void updateImageData_(
+        Image* image,
+        Int x,
+        Int y,
+        Int width,
+        Int height,
+        const void* data,
+        Int lengthInBytes) override;
+
+    void uploadTransientVertexData_(
+        Buffer* buffer,
+        Int regionIndex,
+        Int offsetInBytes,
+        const void* data,
+        Int lengthInBytes) override;
+    void fenceTransientVertexData_(Buffer* buffer, Int regionIndex) override;
+
+    void draw_(
+        GeometryView* view,
+        UInt numIndices,
+        UInt numInstances,
+        UInt startVertex) override;
+    void clear_(const core::Color& color) override;
+
+    UInt64
+    present_(SwapChain* swapChain, UInt32 syncInterval, PresentFlags flags) override;
+
+private:
+    bool isCommandRecordingEnabled_ = true;
+    core::Array<RecordedCommand> commands_;
+    std::array<Int, numRecordedCommandTypes> numCommandsPerType_ = {};
+    Int numUploadedBytes_ = 0;
+    Int numDrawnVertices_ = 0;
+
+    template<typename T, typename... Args>
+    [[nodiscard]] std::unique_ptr<T> makeUnique(Args&&... args) {
+        return std::unique_ptr<T>(new T(std::forward<Args>(args)...));
+    }
+
+    void record_(
+        RecordedCommandType type,
+        Int numBytes = 0,
+        Int numVertices = 0,
+        Int numInstances = 0);
+};
+
+} // namespace vgc::graphics
+
+#endif // VGC_GRAPHICS_RECORDING_RECORDINGENGINE_H
@@ -332,10 +332,25 @@ float getDescent(const RichTextSpan* span, SizedFont* sizedFont) {
 } // namespace
 
 void RichText::fill(core::FloatArray& a) const {
+    fill_(a, nullptr, nullptr);
+}
+
+bool RichText::fill(
+    core::FloatArray& a,
+    core::Array<TextAtlasVertex>& quads,
+    GlyphAtlas& atlas) const {
+
+    return fill_(a, &quads, &atlas);
+}
+
+bool RichText::fill_(
+    core::FloatArray& a,
+    core::Array<TextAtlasVertex>* quads,
+    GlyphAtlas* atlas) const {
 
     // Early return if nothing to draw
     if (shapedText_.text().length() == 0 && !isCursorVisible_) {
-        return;
+        return true;
     }
 
     // Get style attributes
@@ -451,26 +466,34 @@ void RichText::fill(core::FloatArray& a) const {
         }
     }
 
-    // Draw text
+    // Draw text, either as triangles or as glyph atlas quads
     geometry::Vec2f origin(textLeft, baseline);
+    bool hasAllGlyphs = true;
+    auto fillGlyphs = [&](float cr, float cg, float cb, Int start, Int end) {
+        // clang-format off
+        if (quads) {
+            hasAllGlyphs &= shapedText_.fillAtlasQuads(
+                *quads, *atlas, origin, cr, cg, cb, start, end,
+                clipLeft, clipRight, clipTop, clipBottom);
+        }
+        else {
+            shapedText_.fill(
+                a, origin, cr, cg, cb, start, end,
+                clipLeft, clipRight, clipTop, clipBottom);
+        }
+        // clang-format on
+    };
+    Int numGlyphs = shapedText_.glyphs().length();
     if (hasVisibleSelection) {
         if (selectionBeginGlyph > selectionEndGlyph) {
             std::swap(selectionBeginGlyph, selectionEndGlyph);
         }
-        // clang-format off
-        shapedText_.fill(
-            a, origin, r, g, b, 0, selectionBeginGlyph,
-            clipLeft, clipRight, clipTop, clipBottom);
-        shapedText_.fill(
-            a, origin, sr, sg, sb, selectionBeginGlyph, selectionEndGlyph,
-            clipLeft, clipRight, clipTop, clipBottom);
-        shapedText_.fill(
-            a, origin, r, g, b, selectionEndGlyph, shapedText_.glyphs().length(),
-            clipLeft, clipRight, clipTop, clipBottom);
-        // clang-format on
+        fillGlyphs(r, g, b, 0, selectionBeginGlyph);
+        fillGlyphs(sr, sg, sb, selectionBeginGlyph, selectionEndGlyph);
+        fillGlyphs(r, g, b, selectionEndGlyph, numGlyphs);
     }
     else {
-        shapedText_.fill(a, origin, r, g, b, clipLeft, clipRight, clipTop, clipBottom);
+        fillGlyphs(r, g, b, 0, numGlyphs);
     }
 
     // Draw cursor
@@ -499,6 +522,7 @@ void RichText::fill(core::FloatArray& a) const {
             }
         }
     }
+    return hasAllGlyphs;
 }
 
 Int RichText::movedPosition(
@@ -231,6 +231,20 @@ public:
     ///
     void fill(core::FloatArray& a) const;
 
+    /// Inserts to the given `FloatArray` the triangles of the selection
+    /// background and cursor of this `RichText`, and to the given `quads` the
+    /// glyph quads of its text, using the given `atlas` to store the glyphs
+    /// (see `Engine::drawText()`). The quads are meant to be drawn after the
+    /// triangles.
+    ///
+    /// Returns false if some glyphs could not be inserted in the atlas, in
+    /// which case these glyphs are skipped.
+    ///
+    bool fill(
+        core::FloatArray& a,
+        core::Array<TextAtlasVertex>& quads,
+        GlyphAtlas& atlas) const;
+
     /// Returns whether the cursor is visible.
     ///
     bool isCursorVisible() const {
@@ -439,6 +453,10 @@ private:
     float maxCursorHorizontalAdvance_() const;
     void updateScroll_();
     void insertText_(std::string_view text);
+    bool fill_(
+        core::FloatArray& a,
+        core::Array<TextAtlasVertex>* quads,
+        GlyphAtlas* atlas) const;
 };
 
 } // namespace vgc::graphics
@@ -0,0 +1,155 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <vgc/core/exceptions.h>
+#include <vgc/graphics/batch.h>
+
+using vgc::core::FloatArray;
+using vgc::geometry::Mat4f;
+using vgc::geometry::Rect2f;
+using vgc::geometry::Vec2f;
+using vgc::graphics::BatchedTriangles;
+using vgc::graphics::BuiltinGeometryLayout;
+using vgc::graphics::GeometryBatch;
+using vgc::graphics::TextAtlasVertex;
+using vgc::graphics::TextBatch;
+
+TEST(TestGeometryBatch, Append) {
+    GeometryBatch batch;
+    EXPECT_TRUE(batch.isEmpty());
+
+    FloatArray vertex = {1, 2, 0.5f, 0.5f, 0.5f};
+    Mat4f m = Mat4f::identity;
+    batch.append(BuiltinGeometryLayout::XYRGB, vertex, m);
+    m.translate(10, 20);
+    batch.append(BuiltinGeometryLayout::XYRGB, vertex, m);
+    EXPECT_EQ(batch.layout(), BuiltinGeometryLayout::XYRGB);
+    EXPECT_EQ(batch.numVertices(), 2);
+
+    FloatArray expected = {1, 2, 0.5f, 0.5f, 0.5f, 11, 22, 0.5f, 0.5f, 0.5f};
+    EXPECT_EQ(batch.data(), expected);
+
+    // Layouts cannot be mixed
+    EXPECT_THROW(
+        batch.append(BuiltinGeometryLayout::XY, FloatArray{0, 0}, m),
+        vgc::core::LogicError);
+
+    batch.clear();
+    EXPECT_TRUE(batch.isEmpty());
+    batch.append(BuiltinGeometryLayout::XY, FloatArray{0, 0}, m);
+    EXPECT_EQ(batch.numVertices(), 1);
+}
+
+TEST(TestGeometryBatch, BatchedTriangles) {
+    BatchedTriangles a;
+    BatchedTriangles b;
+    EXPECT_NE(a.id(), b.id());
+    a.setVertices(FloatArray{1, 2, 0.5f, 0.5f, 0.5f});
+    b.setVertices(FloatArray{3, 4, 0.5f, 0.5f, 0.5f});
+
+    // The transformed vertices are cached until the vertices or transform
+    // change.
+    Mat4f m = Mat4f::identity;
+    m.translate(10, 20);
+    EXPECT_EQ(a.transformedVertices(m), FloatArray({11, 22, 0.5f, 0.5f, 0.5f}));
+    vgc::UInt64 version = a.transformedVersion();
+    a.transformedVertices(m);
+    EXPECT_EQ(a.transformedVersion(), version);
+    a.transformedVertices(Mat4f::identity);
+    EXPECT_NE(a.transformedVersion(), version);
+    version = a.transformedVersion();
+    a.setVertices(FloatArray{5, 6, 0.5f, 0.5f, 0.5f});
+    EXPECT_EQ(a.transformedVertices(Mat4f::identity), a.vertices());
+    EXPECT_NE(a.transformedVersion(), version);
+
+    // The content key identifies the appended BatchedTriangles
+    GeometryBatch batch1;
+    GeometryBatch batch2;
+    batch1.append(a, m);
+    batch1.append(b, m);
+    batch2.append(a, m);
+    batch2.append(b, m);
+    EXPECT_FALSE(batch1.contentKey().isEmpty());
+    EXPECT_EQ(batch1.contentKey(), batch2.contentKey());
+    EXPECT_EQ(batch1.data(), batch2.data());
+
+    batch2.clear();
+    batch2.append(b, m);
+    batch2.append(a, m);
+    EXPECT_NE(batch1.contentKey(), batch2.contentKey());
+
+    // Vertices appended from a FloatArray can't be identified
+    batch2.clear();
+    batch2.append(a, m);
+    batch2.append(BuiltinGeometryLayout::XYRGB, b.vertices(), m);
+    EXPECT_TRUE(batch2.contentKey().isEmpty());
+    batch2.append(b, m);
+    EXPECT_TRUE(batch2.contentKey().isEmpty());
+}
+
+TEST(TestGeometryBatch, IsBatchable) {
+    Mat4f m = Mat4f::identity;
+    m.translate(1, 2);
+    EXPECT_TRUE(GeometryBatch::isBatchable(BuiltinGeometryLayout::XYRGB, m));
+    m.translate(0, 0, 1);
+    EXPECT_FALSE(GeometryBatch::isBatchable(BuiltinGeometryLayout::XYRGB, m));
+    EXPECT_TRUE(GeometryBatch::isBatchable(BuiltinGeometryLayout::XYZ, m));
+    m(3, 0) = 1; // projective
+    EXPECT_FALSE(GeometryBatch::isBatchable(BuiltinGeometryLayout::XYZ, m));
+}
+
+TEST(TestGeometryBatch, BoundingRect) {
+    FloatArray vertices = {1, 2, 0.5f, 0.5f, 0.5f, 3, 5, 0.5f, 0.5f, 0.5f};
+    Mat4f m = Mat4f::identity;
+    m.translate(10, 20);
+    m.scale(2);
+    Rect2f rect = GeometryBatch::boundingRect(BuiltinGeometryLayout::XYRGB, vertices, m);
+    EXPECT_EQ(rect, Rect2f(12, 24, 16, 30));
+    rect = GeometryBatch::boundingRect(BuiltinGeometryLayout::XYRGB, FloatArray{}, m);
+    EXPECT_TRUE(rect.isEmpty());
+}
+
+TEST(TestTextBatch, Append) {
+    TextBatch batch;
+    EXPECT_TRUE(batch.isEmpty());
+    EXPECT_TRUE(batch.boundingRect().isEmpty());
+
+    vgc::core::Array<TextAtlasVertex> quads(1);
+    quads[0].position = Vec2f(1, 2);
+    quads[0].size = Vec2f(3, 4);
+    Mat4f m = Mat4f::identity;
+    batch.append(quads, m);
+    m.translate(10, 20);
+    m.scale(2);
+    batch.append(quads, m);
+    ASSERT_EQ(batch.numQuads(), 2);
+    EXPECT_EQ(batch.quads()[0].position, Vec2f(1, 2));
+    EXPECT_EQ(batch.quads()[1].position, Vec2f(12, 24));
+    EXPECT_EQ(batch.quads()[1].size, Vec2f(6, 8));
+    EXPECT_EQ(batch.boundingRect(), Rect2f(1, 2, 18, 32));
+
+    // Rotations cannot be batched
+    EXPECT_TRUE(TextBatch::isBatchable(m));
+    m.rotate(1);
+    EXPECT_FALSE(TextBatch::isBatchable(m));
+    EXPECT_THROW(batch.append(quads, m), vgc::core::LogicError);
+
+    batch.clear();
+    EXPECT_TRUE(batch.isEmpty());
+    EXPECT_TRUE(batch.boundingRect().isEmpty());
+}
@@ -0,0 +1,284 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <vgc/core/array.h>
+#include <vgc/core/format.h>
+#include <vgc/core/stopwatch.h>
+#include <vgc/graphics/detail/command.h>
+
+using vgc::Int;
+using vgc::graphics::Engine;
+using vgc::graphics::detail::Command;
+using vgc::graphics::detail::CommandStream;
+
+namespace {
+
+// Appends its value to the given array when executed.
+//
+class AppendCommand : public Command {
+public:
+    AppendCommand(vgc::core::IntArray* out, Int value)
+        : Command("append")
+        , out_(out)
+        , value_(value) {
+    }
+
+    void execute(Engine*) override {
+        out_->append(value_);
+    }
+
+private:
+    vgc::core::IntArray* out_;
+    Int value_;
+};
+
+// Command with an odd size, used to misalign the next allocation.
+//
+class SmallCommand : public Command {
+public:
+    SmallCommand()
+        : Command("small") {
+    }
+
+    void execute(Engine*) override {
+    }
+
+private:
+    char c_[3] = {};
+};
+
+// Command with the strictest alignment supported by the stream.
+//
+class alignas(alignof(std::max_align_t)) AlignedCommand : public Command {
+public:
+    AlignedCommand()
+        : Command("aligned") {
+    }
+
+    void execute(Engine*) override {
+    }
+};
+
+// Command with a large payload, used to fill blocks quickly.
+//
+class LargeCommand : public Command {
+public:
+    LargeCommand()
+        : Command("large") {
+    }
+
+    void execute(Engine*) override {
+    }
+
+private:
+    char data_[1000] = {};
+};
+
+// Command with a non-trivial member and destructor, counting destructions.
+//
+class CountedCommand : public Command {
+public:
+    CountedCommand(Int* numDestroyed, std::string text)
+        : Command("counted")
+        , numDestroyed_(numDestroyed)
+        , text_(std::move(text)) {
+    }
+
+    ~CountedCommand() override {
+        ++(*numDestroyed_);
+    }
+
+    void execute(Engine*) override {
+    }
+
+    const std::string& text() const {
+        return text_;
+    }
+
+private:
+    Int* numDestroyed_;
+    std::string text_;
+};
+
+} // namespace
+
+TEST(TestCommandStream, ExecuteInOrder) {
+    vgc::core::IntArray out;
+    CommandStream stream;
+    EXPECT_TRUE(stream.isEmpty());
+    for (Int i = 0; i < 10; ++i) {
+        stream.emplaceLast<AppendCommand>(&out, i);
+    }
+    EXPECT_EQ(stream.length(), 10);
+    stream.execute(nullptr);
+    EXPECT_EQ(out, vgc::core::IntArray({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST(TestCommandStream, Alignment) {
+    CommandStream stream;
+    for (Int i = 0; i < 100; ++i) {
+        stream.emplaceLast<SmallCommand>();
+        stream.emplaceLast<AlignedCommand>();
+    }
+    Int numAligned = 0;
+    stream.forEach([&](Command* command) {
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(command);
+        if (dynamic_cast<AlignedCommand*>(command)) {
+            EXPECT_EQ(address % alignof(AlignedCommand), 0u);
+            ++numAligned;
+        }
+        else {
+            EXPECT_EQ(address % alignof(SmallCommand), 0u);
+        }
+    });
+    EXPECT_EQ(numAligned, 100);
+}
+
+TEST(TestCommandStream, GrowAcrossBlocks) {
+    vgc::core::IntArray out;
+    CommandStream stream;
+    EXPECT_EQ(stream.numBlocks(), 0);
+
+    // 200 commands of about 1 KiB don't fit in one 64 KiB block.
+    for (Int i = 0; i < 200; ++i) {
+        stream.emplaceLast<LargeCommand>();
+        stream.emplaceLast<AppendCommand>(&out, i);
+    }
+    EXPECT_GE(stream.numBlocks(), 3);
+    EXPECT_EQ(stream.length(), 400);
+
+    // Commands spanning several blocks are still executed in order.
+    stream.execute(nullptr);
+    ASSERT_EQ(out.length(), 200);
+    for (Int i = 0; i < 200; ++i) {
+        EXPECT_EQ(out[i], i);
+    }
+}
+
+TEST(TestCommandStream, Destructors) {
+    Int numDestroyed = 0;
+    {
+        CommandStream stream;
+        for (Int i = 0; i < 5; ++i) {
+            // Strings longer than the small string buffer are heap-allocated,
+            // so a missing destructor call would also be reported as a leak.
+            stream.emplaceLast<CountedCommand>(
+                &numDestroyed, std::string(100, static_cast<char>('a' + i)));
+        }
+        Int i = 0;
+        stream.forEach([&](Command* command) {
+            auto counted = static_cast<CountedCommand*>(command);
+            EXPECT_EQ(counted->text(), std::string(100, static_cast<char>('a' + i)));
+            ++i;
+        });
+        EXPECT_EQ(numDestroyed, 0);
+
+        stream.clear();
+        EXPECT_EQ(numDestroyed, 5);
+        EXPECT_TRUE(stream.isEmpty());
+
+        stream.emplaceLast<CountedCommand>(&numDestroyed, "x");
+        stream.emplaceLast<CountedCommand>(&numDestroyed, "y");
+    }
+    // The stream destructor destroys the remaining commands.
+    EXPECT_EQ(numDestroyed, 7);
+
+    // Moving a stream transfers ownership of its commands.
+    numDestroyed = 0;
+    {
+        CommandStream a;
+        a.emplaceLast<CountedCommand>(&numDestroyed, "a");
+        CommandStream b(std::move(a));
+        EXPECT_TRUE(a.isEmpty());
+        EXPECT_EQ(b.length(), 1);
+        a.clear();
+        EXPECT_EQ(numDestroyed, 0);
+    }
+    EXPECT_EQ(numDestroyed, 1);
+}
+
+TEST(TestCommandStream, ReuseAfterClear) {
+    CommandStream stream;
+    vgc::core::Array<Command*> firstPointers;
+    for (Int i = 0; i < 200; ++i) {
+        stream.emplaceLast<LargeCommand>();
+    }
+    Int numBlocks = stream.numBlocks();
+    stream.forEach([&](Command* command) { firstPointers.append(command); });
+
+    // Recording the same commands again re-uses the same memory, in the
+    // same order, without allocating new blocks.
+    for (Int frame = 0; frame < 3; ++frame) {
+        stream.clear();
+        EXPECT_EQ(stream.numBlocks(), numBlocks);
+        for (Int i = 0; i < 200; ++i) {
+            stream.emplaceLast<LargeCommand>();
+        }
+        EXPECT_EQ(stream.numBlocks(), numBlocks);
+        Int i = 0;
+        stream.forEach([&](Command* command) {
+            EXPECT_EQ(command, firstPointers[i]);
+            ++i;
+        });
+    }
+
+    // Recording fewer commands than before also doesn't allocate.
+    stream.clear();
+    vgc::core::IntArray out;
+    stream.emplaceLast<AppendCommand>(&out, 42);
+    EXPECT_EQ(stream.numBlocks(), numBlocks);
+    stream.execute(nullptr);
+    EXPECT_EQ(out, vgc::core::IntArray({42}));
+}
+
+#ifndef VGC_DEBUG_BUILD
+
+TEST(TestCommandStream, Perf) {
+    vgc::core::IntArray out;
+    out.reserve(10000);
+    CommandStream stream;
+    Int numFrames = 1000;
+    Int numCommandsPerFrame = 10000;
+    vgc::core::Stopwatch s;
+    for (Int frame = 0; frame < numFrames; ++frame) {
+        out.clear();
+        for (Int i = 0; i < numCommandsPerFrame; ++i) {
+            stream.emplaceLast<AppendCommand>(&out, i);
+        }
+        stream.execute(nullptr);
+        stream.clear();
+    }
+    double elapsed = s.elapsed();
+    EXPECT_EQ(out.length(), numCommandsPerFrame);
+    vgc::core::print(
+        "{} frames of {} commands = {:.7f} sec ({:.1f} ns/command).\n",
+        numFrames,
+        numCommandsPerFrame,
+        elapsed,
+        elapsed * 1e9 / static_cast<double>(numFrames * numCommandsPerFrame));
+}
+
+#endif // VGC_DEBUG_BUILD
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
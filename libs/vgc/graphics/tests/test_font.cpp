@@ -0,0 +1,156 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <vgc/core/paths.h>
+#include <vgc/geometry/curves2d.h>
+#include <vgc/graphics/font.h>
+
+using vgc::Int;
+using vgc::UInt32;
+using vgc::core::DoubleArray;
+using vgc::geometry::Curves2d;
+using vgc::geometry::FillMethod;
+using vgc::geometry::Vec2d;
+using vgc::geometry::WindingRule;
+
+namespace {
+
+struct Mesh {
+    DoubleArray vertices;
+    vgc::core::Array<UInt32> indices;
+
+    Vec2d vertex(UInt32 index) const {
+        return Vec2d(vertices[2 * index], vertices[2 * index + 1]);
+    }
+};
+
+Mesh fill(const Curves2d& outline, FillMethod method) {
+    Mesh res;
+    outline.fill(
+        res.vertices,
+        res.indices,
+        vgc::geometry::Curves2dSampleParams::errorBounded(0.1),
+        WindingRule::NonZero,
+        method);
+    return res;
+}
+
+double area(const Mesh& mesh) {
+    double res = 0;
+    for (Int i = 0; i < mesh.indices.length(); i += 3) {
+        Vec2d a = mesh.vertex(mesh.indices[i]);
+        Vec2d b = mesh.vertex(mesh.indices[i + 1]);
+        Vec2d c = mesh.vertex(mesh.indices[i + 2]);
+        res += 0.5 * std::abs((b - a).det(c - a));
+    }
+    return res;
+}
+
+// Returns the number of triangles of the mesh containing p, with at least the
+// given distance between p and the edges of the triangle. A negative margin
+// also counts the triangles whose distance to p is less than -margin.
+//
+Int numTrianglesContaining(const Mesh& mesh, const Vec2d& p, double margin) {
+    Int res = 0;
+    for (Int i = 0; i < mesh.indices.length(); i += 3) {
+        Vec2d v[3] = {
+            mesh.vertex(mesh.indices[i]),
+            mesh.vertex(mesh.indices[i + 1]),
+            mesh.vertex(mesh.indices[i + 2])};
+        double orientation = (v[1] - v[0]).det(v[2] - v[0]) > 0 ? 1 : -1;
+        bool isInside = true;
+        for (Int j = 0; j < 3 && isInside; ++j) {
+            Vec2d edge = v[(j + 1) % 3] - v[j];
+            double length = edge.length();
+            isInside = length > 0 && orientation * edge.det(p - v[j]) / length >= margin;
+        }
+        if (isInside) {
+            ++res;
+        }
+    }
+    return res;
+}
+
+} // namespace
+
+// Checks that the triangulation of glyph outlines computed with
+// FillMethod::PolygonTriangulator covers the same region as the one computed
+// with FillMethod::Libtess2, on a corpus of glyphs from several fonts.
+//
+TEST(TestFont, FillMethodsOnGlyphCorpus) {
+    const char* styles[] = {"Regular", "It", "Bold", "Black", "ExtraLight"};
+    vgc::graphics::FontLibraryPtr fontLibrary = vgc::graphics::FontLibrary::create();
+    Int numGlyphs = 0;
+    for (const char* style : styles) {
+        std::string fontPath = vgc::core::resourcePath(
+            "graphics/fonts/SourceSansPro/TTF/SourceSansPro-" + std::string(style)
+            + ".ttf");
+        vgc::graphics::Font* font = fontLibrary->addFont(fontPath);
+        ASSERT_NE(font, nullptr);
+        vgc::graphics::SizedFont* sizedFont =
+            font->getSizedFont(vgc::graphics::SizedFontParams(
+                100, vgc::graphics::FontHinting::None));
+
+        // Printable characters of Basic Latin and Latin-1 Supplement.
+        for (Int codePoint = 0x21; codePoint <= 0xFF; ++codePoint) {
+            if (codePoint >= 0x7F && codePoint <= 0xA0) {
+                continue;
+            }
+            vgc::graphics::SizedGlyph* glyph =
+                sizedFont->getSizedGlyphFromCodePoint(codePoint);
+            if (!glyph || glyph->boundingBox().isEmpty()) {
+                continue;
+            }
+            ++numGlyphs;
+            SCOPED_TRACE(std::string(style) + " U+" + std::to_string(codePoint));
+            Mesh expected = fill(glyph->outline(), FillMethod::Libtess2);
+            Mesh actual = fill(glyph->outline(), FillMethod::PolygonTriangulator);
+            double expectedArea = area(expected);
+            EXPECT_NEAR(area(actual), expectedArea, 1e-4 * expectedArea);
+
+            // Compare the coverage of both triangulations on a grid of
+            // points, ignoring the points close to the boundary.
+            const vgc::geometry::Rect2f& box = glyph->boundingBox();
+            double margin = 1e-3 * (std::max)(box.width(), box.height());
+            const Int n = 16;
+            for (Int i = 0; i <= n; ++i) {
+                for (Int j = 0; j <= n; ++j) {
+                    Vec2d p(
+                        box.xMin() + box.width() * i / n,
+                        box.yMin() + box.height() * j / n);
+                    if (numTrianglesContaining(expected, p, margin) > 0) {
+                        EXPECT_GT(numTrianglesContaining(actual, p, -margin), 0);
+                    }
+                    if (numTrianglesContaining(actual, p, margin) > 0) {
+                        EXPECT_GT(numTrianglesContaining(expected, p, -margin), 0);
+                    }
+                    EXPECT_LE(numTrianglesContaining(actual, p, margin), 1);
+                }
+            }
+        }
+    }
+    EXPECT_GT(numGlyphs, 5 * 150);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
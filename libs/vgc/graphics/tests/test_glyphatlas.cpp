@@ -0,0 +1,183 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <vgc/core/exceptions.h>
+#include <vgc/graphics/glyphatlas.h>
+
+using vgc::Int;
+using vgc::UInt8;
+using vgc::core::Array;
+using vgc::geometry::Rect2f;
+using vgc::graphics::GlyphAtlas;
+using vgc::graphics::GlyphAtlasEntry;
+using vgc::graphics::GlyphBitmap;
+using vgc::graphics::SizedGlyph;
+using vgc::graphics::detail::SkylinePacker;
+
+namespace {
+
+// The atlas only uses glyph pointers as keys, without dereferencing them
+// (except in getOrInsert()), so we can use fake glyphs in these tests.
+SizedGlyph* fakeGlyph(Int i) {
+    return reinterpret_cast<SizedGlyph*>(static_cast<std::uintptr_t>(i + 1) * 64);
+}
+
+GlyphBitmap bitmap(Int width, Int height, UInt8 value = 255) {
+    return GlyphBitmap(width, height, 1, -height, Array<UInt8>(width * height, value));
+}
+
+} // namespace
+
+TEST(TestSkylinePacker, Insert) {
+    SkylinePacker packer(10, 10);
+    Int x = -1;
+    Int y = -1;
+    EXPECT_TRUE(packer.insert(4, 3, x, y));
+    EXPECT_EQ(x, 0);
+    EXPECT_EQ(y, 0);
+    EXPECT_TRUE(packer.insert(6, 5, x, y));
+    EXPECT_EQ(x, 4);
+    EXPECT_EQ(y, 0);
+
+    // Placed at the lowest position, that is, below the first rectangle
+    EXPECT_TRUE(packer.insert(4, 2, x, y));
+    EXPECT_EQ(x, 0);
+    EXPECT_EQ(y, 3);
+
+    // Spans two segments: placed below the highest of the two
+    EXPECT_TRUE(packer.insert(7, 5, x, y));
+    EXPECT_EQ(x, 0);
+    EXPECT_EQ(y, 5);
+
+    // No more room
+    EXPECT_FALSE(packer.insert(4, 4, x, y));
+    EXPECT_FALSE(packer.insert(11, 1, x, y));
+    EXPECT_TRUE(packer.insert(3, 5, x, y));
+    EXPECT_EQ(x, 7);
+    EXPECT_EQ(y, 5);
+
+    packer.clear();
+    EXPECT_TRUE(packer.insert(10, 10, x, y));
+    EXPECT_EQ(x, 0);
+    EXPECT_EQ(y, 0);
+}
+
+TEST(TestGlyphAtlas, Construct) {
+    GlyphAtlas atlas(64, 32, 16);
+    EXPECT_EQ(atlas.numPlots(), 8);
+    EXPECT_EQ(atlas.pixels().length(), 64 * 32);
+    EXPECT_THROW(GlyphAtlas(64, 30, 16), vgc::core::LogicError);
+    EXPECT_THROW(GlyphAtlas(64, 32, 0), vgc::core::LogicError);
+    EXPECT_THROW(bitmap(-1, 1), vgc::core::LogicError);
+    EXPECT_THROW(GlyphBitmap(2, 2, 0, 0, Array<UInt8>(3)), vgc::core::LogicError);
+}
+
+TEST(TestGlyphAtlas, Insert) {
+    GlyphAtlas atlas(32, 32, 16);
+    EXPECT_EQ(atlas.find(fakeGlyph(0)), nullptr);
+
+    const GlyphAtlasEntry* e = atlas.insert(fakeGlyph(0), bitmap(4, 8, 7));
+    ASSERT_NE(e, nullptr);
+    EXPECT_EQ(atlas.numEntries(), 1);
+    EXPECT_EQ(atlas.find(fakeGlyph(0)), e);
+    EXPECT_EQ(e->x(), 0);
+    EXPECT_EQ(e->y(), 0);
+    EXPECT_EQ(e->width(), 4);
+    EXPECT_EQ(e->height(), 8);
+    EXPECT_EQ(e->left(), 1);
+    EXPECT_EQ(e->top(), -8);
+    EXPECT_EQ(e->texCoords(), Rect2f(0, 0, 0.125f, 0.25f));
+    EXPECT_EQ(atlas.pixels()[3 * 32 + 3], 7);
+    EXPECT_EQ(atlas.pixels()[3 * 32 + 4], 0);
+
+    // Inserting the same glyph twice returns the existing entry
+    EXPECT_EQ(atlas.insert(fakeGlyph(0), bitmap(2, 2)), e);
+
+    // Glyphs are padded by one texel
+    const GlyphAtlasEntry* e2 = atlas.insert(fakeGlyph(1), bitmap(4, 4));
+    ASSERT_NE(e2, nullptr);
+    EXPECT_EQ(e2->x(), 5);
+    EXPECT_EQ(e2->y(), 0);
+
+    // Empty glyphs don't use any room
+    const GlyphAtlasEntry* e3 = atlas.insert(fakeGlyph(2), bitmap(0, 0));
+    ASSERT_NE(e3, nullptr);
+    EXPECT_TRUE(e3->isEmpty());
+    EXPECT_EQ(atlas.numEntries(), 3);
+
+    // Glyphs larger than a plot cannot be inserted
+    EXPECT_EQ(atlas.insert(fakeGlyph(3), bitmap(16, 4)), nullptr);
+}
+
+TEST(TestGlyphAtlas, DirtyRect) {
+    GlyphAtlas atlas(32, 32, 16);
+    EXPECT_FALSE(atlas.isDirty());
+    EXPECT_TRUE(atlas.dirtyRect().isEmpty());
+    atlas.insert(fakeGlyph(0), bitmap(4, 8));
+    atlas.insert(fakeGlyph(1), bitmap(3, 2));
+    EXPECT_TRUE(atlas.isDirty());
+    EXPECT_EQ(atlas.dirtyRect(), Rect2f(0, 0, 8, 8));
+    atlas.clearDirtyRect();
+    EXPECT_FALSE(atlas.isDirty());
+    atlas.find(fakeGlyph(0));
+    EXPECT_FALSE(atlas.isDirty());
+}
+
+TEST(TestGlyphAtlas, Eviction) {
+    // Four plots, each of which can hold exactly one 15x15 glyph (+ padding)
+    GlyphAtlas atlas(32, 32, 16);
+    for (Int i = 0; i < 4; ++i) {
+        EXPECT_NE(atlas.insert(fakeGlyph(i), bitmap(15, 15)), nullptr);
+    }
+
+    // All plots were used during the current frame: nothing can be evicted
+    EXPECT_EQ(atlas.insert(fakeGlyph(4), bitmap(15, 15)), nullptr);
+    EXPECT_EQ(atlas.numEntries(), 4);
+    EXPECT_EQ(atlas.numEvictions(), 0);
+
+    // Use all glyphs except glyph 2 in the next frame
+    atlas.beginFrame();
+    atlas.find(fakeGlyph(0));
+    atlas.find(fakeGlyph(1));
+    atlas.find(fakeGlyph(3));
+    const GlyphAtlasEntry* e2 = atlas.find(fakeGlyph(2));
+    Int x2 = e2->x();
+    Int y2 = e2->y();
+    atlas.beginFrame();
+    atlas.find(fakeGlyph(0));
+    atlas.find(fakeGlyph(1));
+    atlas.find(fakeGlyph(3));
+
+    // Glyph 2 is the least recently used: its plot is reused
+    atlas.clearDirtyRect();
+    const GlyphAtlasEntry* e4 = atlas.insert(fakeGlyph(4), bitmap(15, 15, 9));
+    ASSERT_NE(e4, nullptr);
+    EXPECT_EQ(e4->x(), x2);
+    EXPECT_EQ(e4->y(), y2);
+    EXPECT_EQ(atlas.find(fakeGlyph(2)), nullptr);
+    EXPECT_NE(atlas.find(fakeGlyph(0)), nullptr);
+    EXPECT_EQ(atlas.numEntries(), 4);
+    EXPECT_EQ(atlas.numEvictions(), 1);
+    EXPECT_EQ(atlas.dirtyRect(), Rect2f::fromPositionSize(x2, y2, 16, 16));
+    EXPECT_EQ(atlas.pixels()[y2 * 32 + x2], 9);
+
+    atlas.clear();
+    EXPECT_EQ(atlas.numEntries(), 0);
+    EXPECT_EQ(atlas.numEvictions(), 2);
+    EXPECT_EQ(atlas.pixels()[y2 * 32 + x2], 0);
+}
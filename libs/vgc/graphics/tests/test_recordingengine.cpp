@@ -0,0 +1,743 @@
+// Copyright 2022 The VGC Developers
+// See the COPYRIGHT file at the top-level directory of this distribution
+// and at https://github.com/vgc/vgc/blob/master/COPYRIGHT
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <vgc/graphics/recording/recordingengine.h>
+
+using vgc::Int;
+using vgc::geometry::Mat4f;
+using vgc::core::FloatArray;
+using vgc::graphics::BatchedTriangles;
+using vgc::graphics::BlendStateCreateInfo;
+using vgc::graphics::BlendStatePtr;
+using vgc::graphics::BuiltinGeometryLayout;
+using vgc::graphics::BuiltinProgram;
+using vgc::graphics::EngineCommandTimings;
+using vgc::graphics::EngineCreateInfo;
+using vgc::graphics::EngineFrameProfile;
+using vgc::graphics::EngineFrameStats;
+using vgc::graphics::EngineProfiler;
+using vgc::graphics::ProfiledThread;
+using vgc::graphics::GeometryViewPtr;
+using vgc::graphics::GlyphAtlas;
+using vgc::graphics::GlyphBitmap;
+using vgc::graphics::RecordedCommand;
+using vgc::graphics::RecordedCommandType;
+using vgc::graphics::RecordingEngine;
+using vgc::graphics::RecordingEnginePtr;
+using vgc::graphics::SecondaryCommandList;
+using vgc::graphics::Span;
+using vgc::graphics::SwapChainCreateInfo;
+using vgc::graphics::SwapChainPtr;
+using vgc::graphics::SizedGlyph;
+using vgc::graphics::TextAtlasVertex;
+
+namespace {
+
+// Draws two frames, each containing one triangle (3 vertices of 5 floats)
+// drawn twice.
+//
+void drawFrames(RecordingEngine* engine) {
+    SwapChainPtr swapChain = engine->createSwapChain(SwapChainCreateInfo());
+    GeometryViewPtr triangle =
+        engine->createDynamicTriangleListView(BuiltinGeometryLayout::XYRGB);
+    for (Int i = 0; i < 2; ++i) {
+        engine->beginFrame(swapChain);
+        engine->setProgram(BuiltinProgram::Simple);
+        engine->clear(vgc::core::Color(1, 1, 1));
+        engine->updateVertexBufferData(
+            triangle, FloatArray{0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1});
+        engine->draw(triangle, -1, 0);
+        engine->draw(triangle, -1, 0);
+        engine->endFrame();
+    }
+    engine->flushWait();
+}
+
+void testRecording(bool isMultithreadingEnabled, Int maxFramesInFlight = 3) {
+    EngineCreateInfo createInfo;
+    createInfo.setMultithreadingEnabled(isMultithreadingEnabled);
+    createInfo.setMaxFramesInFlight(maxFramesInFlight);
+    RecordingEnginePtr engine = RecordingEngine::create(createInfo);
+    engine->flushWait();
+    engine->resetRecording();
+    EXPECT_EQ(engine->numCommands(), 0);
+    EXPECT_TRUE(engine->commands().isEmpty());
+
+    drawFrames(engine.get());
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::Present), 2);
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::Draw), 4);
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::Clear), 2);
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::SetSwapChain), 1);
+    EXPECT_EQ(engine->numDrawnVertices(), 4 * 3);
+    EXPECT_GE(engine->numUploadedBytes(), 2 * 15 * Int(sizeof(float)));
+    EXPECT_EQ(engine->commands().length(), engine->numCommands());
+    EXPECT_EQ(engine->commands().last().type(), RecordedCommandType::Present);
+
+    Int numDraws = 0;
+    for (const vgc::graphics::RecordedCommand& command : engine->commands()) {
+        if (command.type() == RecordedCommandType::Draw) {
+            EXPECT_EQ(command.numVertices(), 3);
+            ++numDraws;
+        }
+    }
+    EXPECT_EQ(numDraws, 4);
+
+    // Statistics are still updated when command recording is disabled
+    engine->resetRecording();
+    engine->setCommandRecordingEnabled(false);
+    drawFrames(engine.get());
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::Draw), 4);
+    EXPECT_TRUE(engine->commands().isEmpty());
+}
+
+void testTransientVertices(bool isMultithreadingEnabled) {
+    EngineCreateInfo createInfo;
+    createInfo.setMultithreadingEnabled(isMultithreadingEnabled);
+    createInfo.setMaxFramesInFlight(1);
+    createInfo.setTransientVertexMemorySize(256); // 12 XYRGB vertices per frame
+    RecordingEnginePtr engine = RecordingEngine::create(createInfo);
+    SwapChainPtr swapChain = engine->createSwapChain(SwapChainCreateInfo());
+    GeometryViewPtr triangles =
+        engine->createTransientTriangleListView(BuiltinGeometryLayout::XYRGB);
+    engine->flushWait();
+    engine->resetRecording();
+
+    // With one frame in flight, frames alternate between two regions. The
+    // second region starts at byte 256, aligned up to 260 = 13 * 20.
+    const Int numFrames = 4;
+    for (Int i = 0; i < numFrames; ++i) {
+        Int firstVertex = (i % 2 == 0) ? 0 : 13;
+        engine->beginFrame(swapChain);
+        engine->setProgram(BuiltinProgram::Simple);
+        for (Int j = 0; j < 2; ++j) {
+            Int startVertex = -1;
+            Span<float> data =
+                engine->allocateTransientVertices(triangles, 6, startVertex);
+            ASSERT_EQ(data.length(), 6 * 5);
+            EXPECT_EQ(startVertex, firstVertex + j * 6);
+            for (float& x : data) {
+                x = 1;
+            }
+            engine->draw(triangles, 6, 0, startVertex);
+        }
+        Int startVertex = -1;
+        Span<float> data = engine->allocateTransientVertices(triangles, 1, startVertex);
+        EXPECT_EQ(data.length(), 0); // exhausted
+        engine->endFrame();
+    }
+    engine->flushWait();
+
+    using Type = RecordedCommandType;
+    EXPECT_EQ(engine->numCommands(Type::Draw), 2 * numFrames);
+    EXPECT_EQ(engine->numCommands(Type::UploadTransientVertexData), 2 * numFrames);
+    EXPECT_EQ(engine->numCommands(Type::FenceTransientVertexData), numFrames);
+    Int numTransientBytes = 0;
+    for (const vgc::graphics::RecordedCommand& command : engine->commands()) {
+        if (command.type() == Type::UploadTransientVertexData) {
+            numTransientBytes += command.numBytes();
+        }
+    }
+    EXPECT_EQ(numTransientBytes, numFrames * 12 * 5 * Int(sizeof(float)));
+    EXPECT_EQ(engine->numDrawnVertices(), numFrames * 12);
+}
+
+void testBatchedTriangles(bool isMultithreadingEnabled) {
+    EngineCreateInfo createInfo;
+    createInfo.setMultithreadingEnabled(isMultithreadingEnabled);
+    RecordingEnginePtr engine = RecordingEngine::create(createInfo);
+    SwapChainPtr swapChain = engine->createSwapChain(SwapChainCreateInfo());
+    engine->flushWait();
+    engine->resetRecording();
+
+    // Many "widgets" each drawing a triangle with their own view matrix
+    const Int numWidgets = 100;
+    FloatArray triangle = {0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1};
+    engine->beginFrame(swapChain);
+    engine->setProgram(BuiltinProgram::Simple);
+    for (Int i = 0; i < numWidgets; ++i) {
+        engine->pushViewMatrix();
+        Mat4f m = engine->viewMatrix();
+        m.translate(static_cast<float>(i), 0);
+        engine->setViewMatrix(m);
+        engine->drawBatchedTriangles(BuiltinGeometryLayout::XYRGB, triangle);
+        engine->popViewMatrix();
+    }
+    engine->endFrame();
+    engine->flushWait();
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::Draw), 1);
+    EXPECT_EQ(engine->numDrawnVertices(), numWidgets * 3);
+
+    // A regular draw or a pipeline state change splits the batch
+    GeometryViewPtr view =
+        engine->createDynamicTriangleListView(BuiltinGeometryLayout::XYRGB);
+    engine->updateVertexBufferData(view, triangle);
+    engine->resetRecording();
+    engine->beginFrame(swapChain);
+    engine->drawBatchedTriangles(BuiltinGeometryLayout::XYRGB, triangle);
+    engine->drawBatchedTriangles(BuiltinGeometryLayout::XYRGB, triangle);
+    engine->draw(view, -1, 0);
+    engine->drawBatchedTriangles(BuiltinGeometryLayout::XYRGB, triangle);
+    engine->setViewport(0, 0, 10, 10);
+    engine->drawBatchedTriangles(BuiltinGeometryLayout::XYRGB, triangle);
+    engine->endFrame();
+    engine->flushWait();
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::Draw), 4);
+    EXPECT_EQ(engine->numDrawnVertices(), 5 * 3);
+}
+
+void testRetainedBatches(bool isMultithreadingEnabled) {
+    EngineCreateInfo createInfo;
+    createInfo.setMultithreadingEnabled(isMultithreadingEnabled);
+    RecordingEnginePtr engine = RecordingEngine::create(createInfo);
+    SwapChainPtr swapChain = engine->createSwapChain(SwapChainCreateInfo());
+    engine->flushWait();
+
+    // Many "widgets" each storing a triangle, drawn with their own view
+    // matrix. The first widget can be moved via `offset`.
+    const Int numWidgets = 100;
+    const Int batchSizeInBytes = numWidgets * 15 * Int(sizeof(float));
+    FloatArray triangle = {0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1};
+    std::vector<std::unique_ptr<BatchedTriangles>> widgets;
+    for (Int i = 0; i < numWidgets; ++i) {
+        widgets.push_back(std::make_unique<BatchedTriangles>());
+        widgets.back()->setVertices(triangle);
+    }
+    float offset = 0;
+    auto drawFrame = [&]() {
+        engine->resetRecording();
+        engine->beginFrame(swapChain);
+        engine->setProgram(BuiltinProgram::Simple);
+        for (Int i = 0; i < numWidgets; ++i) {
+            engine->pushViewMatrix();
+            Mat4f m = engine->viewMatrix();
+            m.translate(static_cast<float>(i) + (i == 0 ? offset : 0), 0);
+            engine->setViewMatrix(m);
+            engine->drawBatchedTriangles(*widgets[i]);
+            engine->popViewMatrix();
+        }
+        engine->endFrame();
+        engine->flushWait();
+        EXPECT_EQ(engine->numCommands(RecordedCommandType::Draw), 1);
+        EXPECT_EQ(engine->numDrawnVertices(), numWidgets * 3);
+    };
+    auto numBatchUploads = [&]() {
+        Int res = 0;
+        for (const RecordedCommand& command : engine->commands()) {
+            if (command.type() == RecordedCommandType::UpdateBufferData
+                && command.numBytes() == batchSizeInBytes) {
+                ++res;
+            }
+        }
+        EXPECT_EQ(engine->numCommands(RecordedCommandType::UploadTransientVertexData), 0);
+        return res;
+    };
+
+    // The first frame uploads the batch
+    drawFrame();
+    EXPECT_EQ(numBatchUploads(), 1);
+
+    // A static frame neither transforms nor uploads the vertices again
+    vgc::UInt64 version = widgets[1]->transformedVersion();
+    drawFrame();
+    EXPECT_EQ(numBatchUploads(), 0);
+    EXPECT_EQ(widgets[1]->transformedVersion(), version);
+
+    // Changing the vertices of one widget uploads the batch again, but only
+    // re-transforms the vertices of this widget
+    triangle[2] = 0.5f;
+    widgets[5]->setVertices(triangle);
+    drawFrame();
+    EXPECT_EQ(numBatchUploads(), 1);
+    EXPECT_EQ(widgets[1]->transformedVersion(), version);
+    drawFrame();
+    EXPECT_EQ(numBatchUploads(), 0);
+
+    // Same when changing the view matrix of one widget
+    offset = 0.5f;
+    drawFrame();
+    EXPECT_EQ(numBatchUploads(), 1);
+    EXPECT_EQ(widgets[1]->transformedVersion(), version);
+    drawFrame();
+    EXPECT_EQ(numBatchUploads(), 0);
+}
+
+void testBuiltinConstants(bool isMultithreadingEnabled) {
+    EngineCreateInfo createInfo;
+    createInfo.setMultithreadingEnabled(isMultithreadingEnabled);
+    RecordingEnginePtr engine = RecordingEngine::create(createInfo);
+    SwapChainPtr swapChain = engine->createSwapChain(SwapChainCreateInfo());
+    FloatArray triangle = {0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1};
+    GeometryViewPtr view =
+        engine->createDynamicTriangleListView(BuiltinGeometryLayout::XYRGB);
+    engine->updateVertexBufferData(view, triangle);
+    engine->flushWait();
+    engine->resetRecording();
+
+    // Widgets with their own view matrix, interleaved with regular draws
+    // using the identity view matrix. Both the batches and the regular
+    // draws use an identity view matrix, so the builtin constants only
+    // need to be uploaded once.
+    const Int numWidgets = 100;
+    engine->beginFrame(swapChain);
+    engine->setProgram(BuiltinProgram::Simple);
+    for (Int i = 0; i < numWidgets; ++i) {
+        engine->pushViewMatrix();
+        Mat4f m = engine->viewMatrix();
+        m.translate(static_cast<float>(i), 0);
+        engine->setViewMatrix(m);
+        engine->drawBatchedTriangles(BuiltinGeometryLayout::XYRGB, triangle);
+        engine->popViewMatrix();
+        engine->draw(view, -1, 0);
+    }
+    engine->endFrame();
+    engine->flushWait();
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::Draw), 2 * numWidgets);
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::UpdateBufferData), 1);
+
+    // Builtin constants are uploaded again for each new frame, and for each
+    // regular draw with a different view matrix.
+    engine->resetRecording();
+    engine->beginFrame(swapChain);
+    engine->draw(view, -1, 0);
+    Mat4f m = Mat4f::identity;
+    m.translate(1, 0);
+    engine->setViewMatrix(m);
+    engine->draw(view, -1, 0);
+    engine->draw(view, -1, 0);
+    engine->setViewMatrix(Mat4f::identity);
+    engine->draw(view, -1, 0);
+    engine->endFrame();
+    engine->flushWait();
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::UpdateBufferData), 3);
+
+    // Only uploads identical to the last one are skipped: regular draws with
+    // a distinct view matrix per widget still upload the builtin constants
+    // once per widget, and so does going back to a previous matrix.
+    engine->resetRecording();
+    engine->beginFrame(swapChain);
+    for (Int i = 0; i < numWidgets; ++i) {
+        engine->pushViewMatrix();
+        Mat4f wm = engine->viewMatrix();
+        wm.translate(static_cast<float>(i), 0);
+        engine->setViewMatrix(wm);
+        engine->draw(view, -1, 0);
+        engine->draw(view, -1, 0);
+        engine->popViewMatrix();
+    }
+    engine->endFrame();
+    engine->flushWait();
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::Draw), 2 * numWidgets);
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::UpdateBufferData), numWidgets);
+
+    // Widgets drawing their geometry and text via drawBatchedTriangles() and
+    // drawText() have their view matrix applied on the CPU, so the builtin
+    // constants are uploaded once regardless of the number of widgets.
+    vgc::core::Array<TextAtlasVertex> quads(1);
+    quads[0].position = vgc::geometry::Vec2f(2, 0);
+    quads[0].size = vgc::geometry::Vec2f(10, 10);
+    engine->resetRecording();
+    engine->beginFrame(swapChain);
+    engine->setProgram(BuiltinProgram::Simple);
+    for (Int i = 0; i < numWidgets; ++i) {
+        engine->pushViewMatrix();
+        Mat4f wm = engine->viewMatrix();
+        wm.translate(static_cast<float>(20 * i), 0);
+        engine->setViewMatrix(wm);
+        engine->drawBatchedTriangles(BuiltinGeometryLayout::XYRGB, triangle);
+        engine->drawText(quads);
+        engine->popViewMatrix();
+    }
+    engine->endFrame();
+    engine->flushWait();
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::Draw), 2);
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::UpdateBufferData), 1);
+}
+
+void testRedundantStateChanges(bool isMultithreadingEnabled) {
+    EngineCreateInfo createInfo;
+    createInfo.setMultithreadingEnabled(isMultithreadingEnabled);
+    RecordingEnginePtr engine = RecordingEngine::create(createInfo);
+    SwapChainPtr swapChain = engine->createSwapChain(SwapChainCreateInfo());
+    FloatArray triangle = {0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1};
+    GeometryViewPtr view =
+        engine->createDynamicTriangleListView(BuiltinGeometryLayout::XYRGB);
+    engine->updateVertexBufferData(view, triangle);
+    engine->flushWait();
+    engine->resetRecording();
+
+    // Widgets setting the same program and viewport before each draw
+    const Int numWidgets = 10;
+    engine->beginFrame(swapChain);
+    for (Int i = 0; i < numWidgets; ++i) {
+        engine->setProgram(BuiltinProgram::Simple);
+        engine->setViewport(0, 0, 100, 100);
+        engine->draw(view, -1, 0);
+    }
+    engine->endFrame();
+    engine->flushWait();
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::Draw), numWidgets);
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::SetProgram), 1);
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::SetViewport), 1);
+    const EngineFrameStats& stats = engine->lastFrameStats();
+    EXPECT_EQ(stats.numDraws(), numWidgets);
+    EXPECT_EQ(stats.numSkippedStateChanges(), numWidgets - 1); // viewport
+
+    // Unordered draws alternating between two blend states are sorted by
+    // blend state.
+    BlendStatePtr blendStates[2] = {
+        engine->createBlendState(BlendStateCreateInfo()),
+        engine->createBlendState(BlendStateCreateInfo())};
+    engine->resetRecording();
+    engine->beginFrame(swapChain);
+    engine->beginUnorderedDraws();
+    for (Int i = 0; i < numWidgets; ++i) {
+        engine->setBlendState(blendStates[i % 2], vgc::geometry::Vec4f());
+        engine->draw(view, -1, 0);
+        engine->drawBatchedTriangles(BuiltinGeometryLayout::XYRGB, triangle);
+    }
+    engine->endUnorderedDraws();
+    engine->endFrame();
+    engine->flushWait();
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::Draw), 2 * numWidgets);
+    EXPECT_EQ(engine->numCommands(RecordedCommandType::SetBlendState), 2);
+    EXPECT_EQ(engine->numDrawnVertices(), 2 * numWidgets * 3);
+    EXPECT_FALSE(engine->areDrawsUnordered());
+}
+
+void testProfiler(bool isMultithreadingEnabled) {
+    EngineCreateInfo createInfo;
+    createInfo.setMultithreadingEnabled(isMultithreadingEnabled);
+    RecordingEnginePtr engine = RecordingEngine::create(createInfo);
+    EXPECT_FALSE(engine->isProfilingEnabled());
+    engine->setProfilingEnabled(true);
+    ASSERT_TRUE(engine->profiler());
+    EngineProfiler* profiler = engine->profiler();
+    vgc::core::PerformanceLogPtr log = vgc::core::PerformanceLog::create();
+    profiler->startLoggingUnder(log.get());
+
+    drawFrames(engine.get());
+    drawFrames(engine.get());
+    EXPECT_EQ(engine->profiler(), profiler);
+
+    // A frame is profiled once all its command lists have been executed.
+    // Since the 4 frames drawn above and the next one are executed before the
+    // following endFrame(), at least 5 frames are profiled.
+    SwapChainPtr swapChain = engine->createSwapChain(SwapChainCreateInfo());
+    engine->beginFrame(swapChain);
+    engine->endFrame();
+    engine->flushWait();
+    engine->beginFrame(swapChain);
+    engine->endFrame();
+    ASSERT_GE(profiler->frames().length(), 5);
+    for (Int i = 0; i < profiler->frames().length(); ++i) {
+        EXPECT_EQ(profiler->frames()[i].frameIndex(), i);
+    }
+
+    // Each frame of drawFrames() contains two draws and one present
+    const EngineFrameProfile& frame = profiler->frames()[0];
+    Int numDraws = 0;
+    Int numPresents = 0;
+    for (const EngineCommandTimings& timings : frame.commandTimings()) {
+        if (timings.name() == "draw") {
+            numDraws = timings.count();
+        }
+        else if (timings.name() == "present") {
+            numPresents = timings.count();
+        }
+        EXPECT_GE(timings.totalTime(), 0);
+    }
+    EXPECT_EQ(numDraws, 2);
+    EXPECT_EQ(numPresents, 1);
+    EXPECT_GE(frame.userTime(), 0);
+    EXPECT_GE(frame.executeTime(), frame.presentTime());
+    EXPECT_EQ(frame.numCommandLists() > 0, isMultithreadingEnabled);
+    ASSERT_FALSE(frame.events().isEmpty());
+    EXPECT_EQ(frame.events().first().name(), "frame");
+    EXPECT_EQ(frame.events().first().thread(), ProfiledThread::User);
+    if (isMultithreadingEnabled) {
+        EXPECT_EQ(frame.events().last().thread(), ProfiledThread::Render);
+    }
+
+    // Logs and traces
+    vgc::core::PerformanceLog* engineLog = log->firstChild();
+    ASSERT_TRUE(engineLog);
+    EXPECT_EQ(engineLog->name(), "Graphics Engine");
+    std::string trace = profiler->toTraceJson();
+    EXPECT_NE(trace.find("\"name\":\"draw\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"present\""), std::string::npos);
+    profiler->stopLoggingUnder(log.get());
+
+    engine->setProfilingEnabled(false);
+    EXPECT_FALSE(engine->profiler());
+}
+
+void testSecondaryCommandLists(bool isMultithreadingEnabled) {
+    EngineCreateInfo createInfo;
+    createInfo.setMultithreadingEnabled(isMultithreadingEnabled);
+    RecordingEnginePtr engine = RecordingEngine::create(createInfo);
+    SwapChainPtr swapChain = engine->createSwapChain(SwapChainCreateInfo());
+    FloatArray triangle = {0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1};
+    GeometryViewPtr view =
+        engine->createDynamicTriangleListView(BuiltinGeometryLayout::XYRGB);
+    engine->updateVertexBufferData(view, triangle);
+    engine->flushWait();
+
+    // Panels recorded on worker threads, where panel i draws a batch of
+    // i + 1 triangles. The second frame reuses the secondary command lists
+    // of the first frame.
+    const Int numPanels = 4;
+    for (Int frame = 0; frame < 2; ++frame) {
+        engine->resetRecording();
+        engine->beginFrame(swapChain);
+        engine->setProgram(BuiltinProgram::Simple);
+        engine->draw(view, -1, 0);
+        std::vector<SecondaryCommandList> lists;
+        for (Int i = 0; i < numPanels; ++i) {
+            lists.push_back(engine->beginSecondaryCommandList());
+        }
+        std::vector<std::thread> threads;
+        for (Int i = 0; i < numPanels; ++i) {
+            threads.emplace_back([&, i]() {
+                engine->setThreadCommandList(&lists[i]);
+                FloatArray vertices;
+                for (Int j = 0; j <= i; ++j) {
+                    vertices.extend(triangle.begin(), triangle.end());
+                }
+                engine->drawBatchedTriangles(BuiltinGeometryLayout::XYRGB, vertices);
+                engine->setThreadCommandList(nullptr);
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        for (SecondaryCommandList& list : lists) {
+            engine->executeSecondaryCommandList(list);
+            EXPECT_TRUE(list.isEmpty());
+        }
+        engine->draw(view, -1, 0);
+        engine->endFrame();
+        engine->flushWait();
+
+        // Draws are in the order the lists were executed, and the program
+        // is set again by each list and after the lists (as well as before
+        // the lists in the first frame).
+        vgc::core::Array<Int> numVertices;
+        for (const RecordedCommand& command : engine->commands()) {
+            if (command.type() == RecordedCommandType::Draw) {
+                numVertices.append(command.numVertices());
+            }
+        }
+        EXPECT_EQ(numVertices, (vgc::core::Array<Int>{3, 3, 6, 9, 12, 3}));
+        Int numSetPrograms = (frame == 0) ? numPanels + 2 : numPanels + 1;
+        EXPECT_EQ(engine->numCommands(RecordedCommandType::SetProgram), numSetPrograms);
+        EXPECT_EQ(engine->lastFrameStats().numDraws(), numPanels + 2);
+    }
+}
+
+// Returns the total number of bytes of the recorded commands of the given type.
+//
+Int numRecordedBytes(RecordingEngine* engine, RecordedCommandType type) {
+    Int numBytes = 0;
+    for (const RecordedCommand& command : engine->commands()) {
+        if (command.type() == type) {
+            numBytes += command.numBytes();
+        }
+    }
+    return numBytes;
+}
+
+void testDrawText(bool isMultithreadingEnabled) {
+    EngineCreateInfo createInfo;
+    createInfo.setMultithreadingEnabled(isMultithreadingEnabled);
+    RecordingEnginePtr engine = RecordingEngine::create(createInfo);
+    SwapChainPtr swapChain = engine->createSwapChain(SwapChainCreateInfo());
+    GlyphAtlas& atlas = engine->glyphAtlas();
+    vgc::core::Array<TextAtlasVertex> quads(3);
+    engine->flushWait();
+    engine->resetRecording();
+
+    // The atlas image is created by the first draw, then consecutive calls
+    // are batched, each quad being drawn as an instance of a 4-vertex strip.
+    using Type = RecordedCommandType;
+    engine->beginFrame(swapChain);
+    engine->drawText({});
+    engine->drawText(quads);
+    engine->drawText(quads);
+    engine->endFrame();
+    engine->flushWait();
+    EXPECT_EQ(numRecordedBytes(engine.get(), Type::InitImage), 1024 * 1024);
+    EXPECT_EQ(engine->numCommands(Type::UpdateImageData), 0);
+    EXPECT_EQ(engine->numCommands(Type::Draw), 1);
+    EXPECT_EQ(engine->numCommands(Type::SetStageImageViews), 1);
+    EXPECT_EQ(engine->numDrawnVertices(), 2 * 4 * 3);
+    for (const RecordedCommand& command : engine->commands()) {
+        if (command.type() == Type::Draw) {
+            EXPECT_EQ(command.numVertices(), 4);
+            EXPECT_EQ(command.numInstances(), 6);
+        }
+    }
+
+    // Text is drawn after the triangles of its batch, so only triangles
+    // overlapping text drawn before them start a new batch. Quads drawn with
+    // different translations are still batched.
+    engine->resetRecording();
+    vgc::core::Array<TextAtlasVertex> quad(1);
+    quad[0].size = vgc::geometry::Vec2f(10, 10);
+    FloatArray farTriangle = {100, 100, 1, 0, 0, 110, 100, 1, 0, 0, 100, 110, 1, 0, 0};
+    FloatArray nearTriangle = {5, 5, 1, 0, 0, 15, 5, 1, 0, 0, 5, 15, 1, 0, 0};
+    engine->beginFrame(swapChain);
+    engine->setProgram(BuiltinProgram::Simple);
+    engine->drawBatchedTriangles(BuiltinGeometryLayout::XYRGB, farTriangle);
+    engine->drawText(quad);
+    engine->drawBatchedTriangles(BuiltinGeometryLayout::XYRGB, farTriangle);
+    engine->pushViewMatrix();
+    Mat4f m = Mat4f::identity;
+    m.translate(1000, 0);
+    engine->setViewMatrix(m);
+    engine->drawText(quad);
+    engine->popViewMatrix();
+    engine->drawBatchedTriangles(BuiltinGeometryLayout::XYRGB, nearTriangle);
+    engine->endFrame();
+    engine->flushWait();
+    vgc::core::Array<std::pair<Int, Int>> draws; // (numVertices, numInstances)
+    for (const RecordedCommand& command : engine->commands()) {
+        if (command.type() == Type::Draw) {
+            draws.append({command.numVertices(), command.numInstances()});
+        }
+    }
+    vgc::core::Array<std::pair<Int, Int>> expectedDraws = {{6, 0}, {4, 2}, {3, 0}};
+    EXPECT_EQ(draws, expectedDraws);
+
+    // Quads drawn with a rotation are drawn immediately, and the program and
+    // pixel shader resources are restored.
+    engine->resetRecording();
+    engine->beginFrame(swapChain);
+    engine->setProgram(BuiltinProgram::Simple);
+    engine->pushViewMatrix();
+    m.rotate(1);
+    engine->setViewMatrix(m);
+    engine->drawText(quad);
+    engine->popViewMatrix();
+    engine->drawBatchedTriangles(BuiltinGeometryLayout::XYRGB, farTriangle);
+    engine->endFrame();
+    engine->flushWait();
+    EXPECT_EQ(engine->numCommands(Type::Draw), 2);
+    EXPECT_EQ(engine->numCommands(Type::SetStageImageViews), 2);
+    EXPECT_EQ(engine->numCommands(Type::SetProgram), 2);
+
+    // Only the modified pixels of the atlas are uploaded, once.
+    engine->resetRecording();
+    SizedGlyph* glyph = reinterpret_cast<SizedGlyph*>(std::uintptr_t(64));
+    vgc::core::Array<vgc::UInt8> pixels(4 * 8, 255);
+    ASSERT_NE(atlas.insert(glyph, GlyphBitmap(4, 8, 1, -8, pixels)), nullptr);
+    engine->beginFrame(swapChain);
+    engine->drawText(quads);
+    engine->drawText(quads);
+    engine->endFrame();
+    engine->flushWait();
+    EXPECT_EQ(engine->numCommands(Type::InitImage), 0);
+    EXPECT_EQ(engine->numCommands(Type::UpdateImageData), 1);
+    EXPECT_EQ(numRecordedBytes(engine.get(), Type::UpdateImageData), 4 * 8);
+    EXPECT_FALSE(atlas.isDirty());
+
+    // Text can be drawn in a secondary command list. Glyphs added to the
+    // atlas while recording it are uploaded when it is executed, before its
+    // draws.
+    engine->resetRecording();
+    engine->beginFrame(swapChain);
+    SecondaryCommandList list = engine->beginSecondaryCommandList();
+    std::thread thread([&]() {
+        engine->setThreadCommandList(&list);
+        engine->drawText(quads);
+        engine->drawText(quads);
+        engine->setThreadCommandList(nullptr);
+    });
+    thread.join();
+    SizedGlyph* glyph2 = reinterpret_cast<SizedGlyph*>(std::uintptr_t(128));
+    ASSERT_NE(atlas.insert(glyph2, GlyphBitmap(4, 8, 1, -8, pixels)), nullptr);
+    engine->executeSecondaryCommandList(list);
+    engine->endFrame();
+    engine->flushWait();
+    vgc::core::Array<Type> types;
+    for (const RecordedCommand& command : engine->commands()) {
+        if (command.type() == Type::UpdateImageData || command.type() == Type::Draw) {
+            types.append(command.type());
+        }
+        if (command.type() == Type::Draw) {
+            EXPECT_EQ(command.numInstances(), 6);
+        }
+    }
+    EXPECT_EQ(types, (vgc::core::Array<Type>{Type::UpdateImageData, Type::Draw}));
+}
+
+} // namespace
+
+TEST(TestRecordingEngine, SingleThreaded) {
+    testRecording(false);
+}
+
+TEST(TestRecordingEngine, Multithreaded) {
+    testRecording(true);
+    testRecording(true, 1);
+}
+
+TEST(TestRecordingEngine, BatchedTriangles) {
+    testBatchedTriangles(false);
+    testBatchedTriangles(true);
+}
+
+TEST(TestRecordingEngine, RetainedBatches) {
+    testRetainedBatches(false);
+    testRetainedBatches(true);
+}
+
+TEST(TestRecordingEngine, TransientVertices) {
+    testTransientVertices(false);
+    testTransientVertices(true);
+}
+
+TEST(TestRecordingEngine, BuiltinConstants) {
+    testBuiltinConstants(false);
+    testBuiltinConstants(true);
+}
+
+TEST(TestRecordingEngine, RedundantStateChanges) {
+    testRedundantStateChanges(false);
+    testRedundantStateChanges(true);
+}
+
+TEST(TestRecordingEngine, Profiler) {
+    testProfiler(false);
+    testProfiler(true);
+}
+
+TEST(TestRecordingEngine, SecondaryCommandLists) {
+    testSecondaryCommandLists(false);
+    testSecondaryCommandLists(true);
+}
+
+TEST(TestRecordingEngine, DrawText) {
+    testDrawText(false);
+    testDrawText(true);
+}
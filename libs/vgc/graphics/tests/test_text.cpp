@@ -15,6 +15,8 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <vgc/core/paths.h>
+#include <vgc/graphics/font.h>
 #include <vgc/graphics/text.h>
 
 using namespace vgc;
@@ -89,6 +91,48 @@ TEST(TestText, TextBoundaryIterator) {
     // EXPECT_EQ(numGraphemes(family_man_woman_girl_boy), 1);            // Returns 4 instead of 1. Positions = 0 7 14 21 25
 }
 
+TEST(TestText, ShapedTextCache) {
+    std::string fontPath =
+        core::resourcePath("graphics/fonts/SourceSansPro/TTF/SourceSansPro-Regular.ttf");
+    graphics::FontLibraryPtr fontLibrary = graphics::FontLibrary::create();
+    graphics::Font* font = fontLibrary->addFont(fontPath);
+    graphics::SizedFont* sizedFont = font->getSizedFont(
+        graphics::SizedFontParams::fromPoints(12, 96, graphics::FontHinting::None));
+
+    graphics::ShapedTextCache* cache = graphics::shapedTextCache();
+    cache->clear();
+    cache->resetStats();
+
+    graphics::ShapedText t1(sizedFont, lazyredcat_english);
+    geometry::Vec2f advance = t1.advance();
+    EXPECT_EQ(cache->numMisses(), 1);
+    EXPECT_EQ(cache->numHits(), 0);
+    EXPECT_EQ(cache->numEntries(), 1);
+    EXPECT_GT(cache->memoryUsage(), 0);
+
+    graphics::ShapedText t2(sizedFont, lazyredcat_english);
+    EXPECT_EQ(cache->numMisses(), 1);
+    EXPECT_EQ(cache->numHits(), 1);
+    EXPECT_EQ(cache->numEntries(), 1);
+    EXPECT_EQ(cache->hitRate(), 0.5);
+    EXPECT_EQ(t1.advance(), t2.advance());
+    EXPECT_EQ(t1.glyphs().length(), t2.glyphs().length());
+
+    t2.setText(lazyredcat_russian);
+    EXPECT_EQ(cache->numMisses(), 2);
+    EXPECT_EQ(cache->numEntries(), 2);
+
+    Int capacity = cache->capacity();
+    cache->setCapacity(0);
+    EXPECT_EQ(cache->numEntries(), 0);
+    EXPECT_EQ(cache->memoryUsage(), 0);
+    EXPECT_EQ(t1.advance(), advance); // still owned by t1 after eviction
+
+    cache->setCapacity(capacity);
+    cache->clear();
+    cache->resetStats();
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
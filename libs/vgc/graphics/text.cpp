@@ -17,7 +17,13 @@
 #include <vgc/graphics/text.h>
 
 #include <array>
+#include <cmath> // std::round
 #include <functional> // std::less, std::greater
+#include <limits>
+#include <list>
+#include <memory> // std::shared_ptr
+#include <mutex>
+#include <unordered_map>
 
 #include <hb-ft.h>
 #include <hb.h>
@@ -62,6 +68,110 @@ using Triangle2fArray = core::Array<Triangle2f>;
 
 namespace detail {
 
+// Output of shaping, shared via the ShapedTextCache between all the
+// ShapedText instances with the same input.
+//
+struct ShapedTextData {
+    ShapedGlyphArray glyphs;
+    ShapedGraphemeArray graphemes;
+    ShapedTextPositionInfoArray positions;
+    geometry::Vec2f advance = geometry::Vec2f(0, 0);
+};
+
+using ShapedTextDataPtr = std::shared_ptr<const ShapedTextData>;
+
+class ShapedTextCacheImpl {
+public:
+    // The text of the key refers to the text stored in the entry, so that
+    // lookups don't need to copy the text.
+    //
+    struct Key {
+        const SizedFont* sizedFont;
+        std::string_view text;
+
+        bool operator==(const Key& other) const {
+            return sizedFont == other.sizedFont && text == other.text;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            size_t res = std::hash<std::string_view>()(key.text);
+            return res * 31 + std::hash<const SizedFont*>()(key.sizedFont);
+        }
+    };
+
+    // Note that we store a SizedFontPtr since the glyphs of the data refer to
+    // the SizedFont.
+    //
+    struct Entry {
+        SizedFontPtr sizedFont;
+        std::string text;
+        ShapedTextDataPtr data;
+        Int memoryUsage;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    mutable std::mutex mutex;
+    EntryList entries; // most recently used first
+    std::unordered_map<Key, EntryList::iterator, KeyHash> entriesMap;
+    Int capacity = 4 * 1024 * 1024;
+    Int memoryUsage = 0;
+    Int numHits = 0;
+    Int numMisses = 0;
+
+    ShapedTextDataPtr find(const SizedFont* sizedFont, std::string_view text) {
+        const std::lock_guard<std::mutex> lock(mutex);
+        auto it = entriesMap.find(Key{sizedFont, text});
+        if (it == entriesMap.end()) {
+            ++numMisses;
+            return nullptr;
+        }
+        ++numHits;
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->data;
+    }
+
+    void insert(SizedFont* sizedFont, std::string_view text, ShapedTextDataPtr data) {
+        const std::lock_guard<std::mutex> lock(mutex);
+        Int entryMemoryUsage = computeMemoryUsage(text, *data);
+        if (entryMemoryUsage > capacity) {
+            return;
+        }
+        if (entriesMap.find(Key{sizedFont, text}) != entriesMap.end()) {
+            // Already inserted by another thread.
+            return;
+        }
+        entries.push_front(Entry{sizedFont, std::string(text), data, entryMemoryUsage});
+        const Entry& entry = entries.front();
+        entriesMap.emplace(Key{sizedFont, entry.text}, entries.begin());
+        memoryUsage += entryMemoryUsage;
+        evict();
+    }
+
+    // Removes the least recently used entries until the memory usage fits
+    // the capacity.
+    //
+    void evict() {
+        while (memoryUsage > capacity && !entries.empty()) {
+            const Entry& entry = entries.back();
+            entriesMap.erase(Key{entry.sizedFont.get(), entry.text});
+            memoryUsage -= entry.memoryUsage;
+            entries.pop_back();
+        }
+    }
+
+    static Int computeMemoryUsage(std::string_view text, const ShapedTextData& data) {
+        size_t res = sizeof(Entry) + sizeof(ShapedTextData) + text.size();
+        res += data.glyphs.length() * sizeof(ShapedGlyph);
+        res += data.graphemes.length() * sizeof(ShapedGrapheme);
+        res += data.positions.length() * sizeof(ShapedTextPositionInfo);
+        res += 4 * sizeof(void*); // list node and map node
+        return core::int_cast<Int>(res);
+    }
+};
+
 class ShapedTextImpl {
 public:
     // Input of shaping.
@@ -81,10 +191,7 @@ public:
 
     // Output of shaping
     //
-    ShapedGlyphArray glyphs;
-    ShapedGraphemeArray graphemes;
-    ShapedTextPositionInfoArray positions;
-    geometry::Vec2f advance;
+    ShapedTextDataPtr data;
 
     // Buffers to avoid dynamic allocations during filling.
     //
@@ -92,18 +199,10 @@ public:
     Triangle2fArray trianglesBuffer1;
     Triangle2fArray trianglesBuffer2;
 
-    // HarbBuzz buffer
-    //
-    hb_buffer_t* buf;
-
     ShapedTextImpl(SizedFont* sizedFont, std::string_view text)
         : sizedFont_(sizedFont)
         , text_(text)
-        , glyphs()
-        , graphemes()
-        , positions()
-        , advance(0, 0)
-        , buf(hb_buffer_create()) {
+        , data() {
 
         update();
     }
@@ -111,29 +210,18 @@ public:
     ShapedTextImpl(const ShapedTextImpl& other)
         : sizedFont_(other.sizedFont_)
         , text_(other.text_)
-        , glyphs(other.glyphs)
-        , graphemes(other.graphemes)
-        , positions(other.positions)
-        , advance(other.advance)
-        , buf(hb_buffer_create()) {
+        , data(other.data) {
     }
 
     ShapedTextImpl& operator=(const ShapedTextImpl& other) {
         if (this != &other) {
             sizedFont_ = other.sizedFont_;
             text_ = other.text_;
-            glyphs = other.glyphs;
-            graphemes = other.graphemes;
-            positions = other.positions;
-            advance = other.advance;
+            data = other.data;
         }
         return *this;
     }
 
-    ~ShapedTextImpl() {
-        hb_buffer_destroy(buf);
-    }
-
     void setSizedFont(SizedFont* sizedFont) {
         sizedFont_ = sizedFont;
         update();
@@ -145,6 +233,22 @@ public:
     }
 
     void update() {
+        ShapedTextCacheImpl* cache = shapedTextCache()->impl_;
+        data = cache->find(sizedFont_.get(), text_);
+        if (!data) {
+            auto newData = std::make_shared<ShapedTextData>();
+            shape(*newData);
+            data = newData;
+            cache->insert(sizedFont_.get(), text_, data);
+        }
+    }
+
+    void shape(ShapedTextData& out) {
+
+        ShapedGlyphArray& glyphs = out.glyphs;
+        ShapedGraphemeArray& graphemes = out.graphemes;
+        ShapedTextPositionInfoArray& positions = out.positions;
+        geometry::Vec2f& advance = out.advance;
 
         // Prepare input
         const char* data = text_.data();
@@ -153,7 +257,7 @@ public:
         int numChars = dataLength;
 
         // Shape
-        hb_buffer_reset(buf);
+        hb_buffer_t* buf = hb_buffer_create();
         hb_buffer_set_cluster_level(buf, HB_BUFFER_CLUSTER_LEVEL_MONOTONE_CHARACTERS);
         hb_buffer_add_utf8(buf, data, dataLength, firstChar, numChars);
         hb_buffer_guess_segment_properties(buf);
@@ -187,6 +291,7 @@ public:
             // is to have the y axis pointing down. This might require to add
             // minus signs in front of pos.y_offset and pos.y_advance.
         }
+        hb_buffer_destroy(buf);
 
         // Create grapheme and position info objects with temporary values
         TextBoundaryMarkersArray markersArray = computeBoundaryMarkers(text_);
@@ -278,7 +383,7 @@ public:
     }
 
     float horizontalAdvance(Int position) {
-        return positions[position].advance()[0];
+        return data->positions[position].advance()[0];
     }
 
 private:
@@ -371,37 +476,37 @@ void ShapedText::setText(std::string_view text) {
 }
 
 const ShapedGlyphArray& ShapedText::glyphs() const {
-    return impl_->glyphs;
+    return impl_->data->glyphs;
 }
 
 const ShapedGraphemeArray& ShapedText::graphemes() const {
-    return impl_->graphemes;
+    return impl_->data->graphemes;
 }
 
 ShapedTextPositionInfo ShapedText::positionInfo(Int position) const {
-    if (position < 0 || position >= impl_->positions.length()) {
+    if (position < 0 || position >= impl_->data->positions.length()) {
         return ShapedTextPositionInfo(
             -1, -1, geometry::Vec2f(), TextBoundaryMarker::None);
     }
     else {
-        return impl_->positions.getUnchecked(position);
+        return impl_->data->positions.getUnchecked(position);
     }
 }
 
 Int ShapedText::numPositions() const {
-    return impl_->positions.length();
+    return impl_->data->positions.length();
 }
 
 geometry::Vec2f ShapedText::advance() const {
-    return impl_->advance;
+    return impl_->data->advance;
 }
 
 geometry::Vec2f ShapedText::advance(Int position) const {
-    if (position < 0 || position >= impl_->positions.length()) {
+    if (position < 0 || position >= impl_->data->positions.length()) {
         return geometry::Vec2f();
     }
     else {
-        return impl_->positions.getUnchecked(position).advance();
+        return impl_->data->positions.getUnchecked(position).advance();
     }
 }
 
@@ -423,7 +528,7 @@ void ShapedText::fill(
     float r, float g, float b,
     Int start, Int end) const {
 
-    const ShapedGlyphArray& glyphs = impl_->glyphs;
+    const ShapedGlyphArray& glyphs = impl_->data->glyphs;
     for (Int i = start; i < end; ++i) {
         glyphs[i].fill(data, origin, r, g, b);
     }
@@ -614,7 +719,7 @@ void ShapedText::fill(core::FloatArray& data,
     // glyph's triangles to cut them by the clipRect, and only keep the
     // triangles inside.
     //
-    const ShapedGlyphArray& glyphs = impl_->glyphs;
+    const ShapedGlyphArray& glyphs = impl_->data->glyphs;
     for (Int i = start; i < end; ++i) {
         const ShapedGlyph& glyph = glyphs[i];
         const geometry::Rect2f& bbox = glyph.boundingBox();
@@ -652,11 +757,79 @@ void ShapedText::fill(core::FloatArray& data,
     }
 }
 
+bool ShapedText::fillAtlasQuads(
+    core::Array<TextAtlasVertex>& quads,
+    GlyphAtlas& atlas,
+    const geometry::Vec2f& origin,
+    float r, float g, float b) const {
+
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    return fillAtlasQuads(
+        quads, atlas, origin, r, g, b,
+        0, glyphs().length(),
+        -inf, inf, -inf, inf);
+}
+
+bool ShapedText::fillAtlasQuads(
+    core::Array<TextAtlasVertex>& quads,
+    GlyphAtlas& atlas,
+    const geometry::Vec2f& origin,
+    float r, float g, float b,
+    Int start, Int end,
+    float clipLeft, float clipRight,
+    float clipTop, float clipBottom) const {
+
+    geometry::Rect2f clipRect(clipLeft, clipTop, clipRight, clipBottom);
+    geometry::Vec3f color(r, g, b);
+    bool success = true;
+    const ShapedGlyphArray& glyphs = impl_->data->glyphs;
+    for (Int i = start; i < end; ++i) {
+        const ShapedGlyph& glyph = glyphs[i];
+        const GlyphAtlasEntry* entry = atlas.getOrInsert(glyph.sizedGlyph());
+        if (!entry) {
+            success = false;
+            continue;
+        }
+        if (entry->isEmpty()) {
+            continue;
+        }
+
+        // Snap the glyph origin to the pixel grid, since the glyph bitmap
+        // was rasterized with its origin at integer coordinates.
+        geometry::Vec2f p = origin + glyph.position();
+        float x = std::round(p[0]) + static_cast<float>(entry->left());
+        float y = std::round(p[1]) + static_cast<float>(entry->top());
+        float w = static_cast<float>(entry->width());
+        float h = static_cast<float>(entry->height());
+        geometry::Rect2f quad(x, y, x + w, y + h);
+        geometry::Rect2f texCoords = entry->texCoords();
+
+        // Clip the quad, interpolating its texture coordinates.
+        if (!clipRect.contains(quad)) {
+            geometry::Rect2f clipped = quad.intersectedWith(clipRect);
+            if (clipped.width() <= 0 || clipped.height() <= 0) {
+                continue;
+            }
+            float su = texCoords.width() / w;
+            float sv = texCoords.height() / h;
+            texCoords = geometry::Rect2f(
+                texCoords.xMin() + (clipped.xMin() - quad.xMin()) * su,
+                texCoords.yMin() + (clipped.yMin() - quad.yMin()) * sv,
+                texCoords.xMax() - (quad.xMax() - clipped.xMax()) * su,
+                texCoords.yMax() - (quad.yMax() - clipped.yMax()) * sv);
+            quad = clipped;
+        }
+
+        quads.append({quad.position(), quad.size(), texCoords, color});
+    }
+    return success;
+}
+
 // clang-format on
 
 Int ShapedText::positionFromByte(Int byteIndex) const {
-    auto first = impl_->positions.cbegin();
-    auto last = impl_->positions.cend();
+    auto first = impl_->data->positions.cbegin();
+    auto last = impl_->data->positions.cend();
     auto comp = [](const ShapedTextPositionInfo& info, Int byteIndex) {
         return info.byteIndex() < byteIndex;
     };
@@ -695,8 +868,8 @@ std::pair<Int, Int> ShapedText::positionPairFromPoint(
 
     // Find smallest text position after the given mouse position
     float x = point[0];
-    auto first = impl_->positions.cbegin();
-    auto last = impl_->positions.cend();
+    auto first = impl_->data->positions.cbegin();
+    auto last = impl_->data->positions.cend();
     auto comp = [](const ShapedTextPositionInfo& info, float x) {
         return info.advance()[0] < x;
     };
@@ -742,8 +915,9 @@ Int ShapedText::nextOrEqualBoundary(
         position = minPosition;
     }
 
+    const ShapedTextPositionInfoArray& positions = impl_->data->positions;
     while (position <= maxPosition
-           && !impl_->positions[position].boundaryMarkers().hasAll(boundaryMarkers)) {
+           && !positions[position].boundaryMarkers().hasAll(boundaryMarkers)) {
         ++position;
     }
 
@@ -774,8 +948,9 @@ Int ShapedText::previousOrEqualBoundary(
         position = maxPosition;
     }
 
+    const ShapedTextPositionInfoArray& positions = impl_->data->positions;
     while (position >= minPosition
-           && !impl_->positions[position].boundaryMarkers().hasAll(boundaryMarkers)) {
+           && !positions[position].boundaryMarkers().hasAll(boundaryMarkers)) {
         --position;
     }
 
@@ -787,6 +962,72 @@ Int ShapedText::previousOrEqualBoundary(
     }
 }
 
+ShapedTextCache* shapedTextCache() {
+    static ShapedTextCache* cache = new ShapedTextCache(); // trusty leaky singleton
+    return cache;
+}
+
+ShapedTextCache::ShapedTextCache()
+    : impl_(new detail::ShapedTextCacheImpl()) {
+}
+
+ShapedTextCache::~ShapedTextCache() {
+    delete impl_;
+}
+
+Int ShapedTextCache::capacity() const {
+    const std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->capacity;
+}
+
+void ShapedTextCache::setCapacity(Int capacity) {
+    const std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->capacity = (std::max)(Int(0), capacity);
+    impl_->evict();
+}
+
+Int ShapedTextCache::memoryUsage() const {
+    const std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->memoryUsage;
+}
+
+Int ShapedTextCache::numEntries() const {
+    const std::lock_guard<std::mutex> lock(impl_->mutex);
+    return core::int_cast<Int>(impl_->entriesMap.size());
+}
+
+void ShapedTextCache::clear() {
+    const std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->entriesMap.clear();
+    impl_->entries.clear();
+    impl_->memoryUsage = 0;
+}
+
+Int ShapedTextCache::numHits() const {
+    const std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->numHits;
+}
+
+Int ShapedTextCache::numMisses() const {
+    const std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->numMisses;
+}
+
+double ShapedTextCache::hitRate() const {
+    const std::lock_guard<std::mutex> lock(impl_->mutex);
+    Int numLookups = impl_->numHits + impl_->numMisses;
+    if (numLookups == 0) {
+        return 0;
+    }
+    return static_cast<double>(impl_->numHits) / static_cast<double>(numLookups);
+}
+
+void ShapedTextCache::resetStats() {
+    const std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->numHits = 0;
+    impl_->numMisses = 0;
+}
+
 // Convenient macro for checking assertions and failing with a LogicError.
 // We should eventually add this to vgc::core API
 #define VGC_EXPECT_EQ(a, b)                                                              \
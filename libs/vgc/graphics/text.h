@@ -24,12 +24,14 @@
 #include <vgc/geometry/rect2f.h>
 #include <vgc/graphics/api.h>
 #include <vgc/graphics/font.h>
+#include <vgc/graphics/glyphatlas.h>
 
 namespace vgc::graphics {
 
 namespace detail {
 
 class ShapedTextImpl;
+class ShapedTextCacheImpl;
 class TextBoundaryIteratorImpl;
 
 } // namespace detail
@@ -573,6 +575,9 @@ using ShapedTextPositionInfoArray = core::Array<ShapedTextPositionInfo>;
 /// }
 /// ```
 ///
+/// The results of shaping are shared between all ShapedText instances with
+/// the same SizedFont and text, see `ShapedTextCache`.
+///
 /// Note that the fill functions of this class are not thread-safe. In
 /// particular, two threads cannot concurrently call fill functions on the same
 /// ShapedText instance. The reason is that ShapedText uses internal buffers
@@ -751,6 +756,42 @@ public:
         Int start, Int end,
         float clipLeft, float clipRight, float clipTop, float clipBottom) const;
 
+    /// Appends to the given output parameter `quads` one textured quad per
+    /// visible glyph of this ShapedText at the given origin, using the given
+    /// `atlas` to store the rasterized glyphs.
+    ///
+    /// This is an alternative to fill() which is much cheaper to draw, since
+    /// it only requires one instance of `TextAtlasVertex` per glyph instead of
+    /// all the triangles of the glyph outlines, and doesn't need multisampling
+    /// to be readable. However, since glyphs are rasterized with their origin
+    /// at integer coordinates, the position of each glyph is rounded to the
+    /// nearest pixel.
+    ///
+    /// Returns false if some glyphs could not be inserted in the atlas, in
+    /// which case these glyphs are skipped.
+    ///
+    bool fillAtlasQuads(
+        core::Array<TextAtlasVertex>& quads,
+        GlyphAtlas& atlas,
+        const geometry::Vec2f& origin,
+        float r, float g, float b) const;
+
+    /// Appends quads for this ShapedText from glyph index `start` (included)
+    /// to glyph index `end` (excluded), clipping them to the rectangle given
+    /// by `clipLeft`, `clipRight`, `clipTop`, and `clipBottom`. Clipped quads
+    /// have their texture coordinates adjusted accordingly.
+    ///
+    /// See the other overload of fillAtlasQuads() for documentation of the
+    /// remaining arguments.
+    ///
+    bool fillAtlasQuads(
+        core::Array<TextAtlasVertex>& quads,
+        GlyphAtlas& atlas,
+        const geometry::Vec2f& origin,
+        float r, float g, float b,
+        Int start, Int end,
+        float clipLeft, float clipRight, float clipTop, float clipBottom) const;
+
     // clang-format on
 
     /// Returns the smallest text position whose UTF-8 byte index is greater or
@@ -835,6 +876,88 @@ private:
     detail::ShapedTextImpl* impl_;
 };
 
+class ShapedTextCache;
+
+/// Returns the process-wide cache of shaping results used by all `ShapedText`
+/// instances.
+///
+VGC_GRAPHICS_API ShapedTextCache* shapedTextCache();
+
+/// \class vgc::graphics::ShapedTextCache
+/// \brief Stores shaping results shared between `ShapedText` instances.
+///
+/// Shaping a text (that is, running HarfBuzz and computing the boundaries of
+/// its graphemes, words, sentences, and lines) is costly, while many strings
+/// of a user interface, such as the labels of menus and buttons, are shaped
+/// again and again with the same font. Therefore, the results of shaping are
+/// stored in a process-wide cache, accessible via `shapedTextCache()`, and
+/// shared between all the `ShapedText` instances with the same `SizedFont` and
+/// text.
+///
+/// The memory used by the cache is bounded by its `capacity()`: when it is
+/// exceeded, the least recently used results are removed from the cache.
+/// Note that removed results are only freed once no `ShapedText` uses them.
+///
+/// All the functions of this class are thread-safe.
+///
+class VGC_GRAPHICS_API ShapedTextCache {
+public:
+    ShapedTextCache(const ShapedTextCache&) = delete;
+    ShapedTextCache& operator=(const ShapedTextCache&) = delete;
+
+    /// Returns the maximum amount of memory, in bytes, used by the cached
+    /// results. The default is 4 MiB.
+    ///
+    Int capacity() const;
+
+    /// Sets the maximum amount of memory, in bytes, used by the cached
+    /// results, removing the least recently used results if necessary.
+    /// Setting a capacity of `0` disables the cache.
+    ///
+    void setCapacity(Int capacity);
+
+    /// Returns the approximate amount of memory, in bytes, used by the cached
+    /// results.
+    ///
+    Int memoryUsage() const;
+
+    /// Returns the number of cached results.
+    ///
+    Int numEntries() const;
+
+    /// Removes all the cached results.
+    ///
+    void clear();
+
+    /// Returns how many times the result of shaping a text was found in the
+    /// cache.
+    ///
+    Int numHits() const;
+
+    /// Returns how many times the result of shaping a text was not found in
+    /// the cache, and the text had to be shaped.
+    ///
+    Int numMisses() const;
+
+    /// Returns the ratio of `numHits()` over the total number of lookups, or
+    /// `0` if there was no lookup.
+    ///
+    double hitRate() const;
+
+    /// Resets `numHits()` and `numMisses()` to zero.
+    ///
+    void resetStats();
+
+private:
+    friend ShapedTextCache* shapedTextCache();
+    friend detail::ShapedTextImpl;
+
+    detail::ShapedTextCacheImpl* impl_;
+
+    ShapedTextCache();
+    ~ShapedTextCache();
+};
+
 /// \class vgc::graphics::TextScroll
 /// \brief Represents whether the text is scrolled left/right or up/down.
 ///
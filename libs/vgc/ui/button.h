@@ -97,9 +97,7 @@ public:
 
     // Reimplementation of Widget virtual methods
     void onResize() override;
-    void onPaintCreate(graphics::Engine* engine) override;
     void onPaintDraw(graphics::Engine* engine, PaintOptions options) override;
-    void onPaintDestroy(graphics::Engine* engine) override;
     bool onMouseMove(MouseEvent* event) override;
     bool onMousePress(MouseEvent* event) override;
     bool onMouseRelease(MouseEvent* event) override;
@@ -111,7 +109,9 @@ protected:
 
 private:
     graphics::RichTextPtr richText_;
-    graphics::GeometryViewPtr triangles_;
+    graphics::BatchedTriangles triangles_;
+    core::Array<graphics::TextAtlasVertex> textQuads_;
+    Int textQuadsNumEvictions_ = -1;
     bool reload_ = true;
     bool isPressed_ = false;
 };
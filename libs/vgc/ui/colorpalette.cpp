@@ -395,11 +395,6 @@ void ColorPaletteSelector::setSelectedColor(const core::Color& color) {
     }
 }
 
-void ColorPaletteSelector::onPaintCreate(graphics::Engine* engine) {
-    triangles_ =
-        engine->createDynamicTriangleListView(graphics::BuiltinGeometryLayout::XYRGB);
-}
-
 namespace {
 
 // clang-format off
@@ -619,11 +614,11 @@ void ColorPaletteSelector::onPaintDraw(
         }
 
         // Load triangles
-        engine->updateVertexBufferData(triangles_, std::move(a));
+        triangles_.setVertices(std::move(a));
     }
     //engine->clear(core::Color(0.337, 0.345, 0.353));
     engine->setProgram(graphics::BuiltinProgram::Simple);
-    engine->draw(triangles_, -1, 0);
+    engine->drawBatchedTriangles(triangles_);
 }
 
 ColorPaletteSelector::Metrics
@@ -686,10 +681,6 @@ void ColorPaletteSelector::updateMetrics_() const {
     metrics_ = computeMetricsFromWidth_(width());
 }
 
-void ColorPaletteSelector::onPaintDestroy(graphics::Engine*) {
-    triangles_.reset();
-}
-
 bool ColorPaletteSelector::onMouseMove(MouseEvent* event) {
 
     // Determine relevant selector
@@ -986,11 +977,6 @@ void ColorListView::onResize() {
     reload_ = true;
 }
 
-void ColorListView::onPaintCreate(graphics::Engine* engine) {
-    triangles_ =
-        engine->createDynamicTriangleListView(graphics::BuiltinGeometryLayout::XYRGB);
-}
-
 namespace {
 
 float getItemLengthInPx(style::StylableObject* item, core::StringId property) {
@@ -1045,15 +1031,11 @@ void ColorListView::onPaintDraw(graphics::Engine* engine, PaintOptions) {
                     a, color, borderColor_, itemRect, radiuses, borderWidth_);
             }
         }
-        engine->updateVertexBufferData(triangles_, std::move(a));
+        triangles_.setVertices(std::move(a));
     }
 
     engine->setProgram(graphics::BuiltinProgram::Simple);
-    engine->draw(triangles_, -1, 0);
-}
-
-void ColorListView::onPaintDestroy(graphics::Engine*) {
-    triangles_.reset();
+    engine->drawBatchedTriangles(triangles_);
 }
 
 namespace {
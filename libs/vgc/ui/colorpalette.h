@@ -137,9 +137,7 @@ public:
     VGC_SIGNAL(colorSelected)
 
     // reimpl
-    void onPaintCreate(graphics::Engine* engine) override;
     void onPaintDraw(graphics::Engine* engine, PaintOptions options) override;
-    void onPaintDestroy(graphics::Engine* engine) override;
     bool onMouseMove(MouseEvent* event) override;
     bool onMousePress(MouseEvent* event) override;
     bool onMouseRelease(MouseEvent* event) override;
@@ -158,7 +156,7 @@ private:
         SaturationLightness
     };
     core::Color selectedColor_;
-    graphics::GeometryViewPtr triangles_;
+    graphics::BatchedTriangles triangles_;
     float oldWidth_;
     float oldHeight_;
     bool reload_;
@@ -328,9 +326,7 @@ public:
 
     // Implement Widget interface
     void onResize() override;
-    void onPaintCreate(graphics::Engine* engine) override;
     void onPaintDraw(graphics::Engine* engine, PaintOptions options) override;
-    void onPaintDestroy(graphics::Engine* engine) override;
     bool onMouseMove(MouseEvent* event) override;
     bool onMousePress(MouseEvent* event) override;
     bool onMouseRelease(MouseEvent* event) override;
@@ -363,7 +359,7 @@ private:
     Int hoveredColorIndex_ = -1;
     Int selectedColorIndex_ = -1;
     core::Array<core::Color> colors_;
-    graphics::GeometryViewPtr triangles_;
+    graphics::BatchedTriangles triangles_;
     ColorListViewItemPtr item_;
     bool isScrubbing_ = false;
     bool reload_ = true;
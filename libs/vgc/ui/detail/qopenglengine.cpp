@@ -75,13 +75,23 @@ public:
 protected:
     void release_(Engine* engine) override {
         Buffer::release_(engine);
-        static_cast<QglEngine*>(engine)->api()->glDeleteBuffers(1, &object_);
+        OpenGLFunctions* api = static_cast<QglEngine*>(engine)->api();
+        for (GLsync fence : transientRegionFences_) {
+            if (fence) {
+                api->glDeleteSync(fence);
+            }
+        }
+        api->glDeleteBuffers(1, &object_);
     }
 
 private:
     GLuint object_ = badGLuint;
     GLenum usage_ = badGLenum;
     Int allocatedSize_ = 0;
+
+    // Fences of the transient vertex buffer regions, see
+    // Engine::fenceTransientVertexData_().
+    core::Array<GLsync> transientRegionFences_;
 };
 using QglBufferPtr = ResourcePtr<QglBuffer>;
 
@@ -205,6 +215,11 @@ public:
         return image ? image->object() : bufferTextureObject_;
     }
 
+    GLenum target() const {
+        QglImage* image = viewedImage().get_static_cast<QglImage>();
+        return image ? image->target_ : GL_TEXTURE_BUFFER;
+    }
+
 protected:
     void releaseSubResources_() override {
         ImageView::releaseSubResources_();
@@ -268,6 +283,7 @@ struct GlAttribPointerDesc {
     GLsizei stride;
     uintptr_t offset;
     uintptr_t bufferIndex;
+    GLuint divisor; // 1 for per-instance attributes
 };
 
 class QglProgram : public Program {
@@ -756,6 +772,9 @@ void QglEngine::createBuiltinShaders_() {
     QglProgramPtr simpleProgram(
         new QglProgram(resourceRegistry_, BuiltinProgram::Simple));
     simpleProgram_ = simpleProgram;
+    QglProgramPtr glyphAtlasProgram(
+        new QglProgram(resourceRegistry_, BuiltinProgram::GlyphAtlas));
+    glyphAtlasProgram_ = glyphAtlasProgram;
 }
 
 SwapChainPtr QglEngine::constructSwapChain_(const SwapChainCreateInfo& createInfo) {
@@ -958,6 +977,7 @@ void QglEngine::initBuiltinResources_() {
     xyDesc.stride = sizeof(XYRGBVertex);
     xyDesc.offset = static_cast<uintptr_t>(offsetof(XYRGBVertex, x));
     xyDesc.bufferIndex = 0;
+    xyDesc.divisor = 0;
 
     GlAttribPointerDesc& rgbDesc = layout.emplaceLast();
     rgbDesc.index = rgbLoc_;
@@ -967,6 +987,48 @@ void QglEngine::initBuiltinResources_() {
     rgbDesc.stride = sizeof(XYRGBVertex);
     rgbDesc.offset = static_cast<uintptr_t>(offsetof(XYRGBVertex, r));
     rgbDesc.bufferIndex = 0;
+    rgbDesc.divisor = 0;
+
+    // Initialize glyph atlas shader program
+    QglProgram* glyphAtlasProgram = glyphAtlasProgram_.get_static_cast<QglProgram>();
+    glyphAtlasProgram->prog_.reset(new QOpenGLShaderProgram());
+    prog = glyphAtlasProgram->prog_.get();
+    prog->addShaderFromSourceFile(
+        QOpenGLShader::Vertex,
+        shaderPath_("iv2pos_iv2size_iv4uvs_iv3col_um4proj_um4view_ov2fuv_ov3fcol.v.glsl"));
+    prog->addShaderFromSourceFile(
+        QOpenGLShader::Fragment, shaderPath_("iv2fuv_iv3fcol_us2atlas.f.glsl"));
+    prog->link();
+    prog->bind();
+    struct GlyphAttrib {
+        const char* name;
+        GLint numElements;
+        uintptr_t offset;
+    };
+    std::array<GlyphAttrib, 4> glyphAttribs = {
+        GlyphAttrib{"pos", 2, offsetof(TextAtlasVertex, position)},
+        GlyphAttrib{"size", 2, offsetof(TextAtlasVertex, size)},
+        GlyphAttrib{"uvs", 4, offsetof(TextAtlasVertex, texCoords)},
+        GlyphAttrib{"col", 3, offsetof(TextAtlasVertex, color)}};
+    core::Array<GlAttribPointerDesc>& glyphLayout =
+        glyphAtlasProgram->builtinLayouts_[core::toUnderlying(
+            BuiltinGeometryLayout::TextAtlasQuad)];
+    for (const GlyphAttrib& attrib : glyphAttribs) {
+        GlAttribPointerDesc& desc = glyphLayout.emplaceLast();
+        desc.index = prog->attributeLocation(attrib.name);
+        desc.numElements = attrib.numElements;
+        desc.elementType = GL_FLOAT;
+        desc.normalized = false;
+        desc.stride = sizeof(TextAtlasVertex);
+        desc.offset = attrib.offset;
+        desc.bufferIndex = 0;
+        desc.divisor = 1;
+    }
+    // The atlas is the image view 0 of the pixel stage (see syncTextureStates_()).
+    prog->setUniformValue(
+        "atlas", static_cast<GLint>(toIndex_(ShaderStage::Pixel) * maxSamplersPerStage));
+    api_->glUniformBlockBinding(prog->programId(), 0, 0);
+    prog->release();
 }
 
 void QglEngine::initFramebuffer_(Framebuffer* aFramebuffer) {
@@ -1036,6 +1098,7 @@ void QglEngine::initImage_(
 
         if (isArray) {
             target = GL_TEXTURE_1D_ARRAY;
+            api_->glBindTexture(target, object);
             for (Int mipLevel = 0; mipLevel < numMipLevels; ++mipLevel) {
                 api_->glTexImage2D(
                     GL_TEXTURE_1D_ARRAY,
@@ -1052,6 +1115,7 @@ void QglEngine::initImage_(
         }
         else {
             target = GL_TEXTURE_1D;
+            api_->glBindTexture(target, object);
             for (Int mipLevel = 0; mipLevel < numMipLevels; ++mipLevel) {
                 api_->glTexImage1D(
                     GL_TEXTURE_1D,
@@ -1073,8 +1137,9 @@ void QglEngine::initImage_(
         if (isArray) {
             if (isMultisampled) {
                 target = GL_TEXTURE_2D_MULTISAMPLE_ARRAY;
+                api_->glBindTexture(target, object);
                 api_->glTexImage3DMultisample(
-                    GL_TEXTURE_2D_MULTISAMPLE,
+                    GL_TEXTURE_2D_MULTISAMPLE_ARRAY,
                     image->numSamples(),
                     glFormat.internalFormat,
                     image->width(),
@@ -1084,6 +1149,7 @@ void QglEngine::initImage_(
             }
             else {
                 target = GL_TEXTURE_2D_ARRAY;
+                api_->glBindTexture(target, object);
                 for (Int mipLevel = 0; mipLevel < numMipLevels; ++mipLevel) {
                     api_->glTexImage3D(
                         GL_TEXTURE_2D_ARRAY,
@@ -1103,6 +1169,7 @@ void QglEngine::initImage_(
         else {
             if (isMultisampled) {
                 target = GL_TEXTURE_2D_MULTISAMPLE;
+                api_->glBindTexture(target, object);
                 api_->glTexImage2DMultisample(
                     GL_TEXTURE_2D_MULTISAMPLE,
                     image->numSamples(),
@@ -1113,6 +1180,7 @@ void QglEngine::initImage_(
             }
             else {
                 target = GL_TEXTURE_2D;
+                api_->glBindTexture(target, object);
                 for (Int mipLevel = 0; mipLevel < numMipLevels; ++mipLevel) {
                     api_->glTexImage2D(
                         GL_TEXTURE_2D,
@@ -1131,6 +1199,10 @@ void QglEngine::initImage_(
     }
 
     image->target_ = target;
+
+    // The texture is bound to the active unit, whose state must be restored.
+    isTextureStateDirtyMap_[activeTextureUnit_] = true;
+    isAnyTextureStateDirty_ = true;
 }
 
 void QglEngine::initImageView_(ImageView* aView) {
@@ -1317,21 +1389,39 @@ void QglEngine::setStageConstantBuffers_(
 }
 
 void QglEngine::setStageImageViews_(
-    const ImageViewPtr* /*views*/,
-    Int /*startIndex*/,
-    Int /*count*/,
-    ShaderStage /*shaderStage*/) {
+    const ImageViewPtr* views,
+    Int startIndex,
+    Int count,
+    ShaderStage shaderStage) {
 
-    // todo, + defer coupling with sampler
+    // Coupling with samplers is deferred to syncTextureStates_().
+    Int stageBaseIndex = toIndex_(shaderStage) * maxImageViewsPerStage;
+    for (Int i = 0; i < count; ++i) {
+        Int unit = stageBaseIndex + startIndex + i;
+        if (currentImageViews_[unit] != views[i]) {
+            currentImageViews_[unit] = views[i];
+            isTextureStateDirtyMap_[unit] = true;
+            isAnyTextureStateDirty_ = true;
+        }
+    }
 }
 
 void QglEngine::setStageSamplers_(
-    const SamplerStatePtr* /*states*/,
-    Int /*startIndex*/,
-    Int /*count*/,
-    ShaderStage /*shaderStage*/) {
+    const SamplerStatePtr* states,
+    Int startIndex,
+    Int count,
+    ShaderStage shaderStage) {
 
-    // todo, + defer coupling with view
+    // Coupling with image views is deferred to syncTextureStates_().
+    Int stageBaseIndex = toIndex_(shaderStage) * maxSamplersPerStage;
+    for (Int i = 0; i < count; ++i) {
+        Int unit = stageBaseIndex + startIndex + i;
+        if (currentSamplerStates_[unit] != states[i]) {
+            currentSamplerStates_[unit] = states[i];
+            isTextureStateDirtyMap_[unit] = true;
+            isAnyTextureStateDirty_ = true;
+        }
+    }
 }
 
 void QglEngine::updateBufferData_(Buffer* aBuffer, const void* data, Int lengthInBytes) {
@@ -1339,14 +1429,123 @@ void QglEngine::updateBufferData_(Buffer* aBuffer, const void* data, Int lengthI
     loadBuffer_(buffer, data, lengthInBytes);
 }
 
+void QglEngine::updateImageData_(
+    Image* aImage,
+    Int x,
+    Int y,
+    Int width,
+    Int height,
+    const void* data,
+    Int /*lengthInBytes*/) {
+
+    QglImage* image = static_cast<QglImage*>(aImage);
+    if (image->target_ != GL_TEXTURE_2D) {
+        VGC_ERROR(LogVgcUi, "Only 2D images without layers can be updated.");
+        return;
+    }
+    GlFormat glFormat = image->glFormat();
+    api_->glBindTexture(GL_TEXTURE_2D, image->object());
+    api_->glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // rows are tightly packed
+    api_->glTexSubImage2D(
+        GL_TEXTURE_2D,
+        0,
+        core::int_cast<GLint>(x),
+        core::int_cast<GLint>(y),
+        core::int_cast<GLsizei>(width),
+        core::int_cast<GLsizei>(height),
+        glFormat.pixelFormat,
+        glFormat.pixelType,
+        data);
+    api_->glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    isTextureStateDirtyMap_[activeTextureUnit_] = true;
+    isAnyTextureStateDirty_ = true;
+}
+
 // should do init at beginFrame if needed..
 
-void QglEngine::draw_(GeometryView* aView, UInt numIndices, UInt numInstances) {
+void QglEngine::uploadTransientVertexData_(
+    Buffer* aBuffer,
+    Int regionIndex,
+    Int offsetInBytes,
+    const void* data,
+    Int lengthInBytes) {
+
+    QglBuffer* buffer = static_cast<QglBuffer*>(aBuffer);
+
+    // Wait for the GPU to be done with the previous frame that used this
+    // region. This lets us map the range unsynchronized, which avoids both
+    // the implicit synchronization and the reallocation done by glBufferData.
+    //
+    // The wait is bounded. If it times out or fails, we fall back to a
+    // synchronized mapping, which is slower but still correct.
+    //
+    bool isRegionAvailable = true;
+    if (regionIndex < buffer->transientRegionFences_.length()) {
+        GLsync& fence = buffer->transientRegionFences_[regionIndex];
+        if (fence) {
+            // Note: flushing ensures that the fence is eventually signaled,
+            // even if its commands were not yet sent to the GPU.
+            const GLuint64 timeout = 1000000000; // 1s
+            GLenum result =
+                api_->glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+            if (result == GL_WAIT_FAILED) {
+                VGC_ERROR(LogVgcUi, "Couldn't wait for transient vertex data fence.");
+                isRegionAvailable = false;
+            }
+            else if (result == GL_TIMEOUT_EXPIRED) {
+                VGC_WARNING(
+                    LogVgcUi, "Timeout while waiting for transient vertex data fence.");
+                isRegionAvailable = false;
+            }
+            api_->glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+    if (isRegionAvailable) {
+        access |= GL_MAP_UNSYNCHRONIZED_BIT;
+    }
+    api_->glBindBuffer(GL_COPY_WRITE_BUFFER, buffer->object());
+    void* mapped = api_->glMapBufferRange(
+        GL_COPY_WRITE_BUFFER,
+        core::int_cast<GLintptr>(offsetInBytes),
+        core::int_cast<GLsizeiptr>(lengthInBytes),
+        access);
+    if (mapped) {
+        std::memcpy(mapped, data, lengthInBytes);
+        api_->glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    }
+    else {
+        VGC_ERROR(LogVgcUi, "Couldn't map transient vertex buffer.");
+    }
+    api_->glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void QglEngine::fenceTransientVertexData_(Buffer* aBuffer, Int regionIndex) {
+    QglBuffer* buffer = static_cast<QglBuffer*>(aBuffer);
+    core::Array<GLsync>& fences = buffer->transientRegionFences_;
+    if (regionIndex >= fences.length()) {
+        fences.resize(regionIndex + 1, nullptr);
+    }
+    GLsync& fence = fences[regionIndex];
+    if (fence) {
+        api_->glDeleteSync(fence);
+    }
+    fence = api_->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void QglEngine::draw_(
+    GeometryView* aView,
+    UInt numIndices,
+    UInt numInstances,
+    UInt startVertex) {
 
     syncTextureStates_();
 
     GLsizei nIdx = core::int_cast<GLsizei>(numIndices);
     GLsizei nInst = core::int_cast<GLsizei>(numInstances);
+    GLint first = core::int_cast<GLint>(startVertex);
 
     if (nIdx == 0) {
         return;
@@ -1385,6 +1584,7 @@ void QglEngine::draw_(GeometryView* aView, UInt numIndices, UInt numInstances) {
                 attribDesc.normalized,
                 attribDesc.stride,
                 reinterpret_cast<const GLvoid*>(attribDesc.offset));
+            api_->glVertexAttribDivisor(attribDesc.index, attribDesc.divisor);
             api_->glEnableVertexAttribArray(attribDesc.index);
         }
         api_->glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -1393,6 +1593,28 @@ void QglEngine::draw_(GeometryView* aView, UInt numIndices, UInt numInstances) {
         api_->glBindVertexArray(cachedVao);
     }
 
+    if (view->hasPerInstanceVertexData()) {
+        // OpenGL 3.3 has no base instance, so the per-instance attributes of
+        // the VAO are offset to the first instance at each draw instead.
+        uintptr_t firstInstance = static_cast<uintptr_t>(first);
+        first = 0;
+        for (const GlAttribPointerDesc& attribDesc :
+             program->builtinLayouts_[layoutIdx]) {
+            QglBuffer* vbuf =
+                view->vertexBuffer(attribDesc.bufferIndex).get_static_cast<QglBuffer>();
+            uintptr_t offset = attribDesc.offset + firstInstance * attribDesc.stride;
+            api_->glBindBuffer(GL_ARRAY_BUFFER, vbuf->object());
+            api_->glVertexAttribPointer(
+                attribDesc.index,
+                attribDesc.numElements,
+                attribDesc.elementType,
+                attribDesc.normalized,
+                attribDesc.stride,
+                reinterpret_cast<const GLvoid*>(offset));
+        }
+        api_->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
     QglBuffer* indexBuffer = view->indexBuffer().get_static_cast<QglBuffer>();
     GLenum indexFormat = (view->indexFormat() == IndexFormat::UInt16) ? GL_UNSIGNED_SHORT
                                                                       : GL_UNSIGNED_INT;
@@ -1400,19 +1622,20 @@ void QglEngine::draw_(GeometryView* aView, UInt numIndices, UInt numInstances) {
     if (numInstances == 0) {
         if (indexBuffer) {
             api_->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer->object());
-            api_->glDrawElements(view->drawMode_, nIdx, indexFormat, 0);
+            api_->glDrawElementsBaseVertex(view->drawMode_, nIdx, indexFormat, 0, first);
         }
         else {
-            api_->glDrawArrays(view->drawMode_, 0, nIdx);
+            api_->glDrawArrays(view->drawMode_, first, nIdx);
         }
     }
     else {
         if (indexBuffer) {
             api_->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer->object());
-            api_->glDrawElementsInstanced(view->drawMode_, nIdx, indexFormat, 0, nInst);
+            api_->glDrawElementsInstancedBaseVertex(
+                view->drawMode_, nIdx, indexFormat, 0, nInst, first);
         }
         else {
-            api_->glDrawArraysInstanced(view->drawMode_, 0, nIdx, nInst);
+            api_->glDrawArraysInstanced(view->drawMode_, first, nIdx, nInst);
         }
     }
 }
@@ -1502,7 +1725,75 @@ bool QglEngine::loadBuffer_(class QglBuffer* buffer, const void* data, Int dataS
 }
 
 void QglEngine::syncTextureStates_() {
-    // XXX todo
+    if (!isAnyTextureStateDirty_) {
+        return;
+    }
+    isAnyTextureStateDirty_ = false;
+
+    // Each image view slot of each stage is mapped to its own texture unit.
+    // OpenGL 3.3 sampler states are texture parameters, so they are applied
+    // to the viewed image, which remembers its last applied state to avoid
+    // redundant changes.
+    for (UInt32 unit = 0; unit < numTextureUnits; ++unit) {
+        if (!isTextureStateDirtyMap_[unit]) {
+            continue;
+        }
+        isTextureStateDirtyMap_[unit] = false;
+        QglImageView* view = currentImageViews_[unit].get_static_cast<QglImageView>();
+        if (!view) {
+            continue;
+        }
+        GLenum target = view->target();
+        api_->glActiveTexture(GL_TEXTURE0 + unit);
+        activeTextureUnit_ = unit;
+        api_->glBindTexture(target, view->object());
+
+        QglSamplerStatePtr state =
+            static_pointer_cast<QglSamplerState>(currentSamplerStates_[unit]);
+        if (!state || target == GL_TEXTURE_BUFFER || target == GL_TEXTURE_2D_MULTISAMPLE
+            || target == GL_TEXTURE_2D_MULTISAMPLE_ARRAY) {
+            continue;
+        }
+        QglSamplerStatePtr& appliedState = *view->samplerStatePtrAddress_;
+        if (appliedState && appliedState->isEquivalentTo(*state)) {
+            continue;
+        }
+        appliedState = state;
+
+        GLenum minFilter = state->minFilterGL_;
+        if (view->viewedImage()->numMipLevels() > 1) {
+            bool isMipLinear = state->mipFilterGL_ == GL_LINEAR;
+            if (minFilter == GL_LINEAR) {
+                minFilter =
+                    isMipLinear ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR_MIPMAP_NEAREST;
+            }
+            else {
+                minFilter =
+                    isMipLinear ? GL_NEAREST_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST;
+            }
+        }
+        api_->glTexParameteri(target, GL_TEXTURE_MIN_FILTER, minFilter);
+        api_->glTexParameteri(target, GL_TEXTURE_MAG_FILTER, state->magFilterGL_);
+        if (hasAnisotropicFilteringSupport_) {
+            constexpr GLenum maxAnisotropyEXT = 0x84FE; // GL_TEXTURE_MAX_ANISOTROPY_EXT
+            api_->glTexParameterf(
+                target, maxAnisotropyEXT, (std::max)(1.f, state->maxAnisotropyGL_));
+        }
+        api_->glTexParameteri(target, GL_TEXTURE_WRAP_S, state->wrapS_);
+        api_->glTexParameteri(target, GL_TEXTURE_WRAP_T, state->wrapT_);
+        api_->glTexParameteri(target, GL_TEXTURE_WRAP_R, state->wrapR_);
+        const float* wrapColor = state->wrapColor().data();
+        api_->glTexParameterfv(target, GL_TEXTURE_BORDER_COLOR, wrapColor);
+        if (state->comparisonFunction() == ComparisonFunction::Disabled) {
+            api_->glTexParameteri(target, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+        }
+        else {
+            api_->glTexParameteri(
+                target, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+            api_->glTexParameteri(
+                target, GL_TEXTURE_COMPARE_FUNC, state->comparisonFunctionGL_);
+        }
+    }
 }
 
 } // namespace vgc::ui::detail::qopengl
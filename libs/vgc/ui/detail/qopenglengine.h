@@ -177,7 +177,28 @@ protected:
 
     void updateBufferData_(Buffer* buffer, const void* data, Int lengthInBytes) override;
 
-    void draw_(GeometryView* view, UInt numIndices, UInt numInstances) override;
+    void updateImageData_(
+        Image* image,
+        Int x,
+        Int y,
+        Int width,
+        Int height,
+        const void* data,
+        Int lengthInBytes) override;
+
+    void uploadTransientVertexData_(
+        Buffer* buffer,
+        Int regionIndex,
+        Int offsetInBytes,
+        const void* data,
+        Int lengthInBytes) override;
+    void fenceTransientVertexData_(Buffer* buffer, Int regionIndex) override;
+
+    void draw_(
+        GeometryView* view,
+        UInt numIndices,
+        UInt numInstances,
+        UInt startVertex) override;
     void clear_(const core::Color& color) override;
 
     UInt64
@@ -208,6 +229,7 @@ private:
     std::array<SamplerStatePtr, numTextureUnits> currentSamplerStates_;
     std::array<bool, numTextureUnits> isTextureStateDirtyMap_;
     bool isAnyTextureStateDirty_ = true;
+    UInt32 activeTextureUnit_ = 0;
 
     // helpers
 
@@ -78,16 +78,14 @@ void Label::onResize() {
     reload_ = true;
 }
 
-void Label::onPaintCreate(graphics::Engine* engine) {
-    triangles_ =
-        engine->createDynamicTriangleListView(graphics::BuiltinGeometryLayout::XYRGB);
-}
-
 void Label::onPaintDraw(graphics::Engine* engine, PaintOptions /*options*/) {
 
     namespace gs = graphics::strings;
 
-    if (reload_) {
+    // The cached text quads are invalidated when glyphs are evicted from the
+    // atlas of the engine.
+    graphics::GlyphAtlas& glyphAtlas = engine->glyphAtlas();
+    if (reload_ || textQuadsNumEvictions_ != glyphAtlas.numEvictions()) {
         reload_ = false;
         core::FloatArray a;
 
@@ -98,18 +96,19 @@ void Label::onPaintDraw(graphics::Engine* engine, PaintOptions /*options*/) {
             detail::insertRect(a, backgroundColor, rect(), borderRadiuses);
         }
 
-        // Draw text
-        richText_->fill(a);
+        // Draw text. Glyphs that don't fit in the atlas are retried next time.
+        textQuads_.clear();
+        if (!richText_->fill(a, textQuads_, glyphAtlas)) {
+            reload_ = true;
+        }
+        textQuadsNumEvictions_ = glyphAtlas.numEvictions();
 
         // Load triangles data
-        engine->updateVertexBufferData(triangles_, std::move(a));
+        triangles_.setVertices(std::move(a));
     }
     engine->setProgram(graphics::BuiltinProgram::Simple);
-    engine->draw(triangles_, -1, 0);
-}
-
-void Label::onPaintDestroy(graphics::Engine*) {
-    triangles_.reset();
+    engine->drawBatchedTriangles(triangles_);
+    engine->drawText(textQuads_);
 }
 
 bool Label::onMouseEnter() {
@@ -118,16 +118,14 @@ void LineEdit::onResize() {
     reload_ = true;
 }
 
-void LineEdit::onPaintCreate(graphics::Engine* engine) {
-    triangles_ =
-        engine->createDynamicTriangleListView(graphics::BuiltinGeometryLayout::XYRGB);
-}
-
 void LineEdit::onPaintDraw(graphics::Engine* engine, PaintOptions /*options*/) {
 
     namespace gs = graphics::strings;
 
-    if (reload_) {
+    // The cached text quads are invalidated when glyphs are evicted from the
+    // atlas of the engine.
+    graphics::GlyphAtlas& glyphAtlas = engine->glyphAtlas();
+    if (reload_ || textQuadsNumEvictions_ != glyphAtlas.numEvictions()) {
         reload_ = false;
         core::FloatArray a;
 
@@ -143,18 +141,19 @@ void LineEdit::onPaintDraw(graphics::Engine* engine, PaintOptions /*options*/) {
             detail::insertRect(a, backgroundColor, rect(), borderRadiuses);
         }
 
-        // Draw text
-        richText_->fill(a);
+        // Draw text. Glyphs that don't fit in the atlas are retried next time.
+        textQuads_.clear();
+        if (!richText_->fill(a, textQuads_, glyphAtlas)) {
+            reload_ = true;
+        }
+        textQuadsNumEvictions_ = glyphAtlas.numEvictions();
 
         // Load triangles data
-        engine->updateVertexBufferData(triangles_, std::move(a));
+        triangles_.setVertices(std::move(a));
     }
     engine->setProgram(graphics::BuiltinProgram::Simple);
-    engine->draw(triangles_, -1, 0);
-}
-
-void LineEdit::onPaintDestroy(graphics::Engine*) {
-    triangles_.reset();
+    engine->drawBatchedTriangles(triangles_);
+    engine->drawText(textQuads_);
 }
 
 void LineEdit::extendSelection_(const geometry::Vec2f& point) {
@@ -16,6 +16,7 @@
 
 #include <vgc/widgets/openglviewer.h>
 
+#include <algorithm> // sort, unique
 #include <cassert>
 #include <cmath>
 
@@ -32,6 +33,7 @@
 #include <vgc/core/paths.h>
 #include <vgc/core/stopwatch.h>
 #include <vgc/geometry/curve.h>
+#include <vgc/geometry/points.h>
 #include <vgc/geometry/vec2f.h>
 #include <vgc/ui/qtutil.h>
 
@@ -55,6 +57,9 @@ core::StringId POSITIONS("positions");
 core::StringId WIDTHS("widths");
 core::StringId COLOR("color");
 
+// Size of the control points, in pixels
+const double controlPointSize = 10.0;
+
 void drawCrossCursor(QPainter& painter) {
     painter.setPen(QPen(Qt::color1, 1.0));
     painter.drawLine(16, 0, 16, 10);
@@ -133,7 +138,11 @@ OpenGLViewer::OpenGLViewer(dom::Document* document, QWidget* parent)
     , currentTesselationMode_(2)
     , renderTask_("Render")
     , updateTask_("Update")
-    , drawTask_("Draw") {
+    , tessellationCacheHitsTask_("Tessellation Cache Hits")
+    , tessellationCacheMissesTask_("Tessellation Cache Misses")
+    , drawTask_("Draw")
+    , drawnCurvesTask_("Drawn Curves")
+    , culledCurvesTask_("Culled Curves") {
 
     // Set ClickFocus policy to be able to accept keyboard events (default
     // policy is NoFocus).
@@ -178,14 +187,22 @@ QSize OpenGLViewer::minimumSizeHint() const {
 
 void OpenGLViewer::startLoggingUnder(core::PerformanceLog* parent) {
     core::PerformanceLog* renderLog = renderTask_.startLoggingUnder(parent);
-    updateTask_.startLoggingUnder(renderLog);
-    drawTask_.startLoggingUnder(renderLog);
+    core::PerformanceLog* updateLog = updateTask_.startLoggingUnder(renderLog);
+    tessellationCacheHitsTask_.startLoggingUnder(updateLog);
+    tessellationCacheMissesTask_.startLoggingUnder(updateLog);
+    core::PerformanceLog* drawLog = drawTask_.startLoggingUnder(renderLog);
+    drawnCurvesTask_.startLoggingUnder(drawLog);
+    culledCurvesTask_.startLoggingUnder(drawLog);
 }
 
 void OpenGLViewer::stopLoggingUnder(core::PerformanceLog* parent) {
     core::PerformanceLogPtr renderLog = renderTask_.stopLoggingUnder(parent);
-    updateTask_.stopLoggingUnder(renderLog.get());
-    drawTask_.stopLoggingUnder(renderLog.get());
+    core::PerformanceLogPtr updateLog = updateTask_.stopLoggingUnder(renderLog.get());
+    tessellationCacheHitsTask_.stopLoggingUnder(updateLog.get());
+    tessellationCacheMissesTask_.stopLoggingUnder(updateLog.get());
+    core::PerformanceLogPtr drawLog = drawTask_.stopLoggingUnder(renderLog.get());
+    drawnCurvesTask_.stopLoggingUnder(drawLog.get());
+    culledCurvesTask_.stopLoggingUnder(drawLog.get());
 }
 
 void OpenGLViewer::mousePressEvent(QMouseEvent* event) {
@@ -338,6 +355,9 @@ void OpenGLViewer::pointingDeviceMove(const PointingDeviceEvent& event) {
 }
 
 void OpenGLViewer::pointingDeviceRelease(const PointingDeviceEvent&) {
+    if (isSketching_) {
+        finishCurve_();
+    }
     isSketching_ = false;
     isRotating_ = false;
     isPanning_ = false;
@@ -425,34 +445,51 @@ void OpenGLViewer::paintGL() {
     shaderProgram_.setUniformValue(projMatrixLoc_, ui::toQt(camera_.projectionMatrix()));
     shaderProgram_.setUniformValue(viewMatrixLoc_, ui::toQt(camera_.viewMatrix()));
 
+    // Compute which curves are visible. We enlarge the viewport by the
+    // radius of the control points, so that control points slightly outside
+    // the viewport are still drawn.
+    //
+    double margin = showControlPoints_ ? 0.5 * controlPointSize : 0;
+    geometry::Rect2d visibleRect = camera_.visibleRect(margin);
+    visibleCurves_.clear();
+    for (CurveGLResources& r : curveGLResources_) {
+        if (r.boundingRect.intersects(visibleRect)) {
+            visibleCurves_.append(&r);
+        }
+    }
+    Int numDrawnCurves = visibleCurves_.length();
+    Int numCulledCurves = core::int_cast<Int>(curveGLResources_.size()) - numDrawnCurves;
+
     // Draw triangles
     f->glPolygonMode(GL_FRONT_AND_BACK, (polygonMode_ == 1) ? GL_LINE : GL_FILL);
-    for (CurveGLResources& r : curveGLResources_) {
+    for (CurveGLResources* r : visibleCurves_) {
         shaderProgram_.setUniformValue(
             colorLoc_,
-            static_cast<float>(r.trianglesColor.r()),
-            static_cast<float>(r.trianglesColor.g()),
-            static_cast<float>(r.trianglesColor.b()),
-            static_cast<float>(r.trianglesColor.a()));
-        r.vaoTriangles->bind();
-        f->glDrawArrays(GL_TRIANGLE_STRIP, 0, r.numVerticesTriangles);
-        r.vaoTriangles->release();
+            static_cast<float>(r->trianglesColor.r()),
+            static_cast<float>(r->trianglesColor.g()),
+            static_cast<float>(r->trianglesColor.b()),
+            static_cast<float>(r->trianglesColor.a()));
+        r->vaoTriangles->bind();
+        f->glDrawArrays(GL_TRIANGLE_STRIP, 0, r->numVerticesTriangles);
+        r->vaoTriangles->release();
     }
 
     // Draw control points
     if (showControlPoints_) {
         shaderProgram_.setUniformValue(colorLoc_, 1.0f, 0.0f, 0.0f, 1.0f);
-        f->glPointSize(10.0);
-        for (CurveGLResources& r : curveGLResources_) {
-            r.vaoControlPoints->bind();
-            f->glDrawArrays(GL_POINTS, 0, r.numVerticesControlPoints);
-            r.vaoControlPoints->release();
+        f->glPointSize(static_cast<GLfloat>(controlPointSize));
+        for (CurveGLResources* r : visibleCurves_) {
+            r->vaoControlPoints->bind();
+            f->glDrawArrays(GL_POINTS, 0, r->numVerticesControlPoints);
+            r->vaoControlPoints->release();
         }
     }
 
     // Release shader program
     shaderProgram_.release();
     drawTask_.stop();
+    drawnCurvesTask_.logCount(numDrawnCurves);
+    culledCurvesTask_.logCount(numCulledCurves);
 
     // Complete measure of rendering time
     renderTask_.stop();
@@ -467,6 +504,8 @@ void OpenGLViewer::cleanupGL() {
     }
     curveGLResources_.clear();
     curveGLResourcesMap_.clear();
+    curvesBvh_.clear();
+    bvhElements_.clear();
 }
 
 void OpenGLViewer::onDocumentChanged_(const dom::Diff& diff) {
@@ -477,6 +516,7 @@ void OpenGLViewer::onDocumentChanged_(const dom::Diff& diff) {
         }
         auto it = curveGLResourcesMap_.find(e);
         if (it != curveGLResourcesMap_.end()) {
+            clearCurveBvh_(*it->second);
             removedGLResources_.splice(
                 removedGLResources_.begin(), curveGLResources_, it->second);
             curveGLResourcesMap_.erase(it);
@@ -499,6 +539,7 @@ void OpenGLViewer::onDocumentChanged_(const dom::Diff& diff) {
         else {
             auto it = curveGLResourcesMap_.find(e);
             if (it != curveGLResourcesMap_.end()) {
+                clearCurveBvh_(*it->second);
                 removedGLResources_.splice(
                     removedGLResources_.begin(), curveGLResources_, it->second);
                 curveGLResourcesMap_.erase(it);
@@ -556,12 +597,24 @@ void OpenGLViewer::onDocumentChanged_(const dom::Diff& diff) {
         }
     }
 
+    // Update the spatial index right away rather than in paintGL(), so that
+    // queries are correct even if the viewer isn't redrawn in between.
+    // Note that toUpdate_ may still contain resources which have been removed
+    // since they were inserted, which we must skip.
+    for (auto it : toUpdate_) {
+        auto it2 = curveGLResourcesMap_.find(it->element);
+        if (it2 != curveGLResourcesMap_.end() && it2->second == it) {
+            updateCurveBvh_(*it);
+        }
+    }
+
     // ask for redraw
     update();
 }
 
 void OpenGLViewer::updateGLResources_() {
     updateTask_.start();
+    tessellationCache_.resetCounters();
 
     for (CurveGLResources& r : removedGLResources_) {
         destroyCurveGLResources_(r);
@@ -583,6 +636,94 @@ void OpenGLViewer::updateGLResources_() {
     toUpdate_.clear();
 
     updateTask_.stop();
+    tessellationCacheHitsTask_.logCount(tessellationCache_.numHits());
+    tessellationCacheMissesTask_.logCount(tessellationCache_.numMisses());
+}
+
+void OpenGLViewer::findCurvesIntersecting(
+    const geometry::Rect2d& rect,
+    core::Array<dom::Element*>& elements) const {
+
+    Int oldLength = elements.length();
+    curvesBvh_.visitIntersecting(rect, [&](Int id) {
+        elements.append(bvhElements_[id]);
+        return true;
+    });
+
+    // Remove duplicates, since a curve may have several intersecting segments
+    auto begin = elements.begin() + oldLength;
+    std::sort(begin, elements.end());
+    elements.erase(std::unique(begin, elements.end()), elements.end());
+}
+
+dom::Element*
+OpenGLViewer::findCurveAt(const geometry::Vec2d& position, double tolerance) const {
+    Int id = curvesBvh_.findNearest(
+        position,
+        [&](Int i) { return geometry::Bvh2d::distance(curvesBvh_.rect(i), position); },
+        tolerance);
+    return id == -1 ? nullptr : bvhElements_[id];
+}
+
+// Updates r.curve from the attributes of r.element. Existing control points
+// are modified in place, so that the curve only recomputes the cached data of
+// the segments which actually changed. Returns false if the attributes are
+// invalid, in which case r.curve is left unchanged.
+//
+bool OpenGLViewer::updateCurve_(CurveGLResources& r) {
+    dom::Element* path = r.element;
+    geometry::Vec2dArray positions = path->getAttribute(POSITIONS).getVec2dArray();
+    core::DoubleArray widths = path->getAttribute(WIDTHS).getDoubleArray();
+    if (positions.size() != widths.size()) {
+        return false;
+    }
+
+    geometry::Curve& curve = r.curve;
+    Int n = positions.length();
+    if (curve.numControlPoints() > n) {
+        curve = geometry::Curve();
+    }
+    Int m = curve.numControlPoints();
+    const core::DoubleArray& d = curve.positionData();
+    const core::DoubleArray& w = curve.widthData();
+    for (Int j = 0; j < m; ++j) {
+        geometry::Vec2d p(d[2 * j], d[2 * j + 1]);
+        if (positions[j] != p || widths[j] != w[j]) {
+            curve.setControlPoint(j, positions[j], widths[j]);
+        }
+    }
+    for (Int j = m; j < n; ++j) {
+        curve.addControlPoint(positions[j], widths[j]);
+    }
+    curve.setColor(path->getAttribute(COLOR).getColor());
+    return true;
+}
+
+void OpenGLViewer::updateCurveBvh_(CurveGLResources& r) {
+    clearCurveBvh_(r);
+    r.isCurveValid = updateCurve_(r);
+    if (!r.isCurveValid) {
+        return;
+    }
+
+    const geometry::Curve& curve = r.curve;
+    Int numSegments = curve.numSegments();
+    for (Int j = 0; j < numSegments; ++j) {
+        Int id = curvesBvh_.insert(curve.segmentBoundingRect(j), j);
+        if (id >= bvhElements_.length()) {
+            bvhElements_.resize(id + 1);
+        }
+        bvhElements_[id] = r.element;
+        r.bvhIds.append(id);
+    }
+}
+
+void OpenGLViewer::clearCurveBvh_(CurveGLResources& r) {
+    for (Int id : r.bvhIds) {
+        curvesBvh_.remove(id);
+        bvhElements_[id] = nullptr;
+    }
+    r.bvhIds.clear();
 }
 
 OpenGLViewer::CurveGLResourcesIterator
@@ -645,35 +786,34 @@ void OpenGLViewer::updateCurveGLResources_(CurveGLResources& r) {
     core::Color color = path->getAttribute(COLOR).getColor();
 
     if (1) {
-        // Convert the dom::Path to a geometry::Curve
-        // XXX move this logic to dom::Path
-
-        VGC_CORE_ASSERT(positions.size() == widths.size());
-        Int nControlPoints = positions.length();
-        geometry::Curve curve;
-        curve.setColor(color);
-        for (Int j = 0; j < nControlPoints; ++j) {
-            curve.addControlPoint(positions[j], widths[j]);
-        }
-
-        // Triangulate the curve
-        double maxAngle = 0.05;
-        int minQuads = 1;
-        int maxQuads = 64;
-        if (requestedTesselationMode_ == 0) {
-            maxQuads = 1;
-        }
-        else if (requestedTesselationMode_ == 1) {
-            minQuads = 10;
-            maxQuads = 10;
-        }
-        triangulation = curve.triangulate(maxAngle, minQuads, maxQuads);
-
-        const core::DoubleArray& d = curve.positionData();
-        Int ncp = core::int_cast<GLsizei>(d.length() / 2);
-        for (Int j = 0; j < ncp; ++j) {
-            glVerticesControlPoints.append(geometry::Vec2f(
-                static_cast<float>(d[2 * j]), static_cast<float>(d[2 * j + 1])));
+        // Note: r.curve has already been updated from the dom::Path by
+        // updateCurveBvh_() when the document changed, so we re-use it
+        // rather than rebuilding it. If the attributes of the path are
+        // invalid, we draw nothing.
+        //
+        if (r.isCurveValid) {
+            const geometry::Curve& curve = r.curve;
+
+            // Triangulate the curve
+            double maxAngle = 0.05;
+            int minQuads = 1;
+            int maxQuads = 64;
+            if (requestedTesselationMode_ == 0) {
+                maxQuads = 1;
+            }
+            else if (requestedTesselationMode_ == 1) {
+                minQuads = 10;
+                maxQuads = 10;
+            }
+            triangulation =
+                tessellationCache_.triangulate(curve, maxAngle, minQuads, maxQuads);
+
+            const core::DoubleArray& d = curve.positionData();
+            Int ncp = core::int_cast<GLsizei>(d.length() / 2);
+            for (Int j = 0; j < ncp; ++j) {
+                glVerticesControlPoints.append(geometry::Vec2f(
+                    static_cast<float>(d[2 * j]), static_cast<float>(d[2 * j + 1])));
+            }
         }
     }
     else { // simplest impl for perf comparison
@@ -717,12 +857,23 @@ void OpenGLViewer::updateCurveGLResources_(CurveGLResources& r) {
     //     - directly compute the triangulation using floats (although
     //       using doubles is more precise for intersection tests)
     //
+    // We also cache the bounding rectangle of the triangles and control
+    // points, used by paintGL() to skip drawing off-screen curves.
+    //
     r.numVerticesTriangles = core::int_cast<GLsizei>(triangulation.length());
     geometry::Vec2fArray glVerticesTriangles;
+    glVerticesTriangles.reserve(triangulation.length());
     for (const geometry::Vec2d& v : triangulation) {
         glVerticesTriangles.append(
             geometry::Vec2f(static_cast<float>(v[0]), static_cast<float>(v[1])));
     }
+    geometry::Rect2f controlPointsRect = geometry::boundingRect(glVerticesControlPoints);
+    r.boundingRect = geometry::boundingRect(triangulation);
+    r.boundingRect.uniteWith(geometry::Rect2d(
+        controlPointsRect.xMin(),
+        controlPointsRect.yMin(),
+        controlPointsRect.xMax(),
+        controlPointsRect.yMax()));
     r.vboTriangles.bind();
     int n = core::int_cast<int>(r.numVerticesTriangles)
             * static_cast<int>(sizeof(geometry::Vec2f));
@@ -769,6 +920,11 @@ void OpenGLViewer::startCurve_(const geometry::Vec2d& p, double width) {
     path->setAttribute(WIDTHS, core::DoubleArray());
     path->setAttribute(COLOR, currentColor_);
 
+    // The tolerance is specified in pixels, but the samples are in world
+    // coordinates.
+    sketchSimplifier_.clear();
+    sketchSimplifier_.setTolerance(sketchTolerance_ / camera_.zoom());
+
     continueCurve_(p, width);
 }
 
@@ -787,11 +943,17 @@ void OpenGLViewer::continueCurve_(const geometry::Vec2d& p, double width) {
         // freely mutate the value and trusteing them in sending a changed
         // signal themselves.
 
-        geometry::Vec2dArray positions = path->getAttribute(POSITIONS).getVec2dArray();
-        core::DoubleArray widths = path->getAttribute(WIDTHS).getDoubleArray();
-
-        positions.append(p);
-        widths.append(width);
+        // Only the samples kept by the simplifier are stored in the
+        // document, plus the last input sample so that the curve always ends
+        // under the pointing device.
+        //
+        sketchSimplifier_.addSample(p, width);
+        geometry::Vec2dArray positions = sketchSimplifier_.positions();
+        core::DoubleArray widths = sketchSimplifier_.widths();
+        if (sketchSimplifier_.hasPendingSample()) {
+            positions.append(sketchSimplifier_.lastPosition());
+            widths.append(sketchSimplifier_.lastWidth());
+        }
 
         path->setAttribute(POSITIONS, std::move(positions));
         path->setAttribute(WIDTHS, std::move(widths));
@@ -800,4 +962,12 @@ void OpenGLViewer::continueCurve_(const geometry::Vec2d& p, double width) {
     }
 }
 
+void OpenGLViewer::finishCurve_() {
+    // The last input sample is already stored in the document (see
+    // continueCurve_()), so finalizing the stroke doesn't require to modify
+    // the document. We only reset the simplifier for the next stroke.
+    sketchSimplifier_.finish();
+    sketchSimplifier_.clear();
+}
+
 } // namespace vgc::widgets
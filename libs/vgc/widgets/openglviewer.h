@@ -30,7 +30,12 @@
 #include <vgc/core/performancelog.h>
 #include <vgc/dom/document.h>
 #include <vgc/dom/element.h>
+#include <vgc/geometry/bvh2d.h>
 #include <vgc/geometry/camera2d.h>
+#include <vgc/geometry/curve.h>
+#include <vgc/geometry/rect2d.h>
+#include <vgc/geometry/strokesimplifier.h>
+#include <vgc/geometry/tessellationcache.h>
 #include <vgc/geometry/vec2d.h>
 #include <vgc/widgets/api.h>
 #include <vgc/widgets/pointingdeviceevent.h>
@@ -81,6 +86,37 @@ public:
     ///
     void stopLoggingUnder(core::PerformanceLog* parent);
 
+    /// Returns the tolerance, in pixels, used to discard redundant input
+    /// samples when sketching curves.
+    ///
+    double sketchTolerance() const {
+        return sketchTolerance_;
+    }
+
+    /// Sets the tolerance, in pixels, used to discard redundant input samples
+    /// when sketching curves. An input sample is discarded if the sketched
+    /// curve passes within this distance of it.
+    ///
+    void setSketchTolerance(double tolerance) {
+        sketchTolerance_ = tolerance;
+    }
+
+    /// Appends to `elements` all the curves which may intersect the given
+    /// `rect`, in world coordinates. The test is performed on conservative
+    /// per-segment bounding rectangles, so some of the returned curves may not
+    /// actually intersect `rect`, but all the curves that do are returned.
+    ///
+    void findCurvesIntersecting(
+        const geometry::Rect2d& rect,
+        core::Array<dom::Element*>& elements) const;
+
+    /// Returns the curve nearest to the given `position`, in world
+    /// coordinates, or `nullptr` if there is no curve within the given
+    /// `tolerance`. The distance is measured to the bounding rectangles of
+    /// the curve segments.
+    ///
+    dom::Element* findCurveAt(const geometry::Vec2d& position, double tolerance) const;
+
 Q_SIGNALS:
     /// This signal is emitted when a render is completed.
     ///
@@ -156,6 +192,20 @@ private:
 
         bool inited_ = false;
         dom::Element* element;
+
+        // Geometry of the element, kept across updates so that only the
+        // segments affected by modified control points are recomputed
+        geometry::Curve curve;
+
+        // Whether the attributes of the element were valid when updating
+        // the curve. If false, the curve is not drawn.
+        bool isCurveValid = false;
+
+        // IDs of the items in curvesBvh_, one per segment
+        core::IntArray bvhIds;
+
+        // Bounding rectangle of the triangles and control points
+        geometry::Rect2d boundingRect = geometry::Rect2d::empty;
     };
 
     using CurveGLResourcesIterator = std::list<CurveGLResources>::iterator;
@@ -163,6 +213,7 @@ private:
     std::list<CurveGLResources> curveGLResources_; // in draw order
     std::list<CurveGLResources> removedGLResources_;
     std::map<dom::Element*, CurveGLResourcesIterator> curveGLResourcesMap_;
+    core::Array<CurveGLResources*> visibleCurves_; // cleared at each paintGL()
 
     struct unwrapped_less {
         template<typename It>
@@ -179,6 +230,16 @@ private:
     void updateCurveGLResources_(CurveGLResources& r);
     static void destroyCurveGLResources_(CurveGLResources& r);
 
+    // Spatial index of the curve segments, kept in sync with the document.
+    // The value of each item is the segment index, and bvhElements_[id] is
+    // the element of the item with the given ID.
+    geometry::Bvh2d curvesBvh_;
+    core::Array<dom::Element*> bvhElements_;
+
+    bool updateCurve_(CurveGLResources& r);
+    void updateCurveBvh_(CurveGLResources& r);
+    void clearCurveBvh_(CurveGLResources& r);
+
     // Make sure to disallow concurrent usage of the mouse and the tablet to
     // avoid conflicts. This also acts as a work around the following Qt bugs:
     // 1. At least in Linus/X11, mouse events are generated even when tablet
@@ -226,12 +287,25 @@ private:
     //
     void startCurve_(const geometry::Vec2d& p, double width = 1.0);
     void continueCurve_(const geometry::Vec2d& p, double width = 1.0);
+    void finishCurve_();
     core::Color currentColor_;
 
+    // Discards redundant input samples while sketching
+    geometry::StrokeSimplifier sketchSimplifier_;
+    double sketchTolerance_ = 0.5;
+
+    // Reuses the tessellation of curves whose content is unchanged, such as
+    // after undo/redo or when switching back to a previous tessellation mode
+    geometry::TessellationCache tessellationCache_;
+
     // Performance logging
     core::PerformanceLogTask renderTask_;
     core::PerformanceLogTask updateTask_;
+    core::PerformanceLogTask tessellationCacheHitsTask_;
+    core::PerformanceLogTask tessellationCacheMissesTask_;
     core::PerformanceLogTask drawTask_;
+    core::PerformanceLogTask drawnCurvesTask_;
+    core::PerformanceLogTask culledCurvesTask_;
 };
 
 } // namespace vgc::widgets
@@ -73,7 +73,9 @@ void PerformanceMonitor::refresh() {
         if (log != log_.get()) {
 
             QString valueText =
-                ui::toQt(core::secondsToString(log->lastTime(), unit, decimals));
+                log->isCount()
+                    ? QString::number(log->lastCount())
+                    : ui::toQt(core::secondsToString(log->lastTime(), unit, decimals));
 
             // If there was already something displayed for this index,
             // update the text of the QLabels